@@ -27,6 +27,7 @@
 #include "ct_dialogs.h"
 #include "ct_codebox.h"
 #include "ct_image.h"
+#include "ct_embfiles_sync.h"
 #include "ct_table.h"
 #include "ct_types.h"
 #include "ct_filesystem.h"
@@ -40,7 +41,8 @@ class CtActions
 {
 public:
     CtActions(CtMainWin* pCtMainWin)
-     : _pCtMainWin{pCtMainWin}
+     : _embFilesSync{pCtMainWin}
+     , _pCtMainWin{pCtMainWin}
      , _pCtConfig{pCtMainWin->get_ct_config()}
     {
         _s_options.pMultipleWordsSearchType = &_pCtConfig->multipleWordsSearchType;
@@ -61,12 +63,7 @@ private:
     CtLinkEntry _link_entry;
 
 private:
-    struct CtEmbFileOpened {
-        fs::path tmp_filepath;
-        time_t mod_time;
-    };
-    std::unordered_map<size_t, CtEmbFileOpened> _embfiles_opened;
-    sigc::connection _embfiles_timeout_connection;
+    CtEmbFilesSync _embFilesSync;
 
 private:
     CtMainWin* const _pCtMainWin;
@@ -82,7 +79,8 @@ private:
 
 public:
     CtMainWin*   getCtMainWin() { return _pCtMainWin; }
-    bool         get_were_embfiles_opened() { return _embfiles_opened.size(); }
+    bool         get_were_embfiles_opened() { return not _embFilesSync.empty(); }
+    bool         get_were_embfiles_opened(const gint64 nodeIdDataHolder) { return _embFilesSync.has_node(nodeIdDataHolder); }
 
 private:
     Glib::RefPtr<Gtk::TextBuffer> _curr_buffer() { return _pCtMainWin->get_text_view().get_buffer(); }
@@ -126,10 +124,16 @@ private:
                    const bool add_as_child,
                    const CtTreeIter* pCtTreeIterFrom = nullptr,
                    CtMainWin* pWinToCopyFrom = nullptr);
+    // lazyContent if not empty is the content the node buffer is built from when first needed
     Gtk::TreeModel::iterator _node_add_with_data(Gtk::TreeModel::iterator curr_iter,
                                       CtNodeData& nodeData,
                                       const bool add_as_child,
-                                      std::shared_ptr<CtNodeState> node_state);
+                                      std::string&& lazyContent);
+    // the content of a node as kept for a lazily built buffer, read from the buffer only if the storage
+    // does not have it as is (the buffer modified, or with widgets); empty if the node is empty
+    std::string _node_content_to_duplicate(CtMainWin* pWinFrom, const CtTreeIter& ctTreeIterFrom);
+    // the links and anchors of the new node are the ones of the node it is a copy of, nothing to load
+    void _node_link_index_duplicate(CtMainWin* pWinFrom, const gint64 nodeIdDataHolderFrom, const gint64 newNodeId);
 
 public:
     Gtk::TreeModel::iterator node_child_exist_or_create(Gtk::TreeModel::iterator parentIter,
@@ -148,6 +152,8 @@ private:
     bool _tree_sort_level_and_sublevels(const Gtk::TreeNodeChildren& children,
                                         bool ascending);
     void _node_date(const bool from_sel_not_root, const int days_offset = 0);
+    // list of nodes to choose from, the chosen one gets selected in the tree
+    void _nodes_choose_and_select(const Glib::ustring& title, const std::vector<gint64>& nodeIds);
 
 public:
     // tree actions
@@ -192,9 +198,12 @@ public:
     void tree_sort_ascending();
     void tree_sort_descending();
     void tree_info();
+    void tree_broken_links();
+    void tree_memory_usage();
     void doc_path_to_clipboard();
     void tree_clear_property_exclude_from_search();
     void node_link_to_clipboard();
+    void node_backlinks();
     void node_siblings_sort_ascending();
     void node_siblings_sort_descending();
     void node_go_back();    // was as go_back
@@ -263,6 +272,8 @@ public:
     void find_in_multiple_nodes();
     void find_in_multiple_nodes_act() { _s_options.node_content = true; find_in_multiple_nodes(); }
     void find_a_node() { _s_options.node_content = false; _s_options.node_name_n_tags = true; find_in_multiple_nodes(); }
+    void tags_browse();
+    void tags_filter_nodes();
     void find_again() { find_again_iter(false/*fromIterativeDialog*/); }
     void find_back() { find_back_iter(false/*fromIterativeDialog*/); }
     void replace_in_selected_node();
@@ -432,7 +443,10 @@ private:
     void _anchor_edit_dialog(CtImageAnchor* anchor,
                              Gtk::TextIter insert_iter,
                              Gtk::TextIter* iter_bound);
-    bool _on_embfiles_sentinel_timeout();
+    // progress bar and stop button of the status bar (table csv, directory import)
+    void _status_bar_progress_start();
+    bool _status_bar_progress(const double fraction);
+    void _status_bar_progress_end();
     void _exec_code(const bool is_all);
     void _link_right_click_pre_action();
 
@@ -142,6 +142,8 @@ void CtActions::table_insert()
         }
     }
     CtTableMatrix tbl_matrix;
+    CtTableStore tbl_store;
+    bool from_store{false};
     const auto charOffset = _curr_buffer()->get_insert()->get_iter().get_offset();
     int col_width = _pCtConfig->tableColWidthDefault;
     if (res == CtDialogs::TableHandleResp::OkFromFile) {
@@ -154,7 +156,29 @@ void CtActions::table_insert()
         std::string filepath = CtDialogs::file_select_dialog(_pCtMainWin, args);
         if (filepath.empty()) return;
         _pCtConfig->pickDirCsv = Glib::path_get_dirname(filepath);
-        CtTableCommon::populate_table_matrix_from_csv(filepath, _pCtMainWin, is_light, tbl_matrix);
+        auto f_progress = [this](const double fraction){ return _status_bar_progress(fraction); };
+        _status_bar_progress_start();
+        bool readOk{false};
+        if (is_light) {
+            readOk = CtTableCommon::populate_table_store_from_csv(filepath, tbl_store, f_progress);
+            from_store = true;
+        }
+        else {
+            readOk = CtTableCommon::populate_table_matrix_from_csv(filepath, _pCtMainWin, is_light, tbl_matrix, f_progress);
+        }
+        const bool stopped = _pCtMainWin->get_status_bar().is_progress_stop();
+        _status_bar_progress_end();
+        if (not readOk or (is_light ? 0u == tbl_store.get_num_rows() : tbl_matrix.empty())) {
+            for (CtTableRow& tbl_row : tbl_matrix) {
+                for (void* pCell : tbl_row) {
+                    delete static_cast<CtTextCell*>(pCell);
+                }
+            }
+            if (not stopped) {
+                CtDialogs::error_dialog(str::format(_("Error Reading the File %s."), str::xml_escape(filepath)), *_pCtMainWin);
+            }
+            return;
+        }
         col_width = 60;
     }
     else {
@@ -170,7 +194,10 @@ void CtActions::table_insert()
         }
     }
     CtTableCommon* pCtTable{nullptr};
-    if (is_light) {
+    if (from_store) {
+        pCtTable = new CtTableLight{_pCtMainWin, std::move(tbl_store), col_width, charOffset, "", CtTableColWidths{}};
+    }
+    else if (is_light) {
         pCtTable = new CtTableLight{_pCtMainWin, tbl_matrix, col_width, charOffset, "", CtTableColWidths{}};
     }
     else {
@@ -225,7 +252,7 @@ void CtActions::embfile_insert_path(const std::string& filepath)
     if (not _node_sel_and_rich_text()) return;
     if (not _is_curr_node_not_read_only_or_error()) return;
 
-    std::string blob;
+    CtEmbFileBlobPtr pBlob;
     const bool embfileMFNameOnDisk = _pCtConfig->embfileMFNameOnDisk and fs::is_directory(_pCtMainWin->get_ct_storage()->get_file_path());
 
     const std::string name = Glib::path_get_basename(filepath);
@@ -252,12 +279,16 @@ void CtActions::embfile_insert_path(const std::string& filepath)
                 return;
             }
         }
-        blob = Glib::file_get_contents(filepath);
+        pBlob = CtEmbFileBlob::from_file(filepath);
+        if (not pBlob) {
+            CtDialogs::error_dialog(str::format(_("Error Reading the File %s."), str::xml_escape(filepath)), *_pCtMainWin);
+            return;
+        }
     }
 
     CtAnchoredWidget* pAnchoredWidget = new CtImageEmbFile{_pCtMainWin,
                                                            name,
-                                                           blob,
+                                                           pBlob,
                                                            std::time(nullptr),
                                                            _curr_buffer()->get_insert()->get_iter().get_offset(),
                                                            "",
@@ -425,8 +456,7 @@ void CtActions::_insert_toc_at_pos(Glib::RefPtr<Gtk::TextBuffer> text_buffer, co
         text_buffer->insert_at_cursor(entry.text);
 
         auto mark_iter = mark->get_iter();
-        std::string tag_name = _pCtMainWin->get_text_tag_name_exist_or_create(CtConst::TAG_LINK, entry.anchor_link);
-        text_buffer->apply_tag_by_name(tag_name, mark_iter, text_buffer->get_insert()->get_iter());
+        _pCtMainWin->apply_link(text_buffer, mark_iter, text_buffer->get_insert()->get_iter(), entry.anchor_link);
         text_buffer->delete_mark(mark);
 
         _insert_toc_at_pos(text_buffer, entry.children);
@@ -272,6 +272,7 @@ void CtActions::preferences_import()
     _pCtConfig->ptHighlCurrLine = ctConfigImported.ptHighlCurrLine;
     _pCtConfig->rtHighlMatchBra = ctConfigImported.rtHighlMatchBra;
     _pCtConfig->ptHighlMatchBra = ctConfigImported.ptHighlMatchBra;
+    _pCtConfig->codeHighlFullMaxKB = ctConfigImported.codeHighlFullMaxKB;
     _pCtConfig->spaceAroundLines = ctConfigImported.spaceAroundLines;
     _pCtConfig->relativeWrappedSpace = ctConfigImported.relativeWrappedSpace;
     _pCtConfig->hRule = ctConfigImported.hRule;
@@ -159,6 +159,45 @@ void CtActions::find_in_multiple_nodes()
     find_replace_in_multiple_nodes();
 }
 
+void CtActions::tags_browse()
+{
+    if (not _is_tree_not_empty_or_error()) return;
+    const CtTagIndex& tagIndex = _pCtMainWin->get_tree_store().get_tag_index();
+    if (0u == tagIndex.size()) {
+        CtDialogs::info_dialog(_("No Tags Found"), *_pCtMainWin);
+        return;
+    }
+    auto itemStore = CtChooseDialogListStore::create();
+    for (const auto& [tag, numNodes] : tagIndex.get_tags()) {
+        itemStore->add_row("ct_find", tag, tag + "  (" + std::to_string(numNodes) + ")");
+    }
+    const Gtk::TreeModel::iterator treeIter = CtDialogs::choose_item_dialog(*_pCtMainWin, _("Browse Tags"), itemStore);
+    if (treeIter) {
+        const std::string tag = treeIter->get_value(itemStore->columns.key);
+        _nodes_choose_and_select(_("Tags") + std::string{_(": ")} + tag, tagIndex.query({tag}, true/*requireAll*/));
+    }
+}
+
+void CtActions::tags_filter_nodes()
+{
+    if (not _is_tree_not_empty_or_error()) return;
+    static Glib::ustring s_lastExpression;
+    const Glib::ustring expression = CtDialogs::img_n_entry_dialog(*_pCtMainWin,
+        _("Filter Nodes by Tags (all of 'a b', any of 'a | b')"), s_lastExpression, "ct_find");
+    if (str::trim(expression).empty()) {
+        return;
+    }
+    s_lastExpression = expression;
+    const std::vector<gint64> nodeIds = _pCtMainWin->get_tree_store().get_tag_index().query(expression.raw());
+    if (nodeIds.empty()) {
+        CtDialogs::no_matches_dialog(_pCtMainWin,
+                                     "'" + expression + "'  -  0 " + _("Matches"),
+                                     str::format(_("<b>The pattern '%s' was not found</b>"), str::xml_escape(expression)));
+        return;
+    }
+    _nodes_choose_and_select(_("Tags") + std::string{_(": ")} + expression.raw(), nodeIds);
+}
+
 void CtActions::find_replace_in_multiple_nodes()
 {
     if (not _is_there_selected_node_or_error()) return;
@@ -494,6 +533,8 @@ CtMatchType CtActions::_parse_given_node_content(CtTreeIter node_iter,
 }
 
 // Returns True if pattern was found, False otherwise
+// the pattern is a regex on the node name and the whole tags string so every node is visited,
+// the tag index only serves the exact tag lookups (browse/filter nodes by tags)
 bool CtActions::_parse_node_name_n_tags_iter(CtTreeIter& node_iter,
                                              Glib::RefPtr<Glib::Regex> re_pattern,
                                              const bool all_matches)
@@ -931,6 +972,7 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
                 if (not it.forward_char()) break;
             }
         }
+        const std::string link_property = CtTextIterUtil::get_link_at(pTextBuffer->get_iter_at_offset(startOffset));
         pTextBuffer->erase(sel_start, sel_end);
         pTextBuffer->insert(pTextBuffer->get_iter_at_offset(startOffset), replacer_text);
         // Re-apply preserved tags to the replacement text
@@ -940,6 +982,11 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
             for (const auto& tag : range_tags) {
                 pTextBuffer->apply_tag(tag, new_start, new_end);
             }
+            // the link range is lost if the match covered one of its bounds
+            CtLinkTable* pCtLinkTable = CtLinkTable::get(pTextBuffer);
+            if (not link_property.empty() and pCtLinkTable->get_link(new_start) != link_property) {
+                pCtLinkTable->set(new_start, new_end, link_property);
+            }
         }
         endOffset = startOffset + replacer_text.size();
         _s_state.replace_subsequent = true;
@@ -1201,21 +1248,20 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
                                                   const int anch_offs_end)
 {
     //spdlog::debug("{} obj={} cell={} {}->{}", __FUNCTION__, obj_offset, anch_cell_idx, anch_offs_start, anch_offs_end);
+    // the widget has to be in the text view to select in it
+    pCtMainWin->get_tree_store().text_view_realize_pending_widgets(obj_offset);
     Gtk::TextIter anchor_iter = pTextBuffer->get_iter_at_offset(obj_offset);
     if (CtAnchWidgType::Link == anch_type) {
-        std::optional<Glib::ustring> tag_name = CtTextIterUtil::iter_get_tag_startingwith(anchor_iter, CtConst::TAG_LINK_PREFIX);
-        if (tag_name.has_value()) {
-            Glib::RefPtr<Gtk::TextTag> pTextTag = pCtMainWin->get_text_tag_table()->lookup(tag_name.value());
-            Gtk::TextIter textIterEndTmp{anchor_iter};
-            (void)textIterEndTmp.forward_to_tag_toggle(pTextTag);
-            Gtk::TextIter textIterStartTmp{anchor_iter};
-            (void)textIterStartTmp.backward_to_tag_toggle(pTextTag);
+        Gtk::TextIter textIterStartTmp, textIterEndTmp;
+        if (not CtTextIterUtil::get_link_at(anchor_iter).empty() and
+            CtLinkTable::get(pTextBuffer)->get_bounds(anchor_iter, textIterStartTmp, textIterEndTmp))
+        {
             const int start_offset = textIterStartTmp.get_offset();
             const int end_offset = textIterEndTmp.get_offset();
             pCtMainWin->get_text_view().set_selection_at_offset_n_delta(start_offset, end_offset - start_offset, pTextBuffer);
         }
         else {
-            spdlog::debug("? {} !tag_name", __FUNCTION__);
+            spdlog::debug("? {} !link", __FUNCTION__);
         }
         return;
     }
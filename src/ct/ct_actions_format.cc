@@ -107,6 +107,9 @@ void CtActions::_remove_text_formatting(const bool dismiss_link)
 
     const int sel_start_offset = iter_sel_start.get_offset();
     const int sel_end_offset = iter_sel_end.get_offset();
+    if (dismiss_link) {
+        CtLinkTable::get(pTextBuffer)->remove(iter_sel_start, iter_sel_end);
+    }
 
     for (int offset = sel_start_offset; offset < sel_end_offset; ++offset) {
         Gtk::TextIter it_sel_start = pTextBuffer->get_iter_at_offset(offset);
@@ -463,6 +466,10 @@ void CtActions::apply_tag(const Glib::ustring& tag_property,
             }
         }
     }
+    if (tag_property == CtConst::TAG_LINK) {
+        CtLinkTable::get(text_buffer)->remove(text_buffer->get_iter_at_offset(sel_start_offset),
+                                              text_buffer->get_iter_at_offset(sel_end_offset));
+    }
     // avoid adding invalid color
     if (tag_property == CtConst::TAG_FOREGROUND or tag_property == CtConst::TAG_BACKGROUND) {
         if (property_value == "-") {
@@ -471,9 +478,17 @@ void CtActions::apply_tag(const Glib::ustring& tag_property,
     }
 
     if (not property_value.empty()) {
-        text_buffer->apply_tag_by_name(_pCtMainWin->get_text_tag_name_exist_or_create(tag_property, property_value),
-                                       text_buffer->get_iter_at_offset(sel_start_offset),
-                                       text_buffer->get_iter_at_offset(sel_end_offset));
+        if (tag_property == CtConst::TAG_LINK) {
+            _pCtMainWin->apply_link(text_buffer,
+                                    text_buffer->get_iter_at_offset(sel_start_offset),
+                                    text_buffer->get_iter_at_offset(sel_end_offset),
+                                    property_value);
+        }
+        else {
+            text_buffer->apply_tag_by_name(_pCtMainWin->get_text_tag_name_exist_or_create(tag_property, property_value),
+                                           text_buffer->get_iter_at_offset(sel_start_offset),
+                                           text_buffer->get_iter_at_offset(sel_end_offset));
+        }
     }
 
     if (restore_cursor_offset != -1) { // remove auto selection and restore cursor placement
@@ -30,15 +30,6 @@
 #include "ct_logging.h"
 #include <optional>
 
-// GtkSourceView 5 removed begin/end_not_undoable_action
-#if GTK_SOURCE_CHECK_VERSION(5, 0, 0)
-#define CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(buf) /* no-op */
-#define CT_SOURCE_BUFFER_END_NOT_UNDOABLE(buf)   /* no-op */
-#else
-#define CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(buf) gtk_source_buffer_begin_not_undoable_action(buf)
-#define CT_SOURCE_BUFFER_END_NOT_UNDOABLE(buf)   gtk_source_buffer_end_not_undoable_action(buf)
-#endif
-
 static std::optional<Gtk::TreeModel::iterator> select_parent_dialog(CtMainWin* pCtMainWin)
 {
     #if GTKMM_MAJOR_VERSION >= 4
@@ -302,7 +293,12 @@ void CtActions::_import_from_dir(CtImporterInterface* importer, const std::strin
         _pCtConfig->pickDirImport = import_dir;
     }
     try {
-        auto dir_node = CtImports::traverse_dir(import_dir, importer);
+        _status_bar_progress_start();
+        std::unique_ptr<CtImportedNode> dir_node;
+        {
+            auto on_scope_exit = scope_guard([this](void*) { _status_bar_progress_end(); });
+            dir_node = CtImports::traverse_dir(import_dir, importer, [this](const double fraction){ return _status_bar_progress(fraction); });
+        }
         _create_imported_nodes(dir_node.get());
     }
     catch (std::exception& ex) {
@@ -350,21 +346,19 @@ void CtActions::_create_imported_nodes(CtImportedNode* imported_nodes, const boo
         node_data.tsCreation = std::time(nullptr);
         node_data.tsLastSave = node_data.tsCreation;
         node_data.sequence = -1;
+        std::string xml_content;
         if (imported_node->has_content()) {
-            Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = _pCtMainWin->get_new_text_buffer();
-            #if GTKMM_MAJOR_VERSION < 4
-            auto pGtkSourceBuffer = GTK_SOURCE_BUFFER(pTextBuffer->gobj());
-            #endif
-            CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(pGtkSourceBuffer);
+            // the buffer is built from the xml when the node is first needed, the document is dropped right away
+            CtLinkIndex::NodeData link_index_node_data;
             for (xmlpp::Node* xml_slot : imported_node->xml_content->get_root_node()->get_children("slot")) {
-                for (xmlpp::Node* child: xml_slot->get_children()) {
-                    Gtk::TextIter insert_iter = pTextBuffer->get_insert()->get_iter();
-                    CtStorageXmlHelper{_pCtMainWin}.get_text_buffer_one_slot_from_xml(pTextBuffer, child, node_data.anchoredWidgets, &insert_iter, -1, "");
+                if (auto slot_element = dynamic_cast<const xmlpp::Element*>(xml_slot)) {
+                    CtStorageXmlHelper::link_index_node_from_xml(slot_element, link_index_node_data);
                 }
             }
-            CT_SOURCE_BUFFER_END_NOT_UNDOABLE(pGtkSourceBuffer);
-            pTextBuffer->set_modified(false);
-            node_data.pTextBuffer = pTextBuffer;
+            ct_treestore.link_index_set_node(imported_node->node_id, std::move(link_index_node_data));
+            xml_content = imported_node->xml_content->write_to_string();
+            imported_node->content_broken_links.clear();
+            imported_node->xml_content.reset();
         }
         else {
             node_data.pTextBuffer = _pCtMainWin->get_new_text_buffer();
@@ -378,6 +372,9 @@ void CtActions::_create_imported_nodes(CtImportedNode* imported_nodes, const boo
         else
             node_iter = ct_treestore.append_node(&node_data);
 
+        if (not node_data.pTextBuffer) {
+            ct_treestore.imported_content_set(node_data.nodeId, std::move(xml_content));
+        }
         CtTreeIter ct_tree_iter = ct_treestore.to_ct_tree_iter(node_iter);
         ct_tree_iter.pending_new_db_node();
         ct_treestore.update_node_aux_icon(ct_tree_iter);
@@ -396,12 +393,16 @@ void CtActions::_create_imported_nodes(CtImportedNode* imported_nodes, const boo
     if (not parent_iter.has_value()) {
         return;
     }
-    if (not dummy_root and imported_nodes->has_content()) {
-        f_create_nodes(parent_iter.value(), imported_nodes);
-    }
-    else { // skip top if it's dir
-        for (auto& child : imported_nodes->children) {
-            f_create_nodes(parent_iter.value(), child.get());
+    {
+        ct_treestore.bulk_population_begin();
+        auto on_scope_exit = scope_guard([&ct_treestore](void*) { ct_treestore.bulk_population_end(); });
+        if (not dummy_root and imported_nodes->has_content()) {
+            f_create_nodes(parent_iter.value(), imported_nodes);
+        }
+        else { // skip top if it's dir
+            for (auto& child : imported_nodes->children) {
+                f_create_nodes(parent_iter.value(), child.get());
+            }
         }
     }
 
@@ -168,19 +168,19 @@ void CtActions::embfile_save()
 
     _pCtConfig->pickDirFile = Glib::path_get_dirname(filepath);
 
-    if (curr_file_anchor->get_raw_blob().empty()) {
+    if (curr_file_anchor->get_blob()->empty()) {
         const fs::path& embfilePathLast = curr_file_anchor->get_pathLastMultiFile();
         if (fs::exists(embfilePathLast) and fs::copy_file(embfilePathLast, filepath.c_str())) {
             return;
         }
     }
 
-    g_file_set_contents(filepath.c_str(), curr_file_anchor->get_raw_blob().c_str(), (gssize)curr_file_anchor->get_raw_blob().size(), nullptr);
+    curr_file_anchor->get_blob()->write_to_file(filepath);
 }
 
 void CtActions::embfile_open()
 {
-    if (curr_file_anchor->get_raw_blob().empty()) {
+    if (curr_file_anchor->get_blob()->empty()) {
         const fs::path& embfilePathLast = curr_file_anchor->get_pathLastMultiFile();
         if (fs::exists(embfilePathLast)) {
             fs::open_filepath(embfilePathLast, false/*open_folder_if_file_not_exists*/, _pCtConfig);
@@ -188,32 +188,7 @@ void CtActions::embfile_open()
         }
     }
 
-    const size_t open_id = curr_file_anchor->get_unique_id();
-    auto mapIter = _embfiles_opened.find(open_id);
-    fs::path tmp_filepath;
-    if (mapIter == _embfiles_opened.end()) {
-        // the file was not opened yet
-        const fs::path filename = std::to_string(_pCtMainWin->curr_tree_iter().get_node_id_data_holder()) +
-                                                 CtConst::CHAR_MINUS + std::to_string(open_id) +
-                                                 CtConst::CHAR_MINUS + std::to_string(getpid())+
-                                                 CtConst::CHAR_MINUS + curr_file_anchor->get_file_name().string();
-        tmp_filepath = _pCtMainWin->get_ct_tmp()->getHiddenFilePath(filename);
-        _embfiles_opened[open_id] = CtEmbFileOpened{
-            .tmp_filepath = tmp_filepath,
-            .mod_time = 0};
-        mapIter = _embfiles_opened.find(open_id);
-    }
-    else {
-        tmp_filepath = mapIter->second.tmp_filepath;
-    }
-
-    g_file_set_contents(tmp_filepath.c_str(), curr_file_anchor->get_raw_blob().c_str(), (gssize)curr_file_anchor->get_raw_blob().size(), nullptr);
-    fs::open_filepath(tmp_filepath.c_str(), false, _pCtConfig);
-    mapIter->second.mod_time = fs::getmtime(tmp_filepath);
-
-    if (not _embfiles_timeout_connection) {
-        _embfiles_timeout_connection = Glib::signal_timeout().connect(sigc::mem_fun(*this, &CtActions::_on_embfiles_sentinel_timeout), 500);
-    }
+    _embFilesSync.open(curr_file_anchor, _pCtMainWin->curr_tree_iter().get_node_id_data_holder());
 }
 
 void CtActions::embfile_rename()
@@ -982,14 +957,47 @@ void CtActions::table_export()
     if (!str::endswith(filename, ".csv")) filename += ".csv";
     _pCtConfig->pickDirCsv = Glib::path_get_dirname(filename.raw());
 
+    _status_bar_progress_start();
     try {
-        std::string result = curr_table_anchor->to_csv();
-        Glib::file_set_contents(filename, result);
+        if (not curr_table_anchor->to_csv_file(filename.raw(), [this](const double fraction){ return _status_bar_progress(fraction); })) {
+            spdlog::debug("{} stopped", __FUNCTION__);
+        }
     }
     catch (std::exception& e) {
         spdlog::error("Exception caught while exporting table: {}", e.what());
         CtDialogs::error_dialog("Exception occured while exporting table, see log for details", *_pCtMainWin);
     }
+    _status_bar_progress_end();
+}
+
+void CtActions::_status_bar_progress_start()
+{
+    CtStatusBar& ctStatusBar = _pCtMainWin->get_status_bar();
+    ctStatusBar.progressBar.set_fraction(0);
+    ctStatusBar.progressBar.set_text("");
+    ctStatusBar.progressBar.show();
+    ctStatusBar.stopButton.show();
+    ctStatusBar.set_progress_stop(false);
+}
+
+bool CtActions::_status_bar_progress(const double fraction)
+{
+    CtStatusBar& ctStatusBar = _pCtMainWin->get_status_bar();
+    ctStatusBar.progressBar.set_fraction(fraction);
+    #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
+    while (gtk_events_pending()) gtk_main_iteration();
+    #else
+    while (g_main_context_pending(nullptr)) g_main_context_iteration(nullptr, false);
+    #endif
+    return not ctStatusBar.is_progress_stop();
+}
+
+void CtActions::_status_bar_progress_end()
+{
+    CtStatusBar& ctStatusBar = _pCtMainWin->get_status_bar();
+    ctStatusBar.progressBar.hide();
+    ctStatusBar.stopButton.hide();
+    ctStatusBar.set_progress_stop(false);
 }
 
 void CtActions::_anchor_edit_dialog(CtImageAnchor* anchor, Gtk::TextIter insert_iter, Gtk::TextIter* iter_bound)
@@ -1014,49 +1022,6 @@ void CtActions::_anchor_edit_dialog(CtImageAnchor* anchor, Gtk::TextIter insert_
     image_insert_anchor(insert_iter, ret_anchor_name, expCollState, image_justification);
 }
 
-bool CtActions::_on_embfiles_sentinel_timeout()
-{
-    for (auto& item : _embfiles_opened) {
-        const fs::path& tmp_filepath = item.second.tmp_filepath;
-        if (not fs::is_regular_file(tmp_filepath)) {
-            spdlog::debug("embdrop {}", tmp_filepath.string());
-            _embfiles_opened.erase(item.first);
-            break;
-        }
-        if (item.second.mod_time != fs::getmtime(tmp_filepath)) {
-            item.second.mod_time = fs::getmtime(tmp_filepath);
-            const auto data_vec = str::split(tmp_filepath.filename().string(), "-");
-            const gint64 node_id = std::stoll(data_vec[0]);
-            const size_t embfile_id = std::stol(data_vec[1]);
-
-            CtTreeIter tree_iter = _pCtMainWin->get_tree_store().get_node_from_node_id(node_id);
-            if (not tree_iter) {
-                continue;
-            }
-            if (tree_iter.get_node_read_only()) {
-                CtDialogs::warning_dialog(_("Cannot Edit Embedded File in Read Only Node."), *_pCtMainWin);
-                continue;
-            }
-            _pCtMainWin->get_tree_view().set_cursor_safe(tree_iter);
-            for (auto& widget : tree_iter.get_anchored_widgets_fast()) {
-                if (auto embFile = dynamic_cast<CtImageEmbFile*>(widget)) {
-                    if (embFile->get_unique_id() == embfile_id) {
-                        std::string buffer = Glib::file_get_contents(tmp_filepath.string());
-                        embFile->set_raw_blob(buffer);
-                        embFile->set_time(std::time(nullptr));
-                        embFile->update_tooltip();
-
-                        _pCtMainWin->update_window_save_needed(CtSaveNeededUpdType::nbuf);
-                        _pCtMainWin->get_status_bar().update_status(_("Embedded File Automatically Updated:") + CtConst::CHAR_SPACE + embFile->get_file_name().string());
-                        break;
-                    }
-                }
-            }
-        }
-    }
-    return true; // this way we keep the timer alive
-}
-
 void CtActions::terminal_copy()
 {
 #if defined(HAVE_VTE)
@@ -27,6 +27,7 @@
 #include "ct_dialogs.h"
 #include "ct_clipboard.h"
 #include "ct_treestore.h"
+#include "ct_storage_control.h"
 #include "ct_logging.h"
 #include <ctime>
 #include <gtkmm/dialog.h>
@@ -191,31 +192,28 @@ void CtActions::node_subnodes_paste2(CtTreeIter& other_ct_tree_iter,
     _node_add(CtDuplicateShared::Duplicate, false/*add_as_child*/, &other_ct_tree_iter, pWinToCopyFrom);
 
     Gtk::TreeModel::iterator new_top_iter = _pCtMainWin->curr_tree_iter();
+    CtTreeStore& ct_treestore = _pCtMainWin->get_tree_store();
 
-    // function to duplicate a node
+    // function to duplicate a node, its buffer is only built when first needed
     auto duplicate_subnode = [&](CtTreeIter old_iter, Gtk::TreeModel::iterator new_parent) {
         CtNodeData node_data{};
-        std::shared_ptr<CtNodeState> node_state;
-        pWinToCopyFrom->get_tree_store().get_node_data(old_iter, node_data, true/*loadTextBuffer*/);
-        if (node_data.syntax != CtConst::RICH_TEXT_ID) {
-            node_data.pTextBuffer = _pCtMainWin->get_new_text_buffer(node_data.pTextBuffer->get_text());
-            node_data.anchoredWidgets.clear();
-        }
-        else {
-            CtStateMachine& state_machine_from = pWinToCopyFrom->get_state_machine();
-            state_machine_from.update_state(old_iter);
-            node_state = state_machine_from.requested_state_current(old_iter.get_node_id_data_holder());
-            node_data.anchoredWidgets.clear();                          // node_state will be used instead
-            node_data.pTextBuffer = _pCtMainWin->get_new_text_buffer(); // node_state will be used instead
+        pWinToCopyFrom->get_tree_store().get_node_data(old_iter, node_data, false/*loadTextBuffer*/);
+        std::string lazy_content;
+        if (node_data.sharedNodesMasterId <= 0) {
+            lazy_content = _node_content_to_duplicate(pWinToCopyFrom, old_iter);
+            if (lazy_content.empty()) {
+                node_data.pTextBuffer = _pCtMainWin->get_new_text_buffer();
+            }
         }
         node_data.tsCreation = std::time(nullptr);
         node_data.tsLastSave = node_data.tsCreation;
-        node_data.nodeId = _pCtMainWin->get_tree_store().node_id_get();
-        auto new_iter = _pCtMainWin->get_tree_store().append_node(&node_data, &new_parent/*as parent*/);
-        if (node_state) {
-           _pCtMainWin->load_buffer_from_state(node_state, _pCtMainWin->get_tree_store().to_ct_tree_iter(new_iter));
+        node_data.nodeId = ct_treestore.node_id_get();
+        auto new_iter = ct_treestore.append_node(&node_data, &new_parent/*as parent*/);
+        if (not lazy_content.empty()) {
+            ct_treestore.imported_content_set(node_data.nodeId, std::move(lazy_content));
+            _node_link_index_duplicate(pWinToCopyFrom, old_iter.get_node_id_data_holder(), node_data.nodeId);
         }
-        _pCtMainWin->get_tree_store().to_ct_tree_iter(new_iter).pending_new_db_node();
+        ct_treestore.to_ct_tree_iter(new_iter).pending_new_db_node();
         return new_iter;
     };
 
@@ -234,9 +232,13 @@ void CtActions::node_subnodes_paste2(CtTreeIter& other_ct_tree_iter,
         }
         #endif
     };
-    duplicate_subnodes(other_ct_tree_iter, new_top_iter);
+    {
+        ct_treestore.bulk_population_begin();
+        auto on_scope_exit = scope_guard([&ct_treestore](void*) { ct_treestore.bulk_population_end(); });
+        duplicate_subnodes(other_ct_tree_iter, new_top_iter);
+    }
 
-    _pCtMainWin->get_tree_store().nodes_sequences_fix(new_top_iter->parent(), true);
+    ct_treestore.nodes_sequences_fix(new_top_iter->parent(), true);
     pWinToCopyFrom->get_tree_view().set_cursor_safe(other_ct_tree_iter); // this line fixes glich with text_buffer with widgets caused by the next line
     _pCtMainWin->get_tree_view().set_cursor_safe(new_top_iter);
     _pCtMainWin->get_text_view().mm().grab_focus();
@@ -253,35 +255,78 @@ void CtActions::node_subnodes_duplicate()
     node_subnodes_paste2(top_iter, _pCtMainWin);
 }
 
+std::string CtActions::_node_content_to_duplicate(CtMainWin* pWinFrom, const CtTreeIter& ctTreeIterFrom)
+{
+    CtTreeStore& ct_treestore_from = pWinFrom->get_tree_store();
+    const gint64 nodeIdFrom = ctTreeIterFrom.get_node_id_data_holder();
+    CtTreeIter dataHolderIter = ct_treestore_from.get_node_from_node_id(nodeIdFrom);
+    if (not dataHolderIter) {
+        spdlog::error("!! {} node {}", __FUNCTION__, nodeIdFrom);
+        return std::string{};
+    }
+    // imported or duplicated itself and not yet built
+    if (const std::string* pImportedContent = ct_treestore_from.imported_content_get(nodeIdFrom)) {
+        return *pImportedContent;
+    }
+    const bool isRichText = dataHolderIter.get_node_is_rich_text();
+    auto f_plain_text_to_xml = [](const Glib::ustring& text)->std::string{
+        xmlpp::Document xml_doc;
+        xml_doc.create_root_node("root")->add_child("slot")->add_child("rich_text")->add_child_text(text);
+        return xml_doc.write_to_string().raw();
+    };
+    const bool wasLoaded = dataHolderIter.get_node_buffer_already_loaded();
+    CtStorageControl* pCtStorageFrom = pWinFrom->get_ct_storage();
+    if (not pCtStorageFrom->get_file_path().empty() and
+        (not wasLoaded or not dataHolderIter.get_node_text_buffer()->get_modified()) and
+        0 == pCtStorageFrom->get_storage_sync_pending()->nodes_to_write_dict.count(nodeIdFrom))
+    {
+        // the storage has the current content, as is if without widgets
+        std::string rawText;
+        bool hasWidgets{true};
+        if (pCtStorageFrom->get_delayed_text_raw(nodeIdFrom, rawText, &hasWidgets) and not hasWidgets) {
+            return rawText.empty() or isRichText ? rawText : f_plain_text_to_xml(rawText);
+        }
+    }
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = dataHolderIter.get_node_text_buffer();
+    std::string content;
+    if (pTextBuffer->get_char_count() > 0) {
+        content = isRichText ? CtClipboard{pWinFrom}.rich_text_get_from_text_buffer_selection(dataHolderIter, pTextBuffer, pTextBuffer->begin(), pTextBuffer->end()).raw()
+                             : f_plain_text_to_xml(pTextBuffer->get_text());
+    }
+    if (not wasLoaded) {
+        // loaded only to be copied
+        (void)ct_treestore_from.unload_text_buffer(dataHolderIter);
+    }
+    return content;
+}
+
+void CtActions::_node_link_index_duplicate(CtMainWin* pWinFrom, const gint64 nodeIdDataHolderFrom, const gint64 newNodeId)
+{
+    if (const CtLinkIndex::NodeData* pNodeData = pWinFrom->get_tree_store().get_link_index().get_node(nodeIdDataHolderFrom)) {
+        _pCtMainWin->get_tree_store().link_index_set_node(newNodeId, *pNodeData);
+    }
+}
+
 void CtActions::_node_add(const CtDuplicateShared duplicate_shared,
                           const bool add_as_child,
                           const CtTreeIter* pCtTreeIterFrom/*=nullptr*/,
                           CtMainWin* pWinToCopyFrom/*=nullptr*/)
 {
     CtNodeData nodeData{};
-    std::shared_ptr<CtNodeState> node_state;
+    std::string lazyContent;
     if (CtDuplicateShared::None == duplicate_shared) {
         std::string title = add_as_child ? _("New Child Node Properties") : _("New Node Properties");
         CtTreeIter currTreeIter = _pCtMainWin->curr_tree_iter();
         nodeData.syntax = currTreeIter ? currTreeIter.get_node_syntax_highlighting() : CtConst::RICH_TEXT_ID;
-        if (not CtDialogs::node_prop_dialog(title, _pCtMainWin, nodeData, _pCtMainWin->get_tree_store().get_used_tags())) {
+        if (not CtDialogs::node_prop_dialog(title, _pCtMainWin, nodeData, _pCtMainWin->get_tree_store().get_tag_index())) {
             return;
         }
     }
     else {
-        pWinToCopyFrom->get_tree_store().get_node_data(*pCtTreeIterFrom, nodeData, true/*loadTextBuffer*/);
+        // the duplicate gets a copy of the content, not the buffer
+        pWinToCopyFrom->get_tree_store().get_node_data(*pCtTreeIterFrom, nodeData, CtDuplicateShared::Shared == duplicate_shared/*loadTextBuffer*/);
         if (CtDuplicateShared::Duplicate == duplicate_shared) {
-            if (CtConst::RICH_TEXT_ID != nodeData.syntax) {
-                nodeData.pTextBuffer = _pCtMainWin->get_new_text_buffer(nodeData.pTextBuffer->get_text());
-                nodeData.anchoredWidgets.clear();
-            }
-            else {
-                CtStateMachine& state_machine_from = pWinToCopyFrom->get_state_machine();
-                state_machine_from.update_state(*pCtTreeIterFrom);
-                node_state = state_machine_from.requested_state_current(pCtTreeIterFrom->get_node_id_data_holder());
-                nodeData.anchoredWidgets.clear();                          // node_state will be used instead
-                nodeData.pTextBuffer = _pCtMainWin->get_new_text_buffer(); // node_state will be used instead
-            }
+            lazyContent = _node_content_to_duplicate(pWinToCopyFrom, *pCtTreeIterFrom);
             nodeData.sharedNodesMasterId = 0;
         }
         else {
@@ -295,17 +340,20 @@ void CtActions::_node_add(const CtDuplicateShared duplicate_shared,
             }
         }
     }
-    (void)_node_add_with_data(_pCtMainWin->curr_tree_iter(), nodeData, add_as_child, node_state);
+    (void)_node_add_with_data(_pCtMainWin->curr_tree_iter(), nodeData, add_as_child, std::move(lazyContent));
+    if (CtDuplicateShared::Duplicate == duplicate_shared) {
+        _node_link_index_duplicate(pWinToCopyFrom, pCtTreeIterFrom->get_node_id_data_holder(), nodeData.nodeId);
+    }
 }
 
 Gtk::TreeModel::iterator CtActions::_node_add_with_data(Gtk::TreeModel::iterator curr_iter,
                                              CtNodeData& nodeData,
                                              const bool add_as_child,
-                                             std::shared_ptr<CtNodeState> node_state)
+                                             std::string&& lazyContent)
 {
     if (nodeData.sharedNodesMasterId <= 0) {
         // not a shared node
-        if (not nodeData.pTextBuffer) {
+        if (not nodeData.pTextBuffer and lazyContent.empty()) {
             nodeData.pTextBuffer = _pCtMainWin->get_new_text_buffer();
         }
         nodeData.tsCreation = std::time(nullptr);
@@ -328,8 +376,9 @@ Gtk::TreeModel::iterator CtActions::_node_add_with_data(Gtk::TreeModel::iterator
         nodeIter = ct_treestore.append_node(&nodeData);
     }
     CtTreeIter nodeCtIter = ct_treestore.to_ct_tree_iter(nodeIter);
-    if (node_state) {
-        _pCtMainWin->load_buffer_from_state(node_state, nodeCtIter);
+    if (not lazyContent.empty()) {
+        // built from the content when selected below
+        ct_treestore.imported_content_set(nodeData.nodeId, std::move(lazyContent));
     }
     nodeCtIter.pending_new_db_node();
     ct_treestore.nodes_sequences_fix(nodeIter->parent(), false);
@@ -358,7 +407,7 @@ Gtk::TreeModel::iterator CtActions::node_child_exist_or_create(Gtk::TreeModel::i
     CtNodeData nodeData{};
     nodeData.name = nodeName;
     nodeData.syntax = CtConst::RICH_TEXT_ID;
-    return _node_add_with_data(parentIter, nodeData, true/*add_as_child*/, nullptr/*node_state*/);
+    return _node_add_with_data(parentIter, nodeData, true/*add_as_child*/, std::string{}/*lazyContent*/);
 }
 
 // Move a node to a parent and after a sibling
@@ -464,7 +513,7 @@ void CtActions::node_edit()
     CtTreeStore& ct_treestore = _pCtMainWin->get_tree_store();
     ct_treestore.get_node_data(ct_tree_iter, nodeData, true/*loadTextBuffer*/);
     CtNodeData newData = nodeData;
-    if (not CtDialogs::node_prop_dialog(_("Node Properties"), _pCtMainWin, newData, ct_treestore.get_used_tags())) {
+    if (not CtDialogs::node_prop_dialog(_("Node Properties"), _pCtMainWin, newData, ct_treestore.get_tag_index())) {
         return;
     }
 
@@ -495,8 +544,8 @@ void CtActions::node_edit()
             _pCtMainWin->switch_buffer_text_source(ct_tree_iter.get_node_text_buffer(), ct_tree_iter, newData.syntax, nodeData.syntax);
         }
 
-        // from RICH to text
-        if (CtConst::RICH_TEXT_ID == nodeData.syntax) {
+        // from RICH to text, or from text to RICH (the states of a text node hold no text)
+        if (CtConst::RICH_TEXT_ID == nodeData.syntax or CtConst::RICH_TEXT_ID == newData.syntax) {
             _pCtMainWin->get_state_machine().delete_states(ct_tree_iter.get_node_id_data_holder());
             _pCtMainWin->get_state_machine().update_state(ct_tree_iter);
         }
@@ -752,6 +801,7 @@ void CtActions::node_toggle_read_only()
                     CtTreeIter other_ct_tree_iter = ct_treestore.get_node_from_node_id(nodeId);
                     if (other_ct_tree_iter) {
                         other_ct_tree_iter->set_value(ct_treestore.get_columns().colNodeIsReadOnly, node_is_ro);
+                        ct_treestore.row_cache_reload(other_ct_tree_iter);
                         ct_treestore.update_node_aux_icon(other_ct_tree_iter);
                     }
                 }
@@ -1082,6 +1132,43 @@ void CtActions::tree_info()
     }
 }
 
+void CtActions::tree_broken_links()
+{
+    if (not _is_tree_not_empty_or_error()) return;
+    CtTreeStore& ctTreeStore = _pCtMainWin->get_tree_store();
+    const std::vector<CtLinkIndex::BrokenLink> brokenLinks = ctTreeStore.link_index_get_broken_links();
+    if (brokenLinks.empty()) {
+        CtDialogs::info_dialog(_("No Broken Links Found"), *_pCtMainWin);
+        return;
+    }
+    auto itemStore = CtChooseDialogListStore::create();
+    for (const CtLinkIndex::BrokenLink& brokenLink : brokenLinks) {
+        CtTreeIter referrerIter = ctTreeStore.get_node_from_node_id(brokenLink.referrerId);
+        Glib::ustring desc = CtMiscUtil::get_node_hierarchical_name(referrerIter, " / ", false/*for_filename*/) + "  ->  ";
+        if (brokenLink.missingNode) {
+            desc += str::format(_("Missing Node (Id = %s)"), std::to_string(brokenLink.target.nodeId));
+        }
+        else {
+            desc += ctTreeStore.get_node_from_node_id(brokenLink.target.nodeId).get_node_name() + "#" + brokenLink.target.anchor;
+            desc += " (" + Glib::ustring{_("Anchor Not Found")} + ")";
+        }
+        itemStore->add_row(brokenLink.missingNode ? "ct_warning" : "ct_anchor", ""/*key*/, desc, brokenLink.referrerId);
+    }
+    const Gtk::TreeModel::iterator treeIter = CtDialogs::choose_item_dialog(*_pCtMainWin, _("Broken Links"), itemStore);
+    if (treeIter) {
+        CtTreeIter referrerIter = ctTreeStore.get_node_from_node_id(treeIter->get_value(itemStore->columns.node_id));
+        if (referrerIter) {
+            _pCtMainWin->get_tree_view().set_cursor_safe(referrerIter);
+        }
+    }
+}
+
+void CtActions::tree_memory_usage()
+{
+    if (not _is_tree_not_empty_or_error()) return;
+    CtDialogs::memory_usage_dialog(_pCtMainWin);
+}
+
 void CtActions::tree_clear_property_exclude_from_search()
 {
     if (_in_action) { spdlog::debug("?? 2*{}", __FUNCTION__); return; }
@@ -1101,3 +1188,39 @@ void CtActions::node_link_to_clipboard()
     if (not _is_there_selected_node_or_error()) return;
     CtClipboard(_pCtMainWin).node_link_to_clipboard(_pCtMainWin->curr_tree_iter());
 }
+
+void CtActions::node_backlinks()
+{
+    if (not _is_there_selected_node_or_error()) return;
+    const std::vector<gint64> referrers = _pCtMainWin->get_tree_store().link_index_get_referrers(_pCtMainWin->curr_tree_iter().get_node_id());
+    if (referrers.empty()) {
+        CtDialogs::info_dialog(_("No Node Links to the Selected Node"), *_pCtMainWin);
+        return;
+    }
+    _nodes_choose_and_select(_("Node Backlinks"), referrers);
+}
+
+void CtActions::_nodes_choose_and_select(const Glib::ustring& title, const std::vector<gint64>& nodeIds)
+{
+    CtTreeStore& ctTreeStore = _pCtMainWin->get_tree_store();
+    auto itemStore = CtChooseDialogListStore::create();
+    for (const gint64 nodeId : nodeIds) {
+        CtTreeIter ctTreeIter = ctTreeStore.get_node_from_node_id(nodeId);
+        if (not ctTreeIter) {
+            continue;
+        }
+        itemStore->add_row(ctTreeStore.get_node_icon(ctTreeStore.get_store()->iter_depth(ctTreeIter),
+                                                     ctTreeIter.get_node_syntax_highlighting(),
+                                                     ctTreeIter.get_node_custom_icon_id()),
+                           ""/*key*/,
+                           CtMiscUtil::get_node_hierarchical_name(ctTreeIter, " / ", false/*for_filename*/),
+                           nodeId);
+    }
+    const Gtk::TreeModel::iterator treeIter = CtDialogs::choose_item_dialog(*_pCtMainWin, title, itemStore);
+    if (treeIter) {
+        CtTreeIter ctTreeIter = ctTreeStore.get_node_from_node_id(treeIter->get_value(itemStore->columns.node_id));
+        if (ctTreeIter) {
+            _pCtMainWin->get_tree_view().set_cursor_safe(ctTreeIter);
+        }
+    }
+}
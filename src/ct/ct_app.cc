@@ -271,7 +271,7 @@ void CtApp::on_activate()
                 if (not pAppWindow->start_on_systray_is_active())
 #endif /* GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED) */
                 {
-                    if (not pAppWindow->file_open(canonicalPath, ""/*node*/, ""/*anchor*/, _password)) {
+                    if (CtFileOpenResult::Failed == pAppWindow->file_open(canonicalPath, ""/*node*/, ""/*anchor*/, _password)) {
                         spdlog::warn("{} Couldn't open file: {}", __FUNCTION__, canonicalPath);
                     }
                 }
@@ -347,7 +347,7 @@ void CtApp::on_open(const Gio::Application::type_vec_files& files, const Glib::u
             spdlog::debug("file to export: {}", r_file->get_path());
             CtMainWin* pWin = _create_window(true/*no_gui*/);
             const std::string canonicalPath = fs::canonical(r_file->get_path()).string();
-            if (pWin->file_open(canonicalPath, ""/*node*/, ""/*anchor*/, _password)) {
+            if (CtFileOpenResult::Opened == pWin->file_open(canonicalPath, ""/*node*/, ""/*anchor*/, _password)) {
                 try {
                     if (not _export_to_txt_dir.empty()) {
                         pWin->get_ct_actions()->export_to_txt_auto(_export_to_txt_dir, _export_overwrite, _export_single_file);
@@ -362,6 +362,7 @@ void CtApp::on_open(const Gio::Application::type_vec_files& files, const Glib::u
                 catch (std::exception& e) {
                     spdlog::error("caught exception: {}", e.what());
                 }
+                _print_memory_report(pWin);
             }
             pWin->force_exit() = true;
             remove_window(*pWin);
@@ -382,7 +383,14 @@ void CtApp::on_open(const Gio::Application::type_vec_files& files, const Glib::u
             if (not pAppWindow->start_on_systray_is_active())
 #endif /* GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED) */
             {
-                if (not pAppWindow->file_open(canonicalPath, _node_to_focus, _anchor_to_focus, _password)) {
+                const CtFileOpenResult openResult = pAppWindow->file_open(canonicalPath, _node_to_focus, _anchor_to_focus, _password);
+                if (CtFileOpenResult::OpenedElsewhere == openResult) {
+                    // the window just created is not needed, the one with the document was shown
+                    pAppWindow->force_exit() = true;
+                    remove_window(*pAppWindow);
+                    continue;
+                }
+                if (CtFileOpenResult::Failed == openResult) {
                     spdlog::warn("{} Couldn't open file: {}", __FUNCTION__, canonicalPath);
                 }
             }
@@ -524,6 +532,7 @@ bool CtApp::_quit_or_hide_window(CtMainWin* pCtMainWin, const bool from_delete,
         // It's too dangerous to try and save the document while being killed
     }
 
+    _print_memory_report(pCtMainWin);
     pCtMainWin->force_exit() = true; // this is for on_window_removed
     if (not from_delete) {           // signal from remove, no need to remove again
         remove_window(*pCtMainWin);  // object will be destroyed in on_window_removed
@@ -531,6 +540,20 @@ bool CtApp::_quit_or_hide_window(CtMainWin* pCtMainWin, const bool from_delete,
     return true; // keep deleting window
 }
 
+void CtApp::_print_memory_report(CtMainWin* pCtMainWin)
+{
+    if (not _memory_report or pCtMainWin->get_ct_storage()->get_file_path().empty()) {
+        return;
+    }
+    CtMemoryUsage memoryUsage;
+    pCtMainWin->memory_usage_populate(memoryUsage);
+    CtTreeStore& ctTreeStore = pCtMainWin->get_tree_store();
+    std::cout << pCtMainWin->get_ct_storage()->get_file_path().string() << std::endl
+              << memoryUsage.get_report([&ctTreeStore](const gint64 nodeId){
+                     return ctTreeStore.get_node_name_from_node_id(nodeId);
+                 }, 20u/*max_nodes*/) << std::endl;
+}
+
 #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
 void CtApp::systray_show_hide_windows()
 {
@@ -619,6 +642,7 @@ void CtApp::_add_main_option_entries()
     add_main_option_entry(Gio::Application::OptionType::STRING,   "password",           'P', _("Password to open document"));
     add_main_option_entry(Gio::Application::OptionType::BOOL,     "new_window",         'N', _("Create a new window"));
     add_main_option_entry(Gio::Application::OptionType::BOOL,     "secondary_session",  'S', _("Run in secondary session, independent from main session"));
+    add_main_option_entry(Gio::Application::OptionType::BOOL,     "memory_report",      'M', _("Print the approximate memory used by the nodes when a document is closed"));
 #else
     add_main_option_entry(Gio::Application::OPTION_TYPE_BOOL,     "version",            'V', _("Print CherryTree version"));
     add_main_option_entry(Gio::Application::OPTION_TYPE_STRING,   "node",               'n', _("Node name to focus"));
@@ -631,6 +655,7 @@ void CtApp::_add_main_option_entries()
     add_main_option_entry(Gio::Application::OPTION_TYPE_STRING,   "password",           'P', _("Password to open document"));
     add_main_option_entry(Gio::Application::OPTION_TYPE_BOOL,     "new_window",         'N', _("Create a new window"));
     add_main_option_entry(Gio::Application::OPTION_TYPE_BOOL,     "secondary_session",  'S', _("Run in secondary session, independent from main session"));
+    add_main_option_entry(Gio::Application::OPTION_TYPE_BOOL,     "memory_report",      'M', _("Print the approximate memory used by the nodes when a document is closed"));
 #endif
 }
 
@@ -674,6 +699,7 @@ int CtApp::_on_handle_local_options(const Glib::RefPtr<Glib::VariantDict>& rOpti
     rOptions->lookup_value("export_single_file", _export_single_file);
     rOptions->lookup_value("password", _password);
     rOptions->lookup_value("new_window", new_window);
+    rOptions->lookup_value("memory_report", _memory_report);
 
     if (is_remote() && (not _node_to_focus.empty() || not _anchor_to_focus.empty())) {
         // Forward node focus request from remote to primary instance via action
@@ -70,6 +70,7 @@ protected:
     Glib::ustring _password;
     bool          _export_overwrite{false};
     bool          _export_single_file{false};
+    bool          _memory_report{false};
     bool          _new_window{false};
     bool          _initDone{false};
     bool          _no_gui{false};
@@ -89,6 +90,7 @@ protected:
     CtMainWin*  _get_window_by_path(const std::string& filepath);
     bool        _quit_or_hide_window(CtMainWin* pCtMainWin, const bool fromDelete, const bool fromKillCallback);
     int         _on_handle_local_options(const Glib::RefPtr<Glib::VariantDict>& rOptions);
+    void        _print_memory_report(CtMainWin* pCtMainWin);
 
 private:
     Gtk::Window* _pWinToCopyFrom{nullptr};
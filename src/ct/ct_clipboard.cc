@@ -315,7 +315,10 @@ Glib::ustring CtClipboard::rich_text_get_from_text_buffer_selection(CtTreeIter n
     int iter_sel_end_offset = iter_sel_end.get_offset();
     if (exclude_iter_sel_end)
         iter_sel_end_offset -= 1;
-    std::list<CtAnchoredWidget*> widget_vector = node_iter.get_anchored_widgets(iter_sel_start_offset, iter_sel_end_offset);
+    std::list<CtAnchoredWidget*> widget_vector;
+    if (node_iter) {
+        widget_vector = node_iter.get_anchored_widgets(iter_sel_start_offset, iter_sel_end_offset);
+    }
 
     xmlpp::Document doc;
     auto root = doc.create_root_node("root");
@@ -455,37 +458,134 @@ void CtClipboard::_selection_to_clipboard(Glib::RefPtr<Gtk::TextBuffer> text_buf
         }
     }
 
+    const bool is_rich_text = not pCodebox and CtConst::RICH_TEXT_ID == node_syntax_high;
+    std::vector<std::string> targets_vector;
+    if (CtClipboard::_static_force_plain_text) {
+        targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT};
+    }
+    else if (is_rich_text) {
+        targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT, CtConst::TARGET_CTD_RICH_TEXT, CtConst::TARGETS_HTML[0], CtConst::TARGETS_HTML[1]};
+    }
+    else {
+        targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT, CtConst::TARGETS_HTML[0], CtConst::TARGETS_HTML[1]};
+    }
+
     CtClipboardData* clip_data = new CtClipboardData{};
-    clip_data->html_text = CtExport2Html{_pCtMainWin}.selection_export_to_html(text_buffer, iter_sel_start, iter_sel_end, !pCodebox ? node_syntax_high : CtConst::PLAIN_TEXT_ID);
-    if (not pCodebox and CtConst::RICH_TEXT_ID == node_syntax_high) {
-        std::vector<std::string> targets_vector;
-        clip_data->plain_text = CtExport2Txt{_pCtMainWin}.selection_export_to_txt(ct_tree_iter, text_buffer, iter_sel_start.get_offset(), iter_sel_end.get_offset(), true);
-        clip_data->rich_text = rich_text_get_from_text_buffer_selection(ct_tree_iter, text_buffer, iter_sel_start, iter_sel_end);
-        if (not CtClipboard::_static_force_plain_text) {
-            targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT, CtConst::TARGET_CTD_RICH_TEXT, CtConst::TARGETS_HTML[0], CtConst::TARGETS_HTML[1]};
-            if (pixbuf_target) {
-                clip_data->pix_buf = pixbuf_target->get_pixbuf();
-                targets_vector.push_back(CtConst::TARGETS_IMAGES[0]);
+    const int sel_start_offset = iter_sel_start.get_offset();
+    const int sel_end_offset = iter_sel_end.get_offset();
+    auto f_range_has_anchored_widgets = [&]()->bool{
+        for (CtAnchoredWidget* pCtAnchoredWidget : ct_tree_iter.get_anchored_widgets_fast()) {
+            const int offset = text_buffer->get_iter_at_child_anchor(pCtAnchoredWidget->getTextChildAnchor()).get_offset();
+            if (offset >= sel_start_offset and offset < sel_end_offset) {
+                return true;
             }
         }
-        else {
-            targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT};
-        }
-        _set_clipboard_data(targets_vector, clip_data);
+        return false;
+    };
+    if (not is_rich_text or not f_range_has_anchored_widgets()) {
+        // the targets are rendered only when (and if) requested
+        clip_data->pLazySelection = std::make_unique<CtClipboardLazySelection>();
+        CtClipboardLazySelection& lazySelection = *clip_data->pLazySelection;
+        lazySelection.text_buffer = text_buffer;
+        lazySelection.start_offset = sel_start_offset;
+        lazySelection.end_offset = sel_end_offset;
+        lazySelection.syntax_highlighting = not pCodebox ? node_syntax_high : CtConst::PLAIN_TEXT_ID;
+        lazySelection.is_rich_text = is_rich_text;
+        lazySelection.plain_pending = true;
+        lazySelection.html_pending = not CtClipboard::_static_force_plain_text;
+        lazySelection.rich_pending = is_rich_text and not CtClipboard::_static_force_plain_text;
+        _lazy_selection_watch(clip_data);
     }
     else {
-        clip_data->plain_text = text_buffer->get_text(iter_sel_start, iter_sel_end);
-        std::vector<std::string> targets_vector;
-        if (not CtClipboard::_static_force_plain_text) {
-            targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT, CtConst::TARGETS_HTML[0], CtConst::TARGETS_HTML[1]};
+        clip_data->html_text = CtExport2Html{_pCtMainWin}.selection_export_to_html(ct_tree_iter, text_buffer, iter_sel_start, iter_sel_end, node_syntax_high);
+        clip_data->plain_text = CtExport2Txt{_pCtMainWin}.selection_export_to_txt(ct_tree_iter, text_buffer, sel_start_offset, sel_end_offset, true);
+        clip_data->rich_text = rich_text_get_from_text_buffer_selection(ct_tree_iter, text_buffer, iter_sel_start, iter_sel_end);
+        if (pixbuf_target and not CtClipboard::_static_force_plain_text) {
+            clip_data->pix_buf = pixbuf_target->get_pixbuf();
+            targets_vector.push_back(CtConst::TARGETS_IMAGES[0]);
+        }
+    }
+    _set_clipboard_data(targets_vector, clip_data);
+}
+
+void CtClipboard::_lazy_selection_watch(CtClipboardData* clip_data)
+{
+    CtClipboardLazySelection& lazySelection = *clip_data->pLazySelection;
+    CtMainWin* win = _pCtMainWin; // can't use this, because it will be invalid, so make a copy
+    auto f_render_all = [win, clip_data]() {
+        CtClipboard{win}._lazy_selection_render_all(clip_data);
+    };
+    // connected before the default handlers, the buffer is still unchanged
+    lazySelection.buffer_sigc_conn.push_back(lazySelection.text_buffer->signal_insert().connect(
+        [f_render_all](const Gtk::TextIter&, const Glib::ustring&, int) { f_render_all(); }, false/*after*/));
+    lazySelection.buffer_sigc_conn.push_back(lazySelection.text_buffer->signal_erase().connect(
+        [f_render_all](const Gtk::TextIter&, const Gtk::TextIter&) { f_render_all(); }, false/*after*/));
+    lazySelection.buffer_sigc_conn.push_back(lazySelection.text_buffer->signal_insert_child_anchor().connect(
+        [f_render_all](const Gtk::TextIter&, const Glib::RefPtr<Gtk::TextChildAnchor>&) { f_render_all(); }, false/*after*/));
+    if (lazySelection.is_rich_text) {
+        // the syntax highlighting tags are anonymous and not part of the selection formatting
+        auto f_on_tag = [f_render_all](const Glib::RefPtr<Gtk::TextTag>& pTextTag, const Gtk::TextIter&, const Gtk::TextIter&) {
+            if (not pTextTag->property_name().get_value().empty()) {
+                f_render_all();
+            }
+        };
+        lazySelection.buffer_sigc_conn.push_back(lazySelection.text_buffer->signal_apply_tag().connect(f_on_tag, false/*after*/));
+        lazySelection.buffer_sigc_conn.push_back(lazySelection.text_buffer->signal_remove_tag().connect(f_on_tag, false/*after*/));
+    }
+}
+
+void CtClipboard::_lazy_selection_render(CtClipboardData* clip_data, const Glib::ustring& target)
+{
+    CtClipboardLazySelection* pLazySelection = clip_data->pLazySelection.get();
+    if (not pLazySelection) {
+        return;
+    }
+    for (sigc::connection& sigc_conn : pLazySelection->buffer_sigc_conn) {
+        sigc_conn.block();
+    }
+    Gtk::TextIter iter_sel_start = pLazySelection->text_buffer->get_iter_at_offset(pLazySelection->start_offset);
+    Gtk::TextIter iter_sel_end = pLazySelection->text_buffer->get_iter_at_offset(pLazySelection->end_offset);
+    if (CtConst::TARGET_CTD_PLAIN_TEXT == target and pLazySelection->plain_pending) {
+        pLazySelection->plain_pending = false;
+        if (pLazySelection->is_rich_text) {
+            clip_data->plain_text = CtExport2Txt{_pCtMainWin}.selection_export_to_txt(CtTreeIter{}/*no anchored widgets*/,
+                pLazySelection->text_buffer, pLazySelection->start_offset, pLazySelection->end_offset, true);
         }
         else {
-            targets_vector = {CtConst::TARGET_CTD_PLAIN_TEXT};
+            clip_data->plain_text = pLazySelection->text_buffer->get_text(iter_sel_start, iter_sel_end);
         }
-        _set_clipboard_data(targets_vector, clip_data);
+    }
+    else if (CtConst::TARGET_CTD_RICH_TEXT == target and pLazySelection->rich_pending) {
+        pLazySelection->rich_pending = false;
+        clip_data->rich_text = rich_text_get_from_text_buffer_selection(CtTreeIter{}/*no anchored widgets*/,
+            pLazySelection->text_buffer, iter_sel_start, iter_sel_end);
+    }
+    else if (vec::exists(CtConst::TARGETS_HTML, target) and pLazySelection->html_pending) {
+        pLazySelection->html_pending = false;
+        clip_data->html_text = CtExport2Html{_pCtMainWin}.selection_export_to_html(CtTreeIter{}/*no anchored widgets*/,
+            pLazySelection->text_buffer, iter_sel_start, iter_sel_end, pLazySelection->syntax_highlighting);
+    }
+    for (sigc::connection& sigc_conn : pLazySelection->buffer_sigc_conn) {
+        sigc_conn.unblock();
     }
 }
 
+void CtClipboard::_lazy_selection_render_all(CtClipboardData* clip_data)
+{
+    CtClipboardLazySelection* pLazySelection = clip_data->pLazySelection.get();
+    if (not pLazySelection) {
+        return;
+    }
+    _lazy_selection_render(clip_data, CtConst::TARGET_CTD_PLAIN_TEXT);
+    _lazy_selection_render(clip_data, CtConst::TARGET_CTD_RICH_TEXT);
+    _lazy_selection_render(clip_data, CtConst::TARGETS_HTML[0]);
+    // the clipboard data is complete and no longer tied to the buffer
+    for (sigc::connection& sigc_conn : pLazySelection->buffer_sigc_conn) {
+        sigc_conn.disconnect();
+    }
+    clip_data->pLazySelection.reset();
+}
+
 void CtClipboard::_set_clipboard_data(const std::vector<std::string>& targets_list, CtClipboardData* clip_data)
 {
     #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
@@ -503,7 +603,12 @@ void CtClipboard::_set_clipboard_data(const std::vector<std::string>& targets_li
     Gtk::Clipboard::get()->set(target_entries, clip_data_get, clip_data_clear);
     #else
     // GTK4: minimal clipboard support (text only)
-    (void)targets_list;
+    for (const Glib::ustring& target : {CtConst::TARGET_CTD_RICH_TEXT, CtConst::TARGETS_HTML[0], CtConst::TARGET_CTD_PLAIN_TEXT}) {
+        if (vec::exists(targets_list, target.raw())) {
+            _lazy_selection_render(clip_data, target);
+            break;
+        }
+    }
     auto display = Gdk::Display::get_default();
     if (display) {
         auto clipboard = display->get_clipboard();
@@ -526,6 +631,7 @@ void CtClipboard::_on_clip_data_get(Gtk::SelectionData& selection_data, CtClipbo
 {
     CtClipboard::_static_from_column_edit = clip_data->from_column_edit;
     const Glib::ustring target = selection_data.get_target();
+    _lazy_selection_render(clip_data, target);
     if (CtConst::TARGET_CTD_PLAIN_TEXT == target) {
         selection_data.set(target, 8, (const guint8*)clip_data->plain_text.c_str(), (int)clip_data->plain_text.bytes());
     }
@@ -610,8 +716,7 @@ void CtClipboard::on_received_to_plain_text(const Gtk::SelectionData& selection_
                     link_url = "http://" + link_url;
                 }
                 Glib::ustring property_value = "webs " + link_url;
-                curr_buffer->apply_tag_by_name(_pCtMainWin->get_text_tag_name_exist_or_create(CtConst::TAG_LINK, property_value),
-                                               iter_sel_start, iter_sel_end);
+                _pCtMainWin->apply_link(curr_buffer, iter_sel_start, iter_sel_end, property_value);
             }
         }
         else {
@@ -627,8 +732,7 @@ void CtClipboard::on_received_to_plain_text(const Gtk::SelectionData& selection_
                 if (not property_value.empty()) {
                     Gtk::TextIter iter_sel_end = curr_buffer->get_insert()->get_iter();
                     Gtk::TextIter iter_sel_start = curr_buffer->get_iter_at_offset(start_offset);
-                    curr_buffer->apply_tag_by_name(_pCtMainWin->get_text_tag_name_exist_or_create(CtConst::TAG_LINK, property_value),
-                                                   iter_sel_start, iter_sel_end);
+                    _pCtMainWin->apply_link(curr_buffer, iter_sel_start, iter_sel_end, property_value);
                 }
             }
         }
@@ -996,8 +1100,7 @@ void CtClipboard::_uri_or_filepath_list_into_rich_text(const std::vector<Glib::u
             pTextBuffer->insert(pTextBuffer->get_insert()->get_iter(), element);
             Gtk::TextIter iter_sel_start = pTextBuffer->get_iter_at_offset(start_offset);
             Gtk::TextIter iter_sel_end = pTextBuffer->get_iter_at_offset(start_offset + (int)element.length());
-            pTextBuffer->apply_tag_by_name(_pCtMainWin->get_text_tag_name_exist_or_create(CtConst::TAG_LINK, property_value),
-                                           iter_sel_start, iter_sel_end);
+            _pCtMainWin->apply_link(pTextBuffer, iter_sel_start, iter_sel_end, property_value);
         }
         subsequent_insert = true;
     }
@@ -29,15 +29,38 @@
 #include "ct_table.h"
 #include <libxml++/libxml++.h>
 
+// text selection without anchored widgets whose targets are rendered when first requested;
+// any change to the buffer renders the pending targets before it is applied
+struct CtClipboardLazySelection
+{
+    Glib::RefPtr<Gtk::TextBuffer> text_buffer;
+    int                           start_offset{0};
+    int                           end_offset{0};
+    std::string                   syntax_highlighting;
+    bool                          is_rich_text{false};
+    bool                          html_pending{false};
+    bool                          plain_pending{false};
+    bool                          rich_pending{false};
+    std::list<sigc::connection>   buffer_sigc_conn;
+};
+
 struct CtClipboardData
 {
     CtClipboardData() {}
+    ~CtClipboardData() {
+        if (pLazySelection) {
+            for (sigc::connection& sigc_conn : pLazySelection->buffer_sigc_conn) {
+                sigc_conn.disconnect();
+            }
+        }
+    }
     xmlpp::Document xml_doc;
     Glib::ustring html_text;
     Glib::ustring plain_text;
     Glib::ustring rich_text;
     Glib::RefPtr<Gdk::Pixbuf> pix_buf;
     bool from_column_edit{false};
+    std::unique_ptr<CtClipboardLazySelection> pLazySelection;
 };
 
 class CtClipboard
@@ -93,6 +116,9 @@ private:
                                  CtCodebox* pCodebox);
     void _set_clipboard_data(const std::vector<std::string>& targets_list,
                              CtClipboardData* clip_data);
+    void _lazy_selection_watch(CtClipboardData* clip_data);
+    void _lazy_selection_render(CtClipboardData* clip_data, const Glib::ustring& target);
+    void _lazy_selection_render_all(CtClipboardData* clip_data);
 
 private:
     #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
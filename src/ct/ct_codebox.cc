@@ -307,6 +307,7 @@ void CtCodebox::apply_syntax_highlighting(const bool forceReApply)
     Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = get_buffer();
     _pCtMainWin->apply_syntax_highlighting(pTextBuffer, _syntaxHighlighting, forceReApply);
     gtk_source_buffer_set_highlight_matching_brackets(GTK_SOURCE_BUFFER(pTextBuffer->gobj()), _highlightBrackets);
+    _ctTextview.queue_region_highlight();
 }
 
 void CtCodebox::to_xml(xmlpp::Element* p_node_parent, const int offset_adjustment, CtStorageCache*, const std::string&/*multifile_dir*/)
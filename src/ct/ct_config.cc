@@ -341,6 +341,7 @@ void CtConfig::_populate_keyfile_from_data()
     _uKeyFile->set_boolean(_currentGroup, "pt_highl_curr_line", ptHighlCurrLine);
     _uKeyFile->set_boolean(_currentGroup, "rt_highl_match_bra", rtHighlMatchBra);
     _uKeyFile->set_boolean(_currentGroup, "pt_highl_match_bra", ptHighlMatchBra);
+    _uKeyFile->set_integer(_currentGroup, "code_highl_full_max_kb", codeHighlFullMaxKB);
     _uKeyFile->set_integer(_currentGroup, "space_around_lines", spaceAroundLines);
     _uKeyFile->set_integer(_currentGroup, "relative_wrapped_space", relativeWrappedSpace);
     _uKeyFile->set_string(_currentGroup, "h_rule", hRule);
@@ -450,6 +451,7 @@ void CtConfig::_populate_keyfile_from_data()
     _uKeyFile->set_boolean(_currentGroup, "enable_custom_backup_dir", customBackupDirOn);
     _uKeyFile->set_string(_currentGroup, "custom_backup_dir", customBackupDir);
     _uKeyFile->set_integer(_currentGroup, "limit_undoable_steps", limitUndoableSteps);
+    _uKeyFile->set_boolean(_currentGroup, "ctx_page_encryption", ctxPageEncryption);
 
     // [proxy]
     _currentGroup = "proxy";
@@ -677,6 +679,7 @@ void CtConfig::_populate_data_from_keyfile()
     _populate_bool_from_keyfile("pt_highl_curr_line", &ptHighlCurrLine);
     _populate_bool_from_keyfile("rt_highl_match_bra", &rtHighlMatchBra);
     _populate_bool_from_keyfile("pt_highl_match_bra", &ptHighlMatchBra);
+    _populate_int_from_keyfile("code_highl_full_max_kb", &codeHighlFullMaxKB);
     _populate_int_from_keyfile("space_around_lines", &spaceAroundLines);
     _populate_int_from_keyfile("relative_wrapped_space", &relativeWrappedSpace);
     _populate_string_from_keyfile("h_rule", &hRule);
@@ -814,6 +817,7 @@ void CtConfig::_populate_data_from_keyfile()
     _populate_bool_from_keyfile("enable_custom_backup_dir", &customBackupDirOn);
     _populate_string_from_keyfile("custom_backup_dir", &customBackupDir);
     _populate_int_from_keyfile("limit_undoable_steps", &limitUndoableSteps);
+    _populate_bool_from_keyfile("ctx_page_encryption", &ctxPageEncryption);
 
     // [proxy]
     _currentGroup = "proxy";
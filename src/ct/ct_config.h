@@ -155,6 +155,7 @@ public:
     bool                                        ptHighlCurrLine{true};
     bool                                        rtHighlMatchBra{false};
     bool                                        ptHighlMatchBra{true};
+    int                                         codeHighlFullMaxKB{2048};
     int                                         spaceAroundLines{0};
     int                                         relativeWrappedSpace{50};
     Glib::ustring                               hRule{CtConst::HORIZONTAL_RULE_DEFAULT};
@@ -270,6 +271,7 @@ public:
     bool                                        customBackupDirOn{false};
     std::string                                 customBackupDir{""};
     int                                         limitUndoableSteps{10};
+    bool                                        ctxPageEncryption{false};
 
     // [proxy]
     std::string                                 proxyUrlColonPort;
@@ -622,10 +622,15 @@ bool CtDialogs::choose_data_storage_dialog(CtMainWin* pCtMainWin, CtStorageSelec
     Gtk::Label label_passwd(_("CT saves the document in an encrypted 7zip archive. When viewing or editing the document, CT extracts the encrypted archive to a temporary folder, and works on the unencrypted copy. When closing, the unencrypted copy is deleted from the temporary directory. Note that in the case of application or system crash, the unencrypted document will remain in the temporary folder."));
     label_passwd.set_width_chars(70);
     label_passwd.set_line_wrap(true);
+    auto pCtConfig = pCtMainWin->get_ct_config();
+    Gtk::CheckButton checkbutton_page_encryption{_("SQLite: Encrypt the Database Page by Page instead of 7-zip")};
+    checkbutton_page_encryption.set_tooltip_text(_("The document is worked on in place and saving only writes the changed pages, no unencrypted copy in the temporary folder. Older versions of CherryTree cannot open it."));
+    checkbutton_page_encryption.set_active(pCtConfig->ctxPageEncryption);
     Gtk::Box vbox_passw{Gtk::ORIENTATION_VERTICAL};
     vbox_passw.pack_start(entry_passw_1);
     vbox_passw.pack_start(entry_passw_2);
     vbox_passw.pack_start(label_passwd);
+    vbox_passw.pack_start(checkbutton_page_encryption);
 
     Gtk::Frame passw_frame(Glib::ustring("<b>")+_("Enter the New Password Twice")+"</b>");
     dynamic_cast<Gtk::Label*>(passw_frame.get_label_widget())->set_use_markup(true);
@@ -658,7 +663,8 @@ bool CtDialogs::choose_data_storage_dialog(CtMainWin* pCtMainWin, CtStorageSelec
         passw_frame.set_sensitive(false);
     }
 
-    auto pCtConfig = pCtMainWin->get_ct_config();
+    checkbutton_page_encryption.set_sensitive(radiobutton_sqlite_pass_protected.get_active());
+
     auto hbox_autosave = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_HORIZONTAL, 4/*spacing*/});
     auto checkbutton_autosave = Gtk::manage(new Gtk::CheckButton{_("Autosave Every")});
     Glib::RefPtr<Gtk::Adjustment> adjustment_autosave = Gtk::Adjustment::create(pCtConfig->autosaveMinutes, 1, 1000, 1);
@@ -702,6 +708,7 @@ bool CtDialogs::choose_data_storage_dialog(CtMainWin* pCtMainWin, CtStorageSelec
         else {
             passw_frame.set_sensitive(false);
         }
+        checkbutton_page_encryption.set_sensitive(radiobutton_sqlite_pass_protected.get_active());
     };
     auto on_key_press_edit_data_storage_type_dialog = [&](GdkEventKey* pEventKey)->bool{
         if (GDK_KEY_Return == pEventKey->keyval or GDK_KEY_KP_Enter == pEventKey->keyval) {
@@ -740,6 +747,9 @@ bool CtDialogs::choose_data_storage_dialog(CtMainWin* pCtMainWin, CtStorageSelec
         args.ctDocEncrypt = radiobutton_sqlite_pass_protected.get_active() or radiobutton_xml_pass_protected.get_active() ?
                             CtDocEncrypt::True : CtDocEncrypt::False;
         if (CtDocEncrypt::True == args.ctDocEncrypt) {
+            if (CtDocType::SQLite == args.ctDocType) {
+                pCtConfig->ctxPageEncryption = checkbutton_page_encryption.get_active();
+            }
             args.password = entry_passw_1.get_text();
             if (args.password.empty()) {
                 error_dialog(_("The Password Fields Must be Filled."), *pCtMainWin);
@@ -1132,6 +1142,22 @@ void CtDialogs::summary_info_dialog(CtMainWin* pCtMainWin, const CtSummaryInfo&
     grid.attach(label_shared_key, 0, 9, 1, 1);
     Gtk::Label label_shared_val{fmt::format("{} / {}", summaryInfo.nodes_shared_tot, summaryInfo.nodes_shared_groups)};
     grid.attach(label_shared_val, 1, 9, 1, 1);
+    Gtk::Label label_chars_key;
+    label_chars_key.set_markup(Glib::ustring{"<b>"} + _("Number of Characters") + "</b>");
+    grid.attach(label_chars_key, 0, 10, 1, 1);
+    Gtk::Label label_chars_val{std::to_string(summaryInfo.chars_num)};
+    grid.attach(label_chars_val, 1, 10, 1, 1);
+    Gtk::Label label_words_key;
+    label_words_key.set_markup(Glib::ustring{"<b>"} + _("Number of Words") + "</b>");
+    grid.attach(label_words_key, 0, 11, 1, 1);
+    Gtk::Label label_words_val{std::to_string(summaryInfo.words_num)};
+    grid.attach(label_words_val, 1, 11, 1, 1);
+    Gtk::Label label_blobs_key;
+    label_blobs_key.set_markup(Glib::ustring{"<b>"} + _("Size of Images and Embedded Files") + "</b>");
+    grid.attach(label_blobs_key, 0, 12, 1, 1);
+    g_autofree gchar* pBlobsSize = g_format_size(summaryInfo.blob_bytes);
+    Gtk::Label label_blobs_val{pBlobsSize};
+    grid.attach(label_blobs_val, 1, 12, 1, 1);
     Gtk::Box* pContentArea = dialog.get_content_area();
     pContentArea->pack_start(grid);
     pContentArea->show_all();
@@ -1139,3 +1165,125 @@ void CtDialogs::summary_info_dialog(CtMainWin* pCtMainWin, const CtSummaryInfo&
     dialog.hide();
 #endif
 }
+
+void CtDialogs::memory_usage_dialog(CtMainWin* pCtMainWin)
+{
+#if GTKMM_MAJOR_VERSION >= 4
+    (void)pCtMainWin; // no tree_memory_usage action
+#else
+    struct CtMemoryUsageColumns : public Gtk::TreeModelColumnRecord
+    {
+        CtMemoryUsageColumns() {
+            add(nodeId); add(nodeName);
+            for (auto& columnBytes : bytes) add(columnBytes);
+            add(total);
+        }
+        Gtk::TreeModelColumn<gint64> nodeId;
+        Gtk::TreeModelColumn<Glib::ustring> nodeName;
+        std::array<Gtk::TreeModelColumn<guint64>, CtMemoryUsage::NUM_CATEGORIES> bytes;
+        Gtk::TreeModelColumn<guint64> total;
+    } columns;
+    const std::array<Glib::ustring, CtMemoryUsage::NUM_CATEGORIES> categoryTitles{
+        _("Text"), _("Images"), _("Embedded Files"), _("Not Yet Loaded"), _("Undo History")};
+
+    Gtk::Dialog dialog = Gtk::Dialog{_("Memory Usage"),
+                                     *pCtMainWin,
+                                     Gtk::DialogFlags::DIALOG_MODAL | Gtk::DialogFlags::DIALOG_DESTROY_WITH_PARENT};
+    (void)CtMiscUtil::dialog_add_button(&dialog, _("Close"), Gtk::RESPONSE_CLOSE, "ct_close");
+    dialog.set_default_size(800, 500);
+    dialog.set_position(Gtk::WindowPosition::WIN_POS_CENTER_ON_PARENT);
+
+    CtTreeStore& ctTreestore = pCtMainWin->get_tree_store();
+    Glib::RefPtr<Gtk::ListStore> rListStore = Gtk::ListStore::create(columns);
+    Gtk::TreeView treeview{rListStore};
+    treeview.get_selection()->set_mode(Gtk::SELECTION_MULTIPLE);
+    const int colNumName = treeview.append_column(_("Node Name"), columns.nodeName) - 1;
+    treeview.get_column(colNumName)->set_sort_column(columns.nodeName);
+    treeview.get_column(colNumName)->set_expand(true);
+    auto f_append_size_column = [&treeview](const Glib::ustring& title, const Gtk::TreeModelColumn<guint64>& columnBytes){
+        auto pCellRenderer = Gtk::manage(new Gtk::CellRendererText{});
+        pCellRenderer->property_xalign() = 1;
+        auto pColumn = Gtk::manage(new Gtk::TreeViewColumn{title});
+        pColumn->pack_start(*pCellRenderer, true);
+        pColumn->set_cell_data_func(*pCellRenderer, [&columnBytes](Gtk::CellRenderer* pCell, const Gtk::TreeModel::iterator& iter){
+            g_autofree gchar* pSize = g_format_size(iter->get_value(columnBytes));
+            static_cast<Gtk::CellRendererText*>(pCell)->property_text() = pSize;
+        });
+        pColumn->set_sort_column(columnBytes);
+        treeview.append_column(*pColumn);
+    };
+    for (size_t i = 0; i < CtMemoryUsage::NUM_CATEGORIES; ++i) {
+        f_append_size_column(categoryTitles[i], columns.bytes[i]);
+    }
+    f_append_size_column(_("Total"), columns.total);
+    Gtk::ScrolledWindow scrolledwindow;
+    scrolledwindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+    scrolledwindow.add(treeview);
+
+    Gtk::Label label_totals;
+    label_totals.set_halign(Gtk::ALIGN_START);
+    auto f_populate = [&](){
+        CtMemoryUsage memoryUsage;
+        pCtMainWin->memory_usage_populate(memoryUsage);
+        rListStore->clear();
+        for (const CtMemoryUsage::NodeUsage& nodeUsage : memoryUsage.get_sorted()) {
+            Gtk::TreeModel::Row row = *rListStore->append();
+            row[columns.nodeId] = nodeUsage.nodeId;
+            row[columns.nodeName] = ctTreestore.get_node_name_from_node_id(nodeUsage.nodeId);
+            for (size_t i = 0; i < CtMemoryUsage::NUM_CATEGORIES; ++i) {
+                row[columns.bytes[i]] = nodeUsage.bytes[i];
+            }
+            row[columns.total] = nodeUsage.get_total();
+        }
+        Glib::ustring totals;
+        for (size_t i = 0; i < CtMemoryUsage::NUM_CATEGORIES; ++i) {
+            g_autofree gchar* pSize = g_format_size(memoryUsage.get_total(static_cast<CtMemoryUsage::Category>(i)));
+            totals += categoryTitles[i] + _(": ") + pSize + "   ";
+        }
+        g_autofree gchar* pTotalSize = g_format_size(memoryUsage.get_total());
+        label_totals.set_markup(totals + "<b>" + Glib::ustring{_("Total")} + _(": ") + pTotalSize + "</b>");
+    };
+    auto f_selected_node_ids = [&](){
+        std::vector<gint64> nodeIds;
+        for (const Gtk::TreeModel::Path& path : treeview.get_selection()->get_selected_rows()) {
+            nodeIds.push_back(rListStore->get_iter(path)->get_value(columns.nodeId));
+        }
+        return nodeIds;
+    };
+
+    Gtk::Button button_drop_undo{_("Drop Undo History")};
+    button_drop_undo.set_image_from_icon_name("ct_clear", Gtk::ICON_SIZE_BUTTON);
+    button_drop_undo.set_tooltip_text(_("Drop the Undo History of the Selected Nodes"));
+    button_drop_undo.signal_clicked().connect([&](){
+        for (const gint64 nodeId : f_selected_node_ids()) {
+            pCtMainWin->get_state_machine().drop_undo_states(nodeId);
+        }
+        f_populate();
+    });
+    Gtk::Button button_unload{_("Unload Text Buffers")};
+    button_unload.set_image_from_icon_name("ct_remove", Gtk::ICON_SIZE_BUTTON);
+    button_unload.set_tooltip_text(_("Release the Text of the Selected Nodes, Loaded Again When Needed (Not for the Selected Node or Unsaved Changes)"));
+    button_unload.signal_clicked().connect([&](){
+        for (const gint64 nodeId : f_selected_node_ids()) {
+            CtTreeIter ctTreeIter = ctTreestore.get_node_from_node_id(nodeId);
+            if (ctTreeIter) {
+                (void)ctTreestore.unload_text_buffer(ctTreeIter);
+            }
+        }
+        f_populate();
+    });
+    Gtk::Box hbox_buttons{Gtk::ORIENTATION_HORIZONTAL, 4/*spacing*/};
+    hbox_buttons.pack_start(button_drop_undo, false, false);
+    hbox_buttons.pack_start(button_unload, false, false);
+
+    f_populate();
+    Gtk::Box* pContentArea = dialog.get_content_area();
+    pContentArea->set_spacing(4);
+    pContentArea->pack_start(scrolledwindow);
+    pContentArea->pack_start(label_totals, false, false);
+    pContentArea->pack_start(hbox_buttons, false, false);
+    pContentArea->show_all();
+    dialog.run();
+    dialog.hide();
+#endif
+}
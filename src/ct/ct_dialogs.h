@@ -222,7 +222,7 @@ bool choose_data_storage_dialog(CtMainWin* pCtMainWin, CtStorageSelectArgs& args
 bool node_prop_dialog(const Glib::ustring &title,
                       CtMainWin* pCtMainWin,
                       CtNodeData& nodeData,
-                      const std::set<Glib::ustring>& tags_set);
+                      const CtTagIndex& tagIndex);
 
 CtYesNoCancel exit_save_dialog(CtMainWin& ct_main_win);
 
@@ -242,6 +242,9 @@ gint64 dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& entryStr);
 
 void summary_info_dialog(CtMainWin* pCtMainWin, const CtSummaryInfo& summaryInfo);
 
+// approximate memory per node, with undo history drop and buffers unload of the selected nodes
+void memory_usage_dialog(CtMainWin* pCtMainWin);
+
 enum class TableHandleResp { Cancel, Ok, OkFromFile };
 TableHandleResp table_handle_dialog(CtMainWin* pCtMainWin,
                                     const Glib::ustring& title,
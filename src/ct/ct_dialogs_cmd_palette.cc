@@ -34,57 +34,45 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
     // based on plotinus
     struct CtPaletteColumns : public Gtk::TreeModelColumnRecord
     {
-        Gtk::TreeModelColumn<int>           order;
         Gtk::TreeModelColumn<Glib::ustring> id;
         Gtk::TreeModelColumn<Glib::ustring> path;
         Gtk::TreeModelColumn<Glib::ustring> icon;
         Gtk::TreeModelColumn<Glib::ustring> label;
         Gtk::TreeModelColumn<Glib::ustring> accelerator;
-        CtPaletteColumns() { add(order); add(id); add(path); add(icon); add(label); add(accelerator); }
+        CtPaletteColumns() { add(id); add(path); add(icon); add(label); add(accelerator); }
     } columns;
 
     Glib::ustring filter;
     std::vector<Glib::ustring> filter_words;
 
-    auto get_command_score = [&](const Gtk::TreeModel::iterator& iter) -> int {
-        auto label = iter->get_value(columns.label).lowercase();
-        auto path = iter->get_value(columns.path).lowercase();
-        int score = 0;
-        if (str::startswith(label, filter)) return score;
-        score++;
-        if (label.find(filter) != Glib::ustring::npos) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words, false)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words, false)) return score;
-        return -1;
-    };
-
-    auto list_store = Gtk::ListStore::create(columns);
-    int order_cnt = 0;
+    // the matching runs on the folded index, the rows are filled with the matches in order
+    std::vector<const CtMenuAction*> actions;
+    CtMatchIndex actionsMatchIndex;
     for (auto& action : pCtMainWin->get_ct_menu().get_actions()) {
         if (action.category.empty()) continue;
-        auto iter = *list_store->append();
-        iter[columns.order] = ++order_cnt;
-        iter[columns.id] = action.id;
-        iter[columns.path] = action.category;
-        iter[columns.icon] = action.image;
-        iter[columns.label] = str::replace(action.name, "_", "");
-        iter[columns.accelerator] = action.get_shortcut(pCtMainWin->get_ct_config());
+        actionsMatchIndex.set(static_cast<gint64>(actions.size()),
+                              CtMatchIndex::fold(str::replace(action.name, "_", "")),
+                              CtMatchIndex::fold(action.category));
+        actions.push_back(&action);
     }
 
-    auto tree_model_filter = Gtk::TreeModelFilter::create(list_store);
-    tree_model_filter->set_visible_func([&](const Gtk::TreeModel::iterator& iter) -> bool {
-        if (filter.empty()) return true;
-        return get_command_score(iter) >= 0;
-    });
-    auto tree_model_sort = Gtk::TreeModelSort::create(tree_model_filter);
+    auto list_store = Gtk::ListStore::create(columns);
+    auto fill_list_store = [&]() {
+        list_store->clear();
+        for (const gint64 idx : actionsMatchIndex.query(filter, actions.size())) {
+            const CtMenuAction* pAction = actions.at(static_cast<size_t>(idx));
+            auto iter = *list_store->append();
+            iter[columns.id] = pAction->id;
+            iter[columns.path] = pAction->category;
+            iter[columns.icon] = pAction->image;
+            iter[columns.label] = str::replace(pAction->name, "_", "");
+            iter[columns.accelerator] = pAction->get_shortcut(pCtMainWin->get_ct_config());
+        }
+    };
+    fill_list_store();
+
     auto tree_view = Gtk::TreeView();
-    tree_view.set_model(tree_model_sort);
+    tree_view.set_model(list_store);
     tree_view.set_headers_visible(false);
 
     // The theme's style context is reliably available only after the widget has been realized
@@ -131,18 +119,7 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
         filter = str::trim(filter).lowercase();
         filter_words = str::split(filter, " ");
 
-        tree_model_filter->refilter();
-
-        // TreeModelSort has no "resort" method, but reassigning the comparison function forces a resort
-        tree_model_sort->set_default_sort_func([&](const Gtk::TreeModel::iterator& iter_a, const Gtk::TreeModel::iterator& iter_b) {
-          // "The sort function used by TreeModelSort is not guaranteed to be stable" (GTK+ documentation),
-          // so the original order of commands is needed as a tie-breaker
-          int id_difference = iter_a->get_value(columns.order) - iter_b->get_value(columns.order);
-          if (filter.empty()) return id_difference;
-
-          int score_difference = get_command_score(iter_a) - get_command_score(iter_b);
-          return (score_difference != 0) ? score_difference : id_difference;
-        });
+        fill_list_store();
     };
     auto scroll_to_selected_item = [&]() {
         if (Gtk::TreeModel::iterator selected_iter = tree_view.get_selection()->get_selected()) {
@@ -28,6 +28,9 @@
 
 namespace {
 
+// rows shown at most, the best matching first
+constexpr size_t SEL_NODE_MAX_RESULTS{500};
+
 #if GTKMM_MAJOR_VERSION >= 4
 int _run_dialog_blocking(Gtk::Dialog& dialog)
 {
@@ -59,61 +62,35 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
     // based on plotinus
     struct CtPaletteColumns : public Gtk::TreeModelColumnRecord
     {
-        Gtk::TreeModelColumn<int>           order;
         Gtk::TreeModelColumn<gint64>        id;
         Gtk::TreeModelColumn<Glib::ustring> path;
         Gtk::TreeModelColumn<Glib::RefPtr<Gdk::Pixbuf>> pixbuf;
         Gtk::TreeModelColumn<Glib::ustring> label;
-        CtPaletteColumns() { add(order); add(id); add(path); add(pixbuf); add(label); }
+        CtPaletteColumns() { add(id); add(path); add(pixbuf); add(label); }
     } columns;
 
     Glib::ustring filter;
     std::vector<Glib::ustring> filter_words;
 
-    auto get_command_score = [&](const Gtk::TreeModel::iterator& iter) -> int {
-        auto label = iter->get_value(columns.label).lowercase();
-        auto path = iter->get_value(columns.path).lowercase();
-        int score = 0;
-        if (str::startswith(label, filter)) return score;
-        score++;
-        if (label.find(filter) != Glib::ustring::npos) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words, false/*require_all*/)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words, false/*require_all*/)) return score;
-        return -1;
-    };
-
-    auto list_store = Gtk::ListStore::create(columns);
+    // only the best matches are materialised as rows, the matching runs on the folded index
     auto& treeStore = pCtMainWin->get_tree_store();
+    const CtMatchIndex& nodesMatchIndex = treeStore.get_nodes_match_index();
+    auto list_store = Gtk::ListStore::create(columns);
+    auto fill_list_store = [&]() {
+        list_store->clear();
+        for (const gint64 node_id : nodesMatchIndex.query(filter, SEL_NODE_MAX_RESULTS)) {
+            CtTreeIter ctit = treeStore.get_node_from_node_id(node_id);
+            if (not ctit) continue;
+            auto listIter = *list_store->append();
+            listIter[columns.id] = node_id;
+            listIter[columns.path] = CtMiscUtil::get_node_hierarchical_name(ctit, " / ", false);
+            listIter[columns.pixbuf] = ctit.get_node_icon();
+            listIter[columns.label] = ctit.get_node_name();
+        }
+    };
 
-    int order_cnt = 0;
-
-    treeStore.get_store()->foreach_iter([&](const Gtk::TreeModel::iterator& iter)
-    {
-        auto ctit = treeStore.to_ct_tree_iter(iter);
-        auto full_path = CtMiscUtil::get_node_hierarchical_name(ctit, " / ", false);
-        auto listIter = *list_store->append();
-        listIter[columns.order] = ++order_cnt;
-        listIter[columns.id] = ctit.get_node_id();
-        listIter[columns.path] = full_path;
-        listIter[columns.pixbuf] = ctit.get_node_icon();
-        listIter[columns.label] = ctit.get_node_name();
-        return false;
-    });
-
-    auto tree_model_filter = Gtk::TreeModelFilter::create(list_store);
-    tree_model_filter->set_visible_func([&](const Gtk::TreeModel::iterator& iter) -> bool {
-        if (filter.empty()) return true;
-        return get_command_score(iter) >= 0;
-    });
-    auto tree_model_sort = Gtk::TreeModelSort::create(tree_model_filter);
     auto tree_view = Gtk::TreeView();
-    tree_view.set_model(tree_model_sort);
+    tree_view.set_model(list_store);
     tree_view.set_headers_visible(false);
 
     int root_x, root_y, width_win, height_win;
@@ -160,19 +137,7 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
         filter = Glib::Regex::create("/\\s{2,}/")->replace(raw_filter.c_str(), -1/*string_len*/, 0/*start_position*/, " ");
         filter = str::trim(filter).lowercase();
         filter_words = str::split(filter, " ");
-
-        tree_model_filter->refilter();
-
-        // TreeModelSort has no "re-sort" method, but reassigning the comparison function forces a re-sort
-        tree_model_sort->set_default_sort_func([&](const Gtk::TreeModel::iterator& iter_a, const Gtk::TreeModel::iterator& iter_b) {
-            // "The sort function used by TreeModelSort is not guaranteed to be stable" (GTK+ documentation),
-            // so the original order of commands is needed as a tie-breaker
-            int id_difference = iter_a->get_value(columns.order) - iter_b->get_value(columns.order);
-            if (filter.empty()) return id_difference;
-
-            int score_difference = get_command_score(iter_a) - get_command_score(iter_b);
-            return (score_difference != 0) ? score_difference : id_difference;
-        });
+        fill_list_store();
     };
     auto scroll_to_selected_item = [&]() {
         if (Gtk::TreeModel::iterator selected_iter = tree_view.get_selection()->get_selected()) {
@@ -213,6 +178,7 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
     scrolled_window.set_policy(Gtk::PolicyType::POLICY_NEVER, Gtk::PolicyType::POLICY_AUTOMATIC);
     popup_dialog.get_content_area()->pack_start(scrolled_window);
 
+    set_filter(entryStr);
     select_first_item();
     tree_view.set_can_focus(false);
     scrolled_window.add(tree_view);
@@ -286,65 +252,35 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
 {
     struct CtPaletteColumns : public Gtk::TreeModelColumnRecord
     {
-        Gtk::TreeModelColumn<int>           order;
         Gtk::TreeModelColumn<gint64>        id;
         Gtk::TreeModelColumn<Glib::ustring> path;
         Gtk::TreeModelColumn<Glib::ustring> stock_id;
         Gtk::TreeModelColumn<Glib::ustring> label;
-        CtPaletteColumns() { add(order); add(id); add(path); add(stock_id); add(label); }
+        CtPaletteColumns() { add(id); add(path); add(stock_id); add(label); }
     } columns;
 
     Glib::ustring filter;
     std::vector<Glib::ustring> filter_words;
-    auto get_command_score = [&](const auto& iter) -> int {
-        auto label = iter->get_value(columns.label).lowercase();
-        auto path = iter->get_value(columns.path).lowercase();
-        int score = 0;
-        if (str::startswith(label, filter)) return score;
-        score++;
-        if (label.find(filter) != Glib::ustring::npos) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words, false)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words, false)) return score;
-        return -1;
-    };
 
-    auto list_store = Gtk::ListStore::create(columns);
+    // only the best matches are materialised as rows, the matching runs on the folded index
     auto& treeStore = pCtMainWin->get_tree_store();
-    int order_cnt = 0;
-    treeStore.get_store()->foreach_iter([&](const auto& iter)
-    {
-        auto ctit = treeStore.to_ct_tree_iter(iter);
-        auto full_path = CtMiscUtil::get_node_hierarchical_name(ctit, " / ", false);
-        auto listIter = *list_store->append();
-        listIter[columns.order] = ++order_cnt;
-        listIter[columns.id] = ctit.get_node_id();
-        listIter[columns.path] = full_path;
-        listIter[columns.stock_id] = treeStore.get_node_icon(
-            treeStore.get_store()->iter_depth(iter),
-            ctit.get_node_syntax_highlighting(),
-            ctit.get_node_custom_icon_id());
-        listIter[columns.label] = ctit.get_node_name();
-        return false;
-    });
-
-    auto tree_model_filter = Gtk::TreeModelFilter::create(list_store);
-    tree_model_filter->set_visible_func([&](const auto& iter) -> bool {
-        if (filter.empty()) return true;
-        return get_command_score(iter) >= 0;
-    });
-    auto tree_model_sort = Gtk::TreeModelSort::create(tree_model_filter);
-    tree_model_sort->set_default_sort_func([&](const auto& iter_a, const auto& iter_b) {
-        int id_difference = iter_a->get_value(columns.order) - iter_b->get_value(columns.order);
-        if (filter.empty()) return id_difference;
-        int score_difference = get_command_score(iter_a) - get_command_score(iter_b);
-        return (score_difference != 0) ? score_difference : id_difference;
-    });
+    const CtMatchIndex& nodesMatchIndex = treeStore.get_nodes_match_index();
+    auto list_store = Gtk::ListStore::create(columns);
+    auto fill_list_store = [&]() {
+        list_store->clear();
+        for (const gint64 node_id : nodesMatchIndex.query(filter, SEL_NODE_MAX_RESULTS)) {
+            CtTreeIter ctit = treeStore.get_node_from_node_id(node_id);
+            if (not ctit) continue;
+            auto listIter = *list_store->append();
+            listIter[columns.id] = node_id;
+            listIter[columns.path] = CtMiscUtil::get_node_hierarchical_name(ctit, " / ", false);
+            listIter[columns.stock_id] = treeStore.get_node_icon(
+                treeStore.get_store()->iter_depth(ctit),
+                ctit.get_node_syntax_highlighting(),
+                ctit.get_node_custom_icon_id());
+            listIter[columns.label] = ctit.get_node_name();
+        }
+    };
 
     Gtk::Dialog popup_dialog("", *pCtMainWin, true/*modal*/, true/*use_header_bar*/);
     popup_dialog.add_button(_("Cancel"), Gtk::ResponseType::CANCEL);
@@ -359,7 +295,7 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
     content_box->append(search_entry);
 
     Gtk::TreeView tree_view;
-    tree_view.set_model(tree_model_sort);
+    tree_view.set_model(list_store);
     tree_view.set_headers_visible(false);
     Gtk::CellRendererText path_renderer;
     path_renderer.property_xalign() = 1.0;
@@ -391,13 +327,7 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
     auto set_filter = [&](const Glib::ustring& raw_filter) {
         filter = str::trim(raw_filter).lowercase();
         filter_words = str::split(filter, " ");
-        tree_model_filter->refilter();
-        tree_model_sort->set_default_sort_func([&](const auto& iter_a, const auto& iter_b) {
-            int id_difference = iter_a->get_value(columns.order) - iter_b->get_value(columns.order);
-            if (filter.empty()) return id_difference;
-            int score_difference = get_command_score(iter_a) - get_command_score(iter_b);
-            return (score_difference != 0) ? score_difference : id_difference;
-        });
+        fill_list_store();
     };
     auto select_first_item = [&]() {
         if (Gtk::TreeModel::iterator iter = tree_view.get_model()->get_iter("0")) {
@@ -420,6 +350,7 @@ gint64 CtDialogs::dialog_selnode(CtMainWin* pCtMainWin, const Glib::ustring& ent
     tree_view.signal_row_activated().connect([&](const Gtk::TreeModel::Path&, Gtk::TreeViewColumn*) {
         run_command();
     });
+    set_filter(entryStr);
     select_first_item();
     search_entry.grab_focus();
     search_entry.set_position(search_entry.get_text().size());
@@ -50,12 +50,40 @@ int _run_dialog_blocking(Gtk::Dialog& dialog)
 }
 #endif
 
+// the existing tags completing the word being typed, or all of them
+void _browse_tags(Gtk::Window& dialog, Gtk::Entry* tags_entry, const CtTagIndex& tagIndex)
+{
+    std::string cur_tags = tags_entry->get_text();
+    std::string prefix;
+    if (not cur_tags.empty() and not str::endswith(cur_tags, CtConst::CHAR_SPACE)) {
+        const size_t lastSpacePos = cur_tags.rfind(CtConst::CHAR_SPACE);
+        prefix = std::string::npos == lastSpacePos ? cur_tags : cur_tags.substr(lastSpacePos + 1);
+    }
+    std::vector<std::string> tags = tagIndex.complete(prefix);
+    if (tags.empty()) {
+        prefix.clear();
+        tags = tagIndex.complete(prefix);
+    }
+    auto itemStore = CtChooseDialogListStore::create();
+    for (const std::string& tag : tags) {
+        itemStore->add_row("", "", tag);
+    }
+    const Gtk::TreeModel::iterator treeIter = CtDialogs::choose_item_dialog(dialog, _("Choose Existing Tag"), itemStore, _("Tag Name"));
+    if (treeIter) {
+        cur_tags = cur_tags.substr(0, cur_tags.size() - prefix.size());
+        if (not cur_tags.empty() and not str::endswith(cur_tags, CtConst::CHAR_SPACE)) {
+            cur_tags += CtConst::CHAR_SPACE;
+        }
+        tags_entry->set_text(cur_tags + treeIter->get_value(itemStore->columns.desc));
+    }
+}
+
 }
 
 bool CtDialogs::node_prop_dialog(const Glib::ustring &title,
                                  CtMainWin* pCtMainWin,
                                  CtNodeData& nodeData,
-                                 const std::set<Glib::ustring>& tags_set)
+                                 const CtTagIndex& tagIndex)
 {
 #if GTKMM_MAJOR_VERSION >= 4
     CtConfig* pCtConfig = pCtMainWin->get_ct_config();
@@ -140,7 +168,7 @@ bool CtDialogs::node_prop_dialog(const Glib::ustring &title,
     tags_entry->set_text(nodeData.tags);
     auto button_browse_tags = Gtk::manage(new Gtk::Button{});
     button_browse_tags->set_icon_name("ct_find");
-    button_browse_tags->set_sensitive(not tags_set.empty());
+    button_browse_tags->set_sensitive(tagIndex.size() > 0u);
     tags_hbox->append(*tags_entry);
     tags_hbox->append(*button_browse_tags);
     auto tags_frame = Gtk::manage(new Gtk::Frame{Glib::ustring{"<b>"} + _("Tags for Searching") + "</b>"});
@@ -216,21 +244,8 @@ bool CtDialogs::node_prop_dialog(const Glib::ustring &title,
     radiobutton_auto_syntax_highl->signal_toggled().connect([radiobutton_auto_syntax_highl, button_prog_lang]() {
         button_prog_lang->set_sensitive(radiobutton_auto_syntax_highl->get_active());
     });
-    button_browse_tags->signal_clicked().connect([&dialog, tags_entry, &tags_set]() {
-        auto itemStore = CtChooseDialogListStore::create();
-        for (const auto& tag : tags_set) {
-            itemStore->add_row("", "", tag);
-        }
-        const Gtk::TreeModel::iterator treeIter = CtDialogs::choose_item_dialog(dialog, _("Choose Existing Tag"), itemStore, _("Tag Name"));
-        if (treeIter) {
-            std::string cur_tag = tags_entry->get_text();
-            if (str::endswith(cur_tag, CtConst::CHAR_SPACE)) {
-                tags_entry->set_text(cur_tag + treeIter->get_value(itemStore->columns.desc));
-            }
-            else {
-                tags_entry->set_text(cur_tag + CtConst::CHAR_SPACE + treeIter->get_value(itemStore->columns.desc));
-            }
-        }
+    button_browse_tags->signal_clicked().connect([&dialog, tags_entry, &tagIndex](){
+        _browse_tags(dialog, tags_entry, tagIndex);
     });
     ro_checkbutton->signal_toggled().connect([ro_checkbutton, type_frame]() {
         type_frame->set_sensitive(not ro_checkbutton->get_active());
@@ -394,7 +409,7 @@ bool CtDialogs::node_prop_dialog(const Glib::ustring &title,
     tags_entry->set_text(nodeData.tags);
     auto button_browse_tags = Gtk::manage(new Gtk::Button);
     button_browse_tags->set_image(*pCtMainWin->new_managed_image_from_stock("ct_find", Gtk::ICON_SIZE_BUTTON));
-    button_browse_tags->set_sensitive(not tags_set.empty());
+    button_browse_tags->set_sensitive(tagIndex.size() > 0u);
     tags_hbox->pack_start(*tags_entry);
     tags_hbox->pack_start(*button_browse_tags, false, false);
     auto tags_frame = Gtk::manage(new Gtk::Frame{Glib::ustring{"<b>"}+_("Tags for Searching")+"</b>"});
@@ -477,21 +492,8 @@ bool CtDialogs::node_prop_dialog(const Glib::ustring &title,
     radiobutton_auto_syntax_highl->signal_toggled().connect([radiobutton_auto_syntax_highl, button_prog_lang](){
        button_prog_lang->set_sensitive(radiobutton_auto_syntax_highl->get_active());
     });
-    button_browse_tags->signal_clicked().connect([&dialog, tags_entry, &tags_set](){
-        auto itemStore = CtChooseDialogListStore::create();
-        for (const auto& tag : tags_set) {
-            itemStore->add_row("", "", tag);
-        }
-        const Gtk::TreeModel::iterator treeIter = CtDialogs::choose_item_dialog(dialog, _("Choose Existing Tag"), itemStore, _("Tag Name"));
-        if (treeIter) {
-            std::string cur_tag = tags_entry->get_text();
-            if  (str::endswith(cur_tag, CtConst::CHAR_SPACE)) {
-                tags_entry->set_text(cur_tag + treeIter->get_value(itemStore->columns.desc));
-            }
-            else {
-                tags_entry->set_text(cur_tag + CtConst::CHAR_SPACE + treeIter->get_value(itemStore->columns.desc));
-            }
-        }
+    button_browse_tags->signal_clicked().connect([&dialog, tags_entry, &tagIndex](){
+        _browse_tags(dialog, tags_entry, tagIndex);
     });
     ro_checkbutton->signal_toggled().connect([ro_checkbutton, type_frame](){
         type_frame->set_sensitive(not ro_checkbutton->get_active());
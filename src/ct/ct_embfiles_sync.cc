@@ -0,0 +1,233 @@
+/*
+ * ct_embfiles_sync.cc
+ *
+ * Copyright 2009-2025
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ct_embfiles_sync.h"
+#include "ct_main_win.h"
+#include "ct_const.h"
+#include "ct_dialogs.h"
+#include "ct_logging.h"
+#include <giomm/file.h>
+
+CtEmbFilesSync::CtEmbFilesSync(CtMainWin* pCtMainWin)
+ : _pCtMainWin{pCtMainWin}
+{
+    _dispatcherJobDone.connect(sigc::mem_fun(*this, &CtEmbFilesSync::_on_dispatcher_job_done));
+}
+
+CtEmbFilesSync::~CtEmbFilesSync()
+{
+    for (auto& [embfileId, opened] : _opened) {
+        opened.debounceConnection.disconnect();
+        if (opened.rFileMonitor) {
+            opened.rFileMonitor->cancel();
+        }
+    }
+    if (_pThreadWorker) {
+        // a nullptr is passed on purpose in order to exit the loop, once done with the queued jobs
+        _jobsDEQueue.push_back(nullptr);
+        _pThreadWorker->join();
+    }
+}
+
+bool CtEmbFilesSync::has_node(const gint64 nodeIdDataHolder) const
+{
+    for (const auto& [embfileId, opened] : _opened) {
+        if (nodeIdDataHolder == opened.nodeId) return true;
+    }
+    return false;
+}
+
+void CtEmbFilesSync::open(CtImageEmbFile* pEmbFile, const gint64 nodeIdDataHolder)
+{
+    const size_t embfileId = pEmbFile->get_unique_id();
+    auto it = _opened.find(embfileId);
+    if (_opened.end() == it) {
+        // the file was not opened yet
+        const fs::path filename = std::to_string(nodeIdDataHolder) +
+                                  CtConst::CHAR_MINUS + std::to_string(embfileId) +
+                                  CtConst::CHAR_MINUS + std::to_string(getpid()) +
+                                  CtConst::CHAR_MINUS + pEmbFile->get_file_name().string();
+        it = _opened.emplace(embfileId, Opened{}).first;
+        it->second.nodeId = nodeIdDataHolder;
+        it->second.tmpFilepath = _pCtMainWin->get_ct_tmp()->getHiddenFilePath(filename);
+    }
+    if (not _pThreadWorker) {
+        _pThreadWorker = std::make_unique<std::thread>(&CtEmbFilesSync::_worker_thread, this);
+    }
+    auto pJob = std::make_shared<Job>();
+    pJob->type = JobType::Write;
+    pJob->embfileId = embfileId;
+    pJob->tmpFilepath = it->second.tmpFilepath;
+    pJob->pBlob = pEmbFile->get_blob(); // never modified once created, safe to read from the worker
+    _jobsDEQueue.push_back(pJob);
+    if (pJob->pBlob->size() >= CtEmbFileBlob::SPOOL_MIN_SIZE) {
+        _pCtMainWin->get_status_bar().update_status(_("Preparing the Embedded File...") + CtConst::CHAR_SPACE + pEmbFile->get_file_name().string());
+    }
+}
+
+void CtEmbFilesSync::_worker_thread()
+{
+    while (true) {
+        std::shared_ptr<Job> pJob = _jobsDEQueue.pop_front();
+        if (not pJob) {
+            break;
+        }
+        if (JobType::Write == pJob->type) {
+            pJob->ok = pJob->pBlob->write_to_file(pJob->tmpFilepath, &pJob->sha256sum);
+        }
+        else {
+            // hash first so that an unchanged file does not become a new blob
+            const std::string sha256sum = CtEmbFileBlob::get_file_sha256sum(pJob->tmpFilepath);
+            pJob->ok = not sha256sum.empty();
+            if (pJob->ok and sha256sum != pJob->sha256sum) {
+                pJob->pBlob = CtEmbFileBlob::from_file(pJob->tmpFilepath);
+                pJob->ok = static_cast<bool>(pJob->pBlob);
+            }
+            pJob->sha256sum = sha256sum;
+        }
+        _doneDEQueue.push_back(pJob);
+        _dispatcherJobDone.emit();
+    }
+}
+
+void CtEmbFilesSync::_on_dispatcher_job_done()
+{
+    while (not _doneDEQueue.empty()) {
+        std::shared_ptr<Job> pJob = _doneDEQueue.pop_front();
+        auto it = _opened.find(pJob->embfileId);
+        if (_opened.end() == it) {
+            continue; // dropped meanwhile
+        }
+        Opened& opened = it->second;
+        if (JobType::Write == pJob->type) {
+            if (not pJob->ok) {
+                CtDialogs::error_dialog(str::format(_("Failed to write %s"), str::xml_escape(opened.tmpFilepath.string())), *_pCtMainWin);
+                if (not opened.rFileMonitor) {
+                    _opened.erase(it); // never opened
+                }
+                continue;
+            }
+            opened.sha256sum = pJob->sha256sum;
+            if (not opened.rFileMonitor) {
+                _monitor_start(pJob->embfileId, opened);
+            }
+            _pCtMainWin->get_status_bar().update_status("");
+            fs::open_filepath(opened.tmpFilepath, false/*open_folder_if_file_not_exists*/, _pCtMainWin->get_ct_config());
+        }
+        else if (pJob->ok and pJob->pBlob and pJob->sha256sum != opened.sha256sum) {
+            opened.sha256sum = pJob->sha256sum;
+            _ingest(opened, pJob->embfileId, pJob->pBlob);
+        }
+    }
+}
+
+void CtEmbFilesSync::_monitor_start(const size_t embfileId, Opened& opened)
+{
+    try {
+        opened.rFileMonitor = Gio::File::create_for_path(opened.tmpFilepath.string())->monitor_file();
+    }
+    catch (Glib::Error& error) {
+        spdlog::error("!! {} {} {}", __FUNCTION__, opened.tmpFilepath.string(), error.what());
+        return;
+    }
+#if GTKMM_MAJOR_VERSION >= 4
+    opened.rFileMonitor->signal_changed().connect([this, embfileId](const Glib::RefPtr<Gio::File>&/*file*/,
+                                                                   const Glib::RefPtr<Gio::File>&/*other_file*/,
+                                                                   Gio::FileMonitor::Event event){
+        if (Gio::FileMonitor::Event::ATTRIBUTE_CHANGED != event) {
+            _on_file_changed(embfileId);
+        }
+    });
+#else
+    opened.rFileMonitor->signal_changed().connect([this, embfileId](const Glib::RefPtr<Gio::File>&/*file*/,
+                                                                   const Glib::RefPtr<Gio::File>&/*other_file*/,
+                                                                   Gio::FileMonitorEvent event){
+        if (Gio::FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED != event) {
+            _on_file_changed(embfileId);
+        }
+    });
+#endif
+}
+
+void CtEmbFilesSync::_on_file_changed(const size_t embfileId)
+{
+    // an external application saving may write in several steps or replace the file, wait for the quiet
+    auto it = _opened.find(embfileId);
+    if (_opened.end() == it) {
+        return;
+    }
+    it->second.debounceConnection.disconnect();
+    it->second.debounceConnection = Glib::signal_timeout().connect([this, embfileId](){
+        _on_debounce_timeout(embfileId);
+        return false; /* false to disconnect */
+    }, DEBOUNCE_MSEC);
+}
+
+void CtEmbFilesSync::_on_debounce_timeout(const size_t embfileId)
+{
+    auto it = _opened.find(embfileId);
+    if (_opened.end() == it) {
+        return;
+    }
+    Opened& opened = it->second;
+    if (not fs::is_regular_file(opened.tmpFilepath)) {
+        spdlog::debug("embdrop {}", opened.tmpFilepath.string());
+        if (opened.rFileMonitor) {
+            opened.rFileMonitor->cancel();
+        }
+        _opened.erase(it);
+        return;
+    }
+    auto pJob = std::make_shared<Job>();
+    pJob->type = JobType::Read;
+    pJob->embfileId = embfileId;
+    pJob->tmpFilepath = opened.tmpFilepath;
+    pJob->sha256sum = opened.sha256sum;
+    _jobsDEQueue.push_back(pJob);
+}
+
+void CtEmbFilesSync::_ingest(const Opened& opened, const size_t embfileId, CtEmbFileBlobPtr pBlob)
+{
+    CtTreeIter tree_iter = _pCtMainWin->get_tree_store().get_node_from_node_id(opened.nodeId);
+    if (not tree_iter) {
+        return;
+    }
+    if (tree_iter.get_node_read_only()) {
+        CtDialogs::warning_dialog(_("Cannot Edit Embedded File in Read Only Node."), *_pCtMainWin);
+        return;
+    }
+    _pCtMainWin->get_tree_view().set_cursor_safe(tree_iter);
+    for (CtAnchoredWidget* pWidget : tree_iter.get_anchored_widgets_fast()) {
+        if (auto pEmbFile = dynamic_cast<CtImageEmbFile*>(pWidget)) {
+            if (pEmbFile->get_unique_id() == embfileId) {
+                pEmbFile->set_blob(pBlob);
+                pEmbFile->set_time(std::time(nullptr));
+                pEmbFile->update_tooltip();
+
+                _pCtMainWin->update_window_save_needed(CtSaveNeededUpdType::nbuf);
+                _pCtMainWin->get_status_bar().update_status(_("Embedded File Automatically Updated:") + CtConst::CHAR_SPACE + pEmbFile->get_file_name().string());
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * ct_embfiles_sync.h
+ *
+ * Copyright 2009-2025
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "ct_image.h"
+#include "ct_types.h"
+#include <giomm/filemonitor.h>
+#include <glibmm/dispatcher.h>
+#include <thread>
+#include <unordered_map>
+
+class CtMainWin;
+
+// Embedded files opened with external applications: the temporary files are written and read back
+// by a worker thread, a file monitor notifies the changes that are read back once they settle and
+// only if the content hash differs from the last written or read back
+class CtEmbFilesSync
+{
+public:
+    static constexpr unsigned DEBOUNCE_MSEC{700u};
+
+    CtEmbFilesSync(CtMainWin* pCtMainWin);
+    ~CtEmbFilesSync();
+
+    void open(CtImageEmbFile* pEmbFile, const gint64 nodeIdDataHolder);
+    bool empty() const { return _opened.empty(); }
+    bool has_node(const gint64 nodeIdDataHolder) const;
+
+private:
+    enum class JobType { Write, Read };
+    struct Job
+    {
+        JobType          type;
+        size_t           embfileId;
+        fs::path         tmpFilepath;
+        CtEmbFileBlobPtr pBlob;     // Write: the content to write, Read: the content read if changed
+        std::string      sha256sum; // Read: in the last known, out the read; Write: out the written
+        bool             ok{false};
+    };
+    struct Opened
+    {
+        gint64           nodeId;
+        fs::path         tmpFilepath;
+        std::string      sha256sum; // of the content last written or read back
+        Glib::RefPtr<Gio::FileMonitor> rFileMonitor;
+        sigc::connection debounceConnection;
+    };
+
+    void _worker_thread();
+    void _on_dispatcher_job_done();
+    void _on_file_changed(const size_t embfileId);
+    void _on_debounce_timeout(const size_t embfileId);
+    void _monitor_start(const size_t embfileId, Opened& opened);
+    void _ingest(const Opened& opened, const size_t embfileId, CtEmbFileBlobPtr pBlob);
+
+    CtMainWin* const _pCtMainWin;
+    std::unordered_map<size_t, Opened> _opened; // by embedded file unique id
+    ThreadSafeDEQueue<std::shared_ptr<Job>, 1024> _jobsDEQueue;
+    ThreadSafeDEQueue<std::shared_ptr<Job>, 1024> _doneDEQueue;
+    Glib::Dispatcher _dispatcherJobDone;
+    std::unique_ptr<std::thread> _pThreadWorker; // started at the first open
+};
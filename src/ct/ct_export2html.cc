@@ -29,6 +29,9 @@
 #include "ct_logging.h"
 #include "ct_filesystem.h"
 #include "ct_list.h"
+#include <atomic>
+#include <thread>
+#include <unordered_set>
 
 CtExport2Html::CtExport2Html(CtMainWin* pCtMainWin)
  : _pCtMainWin{pCtMainWin}
@@ -82,13 +85,56 @@ void CtExport2Html::node_export_to_html(CtTreeIter tree_iter,
                                         const Glib::ustring& index,
                                         int sel_start,
                                         int sel_end)
+{
+    _html_render_node_page(_html_snapshot_node(tree_iter, sel_start, sel_end), options, not index.empty());
+}
+
+CtExport2Html::HtmlNode CtExport2Html::_html_snapshot_node(CtTreeIter tree_iter, int sel_start, int sel_end)
 {
     Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = tree_iter.get_node_text_buffer();
     if (not pTextBuffer) {
         throw std::runtime_error(str::format(_("Failed to retrieve the content of the node '%s'"), tree_iter.get_node_name().raw()));
     }
-    Glib::ustring html_text = str::format(HTML_HEADER, tree_iter.get_node_name().raw());
-    if (not index.empty() and options.index_in_page) {
+    HtmlNode html_node;
+    html_node.nodeId = tree_iter.get_node_id_data_holder();
+    html_node.nodeName = tree_iter.get_node_name();
+    html_node.htmlFilename = _get_html_filename(tree_iter);
+    html_node.isText = tree_iter.get_node_is_text();
+    if (html_node.isText) {
+        std::list<CtAnchoredWidget*> widgets = tree_iter.get_anchored_widgets(sel_start, sel_end);
+        int start_offset = sel_start == -1 ? 0 : sel_start;
+        for (CtAnchoredWidget* pWidget : widgets) {
+            const int end_offset = pWidget->getOffset();
+            html_node.slots.push_back(html_snapshot_slot(_pCtConfig, _pCtMainWin, start_offset, end_offset, pTextBuffer, false/*single_file*/));
+            try {
+                html_node.widgets.push_back(_html_snapshot_widget(pWidget, false/*single_file*/));
+            }
+            catch (std::exception& ex) {
+                spdlog::debug("caught ex: {}", ex.what());
+                html_node.widgets.push_back(HtmlWidget{});
+            }
+            catch (...) {
+                spdlog::debug("unknown ex");
+                html_node.widgets.push_back(HtmlWidget{});
+            }
+            start_offset = end_offset;
+        }
+        html_node.slots.push_back(html_snapshot_slot(_pCtConfig, _pCtMainWin, start_offset, sel_end, pTextBuffer, false/*single_file*/));
+        Gtk::TextIter start_iter = pTextBuffer->get_iter_at_offset(sel_start == -1 ? 0 : sel_start);
+        Gtk::TextIter end_iter = sel_end == -1 ? pTextBuffer->end() : pTextBuffer->get_iter_at_offset(sel_end);
+        html_node.text = start_iter.get_text(end_iter);
+    }
+    else {
+        html_node.codeRuns = _html_snapshot_code_buffer(pTextBuffer, sel_start, sel_end, tree_iter.get_node_syntax_highlighting());
+    }
+    return html_node;
+}
+
+// no GTK here, can run on a worker thread
+void CtExport2Html::_html_render_node_page(const HtmlNode& html_node, const CtExportOptions& options, const bool with_index) const
+{
+    Glib::ustring html_text = str::format(HTML_HEADER, html_node.nodeName.raw());
+    if (with_index and options.index_in_page) {
         auto script = R"HTML(
             <script type='text/javascript'>
                 function in_frame () { try { return window.self !== window.top; } catch (e) { return true; } }
@@ -101,26 +147,16 @@ void CtExport2Html::node_export_to_html(CtTreeIter tree_iter,
     }
     html_text += "<div class='page'>";
     if (options.include_node_name) {
-        html_text += "<h1 class='title'>" + tree_iter.get_node_name() + "</h1><br/>";
+        html_text += "<h1 class='title'>" + html_node.nodeName + "</h1><br/>";
     }
-    std::vector<Glib::ustring> html_slots;
-    std::vector<CtAnchoredWidget*> widgets;
-    if (tree_iter.get_node_is_text()) {
+    if (html_node.isText) {
         Glib::ustring node_html_text;
-        _html_get_from_treestore_node(tree_iter, sel_start, sel_end, html_slots, widgets, false/*single_file*/);
         int images_count{0};
-        for (size_t i = 0; i < html_slots.size(); ++i) {
-            node_html_text += html_slots[i];
-            if (i < widgets.size()) {
+        for (size_t i = 0; i < html_node.slots.size(); ++i) {
+            node_html_text += html_render_slot(html_node.slots[i]);
+            if (i < html_node.widgets.size()) {
                 try {
-                    if (auto embfile = dynamic_cast<CtImageEmbFile*>(widgets[i]))
-                        node_html_text += _get_embfile_html(embfile, tree_iter, _embed_dir);
-                    else if (auto image = dynamic_cast<CtImage*>(widgets[i]))
-                        node_html_text += _get_image_html(image, _images_dir, images_count, &tree_iter, false/*single_file*/);
-                    else if (auto table = dynamic_cast<CtTableCommon*>(widgets[i]))
-                        node_html_text += _get_table_html(table);
-                    else if (auto codebox = dynamic_cast<CtCodebox*>(widgets[i]))
-                        node_html_text += _get_codebox_html(codebox);
+                    node_html_text += _html_render_widget(html_node.widgets[i], html_node.nodeId, _images_dir, _embed_dir, images_count);
                 }
                 catch (std::exception& ex) {
                     spdlog::debug("caught ex: {}", ex.what());
@@ -130,11 +166,9 @@ void CtExport2Html::node_export_to_html(CtTreeIter tree_iter,
                 }
             }
         }
-        Gtk::TextIter start_iter = pTextBuffer->get_iter_at_offset(sel_start == -1 ? 0 : sel_start);
-        Gtk::TextIter end_iter = sel_end == -1 ? pTextBuffer->end() : pTextBuffer->get_iter_at_offset(sel_end);
         std::vector<Glib::ustring> node_lines = str::split(node_html_text, "\n");
         if (node_lines.size() > 0) {
-            std::vector<bool> rtl_for_lines = CtStrUtil::get_rtl_for_lines(start_iter.get_text(end_iter));
+            std::vector<bool> rtl_for_lines = CtStrUtil::get_rtl_for_lines(html_node.text);
             while (rtl_for_lines.size() < node_lines.size()) { rtl_for_lines.push_back(false); }
             const size_t lastIdx = node_lines.size() - 1;
             for (size_t i = 0; i <= lastIdx; ++i) {
@@ -146,16 +180,16 @@ void CtExport2Html::node_export_to_html(CtTreeIter tree_iter,
         }
     }
     else {
-        html_text += _html_get_from_code_buffer(pTextBuffer, sel_start, sel_end, tree_iter.get_node_syntax_highlighting());
+        html_text += _html_render_code_runs(html_node.codeRuns, false/*from_selection*/);
     }
-    if (not index.empty() and not options.index_in_page) {
+    if (with_index and not options.index_in_page) {
         html_text += Glib::ustring("<p align=\"center\">") + "<img src=\"" + Glib::build_filename("images", "home.svg") + "\" height=\"22\" width=\"22\">" +
                 CtConst::CHAR_SPACE + CtConst::CHAR_SPACE + "<a href=\"index.html\">" + _("Index") + "</a></p>";
     }
     html_text += "</div>"; // div class='page'
     html_text += HTML_FOOTER;
 
-    fs::path node_html_filepath = _export_dir / _get_html_filename(tree_iter);
+    fs::path node_html_filepath = _export_dir / html_node.htmlFilename;
     g_file_set_contents(node_html_filepath.c_str(), html_text.c_str(), (gssize)html_text.bytes(), nullptr);
 }
 
@@ -165,6 +199,62 @@ void CtExport2Html::nodes_all_export_to_multiple_html(bool all_tree,
     fs::path home_svg = fs::get_cherrytree_datadir() / fs::path("icons") / "ct_home.svg";
     fs::copy_file(home_svg, _images_dir / "home.svg");
 
+    std::vector<CtTreeIter> tree_iters;
+    std::function<void(CtTreeIter)> f_traverseFunc;
+    f_traverseFunc = [this, &f_traverseFunc, &tree_iters](CtTreeIter tree_iter) {
+        tree_iters.push_back(tree_iter);
+        for (auto child_iter = tree_iter->children().begin(); child_iter != tree_iter->children().end(); ++child_iter) {
+            f_traverseFunc(_pCtMainWin->get_tree_store().to_ct_tree_iter(child_iter));
+        }
+    };
+    CtTreeIter tree_iter = all_tree ? _pCtMainWin->get_tree_store().get_ct_iter_first() : _pCtMainWin->curr_tree_iter();
+    for (; tree_iter; ++tree_iter) {
+        f_traverseFunc(tree_iter);
+        if (not all_tree) break;
+    }
+
+    // the text buffers and widgets can only be accessed from the main thread: take a plain snapshot
+    // of a batch of nodes here, then the html rendering, image encoding and files writing happen in parallel.
+    // the batches are bounded not to hold the text, images and files of the whole tree at once
+    const size_t workers_num = std::max(1u, std::thread::hardware_concurrency());
+    const size_t batch_max_nodes = 8u*workers_num;
+    const size_t batch_max_bytes = 64u*1024u*1024u;
+    std::unordered_set<gint64> assets_node_ids; // the shared nodes write the images and files of their data holder once
+    std::vector<HtmlNode> html_nodes;
+    for (size_t iter_idx = 0; iter_idx < tree_iters.size(); ) {
+        size_t batch_bytes{0};
+        for (; iter_idx < tree_iters.size() and html_nodes.size() < batch_max_nodes and batch_bytes < batch_max_bytes; ++iter_idx) {
+            HtmlNode& html_node = html_nodes.emplace_back(_html_snapshot_node(tree_iters[iter_idx], -1, -1));
+            const bool write_assets = assets_node_ids.insert(html_node.nodeId).second;
+            batch_bytes += html_node.text.bytes();
+            for (HtmlWidget& html_widget : html_node.widgets) {
+                if (not write_assets) {
+                    html_widget.pBlob.reset();
+                    html_widget.rPixbuf.reset();
+                }
+                if (html_widget.pBlob) batch_bytes += html_widget.pBlob->size();
+                if (html_widget.rPixbuf) batch_bytes += (size_t)html_widget.rPixbuf->get_rowstride()*html_widget.rPixbuf->get_height();
+            }
+        }
+
+        // the nodes differ a lot in size, the workers pick the next one as soon as they are free
+        std::atomic<size_t> next_idx{0};
+        CtMiscUtil::parallel_for(0, std::min(workers_num, html_nodes.size()), [this, &html_nodes, &next_idx, &options](size_t/*worker_idx*/){
+            for (size_t idx = next_idx++; idx < html_nodes.size(); idx = next_idx++) {
+                try {
+                    _html_render_node_page(html_nodes[idx], options, true/*with_index*/);
+                }
+                catch (std::exception& ex) {
+                    spdlog::error("!! {} {} {}", __FUNCTION__, html_nodes[idx].htmlFilename.raw(), ex.what());
+                }
+                catch (...) {
+                    spdlog::error("!! {} {} unknown ex", __FUNCTION__, html_nodes[idx].htmlFilename.raw());
+                }
+            }
+        });
+        html_nodes.clear(); // release the pixbufs on the main thread
+    }
+
     // create tree links text
     Glib::ustring tree_links_text = // dont' use R"HTML, it gives unnecessary " "
           "<div class='tree'>\n"
@@ -173,7 +263,7 @@ void CtExport2Html::nodes_all_export_to_multiple_html(bool all_tree,
           "<button onclick='expandAllSubtrees()'>Expand All</button> <button onclick='collapseAllSubtrees()'>Collapse All</button>\n"
           "</p>\n"
           "<ul class='outermost'>\n";
-    CtTreeIter tree_iter = all_tree ? _pCtMainWin->get_tree_store().get_ct_iter_first() : _pCtMainWin->curr_tree_iter();
+    tree_iter = all_tree ? _pCtMainWin->get_tree_store().get_ct_iter_first() : _pCtMainWin->curr_tree_iter();
     for (; tree_iter; ++tree_iter) {
         _tree_links_text_iter(tree_iter, tree_links_text, 1, options.index_in_page);
         if (not all_tree) break;
@@ -197,22 +287,6 @@ void CtExport2Html::nodes_all_export_to_multiple_html(bool all_tree,
     html_text += HTML_FOOTER;
     fs::path node_html_filepath = _export_dir / "index.html";
     g_file_set_contents(node_html_filepath.c_str(), html_text.c_str(), (gssize)html_text.bytes(), nullptr);
-
-    // create html pages
-    // function to iterate nodes
-    std::function<void(CtTreeIter)> f_traverseFunc;
-    f_traverseFunc = [this, &f_traverseFunc, &options, &tree_links_text](CtTreeIter tree_iter) {
-        node_export_to_html(tree_iter, options, tree_links_text, -1, -1);
-        for (auto child_iter = tree_iter->children().begin(); child_iter != tree_iter->children().end(); ++child_iter) {
-            f_traverseFunc(_pCtMainWin->get_tree_store().to_ct_tree_iter(child_iter));
-        }
-    };
-    // start to iterarte nodes
-    tree_iter = all_tree ? _pCtMainWin->get_tree_store().get_ct_iter_first() : _pCtMainWin->curr_tree_iter();
-    for (; tree_iter; ++tree_iter) {
-        f_traverseFunc(tree_iter);
-        if (not all_tree) break;
-    }
 }
 
 void CtExport2Html::nodes_all_export_to_single_html(bool all_tree, const CtExportOptions&)
@@ -325,7 +399,9 @@ void CtExport2Html::_tree_links_text_iter(CtTreeIter tree_iter,
     }
 }
 
-Glib::ustring CtExport2Html::selection_export_to_html(Glib::RefPtr<Gtk::TextBuffer> text_buffer,
+// an invalid tree_iter stands for a selection without anchored widgets
+Glib::ustring CtExport2Html::selection_export_to_html(CtTreeIter tree_iter,
+                                                      Glib::RefPtr<Gtk::TextBuffer> text_buffer,
                                                       Gtk::TextIter start_iter,
                                                       Gtk::TextIter end_iter,
                                                       const Glib::ustring& syntax_highlighting)
@@ -336,7 +412,10 @@ Glib::ustring CtExport2Html::selection_export_to_html(Glib::RefPtr<Gtk::TextBuff
         int images_count{0};
         fs::path tempFolder = _pCtMainWin->get_ct_tmp()->getHiddenDirPath("IMAGE_TEMP_FOLDER");
         int start_offset = start_iter.get_offset();
-        std::list<CtAnchoredWidget*> widgets = _pCtMainWin->curr_tree_iter().get_anchored_widgets(start_iter.get_offset(), end_iter.get_offset());
+        std::list<CtAnchoredWidget*> widgets;
+        if (tree_iter) {
+            widgets = tree_iter.get_anchored_widgets(start_iter.get_offset(), end_iter.get_offset());
+        }
         for (CtAnchoredWidget* widget : widgets) {
             int end_offset = widget->getOffset();
             node_html_text += html_process_slot(_pCtConfig, _pCtMainWin, start_offset, end_offset, text_buffer, false/*single_file*/);
@@ -387,19 +466,103 @@ Glib::ustring CtExport2Html::codebox_export_to_html(CtCodebox* codebox)
     return html_text;
 }
 
+CtExport2Html::HtmlWidget CtExport2Html::_html_snapshot_widget(CtAnchoredWidget* pWidget, const bool single_file)
+{
+    HtmlWidget html_widget;
+    html_widget.justification = pWidget->getJustification();
+    if (auto embfile = dynamic_cast<CtImageEmbFile*>(pWidget)) {
+        html_widget.type = HtmlWidget::Type::EmbFile;
+        html_widget.text = embfile->get_file_name().string();
+        html_widget.pBlob = embfile->get_blob();
+    }
+    else if (auto imageAnchor = dynamic_cast<CtImageAnchor*>(pWidget)) {
+        html_widget.type = HtmlWidget::Type::Anchor;
+        html_widget.text = imageAnchor->get_anchor_name();
+    }
+    else if (auto image = dynamic_cast<CtImage*>(pWidget)) {
+        html_widget.type = HtmlWidget::Type::Image;
+        html_widget.rPixbuf = image->get_pixbuf();
+        CtImagePng* png = dynamic_cast<CtImagePng*>(image);
+        if (png and not png->get_link().empty()) {
+            html_widget.text = _get_href_from_link_prop_val(_pCtMainWin, png->get_link(), single_file);
+        }
+    }
+    else if (auto table = dynamic_cast<CtTableCommon*>(pWidget)) {
+        html_widget.type = HtmlWidget::Type::Table;
+        table->write_strings_matrix(html_widget.rows);
+    }
+    else if (auto codebox = dynamic_cast<CtCodebox*>(pWidget)) {
+        html_widget.type = HtmlWidget::Type::Codebox;
+        html_widget.codeRuns = _html_snapshot_code_buffer(codebox->get_buffer(), -1, -1, codebox->get_syntax_highlighting());
+    }
+    return html_widget;
+}
+
+// no GTK here, can run on a worker thread
+Glib::ustring CtExport2Html::_html_render_widget(const HtmlWidget& html_widget,
+                                                 const gint64 node_id,
+                                                 const fs::path& images_dir,
+                                                 const fs::path& embed_dir,
+                                                 int& images_count) const
+{
+    switch (html_widget.type) {
+        case HtmlWidget::Type::EmbFile: {
+            Glib::ustring embfile_align_text = _get_object_alignment_string(html_widget.justification);
+            fs::path embfile_name = std::to_string(node_id) + "-" + html_widget.text.raw();
+            fs::path embfile_rel_path = "EmbeddedFiles" / embfile_name;
+            Glib::ustring embfile_html = "<table style=\"" + embfile_align_text + "\"><tr><td><a href=\"" +
+                    embfile_rel_path.string_unix() + "\">Linked file: " + html_widget.text + " </a></td></tr></table>";
+
+            if (html_widget.pBlob) {
+                html_widget.pBlob->write_to_file(embed_dir / embfile_name);
+            }
+
+            return embfile_html;
+        }
+        case HtmlWidget::Type::Anchor: {
+            return "<a name=\"" + html_widget.text + "\"></a>";
+        }
+        case HtmlWidget::Type::Image: {
+            images_count += 1;
+            Glib::ustring image_name, image_rel_path;
+            if (node_id >= 0) {
+                image_name = std::to_string(node_id) + "-" + std::to_string(images_count) + ".png";
+                image_rel_path = (fs::path{"images"} / image_name).string_unix();
+            }
+            else {
+                image_name = std::to_string(images_count) + ".png";
+                image_rel_path = "file://" + (images_dir / image_name).string_unix();
+            }
+
+            Glib::ustring image_html = "<img src=\"" + image_rel_path + "\" alt=\"" + image_rel_path + "\" />";
+            if (not html_widget.text.empty()) {
+                image_html = "<a href=\"" + html_widget.text + "\">" + image_html + "</a>";
+            }
+
+            if (html_widget.rPixbuf) {
+                html_widget.rPixbuf->save((images_dir / image_name).string(), "png");
+            }
+            return image_html;
+        }
+        case HtmlWidget::Type::Table: {
+            return _get_table_html(html_widget.rows);
+        }
+        case HtmlWidget::Type::Codebox: {
+            return "<div class=\"codebox\">" + _html_render_code_runs(html_widget.codeRuns, false/*from_selection*/) + "</div>";
+        }
+        case HtmlWidget::Type::None:
+            break;
+    }
+    return "";
+}
+
 Glib::ustring CtExport2Html::_get_embfile_html(CtImageEmbFile* embfile,
                                                CtTreeIter tree_iter,
                                                fs::path embed_dir)
 {
-    Glib::ustring embfile_align_text = _get_object_alignment_string(embfile->getJustification());
-    fs::path embfile_name = std::to_string(tree_iter.get_node_id_data_holder()) + "-" +  embfile->get_file_name().string();
-    fs::path embfile_rel_path = "EmbeddedFiles" / embfile_name;
-    Glib::ustring embfile_html = "<table style=\"" + embfile_align_text + "\"><tr><td><a href=\"" +
-            embfile_rel_path.string_unix() + "\">Linked file: " + embfile->get_file_name().string() + " </a></td></tr></table>";
-
-    g_file_set_contents((embed_dir / embfile_name).c_str(), embfile->get_raw_blob().c_str(), (gssize)embfile->get_raw_blob().size(), nullptr);
-
-    return embfile_html;
+    int images_count{0};
+    return _html_render_widget(_html_snapshot_widget(embfile, false/*single_file*/),
+                               tree_iter.get_node_id_data_holder(), _images_dir, embed_dir, images_count);
 }
 
 Glib::ustring CtExport2Html::_get_image_html(CtImage* image,
@@ -408,29 +571,8 @@ Glib::ustring CtExport2Html::_get_image_html(CtImage* image,
                                              CtTreeIter* pCtTreeIter,
                                              const bool single_file)
 {
-    if (CtImageAnchor* imageAnchor = dynamic_cast<CtImageAnchor*>(image)) {
-        return "<a name=\"" + imageAnchor->get_anchor_name() + "\"></a>";
-    }
-    images_count += 1;
-    Glib::ustring image_name, image_rel_path;
-    if (pCtTreeIter) {
-        image_name = std::to_string(pCtTreeIter->get_node_id_data_holder()) + "-" + std::to_string(images_count) + ".png";
-        image_rel_path = (fs::path{"images"} / image_name).string_unix();
-    }
-    else {
-        image_name = std::to_string(images_count) + ".png";
-        image_rel_path = "file://" + (images_dir / image_name).string_unix();
-    }
-
-    Glib::ustring image_html = "<img src=\"" + image_rel_path + "\" alt=\"" + image_rel_path + "\" />";
-    CtImagePng* png = dynamic_cast<CtImagePng*>(image);
-    if (png and not png->get_link().empty()) {
-        Glib::ustring href = _get_href_from_link_prop_val(_pCtMainWin, png->get_link(), single_file);
-        image_html = "<a href=\"" + href + "\">" + image_html + "</a>";
-    }
-
-    image->save(images_dir / image_name, "png");
-    return image_html;
+    return _html_render_widget(_html_snapshot_widget(image, single_file),
+                               pCtTreeIter ? pCtTreeIter->get_node_id_data_holder() : -1, images_dir, _embed_dir, images_count);
 }
 
 Glib::ustring CtExport2Html::_get_codebox_html(CtCodebox* codebox)
@@ -445,6 +587,11 @@ Glib::ustring CtExport2Html::_get_table_html(CtTableCommon* table)
 {
     std::vector<std::vector<Glib::ustring>> rows;
     table->write_strings_matrix(rows);
+    return _get_table_html(rows);
+}
+
+/*static*/Glib::ustring CtExport2Html::_get_table_html(const std::vector<std::vector<Glib::ustring>>& rows)
+{
     Glib::ustring table_html = "<table class=\"table\">";
     bool first{true};
     for (const auto& row : rows) {
@@ -474,21 +621,35 @@ Glib::ustring CtExport2Html::_html_get_from_code_buffer(const Glib::RefPtr<Gtk::
                                                         int sel_end,
                                                         const std::string& syntax_highlighting,
                                                         const bool from_selection/*=false*/)
+{
+    return _html_render_code_runs(_html_snapshot_code_buffer(code_buffer, sel_start, sel_end, syntax_highlighting), from_selection);
+}
+
+std::vector<CtExport2Html::HtmlCodeRun> CtExport2Html::_html_snapshot_code_buffer(const Glib::RefPtr<Gtk::TextBuffer>& code_buffer,
+                                                                                  int sel_start,
+                                                                                  int sel_end,
+                                                                                  const std::string& syntax_highlighting)
 {
     Gtk::TextIter curr_iter = sel_start >= 0 ? code_buffer->get_iter_at_offset(sel_start) : code_buffer->begin();
     Gtk::TextIter end_iter = sel_end >= 0 ? code_buffer->get_iter_at_offset(sel_end) : code_buffer->end();
 
     _pCtMainWin->apply_syntax_highlighting(code_buffer, syntax_highlighting, false/*forceReApply*/);
-    gtk_source_buffer_ensure_highlight(GTK_SOURCE_BUFFER(code_buffer->gobj()), curr_iter.gobj(), end_iter.gobj());
+    if (CtRegionHighlighter* pCtRegionHighlighter = CtRegionHighlighter::get(code_buffer)) {
+        (void)pCtRegionHighlighter->highlight_lines(curr_iter.get_line(), end_iter.get_line(), 0/*no limit*/);
+    }
+    else {
+        gtk_source_buffer_ensure_highlight(GTK_SOURCE_BUFFER(code_buffer->gobj()), curr_iter.gobj(), end_iter.gobj());
+    }
 
-    Glib::ustring html_text;
-    Glib::ustring former_tag_str = CtConst::COLOR_48_BLACK;
-    bool span_opened = false;
+    // a new run starts whenever the foreground colour changes, the font weight is the one at the start of the run
+    std::vector<HtmlCodeRun> code_runs;
+    Glib::ustring former_tag_str;
     for (;;) {
+        Glib::ustring curr_tag_str{CtConst::COLOR_48_BLACK};
+        int font_weight{0};
         std::vector<Glib::RefPtr<Gtk::TextTag>> curr_tags = curr_iter.get_tags();
         if (curr_tags.size() > 0) {
-            Glib::ustring curr_tag_str{CtConst::COLOR_48_BLACK};
-            int font_weight = curr_tags[0]->property_weight().get_value();
+            font_weight = curr_tags[0]->property_weight().get_value();
             for (auto& curr_tag : curr_tags) {
                 if (curr_tag->property_foreground_set()) {
                     Glib::ustring tmpTagStr = curr_tag->property_foreground_rgba().get_value().to_string();
@@ -497,51 +658,43 @@ Glib::ustring CtExport2Html::_html_get_from_code_buffer(const Glib::RefPtr<Gtk::
                         font_weight = curr_tag->property_weight().get_value();
                         break;
                     }
-#if 0
-                    spdlog::debug("{} TAG FG={} BG={} WEIGHT={}", curr_iter.get_offset(),
-                        curr_tag->property_foreground_rgba().get_value().to_string().c_str(),
-                        curr_tag->property_background_rgba().get_value().to_string().c_str(),
-                        curr_tag->property_weight().get_value());
-#endif
-                }
-            }
-            if (curr_tag_str == CtConst::COLOR_48_BLACK) {
-                if (former_tag_str != curr_tag_str) {
-                    former_tag_str = curr_tag_str;
-                    // end of tag
-                    html_text += "</span>";
-                    span_opened = false;
-                }
-            }
-            else {
-                if (former_tag_str != curr_tag_str) {
-                    former_tag_str = curr_tag_str;
-                    if (span_opened) html_text += "</span>";
-                    // start of tag
-                    Glib::ustring color = CtRgbUtil::rgb_to_no_white(curr_tag_str);
-                    color = CtRgbUtil::get_rgb24str_from_str_any(color);
-                    html_text += "<span style=\"color:" + color + ";font-weight:" + std::to_string(font_weight) + "\">";
-                    span_opened = true;
                 }
             }
         }
-        else if (span_opened) {
-            span_opened = false;
-            former_tag_str = CtConst::COLOR_48_BLACK;
-            html_text += "</span>";
+        if (code_runs.empty() or former_tag_str != curr_tag_str) {
+            former_tag_str = curr_tag_str;
+            HtmlCodeRun& code_run = code_runs.emplace_back();
+            if (curr_tag_str != CtConst::COLOR_48_BLACK) {
+                code_run.color = CtRgbUtil::get_rgb24str_from_str_any(CtRgbUtil::rgb_to_no_white(curr_tag_str));
+                code_run.fontWeight = font_weight;
+            }
         }
-        Glib::ustring sym = str::xml_escape(Glib::ustring(1, curr_iter.get_char()));
-        html_text += sym;
+        code_runs.back().text += curr_iter.get_char();
         if (not curr_iter.forward_char() || (sel_end >= 0 && curr_iter.get_offset() >= sel_end)) {
-            if (span_opened) html_text += "</span>";
             break;
         }
     }
+    return code_runs;
+}
+
+// no GTK here, can run on a worker thread
+/*static*/Glib::ustring CtExport2Html::_html_render_code_runs(const std::vector<HtmlCodeRun>& code_runs, const bool from_selection)
+{
+    Glib::ustring html_text;
+    for (const HtmlCodeRun& code_run : code_runs) {
+        if (code_run.color.empty()) {
+            html_text += str::xml_escape(code_run.text);
+        }
+        else {
+            html_text += "<span style=\"color:" + code_run.color + ";font-weight:" + std::to_string(code_run.fontWeight) + "\">";
+            html_text += str::xml_escape(code_run.text);
+            html_text += "</span>";
+        }
+    }
 
     html_text = str::replace(html_text, CtConst::CHAR_NEWLINE, "<br />");
     if (from_selection) html_text = "<pre style=\"display:inline;\">" + html_text + "</pre>";
     else html_text = "<pre>" + html_text + "</pre>";
-    //spdlog::debug("{}", html_text);
     return html_text;
 }
 
@@ -724,48 +877,81 @@ void CtExport2Html::_html_get_from_treestore_node(CtTreeIter tree_iter,
                                                          Glib::RefPtr<Gtk::TextBuffer> curr_buffer,
                                                          const bool single_file)
 {
-    Glib::ustring curr_html_text;
+    return html_render_slot(html_snapshot_slot(pCtConfig, pCtMainWin, start_offset, end_offset, curr_buffer, single_file));
+}
+
+/*static*/CtExport2Html::HtmlSlot CtExport2Html::html_snapshot_slot(const CtConfig* const pCtConfig,
+                                                                    CtMainWin* const pCtMainWin, // the unit tests may pass nullptr here!
+                                                                    int start_offset,
+                                                                    int end_offset,
+                                                                    Glib::RefPtr<Gtk::TextBuffer> curr_buffer,
+                                                                    const bool single_file)
+{
+    HtmlSlot html_slot;
     CtListInfo curr_list_info;
     std::list<CtListType> nested_list_types;
-    CtTextIterUtil::SerializeFunc f_html_serialise = [&](Gtk::TextIter& start_iter,
-                                                         Gtk::TextIter& curr_iter,
-                                                         CtCurrAttributesMap& curr_attributes,
-                                                         CtListInfo* pCurrListInfo)
+    CtTextIterUtil::SerializeFunc f_html_snapshot = [&](Gtk::TextIter& start_iter,
+                                                        Gtk::TextIter& curr_iter,
+                                                        CtCurrAttributesMap& curr_attributes,
+                                                        CtListInfo* pCurrListInfo)
     {
         //spdlog::debug("'{}' t={} s={} l={} c={} n={}", start_iter.get_text(curr_iter), static_cast<int>(pCurrListInfo->type),
         //    pCurrListInfo->startoffs, pCurrListInfo->level, pCurrListInfo->count_nl, pCurrListInfo->num_seq);
-        Glib::ustring list_html_tags;
-        const int forward_start = _html_process_list_info_change(list_html_tags, nested_list_types, &curr_list_info, pCurrListInfo);
-        //spdlog::debug("fw={} +'{}'", forward_start, list_html_tags.raw());
-        if (list_html_tags.size() > 0) curr_html_text += list_html_tags;
+        HtmlTextRun& html_run = html_slot.runs.emplace_back();
+        const int forward_start = _html_process_list_info_change(html_run.listHtmlTags, nested_list_types, &curr_list_info, pCurrListInfo);
+        //spdlog::debug("fw={} +'{}'", forward_start, html_run.listHtmlTags.raw());
         if (forward_start > 0) {
             while ('\n' == start_iter.get_char()) {
                 if (not start_iter.forward_char()) break;
             }
             start_iter.forward_chars(forward_start);
         }
-        const Glib::ustring html_slot = _html_text_serialize(pCtMainWin, start_iter, curr_iter, curr_attributes, single_file);
-        //spdlog::debug("slot({})='{}'", html_slot.size(), html_slot.raw());
-        curr_html_text += html_slot;
+        html_run.text = start_iter.get_text(curr_iter);
+        for (auto tag_property : CtConst::TAG_PROPERTIES) {
+            const std::string& property_value = curr_attributes.at(tag_property);
+            if (property_value.empty()) {
+                continue;
+            }
+            if (tag_property == CtConst::TAG_LINK) {
+                // <a href="http://www.example.com/">link-text goes here</a>
+                if (pCtMainWin) {
+                    html_run.href = _get_href_from_link_prop_val(pCtMainWin, property_value, single_file);
+                }
+                continue;
+            }
+            html_run.attributes.emplace_back(tag_property, property_value);
+        }
     };
-    CtTextIterUtil::generic_process_slot(pCtConfig, start_offset, end_offset, curr_buffer, f_html_serialise, true/*list_info*/);
+    CtTextIterUtil::generic_process_slot(pCtConfig, start_offset, end_offset, curr_buffer, f_html_snapshot, true/*list_info*/);
+
+    CtListInfo list_info_none;
+    (void)_html_process_list_info_change(html_slot.listHtmlTagsEnd, nested_list_types, &curr_list_info, &list_info_none);
+
+    return html_slot;
+}
+
+// no GTK here, can run on a worker thread
+/*static*/Glib::ustring CtExport2Html::html_render_slot(const HtmlSlot& html_slot)
+{
+    Glib::ustring curr_html_text;
+    for (const HtmlTextRun& html_run : html_slot.runs) {
+        curr_html_text += html_run.listHtmlTags;
+        const Glib::ustring html_text = _html_text_serialize(html_run);
+        //spdlog::debug("slot({})='{}'", html_text.size(), html_text.raw());
+        curr_html_text += html_text;
+    }
 
     for (auto header : {CtConst::TAG_PROP_VAL_H1, CtConst::TAG_PROP_VAL_H2, CtConst::TAG_PROP_VAL_H3,
                         CtConst::TAG_PROP_VAL_H4, CtConst::TAG_PROP_VAL_H5, CtConst::TAG_PROP_VAL_H6})
     {
         curr_html_text = str::replace(curr_html_text, ("</" + Glib::ustring{header} + "><" + Glib::ustring{header} + " >").c_str(), "");
     }
-    CtListInfo list_info_none;
-    (void)_html_process_list_info_change(curr_html_text, nested_list_types, &curr_list_info, &list_info_none);
+    curr_html_text += html_slot.listHtmlTagsEnd;
 
     return curr_html_text;
 }
 
-/*static*/Glib::ustring CtExport2Html::_html_text_serialize(CtMainWin* const pCtMainWin, // the unit tests may pass nullptr here!
-                                                            Gtk::TextIter start_iter,
-                                                            Gtk::TextIter end_iter,
-                                                            const CtCurrAttributesMap& curr_attributes,
-                                                            const bool single_file)
+/*static*/Glib::ustring CtExport2Html::_html_text_serialize(const HtmlTextRun& html_run)
 {
     Glib::ustring html_attrs;
     bool superscript_active{false};
@@ -774,12 +960,10 @@ void CtExport2Html::_html_get_from_treestore_node(CtTreeIter tree_iter,
     bool bold_active{false};
     bool italic_active{false};
     Glib::ustring hN_active;
-    Glib::ustring href;
-    for (auto tag_property : CtConst::TAG_PROPERTIES) {
-        if (curr_attributes.at(tag_property).empty()) {
-            continue;
-        }
-        Glib::ustring property_value = curr_attributes.at(tag_property);
+    const Glib::ustring& href = html_run.href;
+    for (const auto& attribute : html_run.attributes) {
+        std::string_view tag_property = attribute.first;
+        Glib::ustring property_value = attribute.second;
         if (tag_property == CtConst::TAG_WEIGHT) {
             // font-weight:bolder
             // tag_property = "font-weight"
@@ -851,19 +1035,12 @@ void CtExport2Html::_html_get_from_treestore_node(CtTreeIter tree_iter,
             // tag_property = "text-align"
             continue;
         }
-        else if (tag_property == CtConst::TAG_LINK) {
-            // <a href="http://www.example.com/">link-text goes here</a>
-            if (pCtMainWin) {
-                href = _get_href_from_link_prop_val(pCtMainWin, property_value, single_file);
-            }
-            continue;
-        }
         html_attrs += Glib::ustring{tag_property.data()} + ":" + property_value + ";";
     }
 
     // split by \n to support RTL lines
     Glib::ustring html_text;
-    std::vector<Glib::ustring> lines = str::split(start_iter.get_text(end_iter), "\n");
+    std::vector<Glib::ustring> lines = str::split(html_run.text, "\n");
     const size_t lastIdx = lines.size() - 1;
     for (size_t i = 0; i < lines.size(); ++i) {
         Glib::ustring tagged_text = str::xml_escape(lines[i]);
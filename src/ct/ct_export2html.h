@@ -1,7 +1,7 @@
 /*
  * ct_export2html.h
  *
- * Copyright 2009-2024
+ * Copyright 2009-2025
  * Giuseppe Penone <giuspen@gmail.com>
  * Evgenii Gurianov <https://github.com/txe>
  *
@@ -49,8 +49,57 @@ private:
 )HTML";
 
 public:
+    // plain representation of a rich text slot, taken on the main thread and rendered without GTK
+    struct HtmlTextRun
+    {
+        Glib::ustring listHtmlTags; // list tags to open/close before the text
+        Glib::ustring text;         // already deprived of the list leading chars
+        std::vector<std::pair<std::string_view, std::string>> attributes; // only the set ones, link excluded
+        std::string   href;         // link attribute already resolved
+    };
+    struct HtmlSlot
+    {
+        std::vector<HtmlTextRun> runs;
+        Glib::ustring listHtmlTagsEnd;
+    };
+    struct HtmlCodeRun
+    {
+        Glib::ustring text;
+        std::string   color; // rgb24, empty for the default
+        int           fontWeight{0};
+    };
+    struct HtmlWidget
+    {
+        enum class Type { None, EmbFile, Image, Anchor, Table, Codebox };
+        Type                      type{Type::None};
+        Glib::ustring             text; // EmbFile: file name, Image: link href, Anchor: anchor name
+        std::string               justification;
+        CtEmbFileBlobPtr          pBlob;   // not set if already written by another node sharing the data holder
+        Glib::RefPtr<Gdk::Pixbuf> rPixbuf; // not set if already written by another node sharing the data holder
+        std::vector<std::vector<Glib::ustring>> rows;
+        std::vector<HtmlCodeRun>  codeRuns;
+    };
+    struct HtmlNode
+    {
+        gint64                    nodeId;
+        Glib::ustring             nodeName;
+        Glib::ustring             htmlFilename;
+        bool                      isText;
+        Glib::ustring             text;     // rich text: to detect the rtl lines
+        std::vector<HtmlSlot>     slots;    // rich text: one more than the widgets
+        std::vector<HtmlWidget>   widgets;  // rich text
+        std::vector<HtmlCodeRun>  codeRuns; // code
+    };
+
     CtExport2Html(CtMainWin* pCtMainWin);
 
+    static HtmlSlot html_snapshot_slot(const CtConfig* const pCtConfig,
+                                       CtMainWin* const pCtMainWin, // the unit tests may pass nullptr here!
+                                       int start_offset,
+                                       int end_offset,
+                                       Glib::RefPtr<Gtk::TextBuffer> curr_buffer,
+                                       const bool single_file);
+    static Glib::ustring html_render_slot(const HtmlSlot& html_slot);
     static Glib::ustring html_process_slot(const CtConfig* const pCtConfig,
                                            CtMainWin* const pCtMainWin, // the unit tests may pass nullptr here!
                                            int start_offset,
@@ -61,13 +110,22 @@ public:
     void          node_export_to_html(CtTreeIter tree_iter, const CtExportOptions& options, const Glib::ustring& index, int sel_start, int sel_end);
     void          nodes_all_export_to_multiple_html(bool all_tree, const CtExportOptions& options);
     void          nodes_all_export_to_single_html(bool all_tree, const CtExportOptions& options);
-    Glib::ustring selection_export_to_html(Glib::RefPtr<Gtk::TextBuffer> text_buffer, Gtk::TextIter start_iter,
+    Glib::ustring selection_export_to_html(CtTreeIter tree_iter, Glib::RefPtr<Gtk::TextBuffer> text_buffer, Gtk::TextIter start_iter,
                                            Gtk::TextIter end_iter, const Glib::ustring& syntax_highlighting);
     Glib::ustring table_export_to_html(CtTableCommon* table);
     Glib::ustring codebox_export_to_html(CtCodebox* codebox);
     bool          prepare_html_folder(fs::path dir_place, fs::path new_folder, bool export_overwrite, fs::path& export_path);
 
 private:
+    HtmlNode _html_snapshot_node(CtTreeIter tree_iter, int sel_start, int sel_end);
+    HtmlWidget _html_snapshot_widget(CtAnchoredWidget* pWidget, const bool single_file);
+    void _html_render_node_page(const HtmlNode& html_node, const CtExportOptions& options, const bool with_index) const;
+    Glib::ustring _html_render_widget(const HtmlWidget& html_widget,
+                                      const gint64 node_id, // -1 for no node, the image is then referenced by absolute path
+                                      const fs::path& images_dir,
+                                      const fs::path& embed_dir,
+                                      int& images_count) const;
+
     Glib::ustring _get_embfile_html(CtImageEmbFile* embfile, CtTreeIter tree_iter, fs::path embed_dir);
     Glib::ustring _get_image_html(CtImage* image,
                                   const fs::path& images_dir,
@@ -76,7 +134,13 @@ private:
                                   const bool single_file);
     Glib::ustring _get_codebox_html(CtCodebox* codebox);
     Glib::ustring _get_table_html(CtTableCommon* table);
+    static Glib::ustring _get_table_html(const std::vector<std::vector<Glib::ustring>>& rows);
 
+    std::vector<HtmlCodeRun> _html_snapshot_code_buffer(const Glib::RefPtr<Gtk::TextBuffer>& code_buffer,
+                                                        int sel_start,
+                                                        int sel_end,
+                                                        const std::string& syntax_highlighting);
+    static Glib::ustring _html_render_code_runs(const std::vector<HtmlCodeRun>& code_runs, const bool from_selection);
     Glib::ustring _html_get_from_code_buffer(const Glib::RefPtr<Gtk::TextBuffer>& code_buffer,
                                              int sel_start,
                                              int sel_end,
@@ -92,15 +156,11 @@ private:
                                               std::list<CtListType>& nested_list_types,
                                               CtListInfo* pListInfoFrom,
                                               const CtListInfo* pListInfoTo);
-    static Glib::ustring _html_text_serialize(CtMainWin* const pCtMainWin, // the unit tests may pass nullptr here!
-                                              Gtk::TextIter start_iter,
-                                              Gtk::TextIter end_iter,
-                                              const CtCurrAttributesMap& curr_attributes,
-                                              const bool single_file);
+    static Glib::ustring _html_text_serialize(const HtmlTextRun& html_run);
     static std::string _get_href_from_link_prop_val(CtMainWin* const pCtMainWin,
                                                     const Glib::ustring& link_prop_val,
                                                     const bool single_file);
-    Glib::ustring _get_object_alignment_string(Glib::ustring alignment);
+    static Glib::ustring _get_object_alignment_string(Glib::ustring alignment);
 
     void _tree_links_text_iter(CtTreeIter tree_iter, Glib::ustring& tree_links_text, int tree_count_level, bool index_in_page);
 
@@ -23,7 +23,11 @@
 
 #include "ct_export2pdf.h"
 #include "ct_dialogs.h"
+#include "ct_misc_utils.h"
 #include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace {
 
@@ -35,6 +39,22 @@ Glib::ustring generate_tag(gint64 node_id, const Glib::ustring& anchor_name)
     return fmt::format("n.{}.{}", node_id, std::hash<std::string>{}(anchor_name.raw()));
 }
 
+// a font map is not thread safe, so every chunk of pages gets its own one
+// (used by the worker while laying out, then by the main thread while drawing)
+Glib::RefPtr<Pango::Context> new_pdf_pango_context()
+{
+    PangoFontMap* pFontMap = pango_cairo_font_map_new();
+    PangoContext* pContext = pango_font_map_create_context(pFontMap);
+    g_object_unref(pFontMap); // the context keeps its reference
+    // like the context of a print operation: no hinting of the metrics, points as units
+    cairo_font_options_t* pFontOptions = cairo_font_options_create();
+    cairo_font_options_set_hint_metrics(pFontOptions, CAIRO_HINT_METRICS_OFF);
+    pango_cairo_context_set_font_options(pContext, pFontOptions);
+    cairo_font_options_destroy(pFontOptions);
+    pango_cairo_context_set_resolution(pContext, 72.0);
+    return Glib::wrap(pContext);
+}
+
 } // namespace (anonymous)
 
 CtExport2Pango::CtExport2Pango(CtMainWin* pCtMainWin)
@@ -95,7 +115,12 @@ Glib::ustring CtExport2Pango::pango_get_from_code_buffer(Glib::RefPtr<Gtk::TextB
     bool indentation_force_spaces{false};
     if (syntax_highlighting != CtConst::PLAIN_TEXT_ID) {
         _pCtMainWin->apply_syntax_highlighting(code_buffer, syntax_highlighting, false/*forceReApply*/);
-        gtk_source_buffer_ensure_highlight(GTK_SOURCE_BUFFER(code_buffer->gobj()), curr_iter.gobj(), end_iter.gobj());
+        if (CtRegionHighlighter* pCtRegionHighlighter = CtRegionHighlighter::get(code_buffer)) {
+            (void)pCtRegionHighlighter->highlight_lines(curr_iter.get_line(), end_iter.get_line(), 0/*no limit*/);
+        }
+        else {
+            gtk_source_buffer_ensure_highlight(GTK_SOURCE_BUFFER(code_buffer->gobj()), curr_iter.gobj(), end_iter.gobj());
+        }
         indentation = str::repeat(CtConst::CHAR_SPACE, _pCtConfig->tabsWidth);
         indentation_force_spaces = true;
     }
@@ -527,6 +552,21 @@ void CtPrint::run_page_setup_dialog(Gtk::Window* pWin)
 // Start the Print Operations for Text
 void CtPrint::print_text(const fs::path& pdf_filepath, const std::vector<CtPangoObjectPtr>& slots)
 {
+    if (not pdf_filepath.empty()) {
+        Glib::ustring warning;
+        try {
+            if (not export_pdf(pdf_filepath, slots, warning)) {
+                CtDialogs::error_dialog("Error printing file: (bad res)", *_pCtMainWin);
+            }
+        }
+        catch (std::exception& ex) {
+            CtDialogs::error_dialog("Error printing file:\n" + str::xml_escape(ex.what()) + " (exception caught)", *_pCtMainWin);
+        }
+        if (not warning.empty())
+            _pCtMainWin->get_status_bar().update_status(warning);
+        return;
+    }
+
     CtPrintData print_data;
     print_data.slots = slots;
 
@@ -554,15 +594,14 @@ void CtPrint::print_text(const fs::path& pdf_filepath, const std::vector<CtPango
     print_data.operation->signal_begin_print().connect(sigc::bind(f_begin_print_text, &print_data));
     print_data.operation->signal_draw_page().connect(sigc::bind(f_draw_page_text, &print_data));
 #endif
-    print_data.operation->set_export_filename(pdf_filepath.string());
     try {
 #if GTKMM_MAJOR_VERSION >= 4
-        auto res = print_data.operation->run(!pdf_filepath.empty() ? Gtk::PrintOperation::Action::EXPORT : Gtk::PrintOperation::Action::PRINT_DIALOG);
+        auto res = print_data.operation->run(Gtk::PrintOperation::Action::PRINT_DIALOG);
         if (res == Gtk::PrintOperation::Result::ERROR)
             CtDialogs::error_dialog("Error printing file: (bad res)", *_pCtMainWin);
         else if (res == Gtk::PrintOperation::Result::APPLY)
 #else
-        auto res = print_data.operation->run(!pdf_filepath.empty() ? Gtk::PRINT_OPERATION_ACTION_EXPORT : Gtk::PRINT_OPERATION_ACTION_PRINT_DIALOG);
+        auto res = print_data.operation->run(Gtk::PRINT_OPERATION_ACTION_PRINT_DIALOG);
         if (res == Gtk::PRINT_OPERATION_RESULT_ERROR)
             CtDialogs::error_dialog("Error printing file: (bad res)", *_pCtMainWin);
         else if (res == Gtk::PRINT_OPERATION_RESULT_APPLY)
@@ -576,8 +615,162 @@ void CtPrint::print_text(const fs::path& pdf_filepath, const std::vector<CtPango
         _pCtMainWin->get_status_bar().update_status(print_data.warning);
 }
 
+bool CtPrint::export_pdf(const fs::path& pdf_filepath, const std::vector<CtPangoObjectPtr>& slots, Glib::ustring& warning)
+{
+#if GTKMM_MAJOR_VERSION >= 4
+    const Gtk::Unit unit = Gtk::Unit::POINTS;
+#else
+    const Gtk::Unit unit = Gtk::UNIT_POINTS;
+#endif
+    auto pSurface = Cairo::PdfSurface::create(pdf_filepath.string(), _pPageSetup->get_paper_width(unit), _pPageSetup->get_paper_height(unit));
+    auto pCairoContext = Cairo::Context::create(pSurface);
+    pCairoContext->translate(_pPageSetup->get_left_margin(unit), _pPageSetup->get_top_margin(unit));
+    _layout_setup(new_pdf_pango_context(), 72.0, _pPageSetup->get_page_width(unit), _pPageSetup->get_page_height(unit));
+
+    // the widgets are read here on the main thread, the workers only see the snapshot;
+    // a new page starts a chunk that can be laid out independently of the previous ones
+    CtPrintWidgetsSnapshot widgetsSnapshot;
+    std::list<Glib::ustring> cairo_names;
+    std::vector<size_t> chunksBegin{0};
+    for (size_t i = 0; i < slots.size(); ++i) {
+        CtPangoObject* slot = slots[i].get();
+        if (dynamic_cast<CtPangoNewPage*>(slot)) {
+            chunksBegin.push_back(i + 1);
+        }
+        else if (auto pango_dest = dynamic_cast<CtPangoDest*>(slot)) {
+            cairo_names.push_back(pango_dest->dest.substr(5)); // name='...'
+        }
+        else if (auto pango_widget = dynamic_cast<CtPangoWidget*>(slot)) {
+            if (auto codebox = dynamic_cast<const CtCodebox*>(pango_widget->widget)) {
+                widgetsSnapshot.codeboxes[codebox] = CtPrintWidgetsSnapshot::CodeboxData{
+                    CtExport2Pango{_pCtMainWin}.pango_get_from_code_buffer(codebox->get_buffer(), -1, -1, codebox->get_syntax_highlighting()),
+                    codebox->get_frame_width()};
+            }
+            else if (auto table = dynamic_cast<const CtTableCommon*>(pango_widget->widget)) {
+                table->write_strings_matrix(widgetsSnapshot.tables[table]);
+            }
+            else if (auto image = dynamic_cast<const CtImage*>(pango_widget->widget)) {
+                widgetsSnapshot.images[image] = image->get_pixbuf();
+            }
+        }
+    }
+
+    const size_t chunksNum = chunksBegin.size();
+    const size_t workersNum = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), chunksNum);
+    const size_t chunksWindow = 2 * workersNum; // laid out chunks waiting to be drawn, bounding the memory
+    std::vector<std::unique_ptr<CtPrintData>> chunks(chunksNum);
+    std::mutex chunksMutex;
+    std::condition_variable chunksCond;
+    size_t nextIdx{0};
+    size_t drawnIdx{0};
+    bool failed{false};
+
+    auto f_worker = [&](){
+        while (true) {
+            size_t idx;
+            {
+                std::unique_lock<std::mutex> lock{chunksMutex};
+                chunksCond.wait(lock, [&](){ return failed or nextIdx >= chunksNum or nextIdx < drawnIdx + chunksWindow; });
+                if (failed or nextIdx >= chunksNum) {
+                    return;
+                }
+                idx = nextIdx++;
+            }
+            auto pPrintData = std::make_unique<CtPrintData>();
+            pPrintData->pango_context = new_pdf_pango_context();
+            pPrintData->widgets_snapshot = &widgetsSnapshot;
+            // the new page slot closing the chunk is left out, each chunk starts with a page of its own
+            const auto slotsEnd = idx + 1 < chunksNum ? slots.cbegin() + (chunksBegin[idx + 1] - 1) : slots.cend();
+            try {
+                _layout_slots(pPrintData.get(), slots.cbegin() + chunksBegin[idx], slotsEnd);
+            }
+            catch (Glib::Error& e) {
+                spdlog::error("{} chunk {}: {}", __FUNCTION__, idx, std::string(e.what()));
+                pPrintData.reset();
+            }
+            catch (std::exception& e) {
+                spdlog::error("{} chunk {}: {}", __FUNCTION__, idx, e.what());
+                pPrintData.reset();
+            }
+            {
+                std::lock_guard<std::mutex> lock{chunksMutex};
+                if (pPrintData) {
+                    chunks[idx] = std::move(pPrintData);
+                }
+                else {
+                    failed = true;
+                }
+            }
+            chunksCond.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    bool anyImageResized{false};
+    {
+        // the workers are stopped and joined also if the drawing throws
+        auto on_scope_exit = scope_guard([&](void*) {
+            {
+                std::lock_guard<std::mutex> lock{chunksMutex};
+                if (drawnIdx < chunksNum) {
+                    failed = true;
+                }
+            }
+            chunksCond.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        });
+        for (size_t i = 0; i < workersNum; ++i) {
+            workers.emplace_back(f_worker);
+        }
+
+        // the pages are streamed to the surface in order, the total is not known in advance
+        int pageNum{0};
+        for (size_t idx = 0; idx < chunksNum; ++idx) {
+            std::unique_ptr<CtPrintData> pPrintData;
+            {
+                std::unique_lock<std::mutex> lock{chunksMutex};
+                chunksCond.wait(lock, [&](){ return failed or chunks[idx]; });
+                if (failed) {
+                    break;
+                }
+                pPrintData = std::move(chunks[idx]);
+                drawnIdx = idx + 1;
+            }
+            chunksCond.notify_all();
+            for (int page_nr = 0; page_nr < pPrintData->pages.size(); ++page_nr) {
+                _draw_page(pCairoContext, pPrintData->pango_context, pPrintData->pages.get_page(page_nr), std::to_string(++pageNum), cairo_names);
+                pCairoContext->show_page();
+            }
+            anyImageResized = anyImageResized or pPrintData->any_image_resized;
+        }
+    }
+    pSurface->finish();
+
+    if (anyImageResized) {
+        warning = _image_resized_warning();
+    }
+    return not failed;
+}
+
 // Here we Compute the Lines Positions, the Number of Pages Needed and the Page Breaks
 void CtPrint::_on_begin_print_text(const Glib::RefPtr<Gtk::PrintContext>& context, CtPrintData* print_data)
+{
+    print_data->pango_context = context->create_pango_context();
+    pango_cairo_update_context(context->get_cairo_context()->cobj(), print_data->pango_context->gobj());
+    // standard - 72, but MS print to pdf - 600
+    // it helps to fix window pixels, otherwise images, etc will be too small
+    _layout_setup(print_data->pango_context, context->get_dpi_x(), context->get_width(), context->get_height());
+
+    _layout_slots(print_data, print_data->slots.cbegin(), print_data->slots.cend());
+
+    print_data->operation->set_n_pages(print_data->pages.size());
+    if (print_data->any_image_resized) {
+        print_data->warning = _image_resized_warning();
+    }
+}
+
+void CtPrint::_layout_setup(const Glib::RefPtr<Pango::Context>& pango_context, const double dpi, const double page_width, const double page_height)
 {
     auto get_font_with_fallback_ = [](Pango::FontDescription font, const std::string& fallbackFont) {
 #ifdef _WIN32
@@ -589,37 +782,39 @@ void CtPrint::_on_begin_print_text(const Glib::RefPtr<Gtk::PrintContext>& contex
         return font;
     };
 
-    print_data->context = context;
     _rich_font = get_font_with_fallback_(Pango::FontDescription(_pCtConfig->rtFont), _pCtConfig->fallbackFontFamily);
     _plain_font = get_font_with_fallback_(Pango::FontDescription(_pCtConfig->ptFont), _pCtConfig->fallbackFontFamily);
     _code_font = get_font_with_fallback_(Pango::FontDescription(_pCtConfig->codeFont), "monospace");
     _text_window_width = _pCtMainWin->get_text_view().mm().get_allocation().get_width();
     _table_text_row_height = _rich_font.get_size()/Pango::SCALE;
     _table_line_thickness = 6;
-    // standard - 72, but MS print to pdf - 600
-    // it helps to fix window pixels, otherwise images, etc will be too small
-    _page_dpi_scale = context->get_dpi_x() / 72.0; 
-    _page_width = context->get_width();
-    _page_height = context->get_height() * 1.02; // tolerance at bottom of the page
+    _page_dpi_scale = dpi / 72.0;
+    _page_width = page_width;
+    _page_height = page_height * 1.02; // tolerance at bottom of the page
     _layout_newline_height = [&](){
-        Glib::RefPtr<Pango::Layout> layout_newline = context->create_pango_layout();
+        Glib::RefPtr<Pango::Layout> layout_newline = Pango::Layout::create(pango_context);
         layout_newline->set_font_description(_rich_font);
         layout_newline->set_width(int(_page_width * Pango::SCALE));
         layout_newline->set_markup(CtConst::CHAR_NEWLINE);
         return _get_width_height_from_layout_line(layout_newline->get_line(0)).height;
     }();
+}
 
-    bool any_image_resized{false};
-    for (auto slot : print_data->slots) {
-        if (dynamic_cast<CtPangoNewPage*>(slot.get())) {
+void CtPrint::_layout_slots(CtPrintData* print_data,
+                            std::vector<CtPangoObjectPtr>::const_iterator slots_begin,
+                            std::vector<CtPangoObjectPtr>::const_iterator slots_end)
+{
+    for (auto it = slots_begin; it != slots_end; ++it) {
+        CtPangoObject* slot = it->get();
+        if (dynamic_cast<CtPangoNewPage*>(slot)) {
             print_data->pages.new_page();
         }
-        else if (auto pango_text = dynamic_cast<CtPangoText*>(slot.get())) {
+        else if (auto pango_text = dynamic_cast<CtPangoText*>(slot)) {
             _process_pango_text(print_data, pango_text);
         }
-        else if (auto pango_widget = dynamic_cast<CtPangoWidget*>(slot.get())) {
+        else if (auto pango_widget = dynamic_cast<CtPangoWidget*>(slot)) {
             if (auto image = dynamic_cast<const CtImage*>(pango_widget->widget)) {
-                _process_pango_image(print_data, image, pango_widget, any_image_resized);
+                _process_pango_image(print_data, image, pango_widget);
             }
             else if (auto codebox = dynamic_cast<const CtCodebox*>(pango_widget->widget)) {
                 _process_pango_codebox(print_data, codebox, pango_widget);
@@ -629,21 +824,21 @@ void CtPrint::_on_begin_print_text(const Glib::RefPtr<Gtk::PrintContext>& contex
             }
         }
     }
+}
 
-    print_data->operation->set_n_pages(print_data->pages.size());
-    if (any_image_resized) {
-        print_data->warning = Glib::ustring(_("Warning: One or More Images Were Reduced to Enter the Page!")) + " ("
-                                       + std::to_string(static_cast<int>(_page_width))+ "x" + std::to_string(static_cast<int>(_page_height)) + ")";
-    }
+Glib::ustring CtPrint::_image_resized_warning()
+{
+    return Glib::ustring(_("Warning: One or More Images Were Reduced to Enter the Page!")) + " ("
+           + std::to_string(static_cast<int>(_page_width))+ "x" + std::to_string(static_cast<int>(_page_height)) + ")";
 }
 
-bool CtPrint::_cairo_tag_can_apply(const Glib::ustring& tag_name, const Glib::ustring& tag_attr, const CtPrintData* print_data)
+bool CtPrint::_cairo_tag_can_apply(const Glib::ustring& tag_name, const Glib::ustring& tag_attr, const std::list<Glib::ustring>& cairo_names)
 {
     if (CAIRO_TAG_DEST == tag_name or not str::startswith(tag_attr, "dest=")) {
         return true;
     }
     Glib::ustring tag_attr_dest = tag_attr.substr(5);
-    for (const Glib::ustring& curr_name : print_data->cairo_names) {
+    for (const Glib::ustring& curr_name : cairo_names) {
         if (curr_name == tag_attr_dest) {
             return true;
         }
@@ -654,13 +849,19 @@ bool CtPrint::_cairo_tag_can_apply(const Glib::ustring& tag_name, const Glib::us
 
 void CtPrint::_on_draw_page_text(const Glib::RefPtr<Gtk::PrintContext>& context, int page_nr, CtPrintData* print_data)
 {
-    auto operation = print_data->operation;
-    auto cairo_context = context->get_cairo_context();
+    Glib::ustring page_num_str = std::to_string(page_nr+1) + "/" + std::to_string(print_data->operation->property_n_pages());
+    _draw_page(context->get_cairo_context(), print_data->pango_context, print_data->pages.get_page(page_nr), page_num_str, print_data->cairo_names);
+}
 
+void CtPrint::_draw_page(Cairo::RefPtr<Cairo::Context> cairo_context,
+                         const Glib::RefPtr<Pango::Context>& pango_context,
+                         CtPrintPages::CtPrintPage& page,
+                         const Glib::ustring& page_num_str,
+                         const std::list<Glib::ustring>& cairo_names)
+{
     // draw page number
     cairo_context->set_source_rgb(0.5, 0.5, 0.5);
-    Glib::ustring page_num_str = std::to_string(page_nr+1) + "/" + std::to_string(operation->property_n_pages());
-    Glib::RefPtr<Pango::Layout> layout = context->create_pango_layout();
+    Glib::RefPtr<Pango::Layout> layout = Pango::Layout::create(pango_context);
     layout->set_font_description(_rich_font);
     layout->set_markup(page_num_str);
     auto layout_line = layout->get_line(0);
@@ -672,7 +873,6 @@ void CtPrint::_on_draw_page_text(const Glib::RefPtr<Gtk::PrintContext>& context,
     //cairo_context->rectangle(0, 0, _page_width, _page_height);
     //cairo_context->stroke();
 
-    auto& page = print_data->pages.get_page(page_nr);
     for (auto& line : page.lines) {
         for (CtPageElementPtr element : line.elements) {
             if (auto page_text = dynamic_cast<CtPageText*>(element.get())) {
@@ -688,7 +888,7 @@ void CtPrint::_on_draw_page_text(const Glib::RefPtr<Gtk::PrintContext>& context,
             else if (auto page_tag = dynamic_cast<CtPageTag*>(element.get())) {
                 cairo_context->set_source_rgb(0, 0, 0);
 
-                const bool can_cairo_tag = _cairo_tag_can_apply(page_tag->tag_name, page_tag->tag_attr, print_data);
+                const bool can_cairo_tag = _cairo_tag_can_apply(page_tag->tag_name, page_tag->tag_attr, cairo_names);
 
                 if (can_cairo_tag) cairo_tag_begin(cairo_context->cobj(), page_tag->tag_name.c_str(), page_tag->tag_attr.c_str());
                 cairo_context->move_to(page_tag->x, line.y);
@@ -732,7 +932,6 @@ void CtPrint::_on_draw_page_text(const Glib::RefPtr<Gtk::PrintContext>& context,
 
 void CtPrint::_process_pango_text(CtPrintData* print_data, CtPangoText* text_slot)
 {
-    auto context = print_data->context;
     CtPrintPages& pages = print_data->pages;
     Pango::FontDescription* font = [&]() {
         if (text_slot->synt_highl == CtConst::RICH_TEXT_ID) return &_rich_font;
@@ -772,7 +971,7 @@ void CtPrint::_process_pango_text(CtPrintData* print_data, CtPangoText* text_slo
         }
     }
 
-    Glib::RefPtr<Pango::Layout> layout = context->create_pango_layout();
+    Glib::RefPtr<Pango::Layout> layout = Pango::Layout::create(print_data->pango_context);
     layout->set_font_description(*font);
     const int max_layout_line_width = _page_width - text_slot->indent;
     layout->set_width(max_layout_line_width * Pango::SCALE);
@@ -857,11 +1056,10 @@ void CtPrint::_process_pango_text(CtPrintData* print_data, CtPangoText* text_slo
     }
 }
 
-void CtPrint::_process_pango_image(CtPrintData* print_data, const CtImage* image, const CtPangoWidget* pango_widget, bool& any_image_resized)
+void CtPrint::_process_pango_image(CtPrintData* print_data, const CtImage* image, const CtPangoWidget* pango_widget)
 {
-    auto context = print_data->context;
     CtPrintPages& pages = print_data->pages;
-    auto pixbuf = image->get_pixbuf();
+    auto pixbuf = print_data->widgets_snapshot ? print_data->widgets_snapshot->images.at(image) : image->get_pixbuf();
 
     for (int i = 0; i < 2; ++i) {
         // first loop we try and fit the image in line with existing text
@@ -908,7 +1106,7 @@ void CtPrint::_process_pango_image(CtPrintData* print_data, const CtImage* image
         double scale_h = (_page_height - _layout_newline_height - (CtConst::WHITE_SPACE_BETW_PIXB_AND_TEXT * _page_dpi_scale)) / (pixbuf->get_height() * _page_dpi_scale);
         double scale = std::min(scale_w, scale_h);
         if (scale > 1.0) scale = 1.0;
-        if (scale < 1.0) any_image_resized = true;
+        if (scale < 1.0) print_data->any_image_resized = true;
 
         scale *= _page_dpi_scale; // need to compensate high dpi
 
@@ -917,7 +1115,7 @@ void CtPrint::_process_pango_image(CtPrintData* print_data, const CtImage* image
 
         // calculate label if it exists
         Cairo::Rectangle label_size{0,0,0,0};
-        Glib::RefPtr<Pango::Layout> label_layout = context->create_pango_layout();
+        Glib::RefPtr<Pango::Layout> label_layout = Pango::Layout::create(print_data->pango_context);
         label_layout->set_font_description(_plain_font);
         if (auto emb_file = dynamic_cast<const CtImageEmbFile*>(image)) {
             label_layout->set_markup("<b><small>"+str::xml_escape(emb_file->get_file_name().string())+"</small></b>");
@@ -967,11 +1165,21 @@ void CtPrint::_process_pango_image(CtPrintData* print_data, const CtImage* image
 
 void CtPrint::_process_pango_codebox(CtPrintData* print_data, const CtCodebox* codebox, const CtPangoWidget* pango_widget)
 {
-    auto context = print_data->context;
+    auto context = print_data->pango_context;
     CtPrintPages& pages = print_data->pages;
 
-    Glib::ustring original_content = CtExport2Pango{_pCtMainWin}.pango_get_from_code_buffer(
-        codebox->get_buffer(), -1, -1, codebox->get_syntax_highlighting());
+    Glib::ustring original_content;
+    int frame_width{0};
+    if (print_data->widgets_snapshot) {
+        const CtPrintWidgetsSnapshot::CodeboxData& codeboxData = print_data->widgets_snapshot->codeboxes.at(codebox);
+        original_content = codeboxData.pango_content;
+        frame_width = codeboxData.frame_width;
+    }
+    else {
+        original_content = CtExport2Pango{_pCtMainWin}.pango_get_from_code_buffer(
+            codebox->get_buffer(), -1, -1, codebox->get_syntax_highlighting());
+        frame_width = codebox->get_frame_width();
+    }
 
     for (int i = 0; i < 1000/*just a big number without meaning*/; ++i) {
         // first loop we try and fit the codebox in line with existing text
@@ -1010,7 +1218,7 @@ void CtPrint::_process_pango_codebox(CtPrintData* print_data, const CtCodebox* c
             }
         }
 
-        double codebox_width = (codebox->get_width_in_pixels() ? codebox->get_frame_width() : _text_window_width * codebox->get_frame_width()/100.0)*_page_dpi_scale;
+        double codebox_width = (codebox->get_width_in_pixels() ? frame_width : _text_window_width * frame_width/100.0)*_page_dpi_scale;
         if (0 == i and codebox_width > available_width and available_width < (_page_width - pango_widget->indent)) {
             pages.new_line();
             continue; // restart loop from a new line
@@ -1068,10 +1276,10 @@ void CtPrint::_process_pango_codebox(CtPrintData* print_data, const CtCodebox* c
 
 Glib::RefPtr<Pango::Layout> CtPrint::_codebox_get_layout(const CtCodebox* codebox,
                                                          Glib::ustring content,
-                                                         Glib::RefPtr<Gtk::PrintContext> context,
+                                                         const Glib::RefPtr<Pango::Context>& context,
                                                          const int codebox_width)
 {
-    Glib::RefPtr<Pango::Layout> layout = context->create_pango_layout();
+    Glib::RefPtr<Pango::Layout> layout = Pango::Layout::create(context);
     layout->set_font_description(codebox->get_syntax_highlighting() != CtConst::PLAIN_TEXT_ID ? _code_font : _plain_font);
     layout->set_width(int(codebox_width * Pango::SCALE));
 #if GTKMM_MAJOR_VERSION >= 4
@@ -1087,7 +1295,7 @@ Glib::RefPtr<Pango::Layout> CtPrint::_codebox_get_layout(const CtCodebox* codebo
 void CtPrint::_codebox_split_content(const CtCodebox* codebox,
                                      Glib::ustring original_content,
                                      const int check_height,
-                                     const Glib::RefPtr<Gtk::PrintContext>& context,
+                                     const Glib::RefPtr<Pango::Context>& context,
                                      Glib::ustring& first_split,
                                      Glib::ustring& second_split,
                                      const int codebox_width)
@@ -1138,7 +1346,6 @@ void CtPrint::_process_pango_table(CtPrintData *print_data,
                                    const CtTableCommon* table,
                                    const CtPangoWidget* pango_widget)
 {
-    auto context = print_data->context;
     CtPrintPages& pages = print_data->pages;
 
     int first_row = 1;
@@ -1193,7 +1400,7 @@ void CtPrint::_process_pango_table(CtPrintData *print_data,
 
         // use table is length is ok
         std::vector<double> rows_h, cols_w;
-        auto table_layouts = _table_get_layouts(table, first_row, -1, context);
+        auto table_layouts = _table_get_layouts(print_data, table, first_row, -1);
         _table_get_grid(table_layouts, table->get_col_widths(), rows_h, cols_w);
         double table_height = _table_get_width_height(rows_h);
         if (pages.last_line().test_element_height(table_height + (BOX_OFFSET * _page_dpi_scale), _page_height)) {
@@ -1214,12 +1421,12 @@ void CtPrint::_process_pango_table(CtPrintData *print_data,
         }
 
         // if table is too long, split it
-        int split_row = _table_split_content(table, first_row, _page_height - pages.last_line().y - (BOX_OFFSET * _page_dpi_scale), context);
+        int split_row = _table_split_content(print_data, table, first_row, _page_height - pages.last_line().y - (BOX_OFFSET * _page_dpi_scale));
         if (split_row == -1) {
             pages.new_page(); // need a new page
         }
         else {
-            auto split_layouts = _table_get_layouts(table, first_row, split_row, context);
+            auto split_layouts = _table_get_layouts(print_data, table, first_row, split_row);
             _table_get_grid(split_layouts, table->get_col_widths(), rows_h, cols_w);
             double table_height = _table_get_width_height(rows_h);
 
@@ -1240,13 +1447,17 @@ void CtPrint::_process_pango_table(CtPrintData *print_data,
     }
 }
 
-CtPageTable::TableLayouts CtPrint::_table_get_layouts(const CtTableCommon* table,
+CtPageTable::TableLayouts CtPrint::_table_get_layouts(const CtPrintData* print_data,
+                                                      const CtTableCommon* table,
                                                       const int first_row,
-                                                      const int last_row,
-                                                      const Glib::RefPtr<Gtk::PrintContext>& context)
+                                                      const int last_row)
 {
-    std::vector<std::vector<Glib::ustring>> rows;
-    table->write_strings_matrix(rows);
+    std::vector<std::vector<Glib::ustring>> rows_read;
+    if (not print_data->widgets_snapshot) {
+        table->write_strings_matrix(rows_read);
+    }
+    const std::vector<std::vector<Glib::ustring>>& rows = print_data->widgets_snapshot ?
+        print_data->widgets_snapshot->tables.at(table) : rows_read;
     CtPageTable::TableLayouts table_layouts;
     for (size_t r = 0u; r < rows.size(); ++r) {
         if (first_row != -1 && r > 0 && (int)r < first_row) continue; // skip row out of range except header
@@ -1256,7 +1467,7 @@ CtPageTable::TableLayouts CtPrint::_table_get_layouts(const CtTableCommon* table
         for (size_t c = 0u; c < rows.at(r).size(); ++c) {
             Glib::ustring text = str::xml_escape(rows.at(r).at(c));
             if (r == 0) text = "<b>" + text + "</b>";
-            Glib::RefPtr<Pango::Layout> cell_layout = context->create_pango_layout();
+            Glib::RefPtr<Pango::Layout> cell_layout = Pango::Layout::create(print_data->pango_context);
             cell_layout->set_font_description(_rich_font);
             cell_layout->set_width(int((table->get_col_width(c) * _page_dpi_scale) * Pango::SCALE));
 #if GTKMM_MAJOR_VERSION >= 4
@@ -1303,15 +1514,15 @@ double CtPrint::_table_get_width_height(std::vector<double>& data)
     return acc;
 }
 
-int CtPrint::_table_split_content(const CtTableCommon* table,
+int CtPrint::_table_split_content(const CtPrintData* print_data,
+                                  const CtTableCommon* table,
                                   const int start_row,
-                                  const int check_height,
-                                  const Glib::RefPtr<Gtk::PrintContext>& context)
+                                  const int check_height)
 {
     int last_row = start_row;
     for (; last_row < (int)table->get_num_rows(); ++last_row) {
         std::vector<double> rows_h, cols_w;
-        auto table_layouts = _table_get_layouts(table, start_row, last_row, context);
+        auto table_layouts = _table_get_layouts(print_data, table, start_row, last_row);
         _table_get_grid(table_layouts, table->get_col_widths(), rows_h, cols_w);
         double table_height = _table_get_width_height(rows_h);
         if (table_height > check_height) {
@@ -270,16 +270,31 @@ private:
     std::vector<CtPrintPage> _pages{CtPrintPage{}};
 };
 
+// The content of the widgets read on the main thread, for the layout to run on the workers
+struct CtPrintWidgetsSnapshot
+{
+    struct CodeboxData
+    {
+        Glib::ustring pango_content;
+        int           frame_width{0};
+    };
+    std::unordered_map<const CtCodebox*, CodeboxData>                                  codeboxes;
+    std::unordered_map<const CtTableCommon*, std::vector<std::vector<Glib::ustring>>> tables;
+    std::unordered_map<const CtImage*, Glib::RefPtr<Gdk::Pixbuf>>                     images;
+};
+
 // Print Operation Data
 struct CtPrintData
 {
     std::vector<CtPangoObjectPtr>      slots;
 
     Glib::RefPtr<Gtk::PrintOperation>  operation;
-    Glib::RefPtr<Gtk::PrintContext>    context;
+    Glib::RefPtr<Pango::Context>       pango_context; // the layouts are created from it
+    const CtPrintWidgetsSnapshot*      widgets_snapshot{nullptr}; // if null the widgets are read directly
 
     CtPrintPages                       pages;
     Glib::ustring                      warning;
+    bool                               any_image_resized{false};
 
     std::list<Glib::ustring>           cairo_names;
 };
@@ -295,44 +310,59 @@ public:
 
 public:
     void run_page_setup_dialog(Gtk::Window* pMainWin);
+    // print, or export to pdf_filepath if not empty
     void print_text(const fs::path& pdf_filepath, const std::vector<CtPangoObjectPtr>& slots);
+    // export without a print operation: the chunks of slots starting on a new page are laid out
+    // by workers and the pages are written to the cairo pdf surface in order, as soon as ready
+    bool export_pdf(const fs::path& pdf_filepath, const std::vector<CtPangoObjectPtr>& slots, Glib::ustring& warning);
 
 private:
     void _on_begin_print_text(const Glib::RefPtr<Gtk::PrintContext>& context, CtPrintData* print_data);
     void _on_draw_page_text(const Glib::RefPtr<Gtk::PrintContext>& context, int page_nr, CtPrintData* print_data);
-    bool _cairo_tag_can_apply(const Glib::ustring& tag_name, const Glib::ustring& tag_attr, const CtPrintData* print_data);
+    bool _cairo_tag_can_apply(const Glib::ustring& tag_name, const Glib::ustring& tag_attr, const std::list<Glib::ustring>& cairo_names);
+
+    void _layout_setup(const Glib::RefPtr<Pango::Context>& pango_context, const double dpi, const double page_width, const double page_height);
+    void _layout_slots(CtPrintData* print_data,
+                       std::vector<CtPangoObjectPtr>::const_iterator slots_begin,
+                       std::vector<CtPangoObjectPtr>::const_iterator slots_end);
+    Glib::ustring _image_resized_warning();
+    void _draw_page(Cairo::RefPtr<Cairo::Context> cairo_context,
+                    const Glib::RefPtr<Pango::Context>& pango_context,
+                    CtPrintPages::CtPrintPage& page,
+                    const Glib::ustring& page_num_str,
+                    const std::list<Glib::ustring>& cairo_names);
 
 private:
     void _process_pango_text(CtPrintData* print_data, CtPangoText* text_slot);
-    void _process_pango_image(CtPrintData* print_data, const CtImage* image, const CtPangoWidget* pango_widget, bool& any_image_resized);
+    void _process_pango_image(CtPrintData* print_data, const CtImage* image, const CtPangoWidget* pango_widget);
     void _process_pango_codebox(CtPrintData* print_data, const CtCodebox* codebox, const CtPangoWidget* pango_widget);
     void _process_pango_table(CtPrintData* print_data, const CtTableCommon* table, const CtPangoWidget* pango_widget);
 
     Glib::RefPtr<Pango::Layout> _codebox_get_layout(const CtCodebox* codebox,
                                                     Glib::ustring content,
-                                                    Glib::RefPtr<Gtk::PrintContext> context,
+                                                    const Glib::RefPtr<Pango::Context>& context,
                                                     const int codebox_width);
     void                        _codebox_split_content(const CtCodebox* codebox,
                                                        Glib::ustring original_content,
                                                        const int check_height,
-                                                       const Glib::RefPtr<Gtk::PrintContext>& context,
+                                                       const Glib::RefPtr<Pango::Context>& context,
                                                        Glib::ustring& first_split,
                                                        Glib::ustring& second_split,
                                                        const int codebox_width);
 
-    CtPageTable::TableLayouts   _table_get_layouts(const CtTableCommon* table,
+    CtPageTable::TableLayouts   _table_get_layouts(const CtPrintData* print_data,
+                                                   const CtTableCommon* table,
                                                    const int first_row,
-                                                   const int last_row,
-                                                   const Glib::RefPtr<Gtk::PrintContext>& context);
+                                                   const int last_row);
     void                        _table_get_grid(const CtPageTable::TableLayouts& table_layouts,
                                                 const CtTableColWidths& col_widths,
                                                 std::vector<double>& rows_h,
                                                 std::vector<double>& cols_w);
     double                      _table_get_width_height(std::vector<double>& data);
-    int                         _table_split_content(const CtTableCommon* table,
+    int                         _table_split_content(const CtPrintData* print_data,
+                                                     const CtTableCommon* table,
                                                      const int start_row,
-                                                     const int check_height,
-                                                     const Glib::RefPtr<Gtk::PrintContext>& context);
+                                                     const int check_height);
 
     void _draw_codebox_box(Cairo::RefPtr<Cairo::Context> cairo_context, double x0, double y0, double codebox_width, double codebox_height);
     void _draw_codebox_code(Cairo::RefPtr<Cairo::Context> cairo_context, Glib::RefPtr<Pango::Layout> codebox_layout, double x0, double y0);
@@ -86,7 +86,10 @@ void CtExport2Txt::nodes_all_export_to_txt(bool all_tree, fs::path export_dir, f
 Glib::ustring CtExport2Txt::selection_export_to_txt(CtTreeIter tree_iter, Glib::RefPtr<Gtk::TextBuffer> text_buffer, int sel_start, int sel_end, bool check_link_target)
 {
     Glib::ustring plain_text;
-    std::list<CtAnchoredWidget*> widgets = tree_iter.get_anchored_widgets(sel_start, sel_end);
+    std::list<CtAnchoredWidget*> widgets;
+    if (tree_iter) {
+        widgets = tree_iter.get_anchored_widgets(sel_start, sel_end);
+    }
 
     int start_offset = sel_start >= 0 ? sel_start : 0;
     for (CtAnchoredWidget* widget : widgets) {
@@ -170,10 +173,7 @@ Glib::ustring CtExport2Txt::_plain_process_slot(int start_offset, int end_offset
 // Check for tag link in given_iter
 Glib::ustring CtExport2Txt::_tag_link_in_given_iter(Gtk::TextIter iter)
 {
-    for (auto tag: iter.get_tags())
-        if (str::startswith(tag->property_name().get_value(), CtConst::TAG_LINK_PREFIX))
-            return tag->property_name().get_value().substr(5);
-    return "";
+    return CtTextIterUtil::get_link_at(iter);
 }
 
 
@@ -29,6 +29,7 @@
 #include "ct_storage_control.h"
 #include "ct_storage_multifile.h"
 #include <regex>
+#include <glib/gstdio.h>
 
 CtImage::CtImage(CtMainWin* pCtMainWin,
                  const std::string& rawBlob,
@@ -762,6 +763,283 @@ bool CtImageLatex::_on_button_press_event(GdkEventButton* event)
 }
 #endif
 
+namespace {
+
+struct CtEmbFileSpoolDir
+{
+    ~CtEmbFileSpoolDir() { if (not path.empty()) fs::remove_all(path); }
+    fs::path path;
+};
+
+} // namespace (anonymous)
+
+/*static*/fs::path CtEmbFileBlob::_get_new_spool_filepath()
+{
+    static CtEmbFileSpoolDir spoolDir;
+    static size_t nextSpoolId{1};
+    // blobs are also created from the embedded files sync worker
+    static std::mutex spoolMutex;
+    std::lock_guard<std::mutex> lock{spoolMutex};
+    if (spoolDir.path.empty()) {
+        gchar* pDirPath = g_dir_make_tmp("ct_embfiles_XXXXXX", nullptr);
+        if (not pDirPath) {
+            spdlog::error("!! {} g_dir_make_tmp", __FUNCTION__);
+            return fs::path{};
+        }
+        spoolDir.path = pDirPath;
+        g_free(pDirPath);
+    }
+    return spoolDir.path / std::to_string(nextSpoolId++);
+}
+
+CtEmbFileBlob::Writer::Writer(const size_t expectedSize)
+{
+    if (expectedSize >= SPOOL_MIN_SIZE) {
+        _spoolFilepath = _get_new_spool_filepath();
+        _pFile = _spoolFilepath.empty() ? nullptr : g_fopen(_spoolFilepath.c_str(), "wb");
+        if (not _pFile) {
+            spdlog::error("!! {} could not create spool file {}", __FUNCTION__, _spoolFilepath.string());
+            _error = true;
+        }
+    }
+    else {
+        _rawBlob.reserve(expectedSize);
+    }
+}
+
+CtEmbFileBlob::Writer::~Writer()
+{
+    if (_pFile) {
+        fclose(_pFile);
+        g_remove(_spoolFilepath.c_str());
+    }
+}
+
+bool CtEmbFileBlob::Writer::append(const char* pData, const size_t dataSize)
+{
+    if (_error) {
+        return false;
+    }
+    if (_pFile) {
+        if (fwrite(pData, 1, dataSize, _pFile) != dataSize) {
+            spdlog::error("!! {} could not write spool file {}", __FUNCTION__, _spoolFilepath.string());
+            _error = true;
+            return false;
+        }
+    }
+    else {
+        _rawBlob.append(pData, dataSize);
+    }
+    _size += dataSize;
+    return true;
+}
+
+CtEmbFileBlobPtr CtEmbFileBlob::Writer::finish()
+{
+    if (_error) {
+        return nullptr;
+    }
+    auto pBlob = std::make_shared<CtEmbFileBlob>();
+    if (_pFile) {
+        const bool closeOk = 0 == fclose(_pFile);
+        _pFile = nullptr;
+        if (not closeOk) {
+            g_remove(_spoolFilepath.c_str());
+            return nullptr;
+        }
+        pBlob->_spoolFilepath = std::move(_spoolFilepath);
+    }
+    else {
+        pBlob->_rawBlob = std::move(_rawBlob);
+    }
+    pBlob->_size = _size;
+    return pBlob;
+}
+
+CtEmbFileBlob::~CtEmbFileBlob()
+{
+    if (not _spoolFilepath.empty()) {
+        g_remove(_spoolFilepath.c_str());
+    }
+}
+
+/*static*/CtEmbFileBlobPtr CtEmbFileBlob::from_memory(std::string rawBlob)
+{
+    auto pBlob = std::make_shared<CtEmbFileBlob>();
+    pBlob->_size = rawBlob.size();
+    pBlob->_rawBlob = std::move(rawBlob);
+    return pBlob;
+}
+
+/*static*/CtEmbFileBlobPtr CtEmbFileBlob::from_file(const fs::path& filepath)
+{
+    FILE* pFile = g_fopen(filepath.c_str(), "rb");
+    if (not pFile) {
+        spdlog::error("!! {} could not open {}", __FUNCTION__, filepath.string());
+        return nullptr;
+    }
+    Writer writer{static_cast<size_t>(fs::file_size(filepath))};
+    std::vector<char> chunk(CHUNK_SIZE);
+    bool readOk{true};
+    while (true) {
+        const size_t readSize = fread(chunk.data(), 1, chunk.size(), pFile);
+        if (readSize > 0 and not writer.append(chunk.data(), readSize)) {
+            readOk = false;
+            break;
+        }
+        if (readSize < chunk.size()) {
+            readOk = 0 == ferror(pFile);
+            break;
+        }
+    }
+    fclose(pFile);
+    if (not readOk) {
+        spdlog::error("!! {} could not read {}", __FUNCTION__, filepath.string());
+        return nullptr;
+    }
+    return writer.finish();
+}
+
+/*static*/CtEmbFileBlobPtr CtEmbFileBlob::from_base64(const std::string& encodedBlob)
+{
+    Writer writer{encodedBlob.size() / 4 * 3};
+    std::vector<guchar> chunk(CHUNK_SIZE / 4 * 3 + 3);
+    gint state{0};
+    guint save{0};
+    for (size_t encOffset = 0; encOffset < encodedBlob.size(); encOffset += CHUNK_SIZE) {
+        const size_t encSize = std::min(CHUNK_SIZE, encodedBlob.size() - encOffset);
+        const gsize decSize = g_base64_decode_step(encodedBlob.data() + encOffset, encSize, chunk.data(), &state, &save);
+        if (not writer.append(reinterpret_cast<const char*>(chunk.data()), decSize)) {
+            break;
+        }
+    }
+    CtEmbFileBlobPtr pBlob = writer.finish();
+    return pBlob ? pBlob : from_memory(std::string{});
+}
+
+bool CtEmbFileBlob::read_chunks(const std::function<bool(const char* pData, const size_t dataSize)>& f) const
+{
+    if (_spoolFilepath.empty()) {
+        for (size_t offset = 0; offset < _rawBlob.size(); offset += CHUNK_SIZE) {
+            if (not f(_rawBlob.data() + offset, std::min(CHUNK_SIZE, _rawBlob.size() - offset))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    FILE* pFile = g_fopen(_spoolFilepath.c_str(), "rb");
+    if (not pFile) {
+        spdlog::error("!! {} could not open {}", __FUNCTION__, _spoolFilepath.string());
+        return false;
+    }
+    std::vector<char> chunk(CHUNK_SIZE);
+    bool retVal{true};
+    size_t sizeLeft{_size};
+    while (sizeLeft > 0) {
+        const size_t readSize = fread(chunk.data(), 1, std::min(chunk.size(), sizeLeft), pFile);
+        if (0 == readSize or not f(chunk.data(), readSize)) {
+            retVal = false;
+            break;
+        }
+        sizeLeft -= readSize;
+    }
+    fclose(pFile);
+    return retVal;
+}
+
+bool CtEmbFileBlob::write_to_file(const fs::path& filepath, std::string* pSha256sum/*= nullptr*/) const
+{
+    FILE* pFile = g_fopen(filepath.c_str(), "wb");
+    if (not pFile) {
+        spdlog::error("!! {} could not create {}", __FUNCTION__, filepath.string());
+        return false;
+    }
+    GChecksum* pChecksum = pSha256sum ? g_checksum_new(G_CHECKSUM_SHA256) : nullptr;
+    const bool writeOk = read_chunks([pFile, pChecksum](const char* pData, const size_t dataSize){
+        if (pChecksum) {
+            g_checksum_update(pChecksum, reinterpret_cast<const guchar*>(pData), static_cast<gssize>(dataSize));
+        }
+        return fwrite(pData, 1, dataSize, pFile) == dataSize;
+    });
+    const bool closeOk = 0 == fclose(pFile);
+    if (pChecksum) {
+        *pSha256sum = g_checksum_get_string(pChecksum);
+        g_checksum_free(pChecksum);
+    }
+    if (not writeOk or not closeOk) {
+        spdlog::error("!! {} could not write {}", __FUNCTION__, filepath.string());
+        return false;
+    }
+    return true;
+}
+
+std::string CtEmbFileBlob::read_all() const
+{
+    if (_spoolFilepath.empty()) {
+        return _rawBlob;
+    }
+    std::string retBlob;
+    retBlob.reserve(_size);
+    read_chunks([&retBlob](const char* pData, const size_t dataSize){
+        retBlob.append(pData, dataSize);
+        return true;
+    });
+    return retBlob;
+}
+
+std::string CtEmbFileBlob::to_base64() const
+{
+    // same output as g_base64_encode (no line breaks), without an intermediate copy of the raw data
+    std::string retEncoded;
+    retEncoded.reserve((_size / 3 + 1) * 4 + 4);
+    std::vector<gchar> chunk(CHUNK_SIZE / 3 * 4 + 8);
+    gint state{0};
+    gint save{0};
+    read_chunks([&](const char* pData, const size_t dataSize){
+        const gsize encSize = g_base64_encode_step(reinterpret_cast<const guchar*>(pData), dataSize, FALSE/*break_lines*/, chunk.data(), &state, &save);
+        retEncoded.append(chunk.data(), encSize);
+        return true;
+    });
+    const gsize encSize = g_base64_encode_close(FALSE/*break_lines*/, chunk.data(), &state, &save);
+    retEncoded.append(chunk.data(), encSize);
+    return retEncoded;
+}
+
+std::string CtEmbFileBlob::get_sha256sum() const
+{
+    GChecksum* pChecksum = g_checksum_new(G_CHECKSUM_SHA256);
+    read_chunks([pChecksum](const char* pData, const size_t dataSize){
+        g_checksum_update(pChecksum, reinterpret_cast<const guchar*>(pData), static_cast<gssize>(dataSize));
+        return true;
+    });
+    const std::string sha256sum = g_checksum_get_string(pChecksum);
+    g_checksum_free(pChecksum);
+    return sha256sum;
+}
+
+/*static*/std::string CtEmbFileBlob::get_file_sha256sum(const fs::path& filepath)
+{
+    FILE* pFile = g_fopen(filepath.c_str(), "rb");
+    if (not pFile) {
+        spdlog::error("!! {} could not open {}", __FUNCTION__, filepath.string());
+        return std::string{};
+    }
+    GChecksum* pChecksum = g_checksum_new(G_CHECKSUM_SHA256);
+    std::vector<char> chunk(CHUNK_SIZE);
+    size_t readSize{0};
+    while ((readSize = fread(chunk.data(), 1, chunk.size(), pFile)) > 0) {
+        g_checksum_update(pChecksum, reinterpret_cast<const guchar*>(chunk.data()), static_cast<gssize>(readSize));
+    }
+    const bool readOk = 0 == ferror(pFile);
+    fclose(pFile);
+    const std::string sha256sum = readOk ? g_checksum_get_string(pChecksum) : "";
+    g_checksum_free(pChecksum);
+    if (not readOk) {
+        spdlog::error("!! {} could not read {}", __FUNCTION__, filepath.string());
+    }
+    return sha256sum;
+}
+
 /*static*/size_t CtImageEmbFile::get_next_unique_id()
 {
     static size_t next_unique_id{1};
@@ -770,7 +1048,7 @@ bool CtImageLatex::_on_button_press_event(GdkEventButton* event)
 
 CtImageEmbFile::CtImageEmbFile(CtMainWin* pCtMainWin,
                                const fs::path& fileName,
-                               const std::string& rawBlob,
+                               CtEmbFileBlobPtr blob,
                                const time_t timeSeconds,
                                const int charOffset,
                                const std::string& justification,
@@ -778,7 +1056,7 @@ CtImageEmbFile::CtImageEmbFile(CtMainWin* pCtMainWin,
                                const fs::path& pathLastMultiFile)
  : CtImage{pCtMainWin, _get_file_icon(pCtMainWin, fileName), charOffset, justification}
  , _fileName{fileName}
- , _rawBlob{rawBlob}
+ , _blob{blob ? blob : CtEmbFileBlob::from_memory(std::string{})}
  , _timeSeconds{timeSeconds}
  , _uniqueId{uniqueId}
  , _pathLastMultiFile{pathLastMultiFile}
@@ -790,17 +1068,22 @@ CtImageEmbFile::CtImageEmbFile(CtMainWin* pCtMainWin,
     update_label_widget();
 }
 
-void CtImageEmbFile::_checkNonEmptyRawBlob(const char* multifile_dir)
+void CtImageEmbFile::_checkNonEmptyBlob(const char* multifile_dir)
 {
-    if (not _rawBlob.empty()) {
+    if (not _blob->empty()) {
         return;
     }
+    const auto f_blob_from_file = [this](const fs::path& embfilePath){
+        if (CtEmbFileBlobPtr pBlob = CtEmbFileBlob::from_file(embfilePath)) {
+            _blob = pBlob;
+        }
+    };
     // an embedded file can potentially be empty, but if that is the case, we will check if a constant file name exists
     if (multifile_dir and multifile_dir[0]) {
         // the current data format is multifile, let's check in the current multifile directory
         const fs::path embfilePath = fs::path{multifile_dir} / _fileName;
         if (fs::exists(embfilePath)) {
-            _rawBlob = Glib::file_get_contents(embfilePath.string());
+            f_blob_from_file(embfilePath);
             spdlog::debug("{} FROM multifile constant {}", __FUNCTION__, embfilePath.c_str());
         }
         else {
@@ -808,7 +1091,7 @@ void CtImageEmbFile::_checkNonEmptyRawBlob(const char* multifile_dir)
             // let's check in the cleanup folder .before
             const fs::path embfileBeforePath = fs::path{multifile_dir} / ".before" / _fileName;
             if (fs::exists(embfileBeforePath)) {
-                _rawBlob = Glib::file_get_contents(embfileBeforePath.string());
+                f_blob_from_file(embfileBeforePath);
                 spdlog::debug("{} FROM multifile before constant {}", __FUNCTION__, embfileBeforePath.c_str());
             }
             else {
@@ -816,12 +1099,12 @@ void CtImageEmbFile::_checkNonEmptyRawBlob(const char* multifile_dir)
             }
         }
     }
-    if (not _rawBlob.empty()) {
+    if (not _blob->empty()) {
         return;
     }
     // let's check also if the embedded file was copied/moved and the original file is still in the old directory
     if (fs::exists(_pathLastMultiFile)) {
-        _rawBlob = Glib::file_get_contents(_pathLastMultiFile.string());
+        f_blob_from_file(_pathLastMultiFile);
         spdlog::debug("{} FROM multifile constant last {}", __FUNCTION__, _pathLastMultiFile.string());
     }
     else {
@@ -841,23 +1124,21 @@ void CtImageEmbFile::to_xml(xmlpp::Element* p_node_parent,
     p_image_node->set_attribute("time", std::to_string(_timeSeconds));
     if (multifile_dir.empty()) {
         // target is not multifile
-        _checkNonEmptyRawBlob(nullptr/*multifile_dir*/);
-        const std::string encodedBlob = Glib::Base64::encode(_rawBlob);
-        p_image_node->add_child_text(encodedBlob);
+        _checkNonEmptyBlob(nullptr/*multifile_dir*/);
+        p_image_node->add_child_text(_blob->to_base64());
     }
     else {
         // target is multifile
         if (_pCtMainWin->get_ct_config()->embfileMFNameOnDisk) {
             // save as multifile constant name on disk.
-            // If _rawBlob is non-empty, the in-memory content is newer and must overwrite the on-disk file.
+            // If _blob is non-empty, the in-memory content is newer and must overwrite the on-disk file.
             const fs::path embfilePath = fs::path{multifile_dir} / _fileName;
-            if (not fs::exists(embfilePath) or not _rawBlob.empty()) {
-                _checkNonEmptyRawBlob(multifile_dir.c_str());
-                Glib::file_set_contents(embfilePath.string(), _rawBlob);
-                if (fs::exists(embfilePath)) {
-                    spdlog::debug("{} written multifile constant name {}, cleared _rawBlob", __FUNCTION__, embfilePath.c_str());
+            if (not fs::exists(embfilePath) or not _blob->empty()) {
+                _checkNonEmptyBlob(multifile_dir.c_str());
+                if (_blob->write_to_file(embfilePath) and fs::exists(embfilePath)) {
+                    spdlog::debug("{} written multifile constant name {}, cleared _blob", __FUNCTION__, embfilePath.c_str());
                     _pathLastMultiFile = embfilePath;
-                    _rawBlob.clear();
+                    _blob = CtEmbFileBlob::from_memory(std::string{});
                 }
                 else {
                     spdlog::warn("!! {} multifile constant name {} could not write", __FUNCTION__, embfilePath.c_str());
@@ -866,8 +1147,8 @@ void CtImageEmbFile::to_xml(xmlpp::Element* p_node_parent,
         }
         else {
             // save as multifile with sha256 as name
-            _checkNonEmptyRawBlob(multifile_dir.c_str());
-            const std::string sha256sum = CtStorageMultiFile::save_blob(_rawBlob, multifile_dir, _fileName.extension());
+            _checkNonEmptyBlob(multifile_dir.c_str());
+            const std::string sha256sum = CtStorageMultiFile::save_blob(*_blob, multifile_dir, _fileName.extension());
             p_image_node->set_attribute("sha256sum", sha256sum);
         }
     }
@@ -887,8 +1168,17 @@ bool CtImageEmbFile::to_sqlite(sqlite3* pDb, const gint64 node_id, const int off
         sqlite3_bind_int64(p_stmt, 2, _charOffset+offset_adjustment);
         sqlite3_bind_text(p_stmt, 3, _justification.c_str(), _justification.size(), SQLITE_STATIC);
         sqlite3_bind_text(p_stmt, 4, "", -1, SQLITE_STATIC); // anchor
-        _checkNonEmptyRawBlob(nullptr/*multifile_dir*/);
-        sqlite3_bind_blob(p_stmt, 5, _rawBlob.c_str(), _rawBlob.size(), SQLITE_STATIC);
+        _checkNonEmptyBlob(nullptr/*multifile_dir*/);
+        const CtEmbFileBlobPtr pBlob = _blob;
+        std::string rawBlob;
+        if (pBlob->is_spooled()) {
+            // reserved here and then streamed into the row through the incremental blob I/O
+            sqlite3_bind_zeroblob64(p_stmt, 5, static_cast<sqlite3_uint64>(pBlob->size()));
+        }
+        else {
+            rawBlob = pBlob->read_all();
+            sqlite3_bind_blob(p_stmt, 5, rawBlob.c_str(), rawBlob.size(), SQLITE_STATIC);
+        }
         sqlite3_bind_text(p_stmt, 6, file_name.c_str(), file_name.size(), SQLITE_STATIC);
         sqlite3_bind_text(p_stmt, 7, "", -1, SQLITE_STATIC); // link
         sqlite3_bind_int64(p_stmt, 8, _timeSeconds);
@@ -896,6 +1186,9 @@ bool CtImageEmbFile::to_sqlite(sqlite3* pDb, const gint64 node_id, const int off
             spdlog::error("{}: {}", CtStorageSqlite::ERR_SQLITE_STEP, sqlite3_errmsg(pDb));
             retVal = false;
         }
+        else if (pBlob->is_spooled()) {
+            retVal = CtStorageSqlite::blob_write_from(pDb, "image", "png", sqlite3_last_insert_rowid(pDb), *pBlob);
+        }
         sqlite3_finalize(p_stmt);
     }
     return retVal;
@@ -27,6 +27,8 @@
 #include "ct_const.h"
 #include "ct_codebox.h"
 #include "ct_widgets.h"
+#include <cstdio>
+#include <functional>
 
 class CtImage : public CtAnchoredWidget
 {
@@ -171,12 +173,71 @@ protected:
     const size_t  _uniqueId;
 };
 
+class CtEmbFileBlob;
+using CtEmbFileBlobPtr = std::shared_ptr<const CtEmbFileBlob>;
+
+// the content of an embedded file, never modified once created so that the widget and its undo
+// states share the same instance; from SPOOL_MIN_SIZE it is kept in a temporary spool file
+// and it is only ever read and written in chunks of CHUNK_SIZE
+class CtEmbFileBlob
+{
+public:
+    static constexpr size_t CHUNK_SIZE{256*1024};
+    static constexpr size_t SPOOL_MIN_SIZE{1024*1024};
+
+    class Writer
+    {
+    public:
+        explicit Writer(const size_t expectedSize);
+        ~Writer();
+        bool             append(const char* pData, const size_t dataSize);
+        CtEmbFileBlobPtr finish(); // nullptr on error
+    private:
+        std::string _rawBlob;
+        fs::path    _spoolFilepath;
+        FILE*       _pFile{nullptr};
+        size_t      _size{0};
+        bool        _error{false};
+    };
+
+    CtEmbFileBlob() = default;
+    ~CtEmbFileBlob();
+    CtEmbFileBlob(const CtEmbFileBlob&) = delete;
+    CtEmbFileBlob& operator=(const CtEmbFileBlob&) = delete;
+
+    static CtEmbFileBlobPtr from_memory(std::string rawBlob);
+    static CtEmbFileBlobPtr from_file(const fs::path& filepath);          // nullptr on error
+    static CtEmbFileBlobPtr from_base64(const std::string& encodedBlob);
+
+    size_t      size() const { return _size; }
+    bool        empty() const { return 0 == _size; }
+    bool        is_spooled() const { return not _spoolFilepath.empty(); }
+    const fs::path& get_spool_filepath() const { return _spoolFilepath; }
+
+    // f returns false to stop, false is returned on read error or stop
+    bool        read_chunks(const std::function<bool(const char* pData, const size_t dataSize)>& f) const;
+    // with pSha256sum the checksum of the content is computed in the same pass
+    bool        write_to_file(const fs::path& filepath, std::string* pSha256sum = nullptr) const;
+    std::string read_all() const;
+    std::string to_base64() const;
+    std::string get_sha256sum() const;
+    // empty on read error
+    static std::string get_file_sha256sum(const fs::path& filepath);
+
+private:
+    static fs::path _get_new_spool_filepath();
+
+    std::string _rawBlob;       // raw data, not a string, empty if spooled
+    fs::path    _spoolFilepath;
+    size_t      _size{0};
+};
+
 class CtImageEmbFile : public CtImage
 {
 public:
     CtImageEmbFile(CtMainWin* pCtMainWin,
                    const fs::path& fileName,
-                   const std::string& rawBlob,
+                   CtEmbFileBlobPtr blob,
                    const time_t timeSeconds,
                    const int charOffset,
                    const std::string& justification,
@@ -191,8 +252,8 @@ public:
 
     const fs::path&      get_file_name() const { return _fileName; }
     void                 set_file_name(const fs::path& path) { _fileName = path; }
-    const std::string&   get_raw_blob() { return _rawBlob; }
-    void                 set_raw_blob(const std::string& buffer) { _rawBlob = buffer; }
+    const CtEmbFileBlobPtr& get_blob() const { return _blob; }
+    void                 set_blob(CtEmbFileBlobPtr blob) { _blob = blob ? blob : CtEmbFileBlob::from_memory(std::string{}); }
     time_t               get_time() { return _timeSeconds; }
     void                 set_time(const time_t time) { _timeSeconds = time; }
     size_t               get_unique_id() { return _uniqueId; }
@@ -210,11 +271,11 @@ private:
 #if GTKMM_MAJOR_VERSION < 4
     bool _on_button_press_event(GdkEventButton* event);
 #endif
-    void _checkNonEmptyRawBlob(const char* multifile_dir);
+    void _checkNonEmptyBlob(const char* multifile_dir);
 
 protected:
     fs::path      _fileName;
-    std::string   _rawBlob;      // raw data, not a string
+    CtEmbFileBlobPtr _blob;
     time_t        _timeSeconds;
     const size_t  _uniqueId;
     fs::path      _pathLastMultiFile;
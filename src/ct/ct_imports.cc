@@ -28,6 +28,10 @@
 #include "ct_export2html.h"
 #include "ct_logging.h"
 #include <libxml2/libxml/SAX.h>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
 
 namespace {
 
@@ -37,6 +41,103 @@ xmlpp::Element* create_root_plaintext_text_el(xmlpp::Document& doc, const Glib::
     return el;
 }
 
+// the directory tree as listed before importing the files
+struct CtTraverseEntry
+{
+    static constexpr size_t IS_DIR{std::numeric_limits<size_t>::max()};
+    fs::path                   path;
+    size_t                     fileIdx{IS_DIR}; // in the list of the files to import
+    std::list<CtTraverseEntry> children;
+};
+
+void traverse_dir_list(const fs::path& dir, CtTraverseEntry& dirEntry, std::vector<fs::path>& files)
+{
+    dirEntry.path = dir;
+    for (const auto& dir_item : fs::get_dir_entries(dir)) {
+        CtTraverseEntry& entry = dirEntry.children.emplace_back();
+        if (fs::is_directory(dir_item)) {
+            traverse_dir_list(dir_item, entry, files);
+        }
+        else {
+            entry.path = dir_item;
+            entry.fileIdx = files.size();
+            files.push_back(dir_item);
+        }
+    }
+}
+
+std::unique_ptr<CtImportedNode> traverse_dir_assemble(CtTraverseEntry& dirEntry, std::vector<std::unique_ptr<CtImportedNode>>& importedFiles)
+{
+    auto dir_node = std::make_unique<CtImportedNode>(dirEntry.path, dirEntry.path.filename().string());
+    for (CtTraverseEntry& entry : dirEntry.children)
+    {
+        if (CtTraverseEntry::IS_DIR == entry.fileIdx)
+        {
+            if (auto node = traverse_dir_assemble(entry, importedFiles))
+                dir_node->children.emplace_back(std::move(node));
+        }
+        else if (importedFiles[entry.fileIdx])
+            dir_node->children.emplace_back(std::move(importedFiles[entry.fileIdx]));
+    }
+
+    // skip empty dirs
+    if (dir_node->children.empty())
+        return nullptr;
+
+    // not the best place but
+    // two cases:
+    // 1. children with the same names, one with content and other as dir, join them
+    // 2. dir contains  note with the same name, join them (from keepnote)
+
+    std::function<void(std::unique_ptr<CtImportedNode>&)> join_subdir_subnote;
+    join_subdir_subnote = [&](std::unique_ptr<CtImportedNode>& node) {
+        for (auto iter1 = node->children.begin(); iter1 != node->children.end(); ++iter1)
+        {
+            if ((*iter1)->has_content() && (*iter1)->children.empty()) // node with content
+            {
+                for (auto iter2 = node->children.begin(); iter2 != node->children.end(); ++iter2)
+                {
+                    if (!(*iter2)->has_content()) // dir node
+                    {
+                        if (iter1->get() == iter2->get()) continue; // same node?
+                        if ((*iter1)->node_name == (*iter2)->node_name)
+                        {
+                            std::swap((*iter1)->children, (*iter2)->children);
+                            node->children.erase(iter2);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        for (auto& child: node->children)
+            join_subdir_subnote(child);
+    };
+
+    std::function<void(std::unique_ptr<CtImportedNode>&)> join_parent_dir_subnote;
+    join_parent_dir_subnote = [&](std::unique_ptr<CtImportedNode>& node) {
+        if (!node->has_content())
+        {
+            for (auto iter = node->children.begin(); iter != node->children.end(); ++iter)
+            {
+                if ((*iter)->has_content() && (*iter)->children.empty() && node->node_name == (*iter)->node_name)
+                {
+                    node->copy_content((*iter));
+                    node->children.erase(iter);
+                    break;
+                }
+            }
+        }
+        for (auto& child: node->children)
+            join_parent_dir_subnote(child);
+    };
+
+    join_subdir_subnote(dir_node);
+    join_parent_dir_subnote(dir_node);
+
+    return dir_node;
+}
+
 } // namespace (anonymous)
 
 namespace CtXML {
@@ -170,76 +271,81 @@ std::vector<std::pair<size_t, size_t>> CtImports::get_web_links_offsets_from_pla
     return web_links;
 }
 
-std::unique_ptr<CtImportedNode> CtImports::traverse_dir(const fs::path& dir, CtImporterInterface* importer)
+std::unique_ptr<CtImportedNode> CtImports::traverse_dir(const fs::path& dir,
+                                                        CtImporterInterface* importer,
+                                                        const CtImportProgressFunc& fProgress/*= nullptr*/)
 {
-    auto dir_node = std::make_unique<CtImportedNode>(dir, dir.filename().string());
-    for (const auto& dir_item: fs::get_dir_entries(dir))
-    {
-        if (fs::is_directory(dir_item))
-        {
-            if (auto node = traverse_dir(dir_item, importer))
-                dir_node->children.emplace_back(std::move(node));
-        }
-        else if (auto node = importer->import_file(dir_item))
-            dir_node->children.emplace_back(std::move(node));
-    }
-
-    // skip empty dirs
-    if (dir_node->children.empty())
-        return nullptr;
+    CtTraverseEntry rootEntry;
+    std::vector<fs::path> files;
+    traverse_dir_list(dir, rootEntry, files);
 
-    // not the best place but
-    // two cases:
-    // 1. children with the same names, one with content and other as dir, join them
-    // 2. dir contains  note with the same name, join them (from keepnote)
-
-    std::function<void(std::unique_ptr<CtImportedNode>&)> join_subdir_subnote;
-    join_subdir_subnote = [&](std::unique_ptr<CtImportedNode>& node) {
-        for (auto iter1 = node->children.begin(); iter1 != node->children.end(); ++iter1)
-        {
-            if ((*iter1)->has_content() && (*iter1)->children.empty()) // node with content
-            {
-                for (auto iter2 = node->children.begin(); iter2 != node->children.end(); ++iter2)
-                {
-                    if (!(*iter2)->has_content()) // dir node
-                    {
-                        if (iter1->get() == iter2->get()) continue; // same node?
-                        if ((*iter1)->node_name == (*iter2)->node_name)
-                        {
-                            std::swap((*iter1)->children, (*iter2)->children);
-                            node->children.erase(iter2);
-                            break;
-                        }
-                    }
-                }
-            }
+    std::vector<std::unique_ptr<CtImportedNode>> importedFiles(files.size());
+    auto f_import_file = [&files, &importedFiles](CtImporterInterface* pImporter, const size_t idx) {
+        // a file that cannot be imported does not stop the others
+        try {
+            importedFiles[idx] = pImporter->import_file(files[idx]);
+        }
+        catch (Glib::Error& error) {
+            spdlog::error("!! {} {} {}", __FUNCTION__, files[idx].string(), std::string(error.what()));
+        }
+        catch (std::exception& ex) {
+            spdlog::error("!! {} {} {}", __FUNCTION__, files[idx].string(), ex.what());
         }
-        for (auto& child: node->children)
-            join_subdir_subnote(child);
     };
 
-    std::function<void(std::unique_ptr<CtImportedNode>&)> join_parent_dir_subnote;
-    join_parent_dir_subnote = [&](std::unique_ptr<CtImportedNode>& node) {
-        if (!node->has_content())
-        {
-            for (auto iter = node->children.begin(); iter != node->children.end(); ++iter)
-            {
-                if ((*iter)->has_content() && (*iter)->children.empty() && node->node_name == (*iter)->node_name)
-                {
-                    node->copy_content((*iter));
-                    node->children.erase(iter);
-                    break;
+    std::vector<std::unique_ptr<CtImporterInterface>> workersImporters;
+    const size_t workers_num = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), files.size());
+    for (size_t i = 0; i < workers_num; ++i) {
+        std::unique_ptr<CtImporterInterface> pClone = importer->clone();
+        if (not pClone) {
+            workersImporters.clear();
+            break;
+        }
+        workersImporters.push_back(std::move(pClone));
+    }
+    bool cancelled{false};
+    if (workersImporters.empty()) {
+        for (size_t idx = 0; idx < files.size() and not cancelled; ++idx) {
+            f_import_file(importer, idx);
+            cancelled = fProgress and not fProgress(double(idx + 1)/double(files.size()));
+        }
+    }
+    else {
+        xmlInitParser(); // before the documents are created by several threads
+        // the files differ a lot in size, the workers pick the next one as soon as they are free
+        std::atomic<size_t> next_idx{0};
+        std::atomic<size_t> done_num{0};
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> workers;
+        for (auto& pWorkerImporter : workersImporters) {
+            workers.emplace_back([&, pImporter = pWorkerImporter.get()](){
+                for (size_t idx = next_idx++; idx < files.size() and not stop; idx = next_idx++) {
+                    f_import_file(pImporter, idx);
+                    ++done_num;
                 }
+            });
+        }
+        // the calling thread (in the UI the main one) is left to report the progress
+        while (fProgress) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            const size_t curr_done_num = done_num;
+            if (not fProgress(double(curr_done_num)/double(files.size()))) {
+                cancelled = true;
+                stop = true;
+                break;
+            }
+            if (curr_done_num == files.size()) {
+                break;
             }
         }
-        for (auto& child: node->children)
-            join_parent_dir_subnote(child);
-    };
-
-    join_subdir_subnote(dir_node);
-    join_parent_dir_subnote(dir_node);
-
-    return dir_node;
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    if (cancelled) {
+        return nullptr;
+    }
+    return traverse_dir_assemble(rootEntry, importedFiles);
 }
 
 CtHtmlImport::CtHtmlImport(CtConfig* config) : _config{config}
@@ -423,7 +529,11 @@ xmlpp::Element* CtTomboyImport::_rich_text_serialize(const Glib::ustring& text_d
     return dom_iter;
 }
 
-CtZimImport::CtZimImport(CtConfig* config) : _zim_parser{std::make_unique<CtZimParser>(config)} {}
+CtZimImport::CtZimImport(CtConfig* config)
+ : _config{config}
+ , _zim_parser{std::make_unique<CtZimParser>(config)}
+{
+}
 
 std::unique_ptr<CtImportedNode> CtZimImport::import_file(const fs::path& file)
 {
@@ -466,7 +576,9 @@ std::unique_ptr<CtImportedNode> CtPlainTextImport::import_file(const fs::path& f
     return nullptr;
 }
 
-CtMDImport::CtMDImport(CtConfig* config) : _parser{std::make_unique<CtMDParser>(config)}
+CtMDImport::CtMDImport(CtConfig* config)
+ : _config{config}
+ , _parser{std::make_unique<CtMDParser>(config)}
 {
 }
 
@@ -33,6 +33,7 @@
 #include <utility>
 #include <glibmm/i18n.h>
 #include <memory>
+#include <functional>
 
 namespace {
 
@@ -48,7 +49,7 @@ struct CtImportedNode
         content_broken_links[link].push_back(el);
     }
     bool has_content() {
-        return xml_content->get_root_node();
+        return xml_content and xml_content->get_root_node();
     }
     void copy_content(std::unique_ptr<CtImportedNode>& copy_node) {
         node_syntax = copy_node->node_syntax;
@@ -72,8 +73,14 @@ public:
     virtual std::string                     file_pattern_name() { return ""; }
     virtual std::vector<Glib::ustring>      file_patterns() { return {}; }
     virtual std::vector<Glib::ustring>      file_mime_types() { return {}; }
+    // another importer of the same kind, to import other files at the same time on a worker thread;
+    // nullptr if the files must be imported one after the other
+    virtual std::unique_ptr<CtImporterInterface> clone() const { return nullptr; }
 };
 
+// fraction of the files imported, false to cancel
+using CtImportProgressFunc = std::function<bool(const double fraction)>;
+
 /// Implementation of file patterns for HTML importers
 class CtHtmlImporterInterface : public CtImporterInterface
 {
@@ -89,7 +96,12 @@ public:
 namespace CtImports {
 
 std::vector<std::pair<size_t, size_t>> get_web_links_offsets_from_plain_text(const Glib::ustring& plain_text);
-std::unique_ptr<CtImportedNode> traverse_dir(const fs::path& dir, CtImporterInterface* importer);
+// the files are listed first and then imported in parallel if the importer can be cloned, the tree
+// is then put together in the order of the listing; fProgress is called on the calling thread
+// and nullptr is returned if cancelled
+std::unique_ptr<CtImportedNode> traverse_dir(const fs::path& dir,
+                                             CtImporterInterface* importer,
+                                             const CtImportProgressFunc& fProgress = nullptr);
 
 } // namespace CtImports
 
@@ -121,6 +133,7 @@ public:
 
     // virtuals of CtImporterInterface
     std::unique_ptr<CtImportedNode> import_file(const fs::path& file) override;
+    std::unique_ptr<CtImporterInterface> clone() const override { return std::make_unique<CtHtmlImport>(_config); }
 
 private:
     CtConfig* _config;
@@ -134,6 +147,7 @@ public:
 public:
     // virtuals of CtImporterInterface
     std::unique_ptr<CtImportedNode> import_file(const fs::path& file) override;
+    std::unique_ptr<CtImporterInterface> clone() const override { return std::make_unique<CtTomboyImport>(_config); }
 
 private:
     void            _iterate_tomboy_note(xmlpp::Element* iter, std::unique_ptr<CtImportedNode>& node);
@@ -161,10 +175,12 @@ public:
 
     // virtuals of CtImporterInterface
     std::unique_ptr<CtImportedNode> import_file(const fs::path& file) override;
+    std::unique_ptr<CtImporterInterface> clone() const override { return std::make_unique<CtZimImport>(_config); }
 
     ~CtZimImport();
 
 private:
+    CtConfig*                    _config;
     std::unique_ptr<CtZimParser> _zim_parser;
 };
 
@@ -175,6 +191,7 @@ public:
 
     // virtuals of CtImporterInterface
     std::unique_ptr<CtImportedNode> import_file(const fs::path& file) override;
+    std::unique_ptr<CtImporterInterface> clone() const override { return std::make_unique<CtPlainTextImport>(nullptr); }
     std::string                     file_pattern_name() override { return _("Plain Text Document"); }
 #ifdef _WIN32
     std::vector<Glib::ustring>      file_patterns() override { return {"*.txt"}; }
@@ -194,8 +211,10 @@ public:
     std::unique_ptr<CtImportedNode> import_file(const fs::path& file) override;
     std::vector<Glib::ustring>        file_patterns() override { return {"*.md"}; };
     std::string                       file_pattern_name() override { return _("Markdown Document"); }
+    std::unique_ptr<CtImporterInterface> clone() const override { return std::make_unique<CtMDImport>(_config); }
 
 private:
+    CtConfig*                   _config;
     std::unique_ptr<CtMDParser> _parser;
 };
 
@@ -204,6 +223,7 @@ class CtKeepnoteImport : public CtImporterInterface
 public:
     explicit CtKeepnoteImport(CtConfig* config) : _config(config) {}
     std::unique_ptr<CtImportedNode> import_file(const fs::path& file) override;
+    std::unique_ptr<CtImporterInterface> clone() const override { return std::make_unique<CtKeepnoteImport>(_config); }
 
 private:
     CtConfig* _config;
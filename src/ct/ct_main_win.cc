@@ -543,7 +543,7 @@ bool CtMainWin::start_on_systray_delayed_file_open_kick()
         _startOnSystray_delayedFilepath.clear();
         _startOnSystray_delayedNodeName.clear();
         _startOnSystray_delayedAnchorName.clear();
-        if (file_open(startOnSystray_delayedFilepath, startOnSystray_delayedNodeName, startOnSystray_delayedAnchorName)) {
+        if (CtFileOpenResult::Failed != file_open(startOnSystray_delayedFilepath, startOnSystray_delayedNodeName, startOnSystray_delayedAnchorName)) {
             return true;
         }
         spdlog::warn("%s Couldn't open file: %s", __FUNCTION__, _startOnSystray_delayedFilepath);
@@ -1259,7 +1259,7 @@ void CtMainWin::menu_set_items_recent_documents()
     #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
     sigc::slot<void, const std::string&> recent_doc_open_action = [&](const std::string& filepath){
         if (Glib::file_test(filepath, Glib::FILE_TEST_EXISTS)) {
-            if (file_open(filepath, ""/*node*/, ""/*anchor*/)) {
+            if (CtFileOpenResult::Failed != file_open(filepath, ""/*node*/, ""/*anchor*/)) {
                 _pCtConfig->recentDocsFilepaths.move_or_push_front(fs_canonicalize_filename(filepath));
                 menu_set_items_recent_documents();
             }
@@ -1514,7 +1514,10 @@ void CtMainWin::update_selected_node_statusbar_info()
             statusbar_text += separator_text + _("Spell Check") + _(": ") + _pCtConfig->spellCheckLang;
         }
         if (_pCtConfig->wordCountOn) {
-            statusbar_text += separator_text + _("Word Count") + _(": ") + std::to_string(CtTextIterUtil::get_words_count(_ctTextview.get_buffer()));
+            CtTextStats& textStats = _uCtTreestore->get_curr_node_text_stats();
+            statusbar_text += separator_text + _("Word Count") + _(": ") + std::to_string(textStats.get_words_count(_ctTextview.get_buffer()));
+            statusbar_text += separator_text + _("Characters") + _(": ") + std::to_string(textStats.get_chars_count());
+            statusbar_text += separator_text + _("Lines") + _(": ") + std::to_string(textStats.get_lines_count());
         }
         if (treeIter.get_node_creating_time() > 0) {
             const Glib::ustring timestamp_creation = str::time_format(_pCtConfig->timestampFormat, treeIter.get_node_creating_time());
@@ -1524,11 +1527,8 @@ void CtMainWin::update_selected_node_statusbar_info()
             const Glib::ustring timestamp_lastsave = str::time_format(_pCtConfig->timestampFormat, treeIter.get_node_modification_time());
             statusbar_text += separator_text + _("Date Modified") + _(": ") + timestamp_lastsave;
         }
-        size_t direct_children_count{0};
-        for (auto child_iter = treeIter->children().begin(); child_iter != treeIter->children().end(); ++child_iter) {
-            ++direct_children_count;
-        }
-        const size_t total_children_count = treeIter.get_children_node_ids().size();
+        const size_t direct_children_count = treeIter->children().size();
+        const size_t total_children_count = _uCtTreestore->get_subtree_nodes_count(treeIter);
         statusbar_text += separator_text + _("Subnodes") + _(": ") + std::to_string(direct_children_count);
         if (direct_children_count != total_children_count) {
             statusbar_text += CtConst::CHAR_SLASH + std::to_string(total_children_count);
@@ -1537,6 +1537,13 @@ void CtMainWin::update_selected_node_statusbar_info()
     _ctStatusBar.update_status(statusbar_text);
 }
 
+void CtMainWin::memory_usage_populate(CtMemoryUsage& memoryUsage)
+{
+    _uCtTreestore->memory_usage_populate(memoryUsage);
+    _uCtStorage->memory_usage_populate(memoryUsage);
+    _ctStateMachine.memory_usage_populate(memoryUsage);
+}
+
 void CtMainWin::tree_node_paste_from_other_window(CtMainWin* pWinToCopyFrom, gint64 nodeIdToCopyFrom)
 {
     if (not pWinToCopyFrom) {
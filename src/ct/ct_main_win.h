@@ -111,11 +111,12 @@ public:
 
     void update_theme();
 
-    bool file_open(const fs::path& filepath,
-                   const std::string& node_to_focus,
-                   const std::string& anchor_to_focus,
-                   const Glib::ustring password = "",
-                   const bool is_reload = false);
+    // OpenedElsewhere if the user chose to show the window that already has the document, this one is left as it was
+    CtFileOpenResult file_open(const fs::path& filepath,
+                               const std::string& node_to_focus,
+                               const std::string& anchor_to_focus,
+                               const Glib::ustring password = "",
+                               const bool is_reload = false);
     bool file_save_ask_user();
     bool file_save(const bool need_vacuum);
     void file_save_as(const std::string& new_filepath, const CtDocType doc_type, const Glib::ustring& password);
@@ -134,6 +135,8 @@ public:
     bool get_file_save_needed();
 
     void update_selected_node_statusbar_info();
+    // buffers and widgets, storage documents waiting to become buffers, then undo states
+    void memory_usage_populate(CtMemoryUsage& memoryUsage);
 
     void tree_node_paste_from_other_window(CtMainWin* pWinToCopyFrom, gint64 nodeIdToCopyFrom);
 
@@ -179,6 +182,10 @@ public:
     void                      codeboxes_reload_toolbar();
     Glib::RefPtr<Gtk::TextBuffer> get_new_text_buffer(const Glib::ustring& textContent="");
     std::string               get_text_tag_name_exist_or_create(const std::string& propertyName, const std::string& propertyValue);
+    void                      apply_link(Glib::RefPtr<Gtk::TextBuffer> pTextBuffer,
+                                         const Gtk::TextIter& iter_start,
+                                         const Gtk::TextIter& iter_end,
+                                         const std::string& link_property);
     void                      apply_scalable_properties(Glib::RefPtr<Gtk::TextTag> rTextTag, CtScalableTag* pCtScalableTag);
     Glib::ustring             sourceview_hovering_link_get_tooltip(const Glib::ustring& link);
     bool                      apply_tag_try_automatic_bounds(Glib::RefPtr<Gtk::TextBuffer> text_buffer, Gtk::TextIter iter_start);
@@ -41,6 +41,7 @@ void CtMainWin::apply_syntax_highlighting(Glib::RefPtr<Gtk::TextBuffer> pTextBuf
     if (not forceReApply and pTextBuffer->get_data(CtConst::STYLE_APPLIED_ID)) {
         return;
     }
+    CtRegionHighlighter::detach(pTextBuffer);
     GtkSourceStyleSchemeManager* pGtkSourceStyleSchemeManager = gtk_source_style_scheme_manager_get_default();
     auto pGtkSourceBuffer = GTK_SOURCE_BUFFER(pTextBuffer->gobj());
     auto f_applyScheme = [pGtkSourceStyleSchemeManager, pGtkSourceBuffer](const char* scheme){
@@ -63,6 +64,10 @@ void CtMainWin::apply_syntax_highlighting(Glib::RefPtr<Gtk::TextBuffer> pTextBuf
         gtk_source_buffer_set_highlight_syntax(pGtkSourceBuffer, false);
     }
     else {
+        // the GtkSourceView engine analyses the whole buffer, above the limit the text views
+        // only highlight the lines around their visible region
+        const bool overFullHighlLimit = _pCtConfig->codeHighlFullMaxKB > 0 and
+                                        pTextBuffer->get_char_count() > _pCtConfig->codeHighlFullMaxKB*1024;
         if (CtConst::PLAIN_TEXT_ID == syntax) {
             f_applyScheme(_pCtConfig->ptStyleScheme.c_str());
             gtk_source_buffer_set_highlight_syntax(pGtkSourceBuffer, false);
@@ -72,13 +77,16 @@ void CtMainWin::apply_syntax_highlighting(Glib::RefPtr<Gtk::TextBuffer> pTextBuf
             GtkSourceLanguage* pGtkSourceLanguage = gtk_source_language_manager_get_language(get_language_manager(), syntax.c_str());
             if (pGtkSourceLanguage) {
                 gtk_source_buffer_set_language(pGtkSourceBuffer, pGtkSourceLanguage);
-                gtk_source_buffer_set_highlight_syntax(pGtkSourceBuffer, true);
+                gtk_source_buffer_set_highlight_syntax(pGtkSourceBuffer, not overFullHighlLimit);
+                if (overFullHighlLimit) {
+                    CtRegionHighlighter::attach(pTextBuffer, pGtkSourceLanguage, gtk_source_buffer_get_style_scheme(pGtkSourceBuffer));
+                }
             }
             else {
                 spdlog::error("!! {} pGtkSourceLanguage '{}'", __FUNCTION__, syntax);
             }
         }
-        gtk_source_buffer_set_highlight_matching_brackets(pGtkSourceBuffer, _pCtConfig->ptHighlMatchBra);
+        gtk_source_buffer_set_highlight_matching_brackets(pGtkSourceBuffer, _pCtConfig->ptHighlMatchBra and not overFullHighlLimit);
     }
     pTextBuffer->set_data(CtConst::STYLE_APPLIED_ID, (void*)1);
 }
@@ -144,19 +152,29 @@ void CtMainWin::codeboxes_reload_toolbar()
 
 void CtMainWin::reapply_syntax_highlighting(const char target/*'r':RichText, 'p':PlainTextNCode, 't':Table*/)
 {
-    std::string error;
+    CtTreeIter currTreeIter = curr_tree_iter();
+    const gint64 currNodeIdDataHolder = currTreeIter ? currTreeIter.get_node_id_data_holder() : -1;
+    // the buffers not yet loaded get the styles when loaded, the ones loaded but not in the
+    // text view get them again when shown, only the buffer in the text view is done now
+    auto f_reapply_node_buffer = [&](CtTreeIter& node) {
+        if (not node.get_node_buffer_already_loaded()) {
+            return;
+        }
+        Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = node.get_node_text_buffer();
+        if (node.get_node_id_data_holder() == currNodeIdDataHolder) {
+            apply_syntax_highlighting(pTextBuffer, node.get_node_syntax_highlighting(), true/*forceReApply*/);
+        }
+        else {
+            pTextBuffer->set_data(CtConst::STYLE_APPLIED_ID, nullptr);
+        }
+    };
     get_tree_store().get_store()->foreach([&](const Gtk::TreePath& /*treePath*/, const Gtk::TreeModel::iterator& treeIter)->bool
     {
         CtTreeIter node = get_tree_store().to_ct_tree_iter(treeIter);
         switch (target) {
             case 'r': {
                 if (node.get_node_is_rich_text()) {
-                    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = node.get_node_text_buffer();
-                    if (not pTextBuffer) {
-                        error = str::format(_("Failed to retrieve the content of the node '%s'"), node.get_node_name().raw());
-                        return true; /* true for stop */
-                    }
-                    apply_syntax_highlighting(pTextBuffer, node.get_node_syntax_highlighting(), true/*forceReApply*/);
+                    f_reapply_node_buffer(node);
                 }
             } break;
             case 'p': {
@@ -169,13 +187,8 @@ void CtMainWin::reapply_syntax_highlighting(const char target/*'r':RichText, 'p'
                         }
                     }
                 }
-                else {
-                    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = node.get_node_text_buffer();
-                    if (not pTextBuffer) {
-                        error = str::format(_("Failed to retrieve the content of the node '%s'"), node.get_node_name().raw());
-                        return true; /* true for stop */
-                    }
-                    apply_syntax_highlighting(pTextBuffer, node.get_node_syntax_highlighting(), true/*forceReApply*/);
+                else if (not node.get_node_is_rich_text()) {
+                    f_reapply_node_buffer(node);
                 }
             } break;
             case 't': {
@@ -193,7 +206,7 @@ void CtMainWin::reapply_syntax_highlighting(const char target/*'r':RichText, 'p'
         }
         return false; /* false for continue */
     });
-    if (not error.empty()) CtDialogs::error_dialog(error, *this);
+    _ctTextview.queue_region_highlight();
 }
 
 Glib::RefPtr<Gtk::TextBuffer> CtMainWin::get_new_text_buffer(const Glib::ustring& textContent)
@@ -240,7 +253,9 @@ void CtMainWin::apply_scalable_properties(Glib::RefPtr<Gtk::TextTag> rTextTag, C
 std::string CtMainWin::get_text_tag_name_exist_or_create(const std::string& propertyName,
                                                          const std::string& propertyValue)
 {
-    const std::string tagName{propertyName + "_" + propertyValue};
+    // the links share one style tag per link type, their targets are in the CtLinkTable of the buffer
+    const std::string tagName = CtConst::TAG_LINK == propertyName ? CtLinkTable::get_style_tag_name(propertyValue)
+                                                                  : propertyName + "_" + propertyValue;
     Glib::RefPtr<Gtk::TextTag> rTextTag = _rGtkTextTagTable->lookup(tagName);
     if (not rTextTag) {
         bool identified{true};
@@ -384,6 +399,15 @@ std::string CtMainWin::get_text_tag_name_exist_or_create(const std::string& prop
     return tagName;
 }
 
+void CtMainWin::apply_link(Glib::RefPtr<Gtk::TextBuffer> pTextBuffer,
+                           const Gtk::TextIter& iter_start,
+                           const Gtk::TextIter& iter_end,
+                           const std::string& link_property)
+{
+    pTextBuffer->apply_tag_by_name(get_text_tag_name_exist_or_create(CtConst::TAG_LINK, link_property), iter_start, iter_end);
+    CtLinkTable::get(pTextBuffer)->set(iter_start, iter_end, link_property);
+}
+
 // Get the tooltip for the underlying link
 Glib::ustring CtMainWin::sourceview_hovering_link_get_tooltip(const Glib::ustring& link)
 {
@@ -402,9 +426,20 @@ Glib::ustring CtMainWin::sourceview_hovering_link_get_tooltip(const Glib::ustrin
         tooltip = link_entry.fold;
     }
     else if (CtLinkType::Node == link_entry.type) {
-        tooltip = _uCtTreestore->get_node_name_from_node_id(link_entry.node_id);
-        if (!link_entry.anch.empty())
-            tooltip += "#" + link_entry.anch;
+        // resolved through the link index, the target buffer is not loaded
+        CtTreeIter targetIter = _uCtTreestore->get_node_from_node_id(link_entry.node_id);
+        if (not targetIter) {
+            tooltip = str::format(_("The Link Refers to a Node that Does Not Exist Anymore (Id = %s)"), std::to_string(link_entry.node_id));
+        }
+        else {
+            tooltip = targetIter.get_node_name();
+            if (!link_entry.anch.empty()) {
+                tooltip += "#" + link_entry.anch;
+                if (_uCtTreestore->link_index_is_target_missing(link_entry.node_id, link_entry.anch.raw())) {
+                    tooltip += " (" + Glib::ustring{_("Anchor Not Found")} + ")";
+                }
+            }
+        }
     }
     return tooltip;
 }
@@ -594,12 +629,17 @@ void CtMainWin::text_view_apply_cursor_position(CtTreeIter& treeIter, const int
 
     pTextBuffer->place_cursor(textIter);
 
+    // the widgets up to the cursor take their place before the scroll is restored,
+    // the following ones are added in idle afterwards
+    _uCtTreestore->text_view_realize_pause(true);
+    _uCtTreestore->text_view_realize_pending_widgets(cursor_pos);
     #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
     while (gtk_events_pending()) gtk_main_iteration();
     #else
     while (g_main_context_pending(nullptr)) g_main_context_iteration(nullptr, false);
     #endif
     _scrolledwindowText.get_vadjustment()->set_value(v_adj_val);
+    _uCtTreestore->text_view_realize_pause(false);
 }
 
 bool CtMainWin::_try_move_focus_to_anchored_widget_if_on_it()
@@ -89,6 +89,9 @@ void CtMainWin::_on_treeview_cursor_changed()
     }
 
     _ctStateMachine.node_selected_changed(nodeIdDataHolder);
+    if (user_active()) {
+        _uCtTreestore->nodes_prefetch_around(treeIter);
+    }
 
     _prevTreeIter = treeIter;
 }
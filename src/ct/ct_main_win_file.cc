@@ -137,6 +137,8 @@ void CtMainWin::update_window_save_needed(const CtSaveNeededUpdType update_type,
             const gint64 curr_time = g_date_time_to_unix(pGDateTime);
             treeIter.set_node_modification_time(curr_time);
             const gint64 node_id_data_holder = treeIter.get_node_id_data_holder();
+            _uCtTreestore->link_index_set_dirty(node_id_data_holder);
+            _uCtTreestore->node_stats_drop(node_id_data_holder);
             if ( (0 == _latestStatusbarUpdateTime.count(node_id_data_holder)) or
                  (curr_time - _latestStatusbarUpdateTime.at(node_id_data_holder) > 60) )
             {
@@ -170,29 +172,63 @@ bool CtMainWin::get_file_save_needed()
     return _fileSaveNeeded or (curr_tree_iter() and curr_tree_iter().get_node_text_buffer()->get_modified());
 }
 
-bool CtMainWin::file_open(const fs::path& filepath,
-                          const std::string& node_to_focus,
-                          const std::string& anchor_to_focus,
-                          const Glib::ustring password/*= ""*/,
-                          const bool is_reload/*= false*/)
+CtFileOpenResult CtMainWin::file_open(const fs::path& filepath,
+                                      const std::string& node_to_focus,
+                                      const std::string& anchor_to_focus,
+                                      const Glib::ustring password/*= ""*/,
+                                      const bool is_reload/*= false*/)
 {
     if (not fs::exists(filepath)) {
         g_autofree gchar* title = g_strdup_printf(_("The Path %s does Not Exist"), str::xml_escape(filepath.string()).c_str());
         CtDialogs::error_dialog(Glib::ustring{title}, *this);
-        return false;
+        return CtFileOpenResult::Failed;
     }
     const CtDocType doc_type = fs::is_directory(filepath) ? CtDocType::MultiFile : fs::get_doc_type_from_file_ext(filepath);
     if (CtDocType::None == doc_type) {
         // not a cherrytree file but can try and insert plain text content into a new node
         if (file_insert_plain_text(filepath)) {
-            return true;
+            return CtFileOpenResult::Opened;
         }
         CtDialogs::error_dialog(str::format(_("\"%s\" is Not a CherryTree File"), str::xml_escape(filepath.string())), *this);
-        return false;
+        return CtFileOpenResult::Failed;
+    }
+    if (not is_reload and not _no_gui) {
+        // a document is loaded once: the window that already has it open is shown instead of a second copy,
+        // unless the user asks for one; the windows without gui (e.g. export from command line) load their own
+        const fs::path canonicalPath = fs::canonical(filepath);
+        CtMainWin* pWinWithDoc{nullptr};
+        emit_app_apply_for_each_window([&](CtMainWin* pWin) {
+            if (pWin != this and not pWinWithDoc and not pWin->no_gui()) {
+                const fs::path& otherPath = pWin->get_ct_storage()->get_file_path();
+                if (not otherPath.empty() and fs::canonical(otherPath) == canonicalPath) {
+                    pWinWithDoc = pWin;
+                }
+            }
+        });
+        if (pWinWithDoc and
+            CtDialogs::question_dialog(_("The Document is Already Open in Another Window.\nShow that Window Instead of Opening the Document Again?"), *this))
+        {
+            spdlog::debug("{} already open in another window", canonicalPath.string());
+            pWinWithDoc->present();
+            if (not node_to_focus.empty()) {
+                CtTreeIter node = pWinWithDoc->get_tree_store().get_node_from_node_name(node_to_focus);
+                if (node) {
+                    pWinWithDoc->get_tree_view().set_cursor_safe(node);
+                    pWinWithDoc->get_text_view().mm().grab_focus();
+                    if (not anchor_to_focus.empty()) {
+                        pWinWithDoc->get_ct_actions()->current_node_scroll_to_anchor(anchor_to_focus);
+                    }
+                }
+                else {
+                    CtDialogs::warning_dialog(str::format(_("No node named '%s' found."), str::xml_escape(node_to_focus)), *pWinWithDoc);
+                }
+            }
+            return CtFileOpenResult::OpenedElsewhere;
+        }
     }
     // check if there is a previous open file with unsaved changes
     if (not file_save_ask_user()) {
-        return false;
+        return CtFileOpenResult::Failed;
     }
 
     _ensure_curr_doc_in_recent_docs();
@@ -243,7 +279,7 @@ bool CtMainWin::file_open(const fs::path& filepath,
             }
         }
         if (not new_storage) {
-            return false; // show the given document is not loaded
+            return CtFileOpenResult::Failed; // show the given document is not loaded
         }
     }
 
@@ -325,7 +361,7 @@ bool CtMainWin::file_open(const fs::path& filepath,
         CtDialogs::warning_dialog(str::xml_escape(error_or_warning), *this);
     }
 
-    return true;
+    return CtFileOpenResult::Opened;
 }
 
 bool CtMainWin::file_save_ask_user()
@@ -477,7 +513,7 @@ void CtMainWin::mod_time_sentinel_restart()
             if (currModTime > _uCtStorage->get_mod_time()) {
                 spdlog::debug("mod time was {} now {}", _uCtStorage->get_mod_time(), currModTime);
                 fs::path file_path = _uCtStorage->get_file_path();
-                if (file_open(file_path, ""/*node*/, ""/*anchor*/, ""/*password*/, true/*is_reload*/)) {
+                if (CtFileOpenResult::Opened == file_open(file_path, ""/*node*/, ""/*anchor*/, ""/*password*/, true/*is_reload*/)) {
                     _ctStatusBar.update_status(_("The Document was Reloaded After External Update to CT* File."));
                 }
             }
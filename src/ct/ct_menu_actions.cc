@@ -99,6 +99,12 @@ void CtMenu::init_actions(CtActions* pActions)
             _("Export Preferences"), sigc::mem_fun(*pActions, &CtActions::preferences_export) });
         _actions.push_back(CtMenuAction{file_cat, "tree_parse_info", "ct_info", _("Tree In_fo"), None,
             _("Tree Summary Information"), sigc::mem_fun(*pActions, &CtActions::tree_info)});
+        _actions.push_back(CtMenuAction{file_cat, "tree_broken_links", "ct_warning", _("_Broken Links..."), None,
+            _("List the Links to Missing Nodes or Anchors"), sigc::mem_fun(*pActions, &CtActions::tree_broken_links)});
+#if GTKMM_MAJOR_VERSION < 4
+        _actions.push_back(CtMenuAction{file_cat, "tree_memory_usage", "ct_info", _("_Memory Usage..."), None,
+            _("Approximate Memory Used by Each Node"), sigc::mem_fun(*pActions, &CtActions::tree_memory_usage)});
+#endif /* GTKMM_MAJOR_VERSION < 4 */
         _actions.push_back(CtMenuAction{file_cat, "doc_path_clip", "ct_edit_copy", _("_Document Path to Clipboard"), None,
             _("Copy Document Path to Clipboard"), sigc::mem_fun(*pActions, &CtActions::doc_path_to_clipboard)});
         _actions.push_back(CtMenuAction{file_cat, "quit_app", "ct_quit-app", _("_Quit"), KB_CONTROL+"q",
@@ -353,6 +359,8 @@ void CtMenu::init_actions(CtActions* pActions)
             _("Toggle the Read Only Property of the Selected Node"), sigc::mem_fun(*pActions, &CtActions::node_toggle_read_only)});
         _actions.push_back(CtMenuAction{tree_cat, "tree_node_link", "ct_node_link", _("Cop_y Link to Node"), None,
             _("Copy Link to the Selected Node to Clipboard"), sigc::mem_fun(*pActions, &CtActions::node_link_to_clipboard)});
+        _actions.push_back(CtMenuAction{tree_cat, "tree_node_backlinks", "ct_node_link", _("Node _Backlinks..."), None,
+            _("List the Nodes Linking to the Selected Node"), sigc::mem_fun(*pActions, &CtActions::node_backlinks)});
         _actions.push_back(CtMenuAction{tree_cat, "child_nodes_inherit_syntax", "ct_execute", _("Children _Inherit Syntax"), None,
             _("Change the Selected Node's Children Syntax Highlighting to the Parent's Syntax Highlighting"),
             sigc::mem_fun(*pActions, &CtActions::node_inherit_syntax)});
@@ -393,6 +401,10 @@ void CtMenu::init_actions(CtActions* pActions)
             _("Quick Node Selection"), sigc::mem_fun(*pActions, &CtActions::command_selnode)});
         _actions.push_back(CtMenuAction{find_cat, "find_in_node_names", "ct_find", _("Find in _Nodes Names and Tags..."), KB_CONTROL+"t",
             _("Find in Nodes Names and Tags"), sigc::mem_fun(*pActions, &CtActions::find_a_node)});
+        _actions.push_back(CtMenuAction{find_cat, "tags_browse", "ct_find", _("_Browse Tags..."), None,
+            _("List the Tags and Their Nodes"), sigc::mem_fun(*pActions, &CtActions::tags_browse)});
+        _actions.push_back(CtMenuAction{find_cat, "tags_filter_nodes", "ct_find", _("Filter Nodes by _Tags..."), None,
+            _("List the Nodes Having All or Any of the Given Tags"), sigc::mem_fun(*pActions, &CtActions::tags_filter_nodes)});
         _actions.push_back(CtMenuAction{find_cat, "find_in_node", "ct_find_sel", _("_Find in Node Content..."), KB_CONTROL+"f",
             _("Find into the Selected Node Content"), sigc::mem_fun(*pActions, &CtActions::find_in_selected_node)});
         _actions.push_back(CtMenuAction{find_cat, "find_in_allnodes", "ct_find_all", _("Find _in Multiple Nodes..."), KB_CONTROL+KB_SHIFT+"f",
@@ -160,6 +160,8 @@ const char* CtMenu::_get_ui_str_menu()
       <menuitem action='open_cfg_folder'/>
     </menu>
     <menuitem action='tree_parse_info'/>
+    <menuitem action='tree_broken_links'/>
+    <menuitem action='tree_memory_usage'/>
     <menuitem action='doc_path_clip'/>
     <separator/>
     <menuitem action='quit_app'/>
@@ -321,6 +323,7 @@ const char* CtMenu::_get_ui_str_menu()
     <menuitem action='tree_node_prop'/>
     <menuitem action='tree_node_toggle_ro'/>
     <menuitem action='tree_node_link'/>
+    <menuitem action='tree_node_backlinks'/>
     <menuitem action='child_nodes_inherit_syntax'/>
     <separator/>
     <menu action='BookmarksSubMenu'>
@@ -352,6 +355,8 @@ const char* CtMenu::_get_ui_str_menu()
   <menu action='SearchMenu'>
     <menuitem action='select_node'/>
     <menuitem action='find_in_node_names'/>
+    <menuitem action='tags_browse'/>
+    <menuitem action='tags_filter_nodes'/>
     <menuitem action='find_in_node'/>
     <menuitem action='find_in_allnodes'/>
     <menuitem action='find_iter_fw'/>
@@ -31,6 +31,7 @@
 #include "ct_list.h"
 #include <ctime>
 #include <regex>
+#include <iterator>
 #include <glib/gstdio.h> // to get stats
 #include <curl/curl.h>
 #include <fribidi.h>
@@ -51,9 +52,17 @@
 #include <sys/wait.h> // WEXITSTATUS __FreeBSD__ (#1550)
 #endif // !_WIN32
 
-CtCSV::CtStringTable CtCSV::table_from_csv(const std::string& filepath)
+bool CtCSV::table_from_csv_stream(const std::string& filepath,
+                                  const CtCsvRowFunc& onRow,
+                                  const CtCsvProgressFunc& onProgress)
 {
-    CtStringTable tbl_matrix;
+    FILE* pFile = g_fopen(filepath.c_str(), "rb");
+    if (not pFile) {
+        spdlog::error("!! {} could not open {}", __FUNCTION__, filepath);
+        return false;
+    }
+    auto on_scope_exit = scope_guard([pFile](void*) { fclose(pFile); });
+    const double fileSize = static_cast<double>(fs::file_size(filepath));
 
     std::vector<std::string> tbl_row;
     constexpr char cell_tag = '"';
@@ -62,56 +71,105 @@ CtCSV::CtStringTable CtCSV::table_from_csv(const std::string& filepath)
     bool in_string = false;
     bool escape_next = false;
 
-    std::string input = Glib::file_get_contents(filepath);
+    std::vector<char> chunk(CSV_CHUNK_SIZE);
     std::string cell_buff;
+    size_t processed{0};
+    bool reached_nul{false};
 
-    for (auto ch : input) {
+    while (not reached_nul) {
+        const size_t readSize = fread(chunk.data(), 1, chunk.size(), pFile);
+        for (size_t i = 0; i < readSize; ++i) {
+            const char ch = chunk[i];
 
-        if (ch == '\0') break;
-        if (escape_next) {
-            escape_next = false;
-            cell_buff += ch;
-            continue;
-        }
-        if (ch == esc ) {
-            // `\` escapes anything `"` escapes a quote
-            escape_next = true;
-            continue;
-        }
-        bool is_newline = ch == '\n';
-        if ((ch == cell_sep || is_newline) && !in_string) {
-            // Close the cell
-            tbl_row.emplace_back(cell_buff);
-            cell_buff.clear();
-
-            if (is_newline) {
-                tbl_matrix.emplace_back(tbl_row);
-                tbl_row.clear();
+            if (ch == '\0') {
+                reached_nul = true;
+                break;
+            }
+            if (escape_next) {
+                escape_next = false;
+                cell_buff += ch;
                 continue;
             }
+            if (ch == esc ) {
+                // `\` escapes anything `"` escapes a quote
+                escape_next = true;
+                continue;
+            }
+            bool is_newline = ch == '\n';
+            if ((ch == cell_sep || is_newline) && !in_string) {
+                // Close the cell
+                tbl_row.emplace_back(std::move(cell_buff));
+                cell_buff.clear();
+
+                if (is_newline) {
+                    if (not onRow(tbl_row)) {
+                        return false;
+                    }
+                    tbl_row.clear();
+                    continue;
+                }
+            }
+            else if (ch == cell_tag) {
+                in_string = !in_string;
+            }
+            else {
+                cell_buff += ch;
+            }
         }
-        else if (ch == cell_tag) {
-            in_string = !in_string;
+        processed += readSize;
+        if (readSize < chunk.size()) {
+            if (ferror(pFile)) {
+                spdlog::error("!! {} could not read {}", __FUNCTION__, filepath);
+                return false;
+            }
+            break;
         }
-        else {
-            cell_buff += ch;
+        if (onProgress and fileSize > 0 and not onProgress(processed/fileSize)) {
+            return false;
         }
     }
+    // last record not terminated by newline
+    if (not cell_buff.empty() or not tbl_row.empty()) {
+        tbl_row.emplace_back(std::move(cell_buff));
+        if (not onRow(tbl_row)) {
+            return false;
+        }
+    }
+    return true;
+}
 
+CtCSV::CtStringTable CtCSV::table_from_csv(const std::string& filepath)
+{
+    CtStringTable tbl_matrix;
+    (void)table_from_csv_stream(filepath, [&tbl_matrix](std::vector<std::string>& row){
+        tbl_matrix.emplace_back(std::move(row));
+        return true;
+    });
     return tbl_matrix;
 }
 
+void CtCSV::cell_to_csv(const std::string_view cell, const bool isLastOfRow, std::string& csvOut)
+{
+    csvOut += '"';
+    for (const char ch : cell) {
+        if ('"' == ch) {
+            csvOut += '\\';
+        }
+        csvOut += ch;
+    }
+    csvOut += '"';
+    csvOut += isLastOfRow ? '\n' : ',';
+}
+
 std::string CtCSV::table_to_csv(const CtStringTable& table)
 {
     std::string ret_str;
     for (const auto& row : table) {
         const size_t numCols = row.size();
         for (size_t i = 0u; i < numCols; ++i) {
-            ret_str += fmt::format("\"{}\"", str::replace(row.at(i), std::string{"\""}, std::string{"\\\""}));
-
-            if (i < (numCols - 1u)) ret_str += ",";
+            cell_to_csv(row.at(i), i == (numCols - 1u), ret_str);
         }
-        ret_str += "\n";
+        if (0u == numCols) ret_str += "\n";
     }
     return ret_str;
 }
@@ -324,45 +382,22 @@ Glib::ustring CtMiscUtil::get_link_property_from_entry(const CtLinkEntry& link_e
 // Check if the cursor is on a link, in this case select the link and return the tag_property_value
 Glib::ustring CtMiscUtil::link_check_around_cursor(Glib::RefPtr<Gtk::TextBuffer> pTextBuffer, std::optional<Gtk::TextIter> optTextIter/*= std::nullopt*/)
 {
-    auto link_check_around_cursor_iter = [](Gtk::TextIter text_iter)->Glib::ustring{
-        auto tags = text_iter.get_tags();
-        for (auto& tag : tags) {
-            Glib::ustring tag_name = tag->property_name();
-            if (str::startswith(tag_name, CtConst::TAG_LINK)) {
-                return tag_name;
-            }
-        }
-        return "";
-    };
     Gtk::TextIter text_iter = optTextIter.has_value() ? optTextIter.value() : pTextBuffer->get_insert()->get_iter();
-    Glib::ustring tag_name = link_check_around_cursor_iter(text_iter);
-    if (tag_name.empty()) {
+    std::string link_property = CtTextIterUtil::get_link_at(text_iter);
+    if (link_property.empty()) {
         if (text_iter.get_char() == ' ' and text_iter.backward_char()) {
-            tag_name = link_check_around_cursor_iter(text_iter);
-            if (tag_name.empty()) return "";
+            link_property = CtTextIterUtil::get_link_at(text_iter);
+            if (link_property.empty()) return "";
         }
         else {
             return "";
         }
     }
-    auto iter_end = text_iter;
-    while (iter_end.forward_char()) {
-        Glib::ustring ret_tag_name = link_check_around_cursor_iter(iter_end);
-        if (ret_tag_name != tag_name) {
-            break;
-        }
-    }
-    while (text_iter.backward_char()) {
-        Glib::ustring ret_tag_name = link_check_around_cursor_iter(text_iter);
-        if (ret_tag_name != tag_name) {
-            text_iter.forward_char();
-            break;
-        }
-    }
-    if (text_iter == iter_end) return "";
+    Gtk::TextIter iter_start, iter_end;
+    if (not CtLinkTable::get(pTextBuffer)->get_bounds(text_iter, iter_start, iter_end)) return "";
     pTextBuffer->move_mark(pTextBuffer->get_insert(), iter_end);
-    pTextBuffer->move_mark(pTextBuffer->get_selection_bound(), text_iter);
-    return tag_name.substr(5);
+    pTextBuffer->move_mark(pTextBuffer->get_selection_bound(), iter_start);
+    return link_property;
 }
 
 bool CtMiscUtil::mime_type_contains(const std::string &filepath, const char* type)
@@ -500,6 +535,14 @@ std::optional<Glib::ustring> CtTextIterUtil::iter_get_tag_startingwith(const Gtk
     return std::nullopt;
 }
 
+std::string CtTextIterUtil::get_link_at(const Gtk::TextIter& iter)
+{
+    if (not iter_get_tag_startingwith(iter, CtConst::TAG_LINK_PREFIX).has_value()) {
+        return "";
+    }
+    return CtLinkTable::get(iter.get_buffer())->get_link(iter);
+}
+
 Glib::ustring CtTextIterUtil::get_selected_text(Glib::RefPtr<Gtk::TextBuffer> pTextBuffer)
 {
     Gtk::TextIter iter_sel_start, iter_sel_end;
@@ -625,6 +668,8 @@ bool CtTextIterUtil::rich_text_attributes_update(const Gtk::TextIter& text_iter,
                                                  CtCurrAttributesMap& delta_attributes)
 {
     delta_attributes.clear();
+    bool link_toggled_off{false};
+    bool link_toggled_on{false};
 #if GTKMM_MAJOR_VERSION >= 4
     auto toggled_off = text_iter.get_toggled_tags(false/*toggled_on*/);
 #else
@@ -645,7 +690,7 @@ bool CtTextIterUtil::rich_text_attributes_update(const Gtk::TextIter& text_iter,
         else if (str::startswith(tag_name, CtConst::TAG_SCALE_PREFIX)) delta_attributes[CtConst::TAG_SCALE].clear();
         else if (str::startswith(tag_name, CtConst::TAG_INVISIBLE_PREFIX)) delta_attributes[CtConst::TAG_INVISIBLE].clear();
         else if (str::startswith(tag_name, CtConst::TAG_JUSTIFICATION_PREFIX)) delta_attributes[CtConst::TAG_JUSTIFICATION].clear();
-        else if (str::startswith(tag_name, CtConst::TAG_LINK_PREFIX)) delta_attributes[CtConst::TAG_LINK].clear();
+        else if (str::startswith(tag_name, CtConst::TAG_LINK_PREFIX)) { delta_attributes[CtConst::TAG_LINK].clear(); link_toggled_off = true; }
         else if (str::startswith(tag_name, CtConst::TAG_FAMILY_PREFIX)) delta_attributes[CtConst::TAG_FAMILY].clear();
     }
 #if GTKMM_MAJOR_VERSION >= 4
@@ -668,9 +713,19 @@ bool CtTextIterUtil::rich_text_attributes_update(const Gtk::TextIter& text_iter,
         else if (str::startswith(tag_name, CtConst::TAG_UNDERLINE_PREFIX)) delta_attributes[CtConst::TAG_UNDERLINE] = tag_name.substr(10);
         else if (str::startswith(tag_name, CtConst::TAG_STRIKETHROUGH_PREFIX)) delta_attributes[CtConst::TAG_STRIKETHROUGH] = tag_name.substr(14);
         else if (str::startswith(tag_name, CtConst::TAG_INDENT_PREFIX)) delta_attributes[CtConst::TAG_INDENT] = tag_name.substr(7);
-        else if (str::startswith(tag_name, CtConst::TAG_LINK_PREFIX)) delta_attributes[CtConst::TAG_LINK] = tag_name.substr(5);
+        else if (str::startswith(tag_name, CtConst::TAG_LINK_PREFIX)) link_toggled_on = true;
         else if (str::startswith(tag_name, CtConst::TAG_FAMILY_PREFIX)) delta_attributes[CtConst::TAG_FAMILY] = tag_name.substr(7);
     }
+    // the link style tag is shared by all the links of a type, the link property is in the link table
+    // and may change without a toggle between adjacent links
+    const auto linkFound = curr_attributes.find(CtConst::TAG_LINK);
+    const bool inside_link = not link_toggled_off and curr_attributes.end() != linkFound and not linkFound->second.empty();
+    if (link_toggled_on or inside_link) {
+        const std::string link_property = CtLinkTable::get(text_iter.get_buffer())->get_link(text_iter);
+        if (link_toggled_on or link_property != linkFound->second) {
+            delta_attributes[CtConst::TAG_LINK] = link_property;
+        }
+    }
     bool anyDelta{false};
     for (const auto& currDelta : delta_attributes) {
         auto keyFound = curr_attributes.find(currDelta.first);
@@ -833,10 +888,54 @@ PangoDirection CtTextIterUtil::get_pango_direction(const Gtk::TextIter& textIter
     return PANGO_DIRECTION_NEUTRAL;
 }
 
+namespace {
+
+// lines copied at once from a buffer, a word never spans more than one line
+const constexpr int TEXT_CHUNK_LINES{2000};
+
+template<class F> void text_chunks_foreach(const Gtk::TextIter& start_iter, const Gtk::TextIter& end_iter, F f)
+{
+    Gtk::TextIter chunk_start = start_iter;
+    while (chunk_start.compare(end_iter) < 0) {
+        Gtk::TextIter chunk_end = chunk_start;
+        chunk_end.forward_lines(TEXT_CHUNK_LINES); // end of the buffer if not as many lines
+        if (chunk_end.compare(end_iter) > 0) {
+            chunk_end = end_iter;
+        }
+        f(chunk_start.get_text(chunk_end));
+        chunk_start = chunk_end;
+    }
+}
+
+} // namespace (anonymous)
+
 int CtTextIterUtil::get_words_count(const Glib::RefPtr<Gtk::TextBuffer>& text_buffer)
+{
+    int words{0};
+    text_chunks_foreach(text_buffer->begin(), text_buffer->end(), [&words](const Glib::ustring& chunk){
+        words += get_words_count(chunk);
+    });
+    return words;
+}
+
+void CtTextIterUtil::get_text_by_chunks(const Gtk::TextIter& start_iter,
+                                        const Gtk::TextIter& end_iter,
+                                        std::string& text_raw,
+                                        size_t& chars,
+                                        size_t& words)
+{
+    // at least a byte per character
+    text_raw.reserve(text_raw.size() + static_cast<size_t>(std::max(0, end_iter.get_offset() - start_iter.get_offset())));
+    text_chunks_foreach(start_iter, end_iter, [&](const Glib::ustring& chunk){
+        chars += chunk.size();
+        words += static_cast<size_t>(get_words_count(chunk));
+        text_raw += chunk.raw();
+    });
+}
+
+int CtTextIterUtil::get_words_count(const Glib::ustring& text)
 {
     int words = 0;
-    Glib::ustring text = text_buffer->get_text(true);
     if (!text.empty())
     {
         int text_size = text.size();
@@ -1551,78 +1650,120 @@ Glib::ustring str::sanitize_bad_symbols(const Glib::ustring& xml_content)
     return re_pattern->replace(xml_content, 0/*start_position*/, "", static_cast<Glib::RegexMatchFlags>(0u));
 }
 
-struct DiacrToAscii {
-    DiacrToAscii(const char* replacement_, const char* pattern_)
-     : replacement{replacement_}
-     , pattern{pattern_}
-    {}
-    Glib::ustring replacement;
-    Glib::ustring pattern;
-    Glib::RefPtr<Glib::Regex> pRegExp;
-};
-static std::list<DiacrToAscii> list_DiacrToAscii{
-    {"a", "[àáâãäåāăąạ]"},
-    {"A", "[ÀÁÂÃÄÅĀĂĄẠ]"},
-    {"b", "[ḅ]"},
-    {"B", "[Ḅ]"},
-    {"c", "[çćĉċč]"},
-    {"C", "[ÇĆĈĊČ]"},
-    {"d", "[ďđḍ]"},
-    {"D", "[ĎĐḌ]"},
-    {"e", "[èéêëēĕėęěẹ]"},
-    {"E", "[ÈÉÊËĒĔĖĘĚẸ]"},
-    {"g", "[ĝğġģ]"},
-    {"G", "[ĜĞĠĢ]"},
-    {"h", "[ĥħḥ]"},
-    {"H", "[ĤĦḤ]"},
-    {"i", "[ìíîïĩīĭįıị]"},
-    {"I", "[ÌÍÎÏĨĪĬĮİỊ]"},
-    {"j", "[ĵ]"},
-    {"J", "[Ĵ]"},
-    {"k", "[ķḳ]"},
-    {"K", "[ĶḲ]"},
-    {"l", "[ĺļľŀłḷ]"},
-    {"L", "[ĹĻĽĿŁḶ]"},
-    {"m", "[ṃ]"},
-    {"M", "[Ṃ]"},
-    {"n", "[ñńņňŉṇ]"},
-    {"N", "[ÑŃŅŇṆ]"},
-    {"o", "[òóôõöøōŏőọ]"},
-    {"O", "[ÒÓÔÕÖØŌŎŐỌ]"},
-    {"r", "[ŕŗřṛ]"},
-    {"R", "[ŔŖŘṚ]"},
-    {"s", "[śŝşšṣ]"},
-    {"S", "[ŚŜŞŠṢ]"},
-    {"t", "[ţťŧṭ]"},
-    {"T", "[ŢŤŦṬ]"},
-    {"u", "[ùúûüũūŭůűųụ]"},
-    {"U", "[ÙÚÛÜŨŪŬŮŰŲỤ]"},
-    {"w", "[ŵẉ]"},
-    {"W", "[ŴẈ]"},
-    {"y", "[ýŷÿỵ]"},
-    {"Y", "[ÝŶŸỴ]"},
-    {"z", "[źżžẓ]"},
-    {"Z", "[ŹŻŽẒ]"},
+namespace {
+
+struct CtDiacrToAscii
+{
+    char        replacement;
+    const char* diacriticals;
 };
-static bool list_DiacrToAscii_initialised{false};
+const std::array<CtDiacrToAscii, 42> DIACR_TO_ASCII{{
+    {'a', "àáâãäåāăąạ"},
+    {'A', "ÀÁÂÃÄÅĀĂĄẠ"},
+    {'b', "ḅ"},
+    {'B', "Ḅ"},
+    {'c', "çćĉċč"},
+    {'C', "ÇĆĈĊČ"},
+    {'d', "ďđḍ"},
+    {'D', "ĎĐḌ"},
+    {'e', "èéêëēĕėęěẹ"},
+    {'E', "ÈÉÊËĒĔĖĘĚẸ"},
+    {'g', "ĝğġģ"},
+    {'G', "ĜĞĠĢ"},
+    {'h', "ĥħḥ"},
+    {'H', "ĤĦḤ"},
+    {'i', "ìíîïĩīĭįıị"},
+    {'I', "ÌÍÎÏĨĪĬĮİỊ"},
+    {'j', "ĵ"},
+    {'J', "Ĵ"},
+    {'k', "ķḳ"},
+    {'K', "ĶḲ"},
+    {'l', "ĺļľŀłḷ"},
+    {'L', "ĹĻĽĿŁḶ"},
+    {'m', "ṃ"},
+    {'M', "Ṃ"},
+    {'n', "ñńņňŉṇ"},
+    {'N', "ÑŃŅŇṆ"},
+    {'o', "òóôõöøōŏőọ"},
+    {'O', "ÒÓÔÕÖØŌŎŐỌ"},
+    {'r', "ŕŗřṛ"},
+    {'R', "ŔŖŘṚ"},
+    {'s', "śŝşšṣ"},
+    {'S', "ŚŜŞŠṢ"},
+    {'t', "ţťŧṭ"},
+    {'T', "ŢŤŦṬ"},
+    {'u', "ùúûüũūŭůűųụ"},
+    {'U', "ÙÚÛÜŨŪŬŮŰŲỤ"},
+    {'w', "ŵẉ"},
+    {'W', "ŴẈ"},
+    {'y', "ýŷÿỵ"},
+    {'Y', "ÝŶŸỴ"},
+    {'z', "źżžẓ"},
+    {'Z', "ŹŻŽẒ"},
+}};
+// all the diacriticals above are in Latin-1 Supplement to Latin Extended Additional
+constexpr gunichar DIACR_FIRST{0x00C0};
+constexpr gunichar DIACR_LAST{0x1EFF};
+
+// codepoint - DIACR_FIRST -> ascii replacement, 0 if none
+const std::vector<char>& _get_diacr_to_ascii_table()
+{
+    static const std::vector<char> table = [](){
+        std::vector<char> diacrTable(DIACR_LAST - DIACR_FIRST + 1, '\0');
+        for (const CtDiacrToAscii& diacrToAscii : DIACR_TO_ASCII) {
+            for (const gchar* pChar = diacrToAscii.diacriticals; *pChar; pChar = g_utf8_next_char(pChar)) {
+                const gunichar uc = g_utf8_get_char(pChar);
+                if (uc >= DIACR_FIRST and uc <= DIACR_LAST) {
+                    diacrTable[uc - DIACR_FIRST] = diacrToAscii.replacement;
+                }
+            }
+        }
+        return diacrTable;
+    }();
+    return table;
+}
+
+} // namespace (anonymous)
 
 // https://docs.oracle.com/cd/E29584_01/webhelp/mdex_basicDev/src/rbdv_chars_mapping.html
 Glib::ustring str::diacritical_to_ascii(const Glib::ustring& in_text)
 {
-    const Glib::RegexMatchFlags re_flags{static_cast<Glib::RegexMatchFlags>(0u)};
-    Glib::ustring tmp_str{in_text};
-    if (not list_DiacrToAscii_initialised) {
-        list_DiacrToAscii_initialised = true;
-        for (DiacrToAscii& curr_DiacrToAscii : list_DiacrToAscii) {
-            curr_DiacrToAscii.pRegExp = Glib::Regex::create(curr_DiacrToAscii.pattern);
+    // single pass, every character is replaced by one character so the
+    // characters offsets in the returned text are valid in in_text
+    const std::vector<char>& diacrTable = _get_diacr_to_ascii_table();
+    const std::string& inRaw = in_text.raw();
+    const char* pIn = inRaw.data();
+    const char* const pEnd = pIn + inRaw.size();
+    std::string outRaw;
+    outRaw.reserve(inRaw.size());
+    while (pIn < pEnd) {
+        // the runs of ascii are copied as they are, checking 8 bytes at a time
+        const char* pRunEnd = pIn;
+        for (guint64 word; pEnd - pRunEnd >= 8; pRunEnd += 8) {
+            memcpy(&word, pRunEnd, 8);
+            if (word & 0x8080808080808080ull) {
+                break;
+            }
         }
-    }
-    for (DiacrToAscii& curr_DiacrToAscii : list_DiacrToAscii) {
-        if (curr_DiacrToAscii.pRegExp->match(tmp_str, re_flags)) {
-            tmp_str = curr_DiacrToAscii.pRegExp->replace(tmp_str, 0/*start_position*/, curr_DiacrToAscii.replacement, re_flags);
+        while (pRunEnd < pEnd and static_cast<unsigned char>(*pRunEnd) < 0x80) {
+            ++pRunEnd;
+        }
+        outRaw.append(pIn, pRunEnd - pIn);
+        if (pRunEnd >= pEnd) {
+            break;
         }
+        pIn = pRunEnd;
+        const char* pNext = std::min<const char*>(g_utf8_next_char(pIn), pEnd);
+        const gunichar uc = g_utf8_get_char(pIn);
+        if (uc >= DIACR_FIRST and uc <= DIACR_LAST and diacrTable[uc - DIACR_FIRST]) {
+            outRaw += diacrTable[uc - DIACR_FIRST];
+        }
+        else {
+            outRaw.append(pIn, pNext - pIn);
+        }
+        pIn = pNext;
     }
-    return tmp_str;
+    return Glib::ustring{outRaw};
 }
 
 Glib::ustring str::re_escape(const Glib::ustring& text)
@@ -1705,3 +1846,1081 @@ Glib::ustring str::repeat(const Glib::ustring& input, int num)
 
 
 
+
+/*static*/std::string CtMatchIndex::fold(const Glib::ustring& text)
+{
+    std::string folded;
+    gchar* pDecomposed = g_utf8_normalize(text.c_str(), -1, G_NORMALIZE_NFD);
+    if (not pDecomposed) {
+        return folded;
+    }
+    folded.reserve(text.bytes());
+    gchar utf8Buff[6];
+    for (const gchar* pChar = pDecomposed; *pChar; pChar = g_utf8_next_char(pChar)) {
+        if (static_cast<unsigned char>(*pChar) < 0x80) {
+            folded += g_ascii_tolower(*pChar);
+            continue;
+        }
+        const gunichar uc = g_utf8_get_char(pChar);
+        if (g_unichar_ismark(uc)) {
+            continue;
+        }
+        folded.append(utf8Buff, g_unichar_to_utf8(g_unichar_tolower(uc), utf8Buff));
+    }
+    g_free(pDecomposed);
+    return folded;
+}
+
+void CtMatchIndex::clear()
+{
+    _entries.clear();
+    _idToIdx.clear();
+    _nextOrder = 0;
+}
+
+const CtMatchIndex::Entry* CtMatchIndex::get(const gint64 id) const
+{
+    auto it = _idToIdx.find(id);
+    return it != _idToIdx.end() ? &_entries[it->second] : nullptr;
+}
+
+void CtMatchIndex::set(const gint64 id, std::string folded_label, std::string folded_path, const gint64 group, const gint64 order)
+{
+    Entry* pEntry{nullptr};
+    auto it = _idToIdx.find(id);
+    if (it != _idToIdx.end()) {
+        pEntry = &_entries[it->second];
+    }
+    else {
+        _idToIdx[id] = _entries.size();
+        pEntry = &_entries.emplace_back();
+        pEntry->id = id;
+        pEntry->order = _nextOrder;
+    }
+    if (order >= 0) {
+        pEntry->order = order;
+    }
+    _nextOrder = std::max(_nextOrder, pEntry->order + 1);
+    pEntry->group = group;
+    pEntry->label = std::move(folded_label);
+    pEntry->path = std::move(folded_path);
+    pEntry->labelWordStarts.clear();
+    for (size_t i = 0; i < pEntry->label.size(); ++i) {
+        const unsigned char prev = i > 0 ? static_cast<unsigned char>(pEntry->label[i-1]) : ' ';
+        if (prev < 0x80 and not g_ascii_isalnum(prev)) {
+            pEntry->labelWordStarts.push_back(static_cast<guint32>(i));
+        }
+    }
+}
+
+void CtMatchIndex::remove(const gint64 id)
+{
+    auto it = _idToIdx.find(id);
+    if (it == _idToIdx.end()) {
+        return;
+    }
+    const size_t idx = it->second;
+    _idToIdx.erase(it);
+    if (idx != _entries.size() - 1) {
+        _entries[idx] = std::move(_entries.back());
+        _idToIdx[_entries[idx].id] = idx;
+    }
+    _entries.pop_back();
+}
+
+std::vector<gint64> CtMatchIndex::get_ids_in_group(const gint64 group) const
+{
+    std::vector<gint64> ids;
+    for (const Entry& entry : _entries) {
+        if (entry.group == group) {
+            ids.push_back(entry.id);
+        }
+    }
+    return ids;
+}
+
+namespace {
+
+bool _match_index_found_at_word_start(const CtMatchIndex::Entry& entry, const std::string& word)
+{
+    for (size_t pos = entry.label.find(word); pos != std::string::npos; pos = entry.label.find(word, pos + 1)) {
+        if (std::binary_search(entry.labelWordStarts.begin(), entry.labelWordStarts.end(), static_cast<guint32>(pos))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool _match_index_is_subsequence(const std::string& text, const std::string& chars)
+{
+    size_t pos{0};
+    for (const gchar* pChar = chars.c_str(); *pChar; ) {
+        const gchar* pNext = g_utf8_next_char(pChar);
+        if (*pChar != ' ') {
+            pos = text.find(pChar, pos, pNext - pChar);
+            if (std::string::npos == pos) {
+                return false;
+            }
+            pos += pNext - pChar;
+        }
+        pChar = pNext;
+    }
+    return true;
+}
+
+} // namespace (anonymous)
+
+/*static*/int CtMatchIndex::score(const Entry& entry, const std::string& filter, const std::vector<std::string>& words)
+{
+    // within a tier, the matches at the start of a word come first
+    if (str::startswith(entry.label, filter)) {
+        return 0;
+    }
+    if (entry.label.find(filter) != std::string::npos) {
+        return _match_index_found_at_word_start(entry, filter) ? 2 : 3;
+    }
+    if (CtStrUtil::contains_words(entry.label, words)) {
+        const bool allAtWordStart = std::all_of(words.begin(), words.end(), [&entry](const std::string& word){
+            return _match_index_found_at_word_start(entry, word);
+        });
+        return allAtWordStart ? 4 : 5;
+    }
+    if (CtStrUtil::contains_words(entry.label, words, false/*require_all*/)) {
+        const bool anyAtWordStart = std::any_of(words.begin(), words.end(), [&entry](const std::string& word){
+            return _match_index_found_at_word_start(entry, word);
+        });
+        return anyAtWordStart ? 6 : 7;
+    }
+    if (CtStrUtil::contains_words(entry.path, words)) {
+        return 8;
+    }
+    if (CtStrUtil::contains_words(entry.path, words, false/*require_all*/)) {
+        return 9;
+    }
+    if (_match_index_is_subsequence(entry.label, filter)) {
+        return 10;
+    }
+    return NoMatch;
+}
+
+std::vector<gint64> CtMatchIndex::query(const Glib::ustring& filter, const size_t max_results) const
+{
+    const std::vector<std::string> words = str::split(fold(filter), " ", true/*compress*/);
+    const std::string folded_filter = str::join(words, " ");
+    struct CtMatchHit
+    {
+        int    score;
+        gint64 order;
+        gint64 id;
+    };
+    std::vector<CtMatchHit> hits;
+    hits.reserve(folded_filter.empty() ? _entries.size() : 256);
+    for (const Entry& entry : _entries) {
+        const int score = folded_filter.empty() ? 0 : CtMatchIndex::score(entry, folded_filter, words);
+        if (NoMatch != score) {
+            hits.push_back(CtMatchHit{score, entry.order, entry.id});
+        }
+    }
+    const size_t numResults = std::min(max_results, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + numResults, hits.end(), [](const CtMatchHit& a, const CtMatchHit& b){
+        return a.score != b.score ? a.score < b.score : a.order < b.order;
+    });
+    std::vector<gint64> ids;
+    ids.reserve(numResults);
+    for (size_t i = 0; i < numResults; ++i) {
+        ids.push_back(hits[i].id);
+    }
+    return ids;
+}
+
+/*static*/bool CtLinkIndex::add_link_from_property(const std::string& link_property, NodeData& nodeData)
+{
+    if (not str::startswith(link_property, CtConst::LINK_TYPE_NODE)) {
+        return false;
+    }
+    CtLinkEntry link_entry;
+    try {
+        link_entry = CtMiscUtil::get_link_entry_from_property(link_property);
+    }
+    catch (std::exception& e) {
+        spdlog::debug("{} bad link '{}': {}", __FUNCTION__, link_property, e.what());
+        return false;
+    }
+    if (CtLinkType::Node != link_entry.type) {
+        return false;
+    }
+    Target target{link_entry.node_id, link_entry.anch.raw()};
+    auto it = std::lower_bound(nodeData.links.begin(), nodeData.links.end(), target);
+    if (it == nodeData.links.end() or not (*it == target)) {
+        nodeData.links.insert(it, std::move(target));
+    }
+    return true;
+}
+
+/*static*/std::string CtLinkIndex::to_link_property(const Target& target)
+{
+    std::string link_property = CtConst::LINK_TYPE_NODE + CtConst::CHAR_SPACE + std::to_string(target.nodeId);
+    if (not target.anchor.empty()) {
+        link_property += CtConst::CHAR_SPACE + target.anchor;
+    }
+    return link_property;
+}
+
+void CtLinkIndex::clear()
+{
+    _nodes.clear();
+    _referrers.clear();
+}
+
+void CtLinkIndex::set_node(const gint64 nodeId, NodeData nodeData)
+{
+    remove_node(nodeId);
+    std::sort(nodeData.links.begin(), nodeData.links.end());
+    nodeData.links.erase(std::unique(nodeData.links.begin(), nodeData.links.end()), nodeData.links.end());
+    for (const Target& target : nodeData.links) {
+        ++_referrers[target.nodeId][nodeId];
+    }
+    _nodes[nodeId] = std::move(nodeData);
+}
+
+void CtLinkIndex::remove_node(const gint64 nodeId)
+{
+    auto it = _nodes.find(nodeId);
+    if (it == _nodes.end()) {
+        return;
+    }
+    for (const Target& target : it->second.links) {
+        auto itTarget = _referrers.find(target.nodeId);
+        if (itTarget == _referrers.end()) {
+            continue;
+        }
+        auto itReferrer = itTarget->second.find(nodeId);
+        if (itReferrer != itTarget->second.end() and --itReferrer->second <= 0) {
+            itTarget->second.erase(itReferrer);
+        }
+        if (itTarget->second.empty()) {
+            _referrers.erase(itTarget);
+        }
+    }
+    _nodes.erase(it);
+}
+
+const CtLinkIndex::NodeData* CtLinkIndex::get_node(const gint64 nodeId) const
+{
+    auto it = _nodes.find(nodeId);
+    return it != _nodes.end() ? &it->second : nullptr;
+}
+
+std::optional<bool> CtLinkIndex::has_anchor(const gint64 nodeId, const std::string& anchor) const
+{
+    const NodeData* pNodeData = get_node(nodeId);
+    if (not pNodeData) {
+        return std::nullopt;
+    }
+    return pNodeData->anchors.count(anchor) != 0;
+}
+
+std::vector<gint64> CtLinkIndex::get_referrers(const gint64 nodeId, const std::string* pAnchor) const
+{
+    std::vector<gint64> referrers;
+    auto itTarget = _referrers.find(nodeId);
+    if (itTarget == _referrers.end()) {
+        return referrers;
+    }
+    for (const auto& [referrerId, count] : itTarget->second) {
+        if (pAnchor) {
+            const NodeData* pNodeData = get_node(referrerId);
+            if (not pNodeData or not std::binary_search(pNodeData->links.begin(), pNodeData->links.end(), Target{nodeId, *pAnchor})) {
+                continue;
+            }
+        }
+        referrers.push_back(referrerId);
+    }
+    std::sort(referrers.begin(), referrers.end());
+    return referrers;
+}
+
+std::vector<CtLinkIndex::BrokenLink> CtLinkIndex::get_broken_links(const std::function<bool(const gint64)>& nodeExists) const
+{
+    std::vector<BrokenLink> brokenLinks;
+    for (const auto& [nodeId, nodeData] : _nodes) {
+        if (not nodeExists(nodeId)) {
+            continue;
+        }
+        for (const Target& target : nodeData.links) {
+            if (not nodeExists(target.nodeId)) {
+                brokenLinks.push_back(BrokenLink{nodeId, target, true/*missingNode*/});
+            }
+            else if (not target.anchor.empty() and has_anchor(target.nodeId, target.anchor) == false) {
+                brokenLinks.push_back(BrokenLink{nodeId, target, false/*missingNode*/});
+            }
+        }
+    }
+    std::sort(brokenLinks.begin(), brokenLinks.end(), [](const BrokenLink& a, const BrokenLink& b){
+        return a.referrerId != b.referrerId ? a.referrerId < b.referrerId : a.target < b.target;
+    });
+    return brokenLinks;
+}
+
+/*static*/CtLinkTable* CtLinkTable::get(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer)
+{
+    auto pCtLinkTable = static_cast<CtLinkTable*>(pTextBuffer->get_data(CtConst::LINK_TABLE_ID));
+    if (not pCtLinkTable) {
+        pCtLinkTable = new CtLinkTable{pTextBuffer.get()};
+        pTextBuffer->set_data(CtConst::LINK_TABLE_ID, pCtLinkTable, [](gpointer data){
+            delete static_cast<CtLinkTable*>(data);
+        });
+    }
+    return pCtLinkTable;
+}
+
+/*static*/std::string CtLinkTable::get_style_tag_name(const std::string& link_property)
+{
+    return CtConst::TAG_LINK_PREFIX + link_property.substr(0, 4);
+}
+
+void CtLinkTable::set(const Gtk::TextIter& iter_start, const Gtk::TextIter& iter_end, const std::string& link_property)
+{
+    const int start_offset = iter_start.get_offset();
+    const int end_offset = iter_end.get_offset();
+    if (start_offset >= end_offset) {
+        return;
+    }
+    _clear_range(start_offset, end_offset);
+    Range range{_pTextBuffer->create_mark(_pTextBuffer->get_iter_at_offset(start_offset), false/*left_gravity*/),
+                _pTextBuffer->create_mark(_pTextBuffer->get_iter_at_offset(end_offset), true/*left_gravity*/),
+                link_property};
+    _ranges.insert(_ranges.begin() + _get_first_starting_after(start_offset), std::move(range));
+}
+
+void CtLinkTable::remove(const Gtk::TextIter& iter_start, const Gtk::TextIter& iter_end)
+{
+    const int start_offset = iter_start.get_offset();
+    const int end_offset = iter_end.get_offset();
+    if (start_offset < end_offset) {
+        _clear_range(start_offset, end_offset);
+    }
+}
+
+std::string CtLinkTable::get_link(const Gtk::TextIter& text_iter) const
+{
+    const int offset = text_iter.get_offset();
+    const size_t idx = _get_first_starting_after(offset);
+    // the previous ranges end before the start of this one
+    if (idx > 0u and offset < _ranges.at(idx - 1).rEnd->get_iter().get_offset()) {
+        return _ranges.at(idx - 1).linkProperty;
+    }
+    return "";
+}
+
+bool CtLinkTable::get_bounds(const Gtk::TextIter& text_iter, Gtk::TextIter& iter_start, Gtk::TextIter& iter_end) const
+{
+    const int offset = text_iter.get_offset();
+    const size_t idx = _get_first_starting_after(offset);
+    if (0u == idx) {
+        return false;
+    }
+    // the previous ranges end before the start of this one
+    const Range& range = _ranges.at(idx - 1);
+    iter_end = range.rEnd->get_iter();
+    if (offset >= iter_end.get_offset()) {
+        return false;
+    }
+    iter_start = range.rStart->get_iter();
+    return true;
+}
+
+void CtLinkTable::for_each(const std::function<void(const Gtk::TextIter& iter_start,
+                                                    const Gtk::TextIter& iter_end,
+                                                    const std::string& link_property)>& f_action) const
+{
+    for (const Range& range : _ranges) {
+        const Gtk::TextIter iter_start = range.rStart->get_iter();
+        const Gtk::TextIter iter_end = range.rEnd->get_iter();
+        if (iter_start.compare(iter_end) < 0) {
+            f_action(iter_start, iter_end, range.linkProperty);
+        }
+    }
+}
+
+size_t CtLinkTable::_get_first_starting_after(const int offset) const
+{
+    size_t lo{0u};
+    size_t hi{_ranges.size()};
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (_ranges[mid].rStart->get_iter().get_offset() <= offset) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void CtLinkTable::_clear_range(const int start_offset, const int end_offset)
+{
+    size_t idx = _get_first_starting_after(start_offset);
+    if (idx > 0u) {
+        --idx; // the range starting at or before start_offset may cross it
+    }
+    while (idx < _ranges.size()) {
+        const int range_start = _ranges[idx].rStart->get_iter().get_offset();
+        const int range_end = _ranges[idx].rEnd->get_iter().get_offset();
+        if (range_start > end_offset) {
+            break;
+        }
+        if (range_end <= range_start or (range_start >= start_offset and range_end <= end_offset)) {
+            _erase(idx); // emptied by the edits or covered
+        }
+        else if (range_end <= start_offset or range_start >= end_offset) {
+            ++idx;
+        }
+        else if (range_start < start_offset) {
+            if (range_end > end_offset) {
+                // split, the head and the tail keep the link
+                Range tail{_pTextBuffer->create_mark(_pTextBuffer->get_iter_at_offset(end_offset), false/*left_gravity*/),
+                           _ranges[idx].rEnd,
+                           _ranges[idx].linkProperty};
+                _ranges[idx].rEnd = _pTextBuffer->create_mark(_pTextBuffer->get_iter_at_offset(start_offset), true/*left_gravity*/);
+                _ranges.insert(_ranges.begin() + idx + 1, std::move(tail));
+                break;
+            }
+            _pTextBuffer->move_mark(_ranges[idx].rEnd, _pTextBuffer->get_iter_at_offset(start_offset));
+            ++idx;
+        }
+        else {
+            _pTextBuffer->move_mark(_ranges[idx].rStart, _pTextBuffer->get_iter_at_offset(end_offset));
+            break;
+        }
+    }
+}
+
+void CtLinkTable::_erase(const size_t idx)
+{
+    for (auto& rMark : {_ranges[idx].rStart, _ranges[idx].rEnd}) {
+        if (not rMark->get_deleted()) {
+            _pTextBuffer->delete_mark(rMark);
+        }
+    }
+    _ranges.erase(_ranges.begin() + idx);
+}
+
+/*static*/std::vector<std::string> CtTagIndex::split_tags(const std::string& tags)
+{
+    std::vector<std::string> tagsVec;
+    for (const std::string& word : str::split(tags, " ", true/*compress*/)) {
+        std::string tag = str::trim(word).raw();
+        if (not tag.empty() and not vec::exists(tagsVec, tag)) {
+            tagsVec.push_back(std::move(tag));
+        }
+    }
+    return tagsVec;
+}
+
+void CtTagIndex::clear()
+{
+    _tagNodes.clear();
+    _nodeTags.clear();
+}
+
+void CtTagIndex::set_node(const gint64 nodeId, const std::string& tags)
+{
+    remove_node(nodeId);
+    std::vector<std::string> tagsVec = split_tags(tags);
+    if (tagsVec.empty()) {
+        return;
+    }
+    for (const std::string& tag : tagsVec) {
+        std::vector<gint64>& nodeIds = _tagNodes[tag];
+        nodeIds.insert(std::lower_bound(nodeIds.begin(), nodeIds.end(), nodeId), nodeId);
+    }
+    _nodeTags[nodeId] = std::move(tagsVec);
+}
+
+void CtTagIndex::remove_node(const gint64 nodeId)
+{
+    auto it = _nodeTags.find(nodeId);
+    if (it == _nodeTags.end()) {
+        return;
+    }
+    for (const std::string& tag : it->second) {
+        auto itTag = _tagNodes.find(tag);
+        if (itTag == _tagNodes.end()) {
+            continue;
+        }
+        std::vector<gint64>& nodeIds = itTag->second;
+        auto itNode = std::lower_bound(nodeIds.begin(), nodeIds.end(), nodeId);
+        if (itNode != nodeIds.end() and *itNode == nodeId) {
+            nodeIds.erase(itNode);
+        }
+        if (nodeIds.empty()) {
+            _tagNodes.erase(itTag);
+        }
+    }
+    _nodeTags.erase(it);
+}
+
+std::vector<std::pair<std::string, size_t>> CtTagIndex::get_tags() const
+{
+    std::vector<std::pair<std::string, size_t>> tags;
+    tags.reserve(_tagNodes.size());
+    for (const auto& [tag, nodeIds] : _tagNodes) {
+        tags.push_back(std::make_pair(tag, nodeIds.size()));
+    }
+    return tags;
+}
+
+std::vector<std::string> CtTagIndex::complete(const std::string& prefix, const size_t max_results) const
+{
+    std::vector<std::string> tags;
+    for (auto it = _tagNodes.lower_bound(prefix); it != _tagNodes.end() and str::startswith(it->first, prefix); ++it) {
+        tags.push_back(it->first);
+        if (tags.size() == max_results) {
+            break;
+        }
+    }
+    return tags;
+}
+
+std::vector<gint64> CtTagIndex::query(const std::vector<std::string>& tags, const bool requireAll) const
+{
+    std::vector<const std::vector<gint64>*> nodeIdsVecs;
+    for (const std::string& tag : tags) {
+        auto it = _tagNodes.find(tag);
+        if (it != _tagNodes.end()) {
+            nodeIdsVecs.push_back(&it->second);
+        }
+        else if (requireAll) {
+            return std::vector<gint64>{};
+        }
+    }
+    if (nodeIdsVecs.empty()) {
+        return std::vector<gint64>{};
+    }
+    // intersect starting from the rarest tag, so that the result is the smallest from the start
+    if (requireAll) {
+        std::sort(nodeIdsVecs.begin(), nodeIdsVecs.end(), [](const std::vector<gint64>* a, const std::vector<gint64>* b){
+            return a->size() < b->size();
+        });
+    }
+    std::vector<gint64> result = *nodeIdsVecs.front();
+    std::vector<gint64> tmp;
+    for (size_t i = 1; i < nodeIdsVecs.size(); ++i) {
+        tmp.clear();
+        if (requireAll) {
+            std::set_intersection(result.begin(), result.end(), nodeIdsVecs[i]->begin(), nodeIdsVecs[i]->end(), std::back_inserter(tmp));
+        }
+        else {
+            std::set_union(result.begin(), result.end(), nodeIdsVecs[i]->begin(), nodeIdsVecs[i]->end(), std::back_inserter(tmp));
+        }
+        result.swap(tmp);
+    }
+    return result;
+}
+
+std::vector<gint64> CtTagIndex::query(const std::string& expression) const
+{
+    std::vector<gint64> result;
+    std::vector<gint64> tmp;
+    for (const std::string& alternative : str::split(expression, "|")) {
+        const std::vector<std::string> tags = split_tags(alternative);
+        if (tags.empty()) {
+            continue;
+        }
+        const std::vector<gint64> nodeIds = query(tags, true/*requireAll*/);
+        tmp.clear();
+        std::set_union(result.begin(), result.end(), nodeIds.begin(), nodeIds.end(), std::back_inserter(tmp));
+        result.swap(tmp);
+    }
+    return result;
+}
+
+void CtNodeStats::add_widget(const CtAnchWidgType type, const size_t widgetBlobBytes)
+{
+    switch (type) {
+        case CtAnchWidgType::CodeBox: ++codeboxes; break;
+        case CtAnchWidgType::ImageAnchor: ++anchors; break;
+        case CtAnchWidgType::ImageLatex: ++latexes; break;
+        case CtAnchWidgType::ImageEmbFile: ++embfiles; blobBytes += widgetBlobBytes; break;
+        case CtAnchWidgType::ImagePng: ++images; blobBytes += widgetBlobBytes; break;
+        case CtAnchWidgType::TableHeavy: ++heavytables; break;
+        case CtAnchWidgType::TableLight: ++lighttables; break;
+        default: break;
+    }
+}
+
+void CtNodeStats::add_to(CtSummaryInfo& summaryInfo) const
+{
+    summaryInfo.chars_num += chars;
+    summaryInfo.words_num += words;
+    summaryInfo.blob_bytes += blobBytes;
+    summaryInfo.images_num += images;
+    summaryInfo.latexes_num += latexes;
+    summaryInfo.embfile_num += embfiles;
+    summaryInfo.heavytables_num += heavytables;
+    summaryInfo.lighttables_num += lighttables;
+    summaryInfo.codeboxes_num += codeboxes;
+    summaryInfo.anchors_num += anchors;
+}
+
+std::string CtNodeStats::to_string() const
+{
+    return fmt::format("1 {} {} {} {} {} {} {} {} {} {}",
+        chars, words, blobBytes, images, latexes, embfiles, heavytables, lighttables, codeboxes, anchors);
+}
+
+/*static*/bool CtNodeStats::from_string(const std::string& statsStr, CtNodeStats& stats)
+{
+    const std::vector<std::string> tokens = str::split(statsStr, " ");
+    if (tokens.size() != 11u or tokens.front() != "1") {
+        return false;
+    }
+    std::vector<size_t> values;
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        if (tokens[i].empty() or not std::all_of(tokens[i].begin(), tokens[i].end(), ::isdigit)) {
+            return false;
+        }
+        values.push_back(std::stoull(tokens[i]));
+    }
+    stats.chars = values[0];
+    stats.words = values[1];
+    stats.blobBytes = values[2];
+    stats.images = values[3];
+    stats.latexes = values[4];
+    stats.embfiles = values[5];
+    stats.heavytables = values[6];
+    stats.lighttables = values[7];
+    stats.codeboxes = values[8];
+    stats.anchors = values[9];
+    return true;
+}
+
+/*static*/const char* CtMemoryUsage::get_category_key(const Category category)
+{
+    switch (category) {
+        case Category::TextBuffer: return "text_buffer";
+        case Category::Images: return "images";
+        case Category::EmbFiles: return "embedded_files";
+        case Category::DelayedXml: return "delayed_xml";
+        case Category::UndoHistory: return "undo_history";
+    }
+    return "";
+}
+
+size_t CtMemoryUsage::NodeUsage::get_total() const
+{
+    return std::accumulate(bytes.begin(), bytes.end(), size_t{0u});
+}
+
+void CtMemoryUsage::add(const gint64 nodeId, const Category category, const size_t bytes)
+{
+    NodeUsage& nodeUsage = _nodes[nodeId];
+    nodeUsage.nodeId = nodeId;
+    nodeUsage.bytes[static_cast<size_t>(category)] += bytes;
+}
+
+void CtMemoryUsage::add_shared(const gint64 nodeId, const Category category, const void* pShared, const size_t bytes)
+{
+    if (_shared.insert(pShared).second) {
+        add(nodeId, category, bytes);
+    }
+}
+
+size_t CtMemoryUsage::get_total(const Category category) const
+{
+    size_t total{0u};
+    for (const auto& [nodeId, nodeUsage] : _nodes) {
+        total += nodeUsage.bytes[static_cast<size_t>(category)];
+    }
+    return total;
+}
+
+size_t CtMemoryUsage::get_total() const
+{
+    size_t total{0u};
+    for (const auto& [nodeId, nodeUsage] : _nodes) {
+        total += nodeUsage.get_total();
+    }
+    return total;
+}
+
+std::vector<CtMemoryUsage::NodeUsage> CtMemoryUsage::get_sorted(const std::optional<Category> category) const
+{
+    std::vector<NodeUsage> sorted;
+    sorted.reserve(_nodes.size());
+    for (const auto& [nodeId, nodeUsage] : _nodes) {
+        sorted.push_back(nodeUsage);
+    }
+    auto f_bytes = [&category](const NodeUsage& nodeUsage){
+        return category.has_value() ? nodeUsage.bytes[static_cast<size_t>(category.value())] : nodeUsage.get_total();
+    };
+    std::sort(sorted.begin(), sorted.end(), [&f_bytes](const NodeUsage& lhs, const NodeUsage& rhs){
+        const size_t lhsBytes = f_bytes(lhs);
+        const size_t rhsBytes = f_bytes(rhs);
+        return lhsBytes != rhsBytes ? lhsBytes > rhsBytes : lhs.nodeId < rhs.nodeId;
+    });
+    return sorted;
+}
+
+std::string CtMemoryUsage::get_report(const std::function<std::string(const gint64)>& f_node_name, const size_t max_nodes) const
+{
+    std::string report = fmt::format("memory usage total {}", get_total());
+    for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+        const auto category = static_cast<Category>(i);
+        report += fmt::format(" {} {}", get_category_key(category), get_total(category));
+    }
+    const std::vector<NodeUsage> sorted = get_sorted();
+    for (size_t n = 0; n < sorted.size() and n < max_nodes; ++n) {
+        const NodeUsage& nodeUsage = sorted[n];
+        report += fmt::format("\n  {} '{}' {}", nodeUsage.nodeId, f_node_name(nodeUsage.nodeId), nodeUsage.get_total());
+        for (size_t i = 0; i < NUM_CATEGORIES; ++i) {
+            if (nodeUsage.bytes[i] > 0u) {
+                report += fmt::format(" {} {}", get_category_key(static_cast<Category>(i)), nodeUsage.bytes[i]);
+            }
+        }
+    }
+    return report;
+}
+
+void CtTextStats::detach()
+{
+    for (sigc::connection& sigc_conn : _bufferSigcConn) {
+        sigc_conn.disconnect();
+    }
+    _bufferSigcConn.clear();
+    _textBuffer.reset();
+    _lineWords.clear();
+    _lineWordsValid = false;
+    _words = 0;
+    _dirtyLines = 0;
+}
+
+int CtTextStats::get_words_count(const Glib::RefPtr<Gtk::TextBuffer>& text_buffer)
+{
+    if (not text_buffer) {
+        detach();
+        return 0;
+    }
+    if (text_buffer != _textBuffer) {
+        detach();
+        _textBuffer = text_buffer;
+        // connected after the default handler so that the line count is already the new one
+        _bufferSigcConn.push_back(_textBuffer->signal_insert().connect(sigc::mem_fun(*this, &CtTextStats::_on_insert), true));
+        _bufferSigcConn.push_back(_textBuffer->signal_erase().connect(sigc::mem_fun(*this, &CtTextStats::_on_erase), true));
+        _bufferSigcConn.push_back(_textBuffer->signal_insert_child_anchor().connect(sigc::mem_fun(*this, &CtTextStats::_on_insert_child_anchor), true));
+    }
+    if (not _lineWordsValid) {
+        _lineWords.assign(static_cast<size_t>(_textBuffer->get_line_count()), -1);
+        _dirtyLines = _lineWords.size();
+        _words = 0;
+        _lineWordsValid = true;
+    }
+    for (size_t line = 0; _dirtyLines > 0 and line < _lineWords.size(); ++line) {
+        if (_lineWords[line] >= 0) {
+            continue;
+        }
+        Gtk::TextIter iter_start = _textBuffer->get_iter_at_line(static_cast<int>(line));
+        Gtk::TextIter iter_end = iter_start;
+        if (not iter_end.ends_line()) {
+            iter_end.forward_to_line_end();
+        }
+        _lineWords[line] = CtTextIterUtil::get_words_count(_textBuffer->get_text(iter_start, iter_end, true));
+        _words += _lineWords[line];
+        --_dirtyLines;
+    }
+    return _words;
+}
+
+void CtTextStats::_line_set_dirty(const int line)
+{
+    if (_lineWords[static_cast<size_t>(line)] >= 0) {
+        _words -= _lineWords[static_cast<size_t>(line)];
+        _lineWords[static_cast<size_t>(line)] = -1;
+        ++_dirtyLines;
+    }
+}
+
+void CtTextStats::_on_insert(const Gtk::TextIter& pos, const Glib::ustring& /*text*/, int /*bytes*/)
+{
+    if (not _lineWordsValid) {
+        return;
+    }
+    // pos was revalidated to the end of the inserted text
+    const int num_new_lines = _textBuffer->get_line_count() - static_cast<int>(_lineWords.size());
+    const int line_first = pos.get_line() - num_new_lines;
+    if (num_new_lines < 0 or line_first < 0) {
+        _lineWordsValid = false;
+        return;
+    }
+    _line_set_dirty(line_first);
+    _lineWords.insert(_lineWords.begin() + line_first + 1, static_cast<size_t>(num_new_lines), -1);
+    _dirtyLines += static_cast<size_t>(num_new_lines);
+}
+
+void CtTextStats::_on_erase(const Gtk::TextIter& range_start, const Gtk::TextIter& /*range_end*/)
+{
+    if (not _lineWordsValid) {
+        return;
+    }
+    // range_start and range_end were both revalidated to the position of the removed text
+    const int num_removed_lines = static_cast<int>(_lineWords.size()) - _textBuffer->get_line_count();
+    const int line_first = range_start.get_line();
+    if (num_removed_lines < 0 or line_first + num_removed_lines >= static_cast<int>(_lineWords.size())) {
+        _lineWordsValid = false;
+        return;
+    }
+    for (int line = line_first; line <= line_first + num_removed_lines; ++line) {
+        _line_set_dirty(line);
+    }
+    _dirtyLines -= static_cast<size_t>(num_removed_lines);
+    _lineWords.erase(_lineWords.begin() + line_first + 1, _lineWords.begin() + line_first + 1 + num_removed_lines);
+}
+
+void CtTextStats::_on_insert_child_anchor(const Gtk::TextIter& pos, const Glib::RefPtr<Gtk::TextChildAnchor>& /*anchor*/)
+{
+    if (not _lineWordsValid) {
+        return;
+    }
+    // the anchor may have split a word, pos is after the anchor (same line)
+    const int line = pos.get_line();
+    if (line < 0 or line >= static_cast<int>(_lineWords.size())) {
+        _lineWordsValid = false;
+        return;
+    }
+    _line_set_dirty(line);
+}
+
+/*static*/CtRegionHighlighter* CtRegionHighlighter::get(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer)
+{
+    return static_cast<CtRegionHighlighter*>(pTextBuffer->get_data(CtConst::REGION_HIGHLIGHTER_ID));
+}
+
+/*static*/CtRegionHighlighter* CtRegionHighlighter::attach(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer,
+                                                           GtkSourceLanguage* pGtkSourceLanguage,
+                                                           GtkSourceStyleScheme* pGtkSourceStyleScheme)
+{
+    detach(pTextBuffer);
+    auto pCtRegionHighlighter = new CtRegionHighlighter{pTextBuffer.get(), pGtkSourceLanguage, pGtkSourceStyleScheme};
+    pTextBuffer->set_data(CtConst::REGION_HIGHLIGHTER_ID, pCtRegionHighlighter, [](gpointer data){
+        delete static_cast<CtRegionHighlighter*>(data);
+    });
+    return pCtRegionHighlighter;
+}
+
+/*static*/void CtRegionHighlighter::detach(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer)
+{
+    if (CtRegionHighlighter* pCtRegionHighlighter = get(pTextBuffer)) {
+        pCtRegionHighlighter->_remove_tags(pTextBuffer->begin(), pTextBuffer->end());
+        pTextBuffer->remove_data(CtConst::REGION_HIGHLIGHTER_ID); // deletes it
+    }
+}
+
+CtRegionHighlighter::CtRegionHighlighter(Gtk::TextBuffer* pTextBuffer,
+                                         GtkSourceLanguage* pGtkSourceLanguage,
+                                         GtkSourceStyleScheme* pGtkSourceStyleScheme)
+ : _pTextBuffer{pTextBuffer}
+ , _pTagTable{GTK_TEXT_TAG_TABLE(g_object_ref(gtk_text_buffer_get_tag_table(pTextBuffer->gobj())))}
+ , _pScratchBuffer{gtk_source_buffer_new_with_language(pGtkSourceLanguage)}
+{
+    if (pGtkSourceStyleScheme) {
+        gtk_source_buffer_set_style_scheme(_pScratchBuffer, pGtkSourceStyleScheme);
+    }
+    gtk_source_buffer_set_highlight_syntax(_pScratchBuffer, true);
+    gtk_source_buffer_set_highlight_matching_brackets(_pScratchBuffer, false);
+    _linesHighlighted.assign(static_cast<size_t>(_pTextBuffer->get_line_count()), false);
+    // connected after the default handler so that the line count is already the new one
+    _bufferSigcConn.push_back(_pTextBuffer->signal_insert().connect(sigc::mem_fun(*this, &CtRegionHighlighter::_on_insert), true));
+    _bufferSigcConn.push_back(_pTextBuffer->signal_erase().connect(sigc::mem_fun(*this, &CtRegionHighlighter::_on_erase), true));
+}
+
+CtRegionHighlighter::~CtRegionHighlighter()
+{
+    for (sigc::connection& sigc_conn : _bufferSigcConn) {
+        sigc_conn.disconnect();
+    }
+    // the style tags were created for this buffer only, the named ones (context classes) are shared
+    for (const auto& pair : _scratchToBufferTags) {
+        gchar* pName{nullptr};
+        g_object_get(pair.second, "name", &pName, nullptr);
+        if (pName) {
+            g_free(pName);
+        }
+        else {
+            gtk_text_tag_table_remove(_pTagTable, pair.second);
+        }
+    }
+    g_object_unref(_pScratchBuffer);
+    g_object_unref(_pTagTable);
+}
+
+bool CtRegionHighlighter::get_line_highlighted(const int line) const
+{
+    return line >= 0 and line < static_cast<int>(_linesHighlighted.size()) and _linesHighlighted[static_cast<size_t>(line)];
+}
+
+bool CtRegionHighlighter::highlight_lines(int line_first, int line_last, const int max_lines)
+{
+    const int lines_num = static_cast<int>(_linesHighlighted.size());
+    line_first = std::max(0, line_first);
+    line_last = std::min(lines_num - 1, line_last);
+    int lines_todo = max_lines > 0 ? max_lines : lines_num;
+    int line = line_first;
+    while (line <= line_last and lines_todo > 0) {
+        if (_linesHighlighted[static_cast<size_t>(line)]) {
+            ++line;
+            continue;
+        }
+        // a block of consecutive lines not yet highlighted
+        int block_last = line;
+        while (block_last < line_last and
+               block_last - line + 1 < std::min(lines_todo, BLOCK_LINES) and
+               not _linesHighlighted[static_cast<size_t>(block_last + 1)])
+        {
+            ++block_last;
+        }
+        _highlight_block(line, block_last);
+        lines_todo -= block_last - line + 1;
+        line = block_last + 1;
+    }
+    for (; line <= line_last; ++line) {
+        if (not _linesHighlighted[static_cast<size_t>(line)]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CtRegionHighlighter::_highlight_block(const int line_first, const int line_last)
+{
+    const Gtk::TextIter iter_context = _pTextBuffer->get_iter_at_line(std::max(0, line_first - CONTEXT_LINES));
+    const Gtk::TextIter iter_start = _pTextBuffer->get_iter_at_line(line_first);
+    Gtk::TextIter iter_end = _pTextBuffer->get_iter_at_line(line_last);
+    iter_end.forward_line(); // start of the next line, or end of the buffer
+    // the slice keeps a character for every anchor, so that the offsets correspond
+    const Glib::ustring text = _pTextBuffer->get_slice(iter_context, iter_end, true/*include_hidden_chars*/);
+    GtkTextBuffer* pScratchBuffer = GTK_TEXT_BUFFER(_pScratchBuffer);
+    gtk_text_buffer_set_text(pScratchBuffer, text.c_str(), static_cast<int>(text.bytes()));
+    GtkTextIter scratch_iter, scratch_end;
+    gtk_text_buffer_get_bounds(pScratchBuffer, &scratch_iter, &scratch_end);
+    gtk_source_buffer_ensure_highlight(_pScratchBuffer, &scratch_iter, &scratch_end);
+
+    _remove_tags(iter_start, iter_end);
+    const int offset_context = iter_context.get_offset();
+    gtk_text_buffer_get_iter_at_offset(pScratchBuffer, &scratch_iter, iter_start.get_offset() - offset_context);
+    while (not gtk_text_iter_is_end(&scratch_iter)) {
+        GtkTextIter scratch_next = scratch_iter;
+        (void)gtk_text_iter_forward_to_tag_toggle(&scratch_next, nullptr);
+        if (GSList* pTags = gtk_text_iter_get_tags(&scratch_iter)) {
+            const Gtk::TextIter iter_tag_start = _pTextBuffer->get_iter_at_offset(offset_context + gtk_text_iter_get_offset(&scratch_iter));
+            const Gtk::TextIter iter_tag_end = _pTextBuffer->get_iter_at_offset(offset_context + gtk_text_iter_get_offset(&scratch_next));
+            for (GSList* pTagsIt = pTags; pTagsIt; pTagsIt = pTagsIt->next) {
+                if (GtkTextTag* pBufferTag = _get_buffer_tag(static_cast<GtkTextTag*>(pTagsIt->data))) {
+                    gtk_text_buffer_apply_tag(_pTextBuffer->gobj(), pBufferTag, iter_tag_start.gobj(), iter_tag_end.gobj());
+                }
+            }
+            g_slist_free(pTags);
+        }
+        scratch_iter = scratch_next;
+    }
+    gtk_text_buffer_set_text(pScratchBuffer, "", 0);
+
+    for (int line = line_first; line <= line_last; ++line) {
+        if (not _linesHighlighted[static_cast<size_t>(line)]) {
+            _linesHighlighted[static_cast<size_t>(line)] = true;
+            ++_linesHighlightedNum;
+        }
+    }
+}
+
+GtkTextTag* CtRegionHighlighter::_get_buffer_tag(GtkTextTag* pScratchTag)
+{
+    const auto it = _scratchToBufferTags.find(pScratchTag);
+    if (it != _scratchToBufferTags.end()) {
+        return it->second;
+    }
+    GtkTextTag* pBufferTag{nullptr};
+    gchar* pName{nullptr};
+    g_object_get(pScratchTag, "name", &pName, nullptr);
+    if (pName) {
+        // the context classes (e.g. no-spell-check) only carry their name
+        pBufferTag = gtk_text_tag_table_lookup(_pTagTable, pName);
+        if (not pBufferTag) {
+            pBufferTag = gtk_text_tag_new(pName);
+            gtk_text_tag_table_add(_pTagTable, pBufferTag);
+            g_object_unref(pBufferTag); // the table keeps its reference
+        }
+        g_free(pName);
+    }
+    else {
+        // the style of the scheme, below any other tag
+        pBufferTag = gtk_text_buffer_create_tag(_pTextBuffer->gobj(), nullptr, nullptr);
+        gtk_text_tag_set_priority(pBufferTag, 0);
+        static const std::array<std::pair<const gchar*, const gchar*>, 7> styleProperties{{
+            {"foreground-rgba", "foreground-set"},
+            {"background-rgba", "background-set"},
+            {"weight", "weight-set"},
+            {"style", "style-set"},
+            {"underline", "underline-set"},
+            {"strikethrough", "strikethrough-set"},
+            {"scale", "scale-set"},
+        }};
+        for (const auto& styleProperty : styleProperties) {
+            gboolean isSet{false};
+            g_object_get(pScratchTag, styleProperty.second, &isSet, nullptr);
+            if (isSet) {
+                GValue value = G_VALUE_INIT;
+                g_value_init(&value, g_object_class_find_property(G_OBJECT_GET_CLASS(pScratchTag), styleProperty.first)->value_type);
+                g_object_get_property(G_OBJECT(pScratchTag), styleProperty.first, &value);
+                g_object_set_property(G_OBJECT(pBufferTag), styleProperty.first, &value);
+                g_value_unset(&value);
+            }
+        }
+    }
+    _scratchToBufferTags[pScratchTag] = pBufferTag;
+    return pBufferTag;
+}
+
+void CtRegionHighlighter::_remove_tags(const Gtk::TextIter& iter_start, const Gtk::TextIter& iter_end)
+{
+    for (const auto& pair : _scratchToBufferTags) {
+        gtk_text_buffer_remove_tag(_pTextBuffer->gobj(), pair.second, iter_start.gobj(), iter_end.gobj());
+    }
+}
+
+void CtRegionHighlighter::_lines_set_dirty(const int line_first, const int line_last)
+{
+    // the lines below are also highlighted again, a multi-line construct may have been opened or closed
+    const int line_end = std::min(static_cast<int>(_linesHighlighted.size()), line_last + 1 + CONTEXT_LINES);
+    for (int line = std::max(0, line_first); line < line_end; ++line) {
+        if (_linesHighlighted[static_cast<size_t>(line)]) {
+            _linesHighlighted[static_cast<size_t>(line)] = false;
+            --_linesHighlightedNum;
+        }
+    }
+}
+
+void CtRegionHighlighter::_on_insert(const Gtk::TextIter& pos, const Glib::ustring& /*text*/, int /*bytes*/)
+{
+    // pos was revalidated to the end of the inserted text
+    const int num_new_lines = _pTextBuffer->get_line_count() - static_cast<int>(_linesHighlighted.size());
+    const int line_first = pos.get_line() - num_new_lines;
+    if (num_new_lines < 0 or line_first < 0) {
+        _linesHighlighted.assign(static_cast<size_t>(_pTextBuffer->get_line_count()), false);
+        _linesHighlightedNum = 0;
+        return;
+    }
+    _linesHighlighted.insert(_linesHighlighted.begin() + line_first + 1, static_cast<size_t>(num_new_lines), false);
+    _lines_set_dirty(line_first, line_first + num_new_lines);
+}
+
+void CtRegionHighlighter::_on_erase(const Gtk::TextIter& range_start, const Gtk::TextIter& /*range_end*/)
+{
+    // range_start and range_end were both revalidated to the position of the removed text
+    const int num_removed_lines = static_cast<int>(_linesHighlighted.size()) - _pTextBuffer->get_line_count();
+    const int line_first = range_start.get_line();
+    if (num_removed_lines < 0 or line_first + num_removed_lines >= static_cast<int>(_linesHighlighted.size())) {
+        _linesHighlighted.assign(static_cast<size_t>(_pTextBuffer->get_line_count()), false);
+        _linesHighlightedNum = 0;
+        return;
+    }
+    _lines_set_dirty(line_first, line_first + num_removed_lines);
+    _linesHighlighted.erase(_linesHighlighted.begin() + line_first + 1, _linesHighlighted.begin() + line_first + 1 + num_removed_lines);
+}
@@ -33,6 +33,7 @@
 #include <gtkmm/treestore.h>
 #include <gtksourceview/gtksource.h>
 #include <numeric>
+#include <unordered_set>
 
 /*
  * Compatibility shim: gtkmm4 removed the BuiltinIconSize enum that existed in
@@ -165,9 +166,23 @@ class CtTreeIter;
 namespace CtCSV {
 
 using CtStringTable = std::vector<std::vector<std::string>>;
+// called for each parsed record, return false to stop the parsing
+using CtCsvRowFunc = std::function<bool(std::vector<std::string>& row)>;
+// called with the fraction of the input processed so far, return false to stop
+using CtCsvProgressFunc = std::function<bool(const double fraction)>;
+
+constexpr size_t CSV_CHUNK_SIZE{256*1024};
+
+// Parse the csv file one chunk at a time, never holding more than a record in memory
+bool table_from_csv_stream(const std::string& filepath,
+                           const CtCsvRowFunc& onRow,
+                           const CtCsvProgressFunc& onProgress = nullptr);
 
 CtStringTable table_from_csv(const std::string& filepath);
 
+// Append the quoted cell followed by the separator or, if last of row, the newline
+void cell_to_csv(const std::string_view cell, const bool isLastOfRow, std::string& csvOut);
+
 std::string table_to_csv(const CtStringTable& table);
 
 } // namespace CtCSV
@@ -297,6 +312,9 @@ bool extend_selection_if_collapsed_text(Gtk::TextIter& iter_sel_end, const CtTre
 
 std::optional<Glib::ustring> iter_get_tag_startingwith(const Gtk::TextIter& iter, const Glib::ustring& tag_startwith);
 
+// the link property of the link at iter, empty if not on a link
+std::string get_link_at(const Gtk::TextIter& iter);
+
 bool get_is_camel_case(Gtk::TextIter iter_start, int num_chars);
 
 bool startswith(Gtk::TextIter text_iter, const gchar* pChar);
@@ -344,6 +362,14 @@ const gchar* get_text_iter_alignment(const Gtk::TextIter& textIter, CtMainWin* p
 PangoDirection get_pango_direction(const Gtk::TextIter& textIter);
 
 int get_words_count(const Glib::RefPtr<Gtk::TextBuffer>& text_buffer);
+int get_words_count(const Glib::ustring& text);
+// appends the text in the range to text_raw a block of lines at a time, counting the characters and the words
+// on the way, instead of copying the whole range (and allocating a log attribute per character to count the words)
+void get_text_by_chunks(const Gtk::TextIter& start_iter,
+                        const Gtk::TextIter& end_iter,
+                        std::string& text_raw,
+                        size_t& chars,
+                        size_t& words);
 
 const inline static size_t LINE_CONTENT_LIMIT{100u};
 Glib::ustring get_line_content(Glib::RefPtr<Gtk::TextBuffer> text_buffer, const int match_end_offset);
@@ -443,6 +469,278 @@ bool file_any_encoding_to_utf8(const std::string& filepath, Glib::ustring& utf8_
 
 } // namespace CtStrUtil
 
+// labels (and paths) kept casefolded and with diacritics stripped, for the filtering
+// of long lists on every keystroke without going through the rows of a Gtk model
+class CtMatchIndex
+{
+public:
+    struct Entry
+    {
+        gint64                id{0};
+        gint64                group{0}; // entries to refresh together with the one of this id
+        gint64                order{0};
+        std::string           label;    // folded
+        std::string           path;     // folded
+        std::vector<guint32>  labelWordStarts;
+    };
+    static constexpr int NoMatch{-1};
+
+    // casefolded text with the combining marks of the canonical decomposition removed
+    static std::string fold(const Glib::ustring& text);
+
+    void         clear();
+    size_t       size() const { return _entries.size(); }
+    const Entry* get(const gint64 id) const;
+    // label and path must be already folded
+    void         set(const gint64 id, std::string folded_label, std::string folded_path, const gint64 group = 0, const gint64 order = -1);
+    void         remove(const gint64 id);
+    std::vector<gint64> get_ids_in_group(const gint64 group) const;
+
+    // ids of the best matching entries, best first, at most max_results
+    std::vector<gint64> query(const Glib::ustring& filter, const size_t max_results) const;
+    // lower is better: label starts with filter, contains filter, contains all/any of the words,
+    // path contains all/any of the words, label contains the filter characters in sequence
+    static int score(const Entry& entry, const std::string& filter, const std::vector<std::string>& words);
+
+private:
+    std::vector<Entry>                 _entries;
+    std::unordered_map<gint64, size_t> _idToIdx;
+    gint64                             _nextOrder{0};
+};
+
+// words of a text buffer counted per paragraph and kept updated from the buffer insert/erase
+// signals, only the paragraphs touched since the previous query are analysed again
+class CtTextStats
+{
+public:
+    ~CtTextStats() { detach(); }
+
+    void detach();
+    // (re)attaches to text_buffer if not already attached to it
+    int  get_words_count(const Glib::RefPtr<Gtk::TextBuffer>& text_buffer);
+    int  get_chars_count() const { return _textBuffer ? _textBuffer->get_char_count() : 0; }
+    int  get_lines_count() const { return _textBuffer ? _textBuffer->get_line_count() : 0; }
+
+private:
+    void _on_insert(const Gtk::TextIter& pos, const Glib::ustring& text, int bytes);
+    void _on_erase(const Gtk::TextIter& range_start, const Gtk::TextIter& range_end);
+    void _on_insert_child_anchor(const Gtk::TextIter& pos, const Glib::RefPtr<Gtk::TextChildAnchor>& anchor);
+    void _line_set_dirty(const int line);
+
+    Glib::RefPtr<Gtk::TextBuffer> _textBuffer;
+    std::vector<sigc::connection> _bufferSigcConn;
+    std::vector<int>              _lineWords; // per buffer line, -1 if to be counted again
+    bool                          _lineWordsValid{false};
+    int                           _words{0};  // sum of the lines that are not to be counted again
+    size_t                        _dirtyLines{0};
+};
+
+// syntax highlighting of the code buffers too big for the GtkSourceView engine, which analyses the whole
+// buffer: the language runs on a copy of a block of lines (preceded by some lines of context) in a scratch
+// buffer and its style tags are copied over, only for the lines asked, which are then kept until edited
+class CtRegionHighlighter
+{
+public:
+    // lines of context before a block, for the constructs started above it
+    static const int CONTEXT_LINES{100};
+    // lines copied to the scratch buffer at once
+    static const int BLOCK_LINES{1000};
+
+    // the highlighter attached to the buffer, nullptr if none
+    static CtRegionHighlighter* get(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer);
+    // attaches a new highlighter to the buffer, replacing any previous one
+    static CtRegionHighlighter* attach(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer,
+                                       GtkSourceLanguage* pGtkSourceLanguage,
+                                       GtkSourceStyleScheme* pGtkSourceStyleScheme);
+    // detaches the highlighter of the buffer if any, removing the tags it applied
+    static void detach(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer);
+
+    ~CtRegionHighlighter();
+
+    // highlights the lines in [line_first, line_last] not yet highlighted, at most max_lines of them
+    // if max_lines > 0; returns true if some are still to be highlighted in the range
+    bool highlight_lines(int line_first, int line_last, const int max_lines);
+    bool get_line_highlighted(const int line) const;
+    size_t get_num_lines_highlighted() const { return _linesHighlightedNum; }
+
+private:
+    CtRegionHighlighter(Gtk::TextBuffer* pTextBuffer, GtkSourceLanguage* pGtkSourceLanguage, GtkSourceStyleScheme* pGtkSourceStyleScheme);
+
+    void _highlight_block(const int line_first, const int line_last);
+    GtkTextTag* _get_buffer_tag(GtkTextTag* pScratchTag);
+    void _remove_tags(const Gtk::TextIter& iter_start, const Gtk::TextIter& iter_end);
+    void _lines_set_dirty(const int line_first, const int line_last);
+    void _on_insert(const Gtk::TextIter& pos, const Glib::ustring& text, int bytes);
+    void _on_erase(const Gtk::TextIter& range_start, const Gtk::TextIter& range_end);
+
+    Gtk::TextBuffer* const                         _pTextBuffer;
+    GtkTextTagTable* const                         _pTagTable; // shared with other buffers, referenced
+    GtkSourceBuffer* const                         _pScratchBuffer;
+    std::unordered_map<GtkTextTag*, GtkTextTag*>   _scratchToBufferTags;
+    std::vector<sigc::connection>                  _bufferSigcConn;
+    std::vector<bool>                              _linesHighlighted; // per buffer line
+    size_t                                         _linesHighlightedNum{0};
+};
+
+// node links (and anchors) of every node, to resolve the links, list the referrers of a node
+// and report the broken links without materialising the text buffers
+class CtLinkIndex
+{
+public:
+    struct Target
+    {
+        gint64      nodeId{0};
+        std::string anchor;
+        bool operator<(const Target& other) const { return nodeId != other.nodeId ? nodeId < other.nodeId : anchor < other.anchor; }
+        bool operator==(const Target& other) const { return nodeId == other.nodeId and anchor == other.anchor; }
+    };
+    struct NodeData
+    {
+        std::vector<Target>   links;   // unique targets of the node links
+        std::set<std::string> anchors; // names of the anchors in the node
+    };
+    struct BrokenLink
+    {
+        gint64 referrerId{0};
+        Target target;
+        bool   missingNode{false}; // else missing anchor
+    };
+
+    // adds the target if link_property is a node link, returns false otherwise
+    static bool add_link_from_property(const std::string& link_property, NodeData& nodeData);
+    static std::string to_link_property(const Target& target);
+
+    void clear();
+    size_t size() const { return _nodes.size(); }
+    void set_node(const gint64 nodeId, NodeData nodeData);
+    void remove_node(const gint64 nodeId);
+    const NodeData* get_node(const gint64 nodeId) const;
+    // nullopt if the anchors of the node are not known
+    std::optional<bool> has_anchor(const gint64 nodeId, const std::string& anchor) const;
+    // sorted ids of the nodes linking to nodeId (or only to its anchor if pAnchor)
+    std::vector<gint64> get_referrers(const gint64 nodeId, const std::string* pAnchor = nullptr) const;
+    std::vector<BrokenLink> get_broken_links(const std::function<bool(const gint64)>& nodeExists) const;
+
+private:
+    std::unordered_map<gint64, NodeData>                        _nodes;
+    std::unordered_map<gint64, std::unordered_map<gint64, int>> _referrers; // target node id -> referrer id -> links count
+};
+
+// the links of a rich text buffer are styled by one tag per link type, while the link property of
+// every link range lives here: the ranges are delimited by text marks with the gravity of the tag
+// toggles (text inserted at the boundaries stays out) so that they move with the edits as the tags
+class CtLinkTable
+{
+public:
+    // the table of the buffer, created and attached to it at the first use
+    static CtLinkTable* get(const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer);
+    // the name of the tag styling the links of the type of link_property
+    static std::string get_style_tag_name(const std::string& link_property);
+
+    // replaces any link in the range
+    void set(const Gtk::TextIter& iter_start, const Gtk::TextIter& iter_end, const std::string& link_property);
+    void remove(const Gtk::TextIter& iter_start, const Gtk::TextIter& iter_end);
+    // empty if no link range contains the iter, the style tag is not checked
+    std::string get_link(const Gtk::TextIter& text_iter) const;
+    bool get_bounds(const Gtk::TextIter& text_iter, Gtk::TextIter& iter_start, Gtk::TextIter& iter_end) const;
+    void for_each(const std::function<void(const Gtk::TextIter& iter_start,
+                                           const Gtk::TextIter& iter_end,
+                                           const std::string& link_property)>& f_action) const;
+    size_t size() const { return _ranges.size(); }
+
+private:
+    struct Range
+    {
+        Glib::RefPtr<Gtk::TextMark> rStart; // right gravity
+        Glib::RefPtr<Gtk::TextMark> rEnd;   // left gravity
+        std::string                 linkProperty;
+    };
+    CtLinkTable(Gtk::TextBuffer* pTextBuffer) : _pTextBuffer{pTextBuffer} {}
+    // the ranges never overlap and the marks never cross, so they stay sorted
+    size_t _get_first_starting_after(const int offset) const;
+    void _clear_range(const int start_offset, const int end_offset);
+    void _erase(const size_t idx);
+
+    Gtk::TextBuffer* const _pTextBuffer;
+    std::vector<Range>     _ranges;
+};
+
+// inverted index of the node tags, kept updated with the node properties
+class CtTagIndex
+{
+public:
+    // space separated tags, without duplicates
+    static std::vector<std::string> split_tags(const std::string& tags);
+
+    void clear();
+    void set_node(const gint64 nodeId, const std::string& tags);
+    void remove_node(const gint64 nodeId);
+    size_t size() const { return _tagNodes.size(); }
+    // sorted tags with their number of nodes
+    std::vector<std::pair<std::string, size_t>> get_tags() const;
+    // sorted tags starting with prefix, at most max_results
+    std::vector<std::string> complete(const std::string& prefix, const size_t max_results = 0) const;
+    // sorted ids of the nodes with all the tags (or any if not requireAll)
+    std::vector<gint64> query(const std::vector<std::string>& tags, const bool requireAll) const;
+    // space separated tags are all required, alternatives separated by '|' e.g. "todo work | urgent"
+    std::vector<gint64> query(const std::string& expression) const;
+
+private:
+    std::map<std::string, std::vector<gint64>>          _tagNodes; // sorted node ids
+    std::unordered_map<gint64, std::vector<std::string>> _nodeTags;
+};
+
+// counters of the content of a node, persisted at save so that the summary info doesn't need the buffers
+struct CtNodeStats
+{
+    size_t chars{0u};       // text only, the anchored widgets excluded
+    size_t words{0u};
+    size_t blobBytes{0u};   // images and embedded files
+    size_t images{0u};
+    size_t latexes{0u};
+    size_t embfiles{0u};
+    size_t heavytables{0u};
+    size_t lighttables{0u};
+    size_t codeboxes{0u};
+    size_t anchors{0u};
+
+    void add_widget(const CtAnchWidgType type, const size_t widgetBlobBytes = 0u);
+    void add_to(CtSummaryInfo& summaryInfo) const;
+    // space separated counters, prefixed by the format version
+    std::string to_string() const;
+    static bool from_string(const std::string& statsStr, CtNodeStats& stats);
+};
+
+// approximate bytes held in memory by the nodes of a document, by category
+class CtMemoryUsage
+{
+public:
+    enum class Category { TextBuffer, Images, EmbFiles, DelayedXml, UndoHistory };
+    static constexpr size_t NUM_CATEGORIES{5u};
+    static const char* get_category_key(const Category category);
+
+    struct NodeUsage
+    {
+        gint64 nodeId{0};
+        std::array<size_t, NUM_CATEGORIES> bytes{};
+        size_t get_total() const;
+    };
+
+    void   add(const gint64 nodeId, const Category category, const size_t bytes);
+    // an object shared by widgets, undo states or nodes is counted once, for the first node
+    void   add_shared(const gint64 nodeId, const Category category, const void* pShared, const size_t bytes);
+    size_t get_total(const Category category) const;
+    size_t get_total() const;
+    // nodes by decreasing bytes in category, or in total without category
+    std::vector<NodeUsage> get_sorted(const std::optional<Category> category = std::nullopt) const;
+    // totals and the top max_nodes nodes, for the log
+    std::string get_report(const std::function<std::string(const gint64)>& f_node_name, const size_t max_nodes) const;
+
+private:
+    std::unordered_map<gint64, NodeUsage> _nodes;
+    std::unordered_set<const void*>       _shared;
+};
+
 namespace CtFontUtil {
 
 Glib::ustring get_font_family(const Glib::ustring& fontStr);
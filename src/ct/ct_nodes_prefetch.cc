@@ -0,0 +1,204 @@
+/*
+ * ct_nodes_prefetch.cc
+ *
+ * Copyright 2009-2025
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ct_nodes_prefetch.h"
+#include "ct_main_win.h"
+#include "ct_storage_control.h"
+#include "ct_storage_xml.h"
+#include "ct_logging.h"
+#include <algorithm>
+
+CtNodesPrefetch::CtNodesPrefetch(CtMainWin* pCtMainWin)
+ : _pCtMainWin{pCtMainWin}
+{
+    _dispatcherJobDone.connect(sigc::mem_fun(*this, &CtNodesPrefetch::_on_dispatcher_job_done));
+}
+
+CtNodesPrefetch::~CtNodesPrefetch()
+{
+    _idleConnection.disconnect();
+    if (_pThreadWorker) {
+        // a nullptr is passed on purpose in order to exit the loop, once done with the queued jobs
+        _jobsDEQueue.push_back(nullptr);
+        _pThreadWorker->join();
+    }
+}
+
+void CtNodesPrefetch::on_node_selected(CtTreeIter& treeIter)
+{
+    CtTreeStore& ctTreeStore = _pCtMainWin->get_tree_store();
+    _candidates.clear();
+    auto f_add = [&](const gint64 nodeId){
+        CtTreeIter ctTreeIter = ctTreeStore.get_node_from_node_id(nodeId);
+        if (not ctTreeIter) {
+            return;
+        }
+        const gint64 nodeIdDataHolder = ctTreeIter.get_node_id_data_holder();
+        if (nodeIdDataHolder != nodeId) {
+            ctTreeIter = ctTreeStore.get_node_from_node_id(nodeIdDataHolder);
+        }
+        if (ctTreeIter and
+            nodeIdDataHolder != treeIter.get_node_id_data_holder() and
+            ctTreeIter.get_node_is_rich_text() and
+            not ctTreeIter.get_node_buffer_already_loaded() and
+            std::find(_candidates.begin(), _candidates.end(), nodeIdDataHolder) == _candidates.end())
+        {
+            _candidates.push_back(nodeIdDataHolder);
+        }
+    };
+    const std::vector<gint64>& visitedNodesList = _pCtMainWin->get_state_machine().get_visited_nodes_list();
+    const int visitedNodesIdx = _pCtMainWin->get_state_machine().get_visited_nodes_idx();
+    if (visitedNodesIdx > 0 and visitedNodesIdx < (int)visitedNodesList.size()) {
+        f_add(visitedNodesList.at(visitedNodesIdx - 1));
+    }
+    if (visitedNodesIdx >= 0 and visitedNodesIdx + 1 < (int)visitedNodesList.size()) {
+        f_add(visitedNodesList.at(visitedNodesIdx + 1));
+    }
+    Gtk::TreeModel::iterator nextIter = treeIter;
+    if (++nextIter) {
+        f_add(ctTreeStore.to_ct_tree_iter(nextIter).get_node_id());
+    }
+    Gtk::TreeModel::iterator prevIter = treeIter;
+    if (--prevIter) {
+        f_add(ctTreeStore.to_ct_tree_iter(prevIter).get_node_id());
+    }
+    if (CtTreeIter childIter = treeIter.first_child()) {
+        f_add(childIter.get_node_id());
+    }
+    if (CtTreeIter parentIter = treeIter.parent()) {
+        f_add(parentIter.get_node_id());
+    }
+    // the prepared text is only kept for the nodes around the selected one
+    _around.assign(_candidates.begin(), _candidates.end());
+    for (auto it = _prepared.begin(); it != _prepared.end(); ) {
+        if (not _is_around(it->first)) {
+            it = _prepared.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    _idle_connect();
+}
+
+bool CtNodesPrefetch::take_prepared(const gint64 nodeIdDataHolder, CtPreparedRichText& preparedRichText)
+{
+    if (_jobInFlight and nodeIdDataHolder == _jobInFlightNodeId) {
+        _jobInFlightStale = true;
+    }
+    auto it = _prepared.find(nodeIdDataHolder);
+    if (_prepared.end() == it) {
+        return false;
+    }
+    preparedRichText = std::move(it->second);
+    _prepared.erase(it);
+    return true;
+}
+
+void CtNodesPrefetch::set_paused(const bool paused)
+{
+    _paused = paused;
+    if (_paused) {
+        _idleConnection.disconnect();
+    }
+    else {
+        _idle_connect();
+    }
+}
+
+bool CtNodesPrefetch::_is_around(const gint64 nodeIdDataHolder) const
+{
+    return std::find(_around.begin(), _around.end(), nodeIdDataHolder) != _around.end();
+}
+
+bool CtNodesPrefetch::_has_work() const
+{
+    return not _doneDEQueue.empty() or (not _jobInFlight and not _candidates.empty());
+}
+
+void CtNodesPrefetch::_idle_connect()
+{
+    if (not _paused and not _idleConnection.connected() and _has_work()) {
+        _idleConnection = Glib::signal_idle().connect(sigc::mem_fun(*this, &CtNodesPrefetch::_on_idle), G_PRIORITY_LOW);
+    }
+}
+
+bool CtNodesPrefetch::_on_idle()
+{
+    if (not _doneDEQueue.empty()) {
+        std::shared_ptr<Job> pJob = _doneDEQueue.pop_front();
+        _jobInFlight = false;
+        CtTreeIter ctTreeIter = _pCtMainWin->get_tree_store().get_node_from_node_id(pJob->nodeId);
+        if (pJob->ok and not _jobInFlightStale and ctTreeIter and not ctTreeIter.get_node_buffer_already_loaded() and
+            _is_around(pJob->nodeId))
+        {
+            _prepared[pJob->nodeId] = std::move(pJob->preparedRichText);
+            spdlog::debug("prefetch {} prepared", pJob->nodeId);
+        }
+        return _has_work();
+    }
+    while (not _jobInFlight and not _candidates.empty()) {
+        const gint64 nodeId = _candidates.front();
+        _candidates.pop_front();
+        CtTreeIter ctTreeIter = _pCtMainWin->get_tree_store().get_node_from_node_id(nodeId);
+        if (not ctTreeIter or ctTreeIter.get_node_buffer_already_loaded() or _prepared.count(nodeId)) {
+            continue;
+        }
+        auto pJob = std::make_shared<Job>();
+        pJob->nodeId = nodeId;
+        if (not _pCtMainWin->get_ct_storage()->get_delayed_text_raw(nodeId, pJob->rawXml) or
+            pJob->rawXml.size() > RAW_MAX_BYTES)
+        {
+            continue; // the storage keeps the nodes already parsed, or too large to be kept prepared
+        }
+        if (not _pThreadWorker) {
+            _pThreadWorker = std::make_unique<std::thread>(&CtNodesPrefetch::_worker_thread, this);
+        }
+        _jobInFlight = true;
+        _jobInFlightStale = false;
+        _jobInFlightNodeId = nodeId;
+        _jobsDEQueue.push_back(pJob);
+        return false; /* false to disconnect, connected again once the job is done */
+    }
+    return _has_work();
+}
+
+void CtNodesPrefetch::_worker_thread()
+{
+    while (true) {
+        std::shared_ptr<Job> pJob = _jobsDEQueue.pop_front();
+        if (not pJob) {
+            break;
+        }
+        pJob->ok = CtStorageXmlHelper::prepare_rich_text(pJob->rawXml, pJob->preparedRichText);
+        pJob->rawXml.clear();
+        _doneDEQueue.push_back(pJob);
+        _dispatcherJobDone.emit();
+    }
+}
+
+void CtNodesPrefetch::_on_dispatcher_job_done()
+{
+    // the buffer is built in idle, not while a node is being switched
+    _idle_connect();
+}
@@ -0,0 +1,81 @@
+/*
+ * ct_nodes_prefetch.h
+ *
+ * Copyright 2009-2025
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "ct_types.h"
+#include <glibmm/dispatcher.h>
+#include <thread>
+
+class CtMainWin;
+class CtTreeIter;
+
+// The rich text of the nodes likely to be selected next (visited previous/next, siblings, first child, parent)
+// that the storage keeps as xml is parsed by a worker thread, one node at a time while idle. Nothing is built
+// on the main thread: the buffer and its widgets are only created from the prepared text once the node is
+// selected. The storages keeping the nodes already parsed, the plain text/code nodes and the large ones
+// are not prefetched
+class CtNodesPrefetch
+{
+public:
+    static constexpr size_t RAW_MAX_BYTES{512u*1024u}; // larger rich text is not kept prepared
+
+    CtNodesPrefetch(CtMainWin* pCtMainWin);
+    ~CtNodesPrefetch();
+
+    void on_node_selected(CtTreeIter& treeIter);
+    // nothing is parsed while paused
+    void set_paused(const bool paused);
+    // the prepared rich text of the node if any, to build its buffer from; called whenever the buffer is built
+    bool take_prepared(const gint64 nodeIdDataHolder, CtPreparedRichText& preparedRichText);
+
+private:
+    struct Job
+    {
+        gint64             nodeId;
+        std::string        rawXml;
+        CtPreparedRichText preparedRichText;
+        bool               ok{false};
+    };
+
+    bool _is_around(const gint64 nodeIdDataHolder) const;
+    bool _has_work() const;
+    void _idle_connect();
+    bool _on_idle();
+    void _worker_thread();
+    void _on_dispatcher_job_done();
+
+    CtMainWin* const   _pCtMainWin;
+    std::deque<gint64> _candidates; // data holder node ids, the most likely first
+    std::vector<gint64> _around;    // the candidates as they were when the node was selected
+    std::unordered_map<gint64, CtPreparedRichText> _prepared; // by data holder node id, only of the candidates
+    bool               _jobInFlight{false}; // the idle waits for the worker, one node at a time
+    bool               _jobInFlightStale{false}; // the node was loaded meanwhile, the parse may be outdated
+    gint64             _jobInFlightNodeId{-1};
+    bool               _paused{false};
+    sigc::connection   _idleConnection;
+    ThreadSafeDEQueue<std::shared_ptr<Job>, 16> _jobsDEQueue;
+    ThreadSafeDEQueue<std::shared_ptr<Job>, 16> _doneDEQueue;
+    Glib::Dispatcher   _dispatcherJobDone;
+    std::unique_ptr<std::thread> _pThreadWorker; // started at the first job
+};
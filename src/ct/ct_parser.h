@@ -180,11 +180,19 @@ public:
      * @param tokens
      * @return
      */
-    std::vector<std::pair<const token_schema*, std::string>> parse_tokens(const std::vector<std::string>& tokens) const;
+    std::vector<std::pair<const token_schema*, std::string>> parse_tokens(const std::vector<std::string_view>& tokens) const;
 
-    std::vector<std::string> tokenize(const std::string& text) const;
+    /**
+     * @brief Split the text into plain text and tags, without copying
+     * @param text: must outlive the returned tokens, which are views into it
+     * @return
+     */
+    std::vector<std::string_view> tokenize(std::string_view text) const;
 
 private:
+    std::vector<std::pair<const token_schema*, std::string>> _parse_tokens(std::vector<std::string_view>::const_iterator token,
+                                                                         const std::vector<std::string_view>::const_iterator tokens_end) const;
+
     /// Tokens to be cached by the parser
     const std::vector<token_schema> _token_schemas;
 
@@ -208,7 +208,7 @@ void CtMDParser::_place_free_text()
 void CtMDParser::feed(const Glib::ustring& buffer)
 {
     try {
-        auto tokens_raw = _text_parser->tokenize(buffer);
+        auto tokens_raw = _text_parser->tokenize(buffer.raw());
         auto tokens     = _text_parser->parse_tokens(tokens_raw);
 
         for (auto iter = tokens.begin(); iter != tokens.end(); ++iter) {
@@ -26,25 +26,17 @@
 
 namespace {
 
-template<class ITER_T>
-bool do_token_branch(ITER_T begin, ITER_T end, std::string_view match) {
-    std::string buff;
-    while ((begin != end) && (buff.size() < match.size())) {
-        buff += *begin;
-        if (buff == match) {
-            return true;
-        }
-        ++begin;
-    }
-    return false;
+// text (from pos) starts with the whole match
+bool do_token_branch(std::string_view text, const size_t pos, std::string_view match) {
+    return text.size() - pos >= match.size() and 0 == text.compare(pos, match.size(), match);
 }
 
-template<class ITER_T, class STR_T>
-std::optional<STR_T> branch_token(ITER_T begin, ITER_T end, const std::vector<STR_T>& options) {
+template<class STR_T>
+std::optional<STR_T> branch_token(std::string_view text, const size_t pos, const std::vector<STR_T>& options) {
     std::size_t largest_len = 0;
     std::optional<STR_T> largest = std::nullopt;
     for (const auto& opt : options) {
-        if (do_token_branch(begin, end, opt)) {
+        if (do_token_branch(text, pos, opt)) {
             // Do a greedy match
             if (opt.length() > largest_len) {
                 largest_len = opt.length();
@@ -99,48 +91,52 @@ CtTextParser::CtTextParser(std::vector<token_schema>&& token_schemas) : _token_s
 
 
 
-std::vector<std::string> CtTextParser::tokenize(const std::string& text) const
+std::vector<std::string_view> CtTextParser::tokenize(std::string_view text) const
 {
+    std::vector<std::string_view> tokens;
+    size_t last_pos{0};
+    for (size_t ch = 0; ch < text.size(); ++ch) {
 
-    std::vector<std::string> tokens;
-    std::string::const_iterator last_pos = text.begin();
-    for (auto ch = text.begin(); ch != text.end(); ++ch) {
-
-        if (*ch == ' ') {
-            if (last_pos != ch) tokens.emplace_back(last_pos, ch);
+        if (text[ch] == ' ') {
+            if (last_pos != ch) tokens.push_back(text.substr(last_pos, ch - last_pos));
             last_pos = ch;
             continue;
         }
-        if (*ch == '\\') {
+        if (text[ch] == '\\') {
             // Escape next char
-            if (last_pos != ch) tokens.emplace_back(last_pos, ch);
+            if (last_pos != ch) tokens.push_back(text.substr(last_pos, ch - last_pos));
             ++ch;
             last_pos = ch;
-            if (ch == text.end()) break;
+            if (ch == text.size()) break;
             continue;
         }
 
-        auto pos_token = _possible_tokens.find(*ch);
-        if (pos_token != _possible_tokens.end()){
-            auto found_token = branch_token(ch, text.end(), pos_token->second);
+        auto pos_token = _possible_tokens.find(text[ch]);
+        if (pos_token != _possible_tokens.end()) {
+            auto found_token = branch_token(text, ch, pos_token->second);
             if (found_token) {
                 spdlog::debug("TOKEN: {}", *found_token);
-                tokens.emplace_back(last_pos, ch);
-                tokens.emplace_back(*found_token);
+                tokens.push_back(text.substr(last_pos, ch - last_pos));
+                // the token as found in the text rather than in the schema, all the views share the text lifetime
+                tokens.push_back(text.substr(ch, found_token->length()));
                 ch += found_token->length() - 1;
                 last_pos = ch + 1;
             }
-
-            if (ch == text.end()) break;
         }
     }
-    if (last_pos != text.end()) {
-        tokens.emplace_back(last_pos, text.end());
+    if (last_pos < text.size()) {
+        tokens.push_back(text.substr(last_pos));
     }
     return tokens;
 }
 
-std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextParser::parse_tokens(const std::vector<std::string>& tokens) const
+std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextParser::parse_tokens(const std::vector<std::string_view>& tokens) const
+{
+    return _parse_tokens(tokens.begin(), tokens.end());
+}
+
+std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextParser::_parse_tokens(std::vector<std::string_view>::const_iterator token,
+                                                                                                    const std::vector<std::string_view>::const_iterator tokens_end) const
 {
     std::vector<std::pair<const token_schema *, std::string>> token_stream;
     std::unordered_map<std::string_view, bool>                open_tags;
@@ -150,7 +146,7 @@ std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextPa
     auto                                                      &token_map_close = close_tokens_map();
     int  nb_open_tags = 0;
 
-    for (auto token = tokens.begin(); token != tokens.end(); ++token) {
+    for (; token != tokens_end; ++token) {
 
         if (token->empty()) continue;
 
@@ -173,12 +169,11 @@ std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextPa
                     if (keep_parsing) {
                         // Parse the other data in the stream
                         token_stream.emplace_back(tokens_iter->second, "");
-                        std::vector<std::string> rem_tokens(token, tokens.end());
-                        auto tokonised_stream = parse_tokens(rem_tokens);
+                        auto tokonised_stream = _parse_tokens(token, tokens_end);
                         token_stream.insert(token_stream.end(), tokonised_stream.begin(), tokonised_stream.end());
                     } else {
                         std::string buff;
-                        while (token != tokens.end()) {
+                        while (token != tokens_end) {
                             buff += *token;
                             ++token;
                         }
@@ -196,7 +191,7 @@ std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextPa
         if (token_iter != token_map_close.end()) {
             if (curr_open_tags.first.empty()) {
                 spdlog::debug("Found close tag without open: {}, assuming escaped", *token);
-                token_stream.emplace_back(nullptr, *token);
+                token_stream.emplace_back(nullptr, std::string{*token});
                 continue;
             }
 
@@ -229,7 +224,7 @@ std::vector<std::pair<const CtTextParser::token_schema *, std::string>> CtTextPa
             curr_open_tags.second.clear();
             curr_open_tags.first.clear();
         } else if (curr_open_tags.first.empty()) {
-            token_stream.emplace_back(nullptr, *token);
+            token_stream.emplace_back(nullptr, std::string{*token});
         } else if (!curr_open_tags.first.empty()) {
             curr_open_tags.second += *token;
         }
@@ -420,7 +415,7 @@ void CtTokenMatcher::insert(char ch, int offset) {
 
 void CtTokenMatcher::_update_tokens() {
     if (!_pos_tokens.empty()) {
-        auto pos_token = branch_token(_token_buff.begin(), _token_buff.end(), _pos_tokens);
+        auto pos_token = branch_token(_token_buff, 0, _pos_tokens);
         if (pos_token) {
             // Found a possible token
             if (*pos_token == _open_token && _token_contents.empty()) {
@@ -472,7 +467,7 @@ std::pair<Gtk::TextIter, Gtk::TextIter> CtTextParser::find_formatting_boundaries
 
     Glib::ustring token_str(start_bounds, word_end);
 
-    auto tokens = tokenize(token_str);
+    auto tokens = tokenize(token_str.raw());
     auto& close_tags = close_tokens_map();
 
     // Forward match
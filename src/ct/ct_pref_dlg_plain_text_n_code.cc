@@ -35,14 +35,28 @@ Gtk::Widget* CtPrefDlg::build_tab_plain_text_n_code()
     auto checkbutton_pt_highl_match_bra = Gtk::manage(new Gtk::CheckButton{_("Highlight Matching Brackets")});
     checkbutton_pt_highl_match_bra->set_active(_pConfig->ptHighlMatchBra);
 
+    auto hbox_code_highl_full_max = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_HORIZONTAL, 4/*spacing*/});
+    auto label_code_highl_full_max = Gtk::manage(new Gtk::Label{_("Highlight Only Around the Visible Region Above (KB, 0 = Never)")});
+    Glib::RefPtr<Gtk::Adjustment> adj_code_highl_full_max = Gtk::Adjustment::create(_pConfig->codeHighlFullMaxKB, 0, 1000000, 1);
+    auto spinbutton_code_highl_full_max = Gtk::manage(new Gtk::SpinButton{adj_code_highl_full_max});
+#if GTKMM_MAJOR_VERSION >= 4
+    hbox_code_highl_full_max->append(*label_code_highl_full_max);
+    hbox_code_highl_full_max->append(*spinbutton_code_highl_full_max);
+#else
+    hbox_code_highl_full_max->pack_start(*label_code_highl_full_max, false, false);
+    hbox_code_highl_full_max->pack_start(*spinbutton_code_highl_full_max, false, false);
+#endif
+
 #if GTKMM_MAJOR_VERSION >= 4
     vbox_syntax->append(*checkbutton_pt_show_white_spaces);
     vbox_syntax->append(*checkbutton_pt_highl_curr_line);
     vbox_syntax->append(*checkbutton_pt_highl_match_bra);
+    vbox_syntax->append(*hbox_code_highl_full_max);
 #else
     vbox_syntax->pack_start(*checkbutton_pt_show_white_spaces, false, false);
     vbox_syntax->pack_start(*checkbutton_pt_highl_curr_line, false, false);
     vbox_syntax->pack_start(*checkbutton_pt_highl_match_bra, false, false);
+    vbox_syntax->pack_start(*hbox_code_highl_full_max, false, false);
 #endif
 
     Gtk::Frame* frame_syntax = new_managed_frame_with_align(_("Text Editor"), vbox_syntax);
@@ -231,6 +245,10 @@ Gtk::Widget* CtPrefDlg::build_tab_plain_text_n_code()
         _pConfig->ptHighlMatchBra = checkbutton_pt_highl_match_bra->get_active();
         apply_for_each_window([](CtMainWin* win) { win->reapply_syntax_highlighting('p'/*PlainTextNCode*/); });
     });
+    spinbutton_code_highl_full_max->signal_value_changed().connect([this, spinbutton_code_highl_full_max](){
+        _pConfig->codeHighlFullMaxKB = spinbutton_code_highl_full_max->get_value_as_int();
+        apply_for_each_window([](CtMainWin* win) { win->reapply_syntax_highlighting('p'/*PlainTextNCode*/); });
+    });
     checkbutton_code_exec_confirm->signal_toggled().connect([this, checkbutton_code_exec_confirm](){
         _pConfig->codeExecConfirm = checkbutton_code_exec_confirm->get_active();
     });
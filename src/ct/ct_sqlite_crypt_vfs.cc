@@ -0,0 +1,836 @@
+/*
+ * ct_sqlite_crypt_vfs.cc
+ *
+ * Copyright 2009-2025
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ct_sqlite_crypt_vfs.h"
+#include "../7za/C/Aes.h"
+#include "../7za/C/Sha256.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/*
+ * file layout:
+ * header    | HEADER_SIZE bytes: MAGIC, block size, kdf iterations, salt, verifier
+ * block 0   | iv (16) | plain length (4) | ciphertext (BLOCK_SIZE) | tag (16)
+ * block 1   | ...
+ * the logical file is the concatenation of the plain blocks, only the last one can be shorter than BLOCK_SIZE
+ */
+const char     MAGIC[16]{'C','h','e','r','r','y','T','r','e','e','.','v','f','s','1','\0'};
+const uint32_t BLOCK_SIZE{4096u}; // matches the SQLite default page size, a page write is a block write
+const uint32_t KDF_ITERATIONS{100000u};
+const int      HEADER_SIZE{4096};
+const int      HEADER_HMAC_OFFSET{40}; // MAGIC(16) + block size(4) + kdf iterations(4) + salt(16)
+const int      SALT_SIZE{16};
+const int      IV_SIZE{16};
+const int      LEN_SIZE{4};
+const int      TAG_SIZE{16};
+const int      PHYS_BLOCK_SIZE{IV_SIZE + LEN_SIZE + (int)BLOCK_SIZE + TAG_SIZE};
+#if defined(SQLITE_IOERR_DATA)
+const int      ERR_NOT_AUTHENTIC{SQLITE_IOERR_DATA};
+#else
+const int      ERR_NOT_AUTHENTIC{SQLITE_CORRUPT};
+#endif
+
+struct CtCryptKeys
+{
+    uint8_t encKey[32];
+    CSha256 macInner; // sha256 state after the inner pad of the mac key
+    CSha256 macOuter; // sha256 state after the outer pad of the mac key
+};
+
+struct CtCryptData
+{
+    CtCryptKeys keys;
+    alignas(16) UInt32 ivAes[AES_NUM_IVMRK_WORDS];
+    alignas(16) uint8_t plain[BLOCK_SIZE];
+    uint8_t phys[PHYS_BLOCK_SIZE];
+    bool isLog{false};             // write ahead log or rollback journal, where a crash can leave a torn block
+    sqlite3_int64 lastBlockIdx{-1}; // the last block authenticated by _logical_size, its tag and plain length
+    uint8_t lastBlockTag[TAG_SIZE];
+    uint32_t lastBlockLen{0};
+    std::string salt;               // the entry of _keysBySalt counting this file
+    std::string dbPath;             // the entry of _headerByDb counting this file, empty if none
+};
+
+struct CtCryptFile
+{
+    sqlite3_file  base;
+    sqlite3_file* pReal;  // the file of the root VFS, allocated right after this struct
+    CtCryptData*  pData;  // nullptr for a plain file, passed through
+};
+
+struct CtSaltKeys
+{
+    CtCryptKeys keys;
+    int unlocks{0};   // unlock_file()/create_file() not yet paired with release_file()
+    int openFiles{0}; // files open with these keys
+};
+
+struct CtDbHeader
+{
+    std::string header;
+    int openFiles{0}; // main database, write ahead log and journal files open
+};
+
+std::mutex                          _mutex;
+std::map<std::string, CtSaltKeys>   _keysBySalt;    // the keys of every unlocked salt
+std::map<std::string, CtDbHeader>   _headerByDb;    // the header of every encrypted main database open, by path
+sqlite3_vfs*                        _pRootVfs{nullptr};
+sqlite3_vfs                         _ctCryptVfs;
+
+void _put_le32(uint8_t* p, const uint32_t val)
+{
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(val >> (8*i));
+}
+
+uint32_t _get_le32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void _hmac_init(const uint8_t* key, const size_t keyLen, CSha256& inner, CSha256& outer)
+{
+    uint8_t keyBlock[64]{};
+    if (keyLen > sizeof(keyBlock)) {
+        CSha256 sha;
+        Sha256_Init(&sha);
+        Sha256_Update(&sha, key, keyLen);
+        Sha256_Final(&sha, keyBlock);
+    }
+    else {
+        memcpy(keyBlock, key, keyLen);
+    }
+    uint8_t pad[64];
+    for (int i = 0; i < 64; ++i) pad[i] = keyBlock[i] ^ 0x36;
+    Sha256_Init(&inner);
+    Sha256_Update(&inner, pad, sizeof(pad));
+    for (int i = 0; i < 64; ++i) pad[i] = keyBlock[i] ^ 0x5c;
+    Sha256_Init(&outer);
+    Sha256_Update(&outer, pad, sizeof(pad));
+}
+
+void _hmac_final(const CSha256& outerInit, CSha256& inner, uint8_t* digest)
+{
+    uint8_t innerDigest[SHA256_DIGEST_SIZE];
+    Sha256_Final(&inner, innerDigest);
+    CSha256 outer = outerInit;
+    Sha256_Update(&outer, innerDigest, sizeof(innerDigest));
+    Sha256_Final(&outer, digest);
+}
+
+void _pbkdf2_hmac_sha256(const std::string& password, const uint8_t* salt, const size_t saltLen,
+                         const uint32_t iterations, uint8_t* out, const size_t outLen)
+{
+    CSha256 innerInit, outerInit;
+    _hmac_init((const uint8_t*)password.data(), password.size(), innerInit, outerInit);
+    for (uint32_t blockIdx = 1u; outLen > (blockIdx-1u)*SHA256_DIGEST_SIZE; ++blockIdx) {
+        uint8_t be32[4]{(uint8_t)(blockIdx >> 24), (uint8_t)(blockIdx >> 16), (uint8_t)(blockIdx >> 8), (uint8_t)blockIdx};
+        uint8_t u[SHA256_DIGEST_SIZE], t[SHA256_DIGEST_SIZE];
+        CSha256 inner = innerInit;
+        Sha256_Update(&inner, salt, saltLen);
+        Sha256_Update(&inner, be32, sizeof(be32));
+        _hmac_final(outerInit, inner, u);
+        memcpy(t, u, sizeof(t));
+        for (uint32_t i = 1u; i < iterations; ++i) {
+            inner = innerInit;
+            Sha256_Update(&inner, u, sizeof(u));
+            _hmac_final(outerInit, inner, u);
+            for (int j = 0; j < SHA256_DIGEST_SIZE; ++j) t[j] ^= u[j];
+        }
+        const size_t offset = (blockIdx-1u)*SHA256_DIGEST_SIZE;
+        memcpy(out + offset, t, std::min((size_t)SHA256_DIGEST_SIZE, outLen - offset));
+    }
+}
+
+// the header verifier is the mac of the header fields, it tells a wrong password
+void _header_hmac(const CtCryptKeys& keys, const uint8_t* header, uint8_t* digest)
+{
+    CSha256 inner = keys.macInner;
+    Sha256_Update(&inner, header, HEADER_HMAC_OFFSET);
+    _hmac_final(keys.macOuter, inner, digest);
+}
+
+bool _timing_safe_equal(const uint8_t* a, const uint8_t* b, const size_t len)
+{
+    uint8_t diff{0};
+    for (size_t i = 0; i < len; ++i) diff |= a[i] ^ b[i];
+    return 0 == diff;
+}
+
+void _derive_keys(const std::string& password, const uint8_t* header, CtCryptKeys& keys)
+{
+    uint8_t derived[64];
+    _pbkdf2_hmac_sha256(password, header + 24, SALT_SIZE, _get_le32(header + 20), derived, sizeof(derived));
+    memcpy(keys.encKey, derived, sizeof(keys.encKey));
+    _hmac_init(derived + 32, 32, keys.macInner, keys.macOuter);
+    memset(derived, 0, sizeof(derived));
+}
+
+bool _header_is_crypt(const uint8_t* header)
+{
+    return 0 == memcmp(header, MAGIC, sizeof(MAGIC)) and BLOCK_SIZE == _get_le32(header + 16);
+}
+
+std::string _header_salt(const uint8_t* header)
+{
+    return std::string{(const char*)header + 24, (size_t)SALT_SIZE};
+}
+
+// file of the root VFS used outside of an SQLite connection, to read/write the header
+class CtRootFile
+{
+public:
+    CtRootFile() : _buf(_pRootVfs->szOsFile) {}
+    ~CtRootFile() { if (_opened) get()->pMethods->xClose(get()); }
+    bool open(const std::string& filepath, const int flags) {
+        _filepath = filepath;
+        _opened = SQLITE_OK == _pRootVfs->xOpen(_pRootVfs, _filepath.c_str(), get(), flags | SQLITE_OPEN_MAIN_DB, nullptr);
+        return _opened;
+    }
+    sqlite3_file* get() { return (sqlite3_file*)_buf.data(); }
+    bool read_header(uint8_t* header) {
+        return SQLITE_OK == get()->pMethods->xRead(get(), header, HEADER_SIZE, 0);
+    }
+private:
+    std::string          _filepath; // must outlive the root file
+    std::vector<uint8_t> _buf;
+    bool                 _opened{false};
+};
+
+/* ---------------------------------------- blocks ---------------------------------------- */
+
+void _block_tag(const CtCryptKeys& keys, const sqlite3_int64 blockIdx, const uint8_t* phys, uint8_t* tag)
+{
+    uint8_t le64[8];
+    for (int i = 0; i < 8; ++i) le64[i] = (uint8_t)((sqlite3_uint64)blockIdx >> (8*i));
+    CSha256 inner = keys.macInner;
+    Sha256_Update(&inner, le64, sizeof(le64)); // a block moved elsewhere does not authenticate
+    Sha256_Update(&inner, phys, IV_SIZE + LEN_SIZE + BLOCK_SIZE);
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    _hmac_final(keys.macOuter, inner, digest);
+    memcpy(tag, digest, TAG_SIZE);
+}
+
+sqlite3_int64 _phys_offset(const sqlite3_int64 blockIdx)
+{
+    return HEADER_SIZE + blockIdx*PHYS_BLOCK_SIZE;
+}
+
+// the logical size is given by the number of blocks and the plain length of the last one;
+// the length is only trusted once the last block authenticates, which is not repeated while its tag is unchanged
+int _logical_size(CtCryptFile* p, sqlite3_int64& size)
+{
+    sqlite3_int64 physSize{0};
+    int rc = p->pReal->pMethods->xFileSize(p->pReal, &physSize);
+    if (SQLITE_OK != rc) return rc;
+    const sqlite3_int64 numBlocks = physSize > HEADER_SIZE ? (physSize - HEADER_SIZE)/PHYS_BLOCK_SIZE : 0;
+    if (0 == numBlocks) {
+        size = 0;
+        return SQLITE_OK;
+    }
+    CtCryptData* pData = p->pData;
+    const sqlite3_int64 lastIdx = numBlocks-1;
+    rc = p->pReal->pMethods->xRead(p->pReal, pData->phys, PHYS_BLOCK_SIZE, _phys_offset(lastIdx));
+    if (SQLITE_OK != rc) {
+        return SQLITE_IOERR_SHORT_READ == rc ? ERR_NOT_AUTHENTIC : rc;
+    }
+    const uint8_t* pTag = pData->phys + IV_SIZE + LEN_SIZE + BLOCK_SIZE;
+    if (lastIdx != pData->lastBlockIdx or 0 != memcmp(pTag, pData->lastBlockTag, TAG_SIZE)) {
+        uint8_t tag[TAG_SIZE];
+        _block_tag(pData->keys, lastIdx, pData->phys, tag);
+        const uint32_t plainLen = _get_le32(pData->phys + IV_SIZE);
+        if (not _timing_safe_equal(tag, pTag, TAG_SIZE) or plainLen > BLOCK_SIZE) {
+            if (not pData->isLog) {
+                return ERR_NOT_AUTHENTIC;
+            }
+            // torn by a crash while appending: the log ends before it and sqlite recovers up to the last whole frame
+            size = lastIdx*BLOCK_SIZE;
+            return SQLITE_OK;
+        }
+        pData->lastBlockIdx = lastIdx;
+        memcpy(pData->lastBlockTag, pTag, TAG_SIZE);
+        pData->lastBlockLen = plainLen;
+    }
+    size = lastIdx*BLOCK_SIZE + pData->lastBlockLen;
+    return SQLITE_OK;
+}
+
+// reads, authenticates and decrypts the block into pData->plain; zero padded past the plain length.
+// only the last block of a log is allowed to be torn and _logical_size already leaves it out, so any
+// block read here that does not authenticate has been tampered with
+int _block_read(CtCryptFile* p, const sqlite3_int64 blockIdx, uint32_t& plainLen)
+{
+    CtCryptData* pData = p->pData;
+    int rc = p->pReal->pMethods->xRead(p->pReal, pData->phys, PHYS_BLOCK_SIZE, _phys_offset(blockIdx));
+    if (SQLITE_OK != rc) {
+        return SQLITE_IOERR_SHORT_READ == rc ? ERR_NOT_AUTHENTIC : rc;
+    }
+    uint8_t tag[TAG_SIZE];
+    _block_tag(pData->keys, blockIdx, pData->phys, tag);
+    plainLen = _get_le32(pData->phys + IV_SIZE);
+    if (not _timing_safe_equal(tag, pData->phys + IV_SIZE + LEN_SIZE + BLOCK_SIZE, TAG_SIZE) or plainLen > BLOCK_SIZE) {
+        return ERR_NOT_AUTHENTIC;
+    }
+    memcpy(pData->plain, pData->phys + IV_SIZE + LEN_SIZE, BLOCK_SIZE);
+    AesCbc_Init(pData->ivAes, pData->phys);
+    g_AesCtr_Code(pData->ivAes, pData->plain, BLOCK_SIZE/AES_BLOCK_SIZE);
+    memset(pData->plain + plainLen, 0, BLOCK_SIZE - plainLen);
+    return SQLITE_OK;
+}
+
+// encrypts pData->plain with a fresh iv and writes the block
+int _block_write(CtCryptFile* p, const sqlite3_int64 blockIdx, const uint32_t plainLen)
+{
+    CtCryptData* pData = p->pData;
+    uint8_t* pIv = pData->phys;
+    sqlite3_randomness(IV_SIZE, pIv);
+    _put_le32(pData->phys + IV_SIZE, plainLen);
+    memset(pData->plain + plainLen, 0, BLOCK_SIZE - plainLen);
+    AesCbc_Init(pData->ivAes, pIv);
+    g_AesCtr_Code(pData->ivAes, pData->plain, BLOCK_SIZE/AES_BLOCK_SIZE);
+    memcpy(pData->phys + IV_SIZE + LEN_SIZE, pData->plain, BLOCK_SIZE);
+    _block_tag(pData->keys, blockIdx, pData->phys, pData->phys + IV_SIZE + LEN_SIZE + BLOCK_SIZE);
+    return p->pReal->pMethods->xWrite(p->pReal, pData->phys, PHYS_BLOCK_SIZE, _phys_offset(blockIdx));
+}
+
+// pData == nullptr writes zeros
+int _write_range(CtCryptFile* p, const uint8_t* pData, const sqlite3_int64 amount, const sqlite3_int64 offset, const sqlite3_int64 logicalSize)
+{
+    sqlite3_int64 done{0};
+    while (done < amount) {
+        const sqlite3_int64 pos = offset + done;
+        const sqlite3_int64 blockIdx = pos / BLOCK_SIZE;
+        const uint32_t inBlock = (uint32_t)(pos % BLOCK_SIZE);
+        const uint32_t num = (uint32_t)std::min<sqlite3_int64>(BLOCK_SIZE - inBlock, amount - done);
+        const sqlite3_int64 blockStart = blockIdx*BLOCK_SIZE;
+        uint32_t plainLen = blockStart < logicalSize ? (uint32_t)std::min<sqlite3_int64>(BLOCK_SIZE, logicalSize - blockStart) : 0u;
+        if (num != BLOCK_SIZE and plainLen > 0u) {
+            // partial write over existing content
+            uint32_t storedLen{0};
+            const int rc = _block_read(p, blockIdx, storedLen);
+            if (SQLITE_OK != rc) return rc;
+        }
+        else {
+            memset(p->pData->plain, 0, BLOCK_SIZE);
+        }
+        if (pData) memcpy(p->pData->plain + inBlock, pData + done, num);
+        else memset(p->pData->plain + inBlock, 0, num);
+        plainLen = std::max(plainLen, inBlock + num);
+        const int rc = _block_write(p, blockIdx, plainLen);
+        if (SQLITE_OK != rc) return rc;
+        done += num;
+    }
+    return SQLITE_OK;
+}
+
+// the header of a database goes with its last file closed, the keys also wait for release_file()
+void _forget_closed_file(CtCryptData* pData)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto itHeader = _headerByDb.find(pData->dbPath);
+    if (_headerByDb.end() != itHeader and 0 == --itHeader->second.openFiles) {
+        _headerByDb.erase(itHeader);
+    }
+    auto itKeys = _keysBySalt.find(pData->salt);
+    if (_keysBySalt.end() != itKeys and 0 == --itKeys->second.openFiles and 0 == itKeys->second.unlocks) {
+        memset(&itKeys->second.keys, 0, sizeof(CtCryptKeys));
+        _keysBySalt.erase(itKeys);
+    }
+    memset(&pData->keys, 0, sizeof(CtCryptKeys));
+}
+
+/* ---------------------------------------- io methods ---------------------------------------- */
+
+int _x_close(sqlite3_file* pFile)
+{
+    auto p = (CtCryptFile*)pFile;
+    const int rc = p->pReal->pMethods->xClose(p->pReal);
+    if (p->pData) _forget_closed_file(p->pData);
+    delete p->pData;
+    p->pData = nullptr;
+    return rc;
+}
+
+int _x_read(sqlite3_file* pFile, void* pBuf, int iAmt, sqlite3_int64 iOfst)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (not p->pData) return p->pReal->pMethods->xRead(p->pReal, pBuf, iAmt, iOfst);
+    sqlite3_int64 logicalSize{0};
+    int rc = _logical_size(p, logicalSize);
+    if (SQLITE_OK != rc) return rc;
+    auto pOut = (uint8_t*)pBuf;
+    int done{0};
+    while (done < iAmt) {
+        const sqlite3_int64 pos = iOfst + done;
+        if (pos >= logicalSize) {
+            memset(pOut + done, 0, iAmt - done);
+            return SQLITE_IOERR_SHORT_READ;
+        }
+        const sqlite3_int64 blockIdx = pos / BLOCK_SIZE;
+        const uint32_t inBlock = (uint32_t)(pos % BLOCK_SIZE);
+        uint32_t plainLen{0};
+        rc = _block_read(p, blockIdx, plainLen);
+        if (SQLITE_OK != rc) return rc;
+        const int num = (int)std::min<sqlite3_int64>({(sqlite3_int64)(BLOCK_SIZE - inBlock), (sqlite3_int64)(iAmt - done), logicalSize - pos});
+        memcpy(pOut + done, p->pData->plain + inBlock, num);
+        done += num;
+    }
+    return SQLITE_OK;
+}
+
+int _x_write(sqlite3_file* pFile, const void* pBuf, int iAmt, sqlite3_int64 iOfst)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (not p->pData) return p->pReal->pMethods->xWrite(p->pReal, pBuf, iAmt, iOfst);
+    sqlite3_int64 logicalSize{0};
+    int rc = _logical_size(p, logicalSize);
+    if (SQLITE_OK != rc) return rc;
+    if (iOfst > logicalSize) {
+        // the gap reads as zeros like in a sparse file
+        rc = _write_range(p, nullptr, iOfst - logicalSize, logicalSize, logicalSize);
+        if (SQLITE_OK != rc) return rc;
+        logicalSize = iOfst;
+    }
+    return _write_range(p, (const uint8_t*)pBuf, iAmt, iOfst, logicalSize);
+}
+
+int _x_truncate(sqlite3_file* pFile, sqlite3_int64 size)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (not p->pData) return p->pReal->pMethods->xTruncate(p->pReal, size);
+    sqlite3_int64 logicalSize{0};
+    int rc = _logical_size(p, logicalSize);
+    if (SQLITE_OK != rc) return rc;
+    if (size >= logicalSize) {
+        return size > logicalSize ? _write_range(p, nullptr, size - logicalSize, logicalSize, logicalSize) : SQLITE_OK;
+    }
+    const sqlite3_int64 numBlocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint32_t lastLen = (uint32_t)(size % BLOCK_SIZE);
+    if (lastLen > 0u) {
+        // the last block kept gets shorter
+        uint32_t plainLen{0};
+        rc = _block_read(p, numBlocks-1, plainLen);
+        if (SQLITE_OK != rc) return rc;
+        rc = _block_write(p, numBlocks-1, lastLen);
+        if (SQLITE_OK != rc) return rc;
+    }
+    return p->pReal->pMethods->xTruncate(p->pReal, _phys_offset(numBlocks));
+}
+
+int _x_sync(sqlite3_file* pFile, int flags)
+{
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xSync(p->pReal, flags);
+}
+
+int _x_file_size(sqlite3_file* pFile, sqlite3_int64* pSize)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (not p->pData) return p->pReal->pMethods->xFileSize(p->pReal, pSize);
+    return _logical_size(p, *pSize);
+}
+
+int _x_lock(sqlite3_file* pFile, int eLock)
+{
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xLock(p->pReal, eLock);
+}
+
+int _x_unlock(sqlite3_file* pFile, int eLock)
+{
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xUnlock(p->pReal, eLock);
+}
+
+int _x_check_reserved_lock(sqlite3_file* pFile, int* pResOut)
+{
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xCheckReservedLock(p->pReal, pResOut);
+}
+
+int _x_file_control(sqlite3_file* pFile, int op, void* pArg)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (p->pData) {
+        switch (op) {
+            // the root VFS would grow the physical file with zeros that do not authenticate
+            case SQLITE_FCNTL_SIZE_HINT:
+            case SQLITE_FCNTL_CHUNK_SIZE:
+                return SQLITE_OK;
+            case SQLITE_FCNTL_MMAP_SIZE:
+                *(sqlite3_int64*)pArg = 0;
+                return SQLITE_OK;
+            default:
+                break;
+        }
+    }
+    return p->pReal->pMethods->xFileControl(p->pReal, op, pArg);
+}
+
+int _x_sector_size(sqlite3_file* pFile)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (p->pData) return BLOCK_SIZE;
+    return p->pReal->pMethods->xSectorSize(p->pReal);
+}
+
+int _x_device_characteristics(sqlite3_file* pFile)
+{
+    auto p = (CtCryptFile*)pFile;
+    const int characteristics = p->pReal->pMethods->xDeviceCharacteristics(p->pReal);
+    if (p->pData) {
+        // a partial block write rewrites the whole block: neither atomic nor powersafe overwrite
+        return characteristics & (SQLITE_IOCAP_SEQUENTIAL | SQLITE_IOCAP_UNDELETABLE_WHEN_OPEN | SQLITE_IOCAP_IMMUTABLE);
+    }
+    return characteristics;
+}
+
+int _x_shm_map(sqlite3_file* pFile, int iPg, int pgsz, int bExtend, void volatile** pp)
+{
+    // the write ahead log index holds no content, only frame numbers and hashes of page numbers
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xShmMap(p->pReal, iPg, pgsz, bExtend, pp);
+}
+
+int _x_shm_lock(sqlite3_file* pFile, int offset, int n, int flags)
+{
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xShmLock(p->pReal, offset, n, flags);
+}
+
+void _x_shm_barrier(sqlite3_file* pFile)
+{
+    auto p = (CtCryptFile*)pFile;
+    p->pReal->pMethods->xShmBarrier(p->pReal);
+}
+
+int _x_shm_unmap(sqlite3_file* pFile, int deleteFlag)
+{
+    auto p = (CtCryptFile*)pFile;
+    return p->pReal->pMethods->xShmUnmap(p->pReal, deleteFlag);
+}
+
+int _x_fetch(sqlite3_file* pFile, sqlite3_int64 iOfst, int iAmt, void** pp)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (p->pData or p->pReal->pMethods->iVersion < 3) {
+        *pp = nullptr; // no memory mapping of ciphertext, sqlite falls back to xRead
+        return SQLITE_OK;
+    }
+    return p->pReal->pMethods->xFetch(p->pReal, iOfst, iAmt, pp);
+}
+
+int _x_unfetch(sqlite3_file* pFile, sqlite3_int64 iOfst, void* pPage)
+{
+    auto p = (CtCryptFile*)pFile;
+    if (p->pData or p->pReal->pMethods->iVersion < 3) {
+        return SQLITE_OK;
+    }
+    return p->pReal->pMethods->xUnfetch(p->pReal, iOfst, pPage);
+}
+
+const sqlite3_io_methods _ioMethods {
+    3,
+    _x_close,
+    _x_read,
+    _x_write,
+    _x_truncate,
+    _x_sync,
+    _x_file_size,
+    _x_lock,
+    _x_unlock,
+    _x_check_reserved_lock,
+    _x_file_control,
+    _x_sector_size,
+    _x_device_characteristics,
+    _x_shm_map,
+    _x_shm_lock,
+    _x_shm_barrier,
+    _x_shm_unmap,
+    _x_fetch,
+    _x_unfetch
+};
+
+/* ---------------------------------------- vfs methods ---------------------------------------- */
+
+// the write ahead log and the rollback journal are named after the main database
+std::string _main_db_path(const char* zName, const int flags)
+{
+    std::string path{zName};
+    const std::string suffix = (flags & SQLITE_OPEN_WAL) ? "-wal" : "-journal";
+    if (path.size() > suffix.size() and 0 == path.compare(path.size() - suffix.size(), suffix.size(), suffix)) {
+        path.resize(path.size() - suffix.size());
+    }
+    return path;
+}
+
+// decides whether the file just opened by the root VFS is encrypted and if so sets up its keys
+int _open_crypt_data(CtCryptFile* p, const char* zName, const int flags)
+{
+    if (not zName or 0 == (flags & (SQLITE_OPEN_MAIN_DB | SQLITE_OPEN_WAL | SQLITE_OPEN_MAIN_JOURNAL))) {
+        return SQLITE_OK; // temp files are not named, plain
+    }
+    sqlite3_int64 physSize{0};
+    int rc = p->pReal->pMethods->xFileSize(p->pReal, &physSize);
+    if (SQLITE_OK != rc) return rc;
+    std::string header;
+    if (physSize >= HEADER_SIZE) {
+        header.resize(HEADER_SIZE);
+        rc = p->pReal->pMethods->xRead(p->pReal, header.data(), HEADER_SIZE, 0);
+        if (SQLITE_OK != rc) return rc;
+        if (not _header_is_crypt((const uint8_t*)header.data())) {
+            return SQLITE_OK; // plain
+        }
+    }
+    else if (flags & SQLITE_OPEN_MAIN_DB) {
+        return SQLITE_OK; // plain, also a new database not created through create_file()
+    }
+    else {
+        // new (or torn at creation) write ahead log or journal of an encrypted database gets its header
+        std::lock_guard<std::mutex> lock{_mutex};
+        auto it = _headerByDb.find(_main_db_path(zName, flags));
+        if (_headerByDb.end() == it) {
+            return SQLITE_OK; // plain
+        }
+        header = it->second.header;
+        if (physSize > 0) {
+            rc = p->pReal->pMethods->xTruncate(p->pReal, 0);
+            if (SQLITE_OK != rc) return rc;
+        }
+        rc = p->pReal->pMethods->xWrite(p->pReal, header.data(), HEADER_SIZE, 0);
+        if (SQLITE_OK != rc) return rc;
+    }
+    std::lock_guard<std::mutex> lock{_mutex};
+    const std::string salt = _header_salt((const uint8_t*)header.data());
+    auto itKeys = _keysBySalt.find(salt);
+    if (_keysBySalt.end() == itKeys) {
+        return SQLITE_AUTH; // locked, unlock_file() first
+    }
+    p->pData = new CtCryptData{};
+    p->pData->keys = itKeys->second.keys;
+    p->pData->isLog = 0 != (flags & (SQLITE_OPEN_WAL | SQLITE_OPEN_MAIN_JOURNAL));
+    Aes_SetKey_Enc(p->pData->ivAes + 4, p->pData->keys.encKey, sizeof(p->pData->keys.encKey));
+    ++itKeys->second.openFiles;
+    p->pData->salt = salt;
+    if (flags & SQLITE_OPEN_MAIN_DB) {
+        CtDbHeader& dbHeader = _headerByDb[zName];
+        dbHeader.header = header;
+        ++dbHeader.openFiles;
+        p->pData->dbPath = zName;
+    }
+    else {
+        auto itHeader = _headerByDb.find(_main_db_path(zName, flags));
+        if (_headerByDb.end() != itHeader) {
+            ++itHeader->second.openFiles;
+            p->pData->dbPath = itHeader->first;
+        }
+    }
+    return SQLITE_OK;
+}
+
+int _x_open(sqlite3_vfs*/*pVfs*/, const char* zName, sqlite3_file* pFile, int flags, int* pOutFlags)
+{
+    auto p = (CtCryptFile*)pFile;
+    p->base.pMethods = nullptr;
+    p->pReal = (sqlite3_file*)&p[1];
+    p->pData = nullptr;
+    int rc = _pRootVfs->xOpen(_pRootVfs, zName, p->pReal, flags, pOutFlags);
+    if (SQLITE_OK != rc) return rc;
+    rc = _open_crypt_data(p, zName, flags);
+    if (SQLITE_OK != rc) {
+        p->pReal->pMethods->xClose(p->pReal);
+        return rc;
+    }
+    p->base.pMethods = &_ioMethods;
+    return SQLITE_OK;
+}
+
+int _x_delete(sqlite3_vfs*, const char* zName, int syncDir) { return _pRootVfs->xDelete(_pRootVfs, zName, syncDir); }
+int _x_access(sqlite3_vfs*, const char* zName, int flags, int* pResOut) { return _pRootVfs->xAccess(_pRootVfs, zName, flags, pResOut); }
+int _x_full_pathname(sqlite3_vfs*, const char* zName, int nOut, char* zOut) { return _pRootVfs->xFullPathname(_pRootVfs, zName, nOut, zOut); }
+void* _x_dl_open(sqlite3_vfs*, const char* zFilename) { return _pRootVfs->xDlOpen(_pRootVfs, zFilename); }
+void _x_dl_error(sqlite3_vfs*, int nByte, char* zErrMsg) { _pRootVfs->xDlError(_pRootVfs, nByte, zErrMsg); }
+void (*_x_dl_sym(sqlite3_vfs*, void* pHandle, const char* zSymbol))(void) { return _pRootVfs->xDlSym(_pRootVfs, pHandle, zSymbol); }
+void _x_dl_close(sqlite3_vfs*, void* pHandle) { _pRootVfs->xDlClose(_pRootVfs, pHandle); }
+int _x_randomness(sqlite3_vfs*, int nByte, char* zOut) { return _pRootVfs->xRandomness(_pRootVfs, nByte, zOut); }
+int _x_sleep(sqlite3_vfs*, int microseconds) { return _pRootVfs->xSleep(_pRootVfs, microseconds); }
+int _x_current_time(sqlite3_vfs*, double* pTime) { return _pRootVfs->xCurrentTime(_pRootVfs, pTime); }
+int _x_get_last_error(sqlite3_vfs*, int nBuf, char* zBuf) { return _pRootVfs->xGetLastError ? _pRootVfs->xGetLastError(_pRootVfs, nBuf, zBuf) : 0; }
+int _x_current_time_int64(sqlite3_vfs*, sqlite3_int64* pTime) { return _pRootVfs->xCurrentTimeInt64(_pRootVfs, pTime); }
+
+bool _register_vfs()
+{
+    _pRootVfs = sqlite3_vfs_find(nullptr);
+    if (not _pRootVfs or _pRootVfs->iVersion < 2) {
+        return false;
+    }
+    AesGenTables();
+    _ctCryptVfs = sqlite3_vfs{};
+    _ctCryptVfs.iVersion = 2;
+    _ctCryptVfs.szOsFile = sizeof(CtCryptFile) + _pRootVfs->szOsFile;
+    _ctCryptVfs.mxPathname = _pRootVfs->mxPathname;
+    _ctCryptVfs.zName = "ctcrypt";
+    _ctCryptVfs.xOpen = _x_open;
+    _ctCryptVfs.xDelete = _x_delete;
+    _ctCryptVfs.xAccess = _x_access;
+    _ctCryptVfs.xFullPathname = _x_full_pathname;
+    _ctCryptVfs.xDlOpen = _x_dl_open;
+    _ctCryptVfs.xDlError = _x_dl_error;
+    _ctCryptVfs.xDlSym = _x_dl_sym;
+    _ctCryptVfs.xDlClose = _x_dl_close;
+    _ctCryptVfs.xRandomness = _x_randomness;
+    _ctCryptVfs.xSleep = _x_sleep;
+    _ctCryptVfs.xCurrentTime = _x_current_time;
+    _ctCryptVfs.xGetLastError = _x_get_last_error;
+    _ctCryptVfs.xCurrentTimeInt64 = _x_current_time_int64;
+    return SQLITE_OK == sqlite3_vfs_register(&_ctCryptVfs, 0/*makeDflt*/);
+}
+
+bool _write_new_file(const std::string& filepath, const uint8_t* header)
+{
+    CtRootFile rootFile;
+    if (not rootFile.open(filepath, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) {
+        return false;
+    }
+    sqlite3_file* pFile = rootFile.get();
+    return SQLITE_OK == pFile->pMethods->xTruncate(pFile, 0) and
+           SQLITE_OK == pFile->pMethods->xWrite(pFile, header, HEADER_SIZE, 0) and
+           SQLITE_OK == pFile->pMethods->xSync(pFile, SQLITE_SYNC_NORMAL);
+}
+
+void _pin_keys(const std::string& salt, const CtCryptKeys& keys)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    CtSaltKeys& saltKeys = _keysBySalt[salt];
+    saltKeys.keys = keys;
+    ++saltKeys.unlocks;
+}
+
+void _unpin_keys(const std::string& salt)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto itKeys = _keysBySalt.find(salt);
+    if (_keysBySalt.end() == itKeys or 0 == itKeys->second.unlocks) {
+        return;
+    }
+    if (0 == --itKeys->second.unlocks and 0 == itKeys->second.openFiles) {
+        memset(&itKeys->second.keys, 0, sizeof(CtCryptKeys));
+        _keysBySalt.erase(itKeys);
+    }
+}
+
+} // namespace (anonymous)
+
+const char* CtSqliteCryptVfs::get_vfs_name()
+{
+    static std::once_flag onceFlag;
+    static bool registered{false};
+    std::call_once(onceFlag, [](){ registered = _register_vfs(); });
+    return registered ? _ctCryptVfs.zName : nullptr;
+}
+
+bool CtSqliteCryptVfs::is_crypt_file(const std::string& filepath)
+{
+    if (not get_vfs_name()) return false;
+    CtRootFile rootFile;
+    uint8_t header[HEADER_SIZE];
+    return rootFile.open(filepath, SQLITE_OPEN_READONLY) and
+           rootFile.read_header(header) and
+           _header_is_crypt(header);
+}
+
+bool CtSqliteCryptVfs::create_file(const std::string& filepath, const std::string& password)
+{
+    if (not get_vfs_name()) return false;
+    uint8_t header[HEADER_SIZE]{};
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    _put_le32(header + 16, BLOCK_SIZE);
+    _put_le32(header + 20, KDF_ITERATIONS);
+    sqlite3_randomness(SALT_SIZE, header + 24);
+    CtCryptKeys keys;
+    _derive_keys(password, header, keys);
+    _header_hmac(keys, header, header + HEADER_HMAC_OFFSET);
+    _pin_keys(_header_salt(header), keys);
+    if (not _write_new_file(filepath, header)) {
+        _unpin_keys(_header_salt(header));
+        return false;
+    }
+    return true;
+}
+
+bool CtSqliteCryptVfs::unlock_file(const std::string& filepath, const std::string& password)
+{
+    if (not get_vfs_name()) return false;
+    CtRootFile rootFile;
+    uint8_t header[HEADER_SIZE];
+    if (not rootFile.open(filepath, SQLITE_OPEN_READONLY) or
+        not rootFile.read_header(header) or
+        not _header_is_crypt(header))
+    {
+        return false;
+    }
+    CtCryptKeys keys;
+    _derive_keys(password, header, keys);
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    _header_hmac(keys, header, digest);
+    if (not _timing_safe_equal(digest, header + HEADER_HMAC_OFFSET, sizeof(digest))) {
+        return false;
+    }
+    _pin_keys(_header_salt(header), keys);
+    return true;
+}
+
+void CtSqliteCryptVfs::release_file(const std::string& filepath)
+{
+    if (not get_vfs_name()) return;
+    CtRootFile rootFile;
+    uint8_t header[HEADER_SIZE];
+    if (rootFile.open(filepath, SQLITE_OPEN_READONLY) and
+        rootFile.read_header(header) and
+        _header_is_crypt(header))
+    {
+        _unpin_keys(_header_salt(header));
+    }
+}
+
+bool CtSqliteCryptVfs::clone_header(const std::string& fromFilepath, const std::string& toFilepath)
+{
+    if (not get_vfs_name()) return false;
+    uint8_t header[HEADER_SIZE];
+    {
+        CtRootFile rootFile;
+        if (not rootFile.open(fromFilepath, SQLITE_OPEN_READONLY) or
+            not rootFile.read_header(header) or
+            not _header_is_crypt(header))
+        {
+            return false;
+        }
+    }
+    return _write_new_file(toFilepath, header);
+}
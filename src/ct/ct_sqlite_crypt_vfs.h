@@ -0,0 +1,52 @@
+/*
+ * ct_sqlite_crypt_vfs.h
+ *
+ * Copyright 2009-2025
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <string>
+
+// SQLite VFS storing the database (and its write ahead log / rollback journal) encrypted block by block:
+// every 4 KiB block is AES-256-CTR encrypted with a fresh random IV and authenticated with HMAC-SHA256,
+// so that a save only rewrites the changed pages. The keys are derived from the password with PBKDF2-HMAC-SHA256
+// over the salt in the file header. A file without the header is passed through untouched to the default VFS
+namespace CtSqliteCryptVfs {
+
+// registered at the first call, to be passed to sqlite3_open_v2
+const char* get_vfs_name();
+
+// the file starts with the header of a page encrypted database (as opposed to a 7-zip archive or plain SQLite)
+bool is_crypt_file(const std::string& filepath);
+
+// creates an empty page encrypted database with a new random salt, ready to be opened through the VFS
+bool create_file(const std::string& filepath, const std::string& password);
+
+// derives the keys from the password and the salt of the file; false if the password is wrong
+bool unlock_file(const std::string& filepath, const std::string& password);
+
+// pairs a successful unlock_file()/create_file(): the keys are forgotten once no file using them is open either
+void release_file(const std::string& filepath);
+
+// creates an empty page encrypted database sharing the salt (and so the keys) of an unlocked one
+bool clone_header(const std::string& fromFilepath, const std::string& toFilepath);
+
+} // namespace CtSqliteCryptVfs
@@ -99,7 +99,7 @@ CtAnchoredWidget* CtAnchoredWidgetState_Latex::to_widget(CtMainWin* pCtMainWin)
 CtAnchoredWidgetState_EmbFile::CtAnchoredWidgetState_EmbFile(CtImageEmbFile* embFile)
  : CtAnchoredWidgetState{embFile->getOffset(), embFile->getJustification()}
  , fileName{embFile->get_file_name()}
- , rawBlob{embFile->get_raw_blob()}
+ , blob{embFile->get_blob()}
  , timeSeconds{embFile->get_time()}
  , uniqueId{embFile->get_unique_id()}
  , pathLastMultiFile{embFile->get_pathLastMultiFile()}
@@ -113,7 +113,7 @@ bool CtAnchoredWidgetState_EmbFile::equal(std::shared_ptr<CtAnchoredWidgetState>
            charOffset == other_state->charOffset and
            justification == other_state->justification and
            fileName == other_state->fileName and
-           rawBlob == other_state->rawBlob and
+           blob == other_state->blob and
            timeSeconds == other_state->timeSeconds and
            uniqueId == other_state->uniqueId and
            pathLastMultiFile == other_state->pathLastMultiFile;
@@ -121,7 +121,7 @@ bool CtAnchoredWidgetState_EmbFile::equal(std::shared_ptr<CtAnchoredWidgetState>
 
 CtAnchoredWidget* CtAnchoredWidgetState_EmbFile::to_widget(CtMainWin* pCtMainWin)
 {
-    return new CtImageEmbFile{pCtMainWin, fileName, rawBlob, timeSeconds, charOffset, justification, uniqueId, pathLastMultiFile};
+    return new CtImageEmbFile{pCtMainWin, fileName, blob, timeSeconds, charOffset, justification, uniqueId, pathLastMultiFile};
 }
 
 // Codebox
@@ -192,17 +192,21 @@ bool CtAnchoredWidgetState_TableCommon::equal(std::shared_ptr<CtAnchoredWidgetSt
 
 CtTableLight* CtAnchoredWidgetState_TableCommon::to_widget_light(CtMainWin* pCtMainWin) const
 {
-    CtTableMatrix tableMatrix;
-    tableMatrix.reserve(rows.size());
+    size_t numColumns{0u};
     for (const auto& row : rows) {
-        tableMatrix.push_back(CtTableRow{});
-        tableMatrix.back().reserve(row.size());
-        for (const auto& cell : row) {
-            tableMatrix.back().push_back(new Glib::ustring{cell});
+        numColumns = std::max(numColumns, row.size());
+    }
+    CtTableStore tableStore{numColumns};
+    tableStore.reserve_rows(rows.size());
+    for (const auto& row : rows) {
+        const size_t rowIdx = tableStore.get_num_rows();
+        tableStore.row_insert(rowIdx);
+        for (size_t colIdx = 0u; colIdx < row.size(); ++colIdx) {
+            tableStore.set(rowIdx, colIdx, row[colIdx].raw());
         }
     }
     return new CtTableLight{pCtMainWin,
-                            tableMatrix,
+                            std::move(tableStore),
                             colWidthDefault,
                             charOffset,
                             justification,
@@ -287,11 +291,14 @@ void CtStateMachine::node_selected_changed(const gint64 node_id_data_holder)
     if (not map::exists(_node_states, node_id_data_holder)) {
         CtTreeIter node = _pCtMainWin->curr_tree_iter();
         auto state = std::shared_ptr<CtNodeState>(new CtNodeState{});
-        CtStorageXmlHelper{_pCtMainWin}.save_buffer_no_widgets_to_xml(state->buffer_xml.get_root_node(),
-                                                                      node.get_node_text_buffer(), 0, -1, 'n');
-        state->buffer_xml_string = state->buffer_xml.write_to_string();
-        for (auto widget : node.get_anchored_widgets()) {
-            state->widgetStates.push_back(widget->get_state());
+        // the plain text and code nodes use the undo of the GtkSourceBuffer, a copy of their text would never be read
+        if (node.get_node_is_rich_text()) {
+            CtStorageXmlHelper{_pCtMainWin}.save_buffer_no_widgets_to_xml(state->buffer_xml.get_root_node(),
+                                                                          node.get_node_text_buffer(), 0, -1, 'n');
+            state->buffer_xml_string = state->buffer_xml.write_to_string();
+            for (auto widget : node.get_anchored_widgets()) {
+                state->widgetStates.push_back(widget->get_state());
+            }
         }
 
         CtNodeStates states;
@@ -370,6 +377,64 @@ void CtStateMachine::delete_states(const gint64 node_id_data_holder)
     }
 }
 
+void CtStateMachine::drop_undo_states(const gint64 node_id_data_holder)
+{
+    auto iterStates = _node_states.find(node_id_data_holder);
+    if (_node_states.end() == iterStates) {
+        return;
+    }
+    CtTreeIter currTreeIter = _pCtMainWin->curr_tree_iter();
+    if (not currTreeIter or currTreeIter.get_node_id_data_holder() != node_id_data_holder) {
+        // recreated from the buffer when the node is selected again
+        _node_states.erase(iterStates);
+        return;
+    }
+    CtNodeStates& nodeStates = iterStates->second;
+    std::shared_ptr<CtNodeState> currState = nodeStates.get_state();
+    nodeStates.states.clear();
+    nodeStates.states.push_back(currState);
+    nodeStates.index = 0;
+}
+
+void CtStateMachine::memory_usage_populate(CtMemoryUsage& memoryUsage) const
+{
+    using Category = CtMemoryUsage::Category;
+    for (const auto& [nodeId, nodeStates] : _node_states) {
+        for (const std::shared_ptr<CtNodeState>& pState : nodeStates.states) {
+            size_t bytes = pState->buffer_xml_string.bytes() + sizeof(CtNodeState);
+            bytes += CtStorageXmlHelper::estimate_node_xml_bytes(const_cast<xmlpp::Document&>(pState->buffer_xml).get_root_node());
+            for (const std::shared_ptr<CtAnchoredWidgetState>& pWidgetState : pState->widgetStates) {
+                if (auto pImagePng = dynamic_cast<const CtAnchoredWidgetState_ImagePng*>(pWidgetState.get())) {
+                    if (pImagePng->pixbuf) {
+                        memoryUsage.add_shared(nodeId, Category::UndoHistory, pImagePng->pixbuf->gobj(),
+                                               gdk_pixbuf_get_byte_length(pImagePng->pixbuf->gobj()));
+                    }
+                }
+                else if (auto pEmbFile = dynamic_cast<const CtAnchoredWidgetState_EmbFile*>(pWidgetState.get())) {
+                    // the blob is usually shared with the widget, in that case counted with the widget
+                    if (pEmbFile->blob and not pEmbFile->blob->is_spooled()) {
+                        memoryUsage.add_shared(nodeId, Category::UndoHistory, pEmbFile->blob.get(), pEmbFile->blob->size());
+                    }
+                }
+                else if (auto pCodebox = dynamic_cast<const CtAnchoredWidgetState_Codebox*>(pWidgetState.get())) {
+                    bytes += pCodebox->content.bytes();
+                }
+                else if (auto pLatex = dynamic_cast<const CtAnchoredWidgetState_Latex*>(pWidgetState.get())) {
+                    bytes += pLatex->text.bytes();
+                }
+                else if (auto pTable = dynamic_cast<const CtAnchoredWidgetState_TableCommon*>(pWidgetState.get())) {
+                    for (const std::vector<Glib::ustring>& row : pTable->rows) {
+                        for (const Glib::ustring& cell : row) {
+                            bytes += cell.bytes() + sizeof(Glib::ustring);
+                        }
+                    }
+                }
+            }
+            memoryUsage.add(nodeId, Category::UndoHistory, bytes);
+        }
+    }
+}
+
 // Are we in the last state?
 bool CtStateMachine::curr_index_is_last_index(const gint64 node_id_data_holder)
 {
@@ -100,7 +100,7 @@ public:
 
 public:
     fs::path      fileName;
-    std::string   rawBlob;      // raw data, not a string
+    CtEmbFileBlobPtr blob;      // shared with the widget, not copied
     time_t        timeSeconds;
     const size_t  uniqueId;
     fs::path      pathLastMultiFile;
@@ -199,10 +199,14 @@ public:
     void update_state(CtTreeIter tree_iter);
     void update_curr_state_cursor_pos(const gint64 node_id_data_holder);
     void update_curr_state_v_adj_val(const gint64 node_id_data_holder);
+    // keep only the current state, or none if not the selected node
+    void drop_undo_states(const gint64 node_id_data_holder);
+    void memory_usage_populate(CtMemoryUsage& memoryUsage) const;
 
     void set_go_bk_fw_active(bool val) { _go_bk_fw_active = val; }
 
     const std::vector<gint64>& get_visited_nodes_list() { return _visited_nodes_list; }
+    int get_visited_nodes_idx() const { return _visited_nodes_idx; }
     void set_visited_nodes_list(const std::vector<gint64>& list) {
         _visited_nodes_list = list;
         _visited_nodes_idx = _visited_nodes_list.size() - 1;
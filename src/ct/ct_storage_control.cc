@@ -27,6 +27,7 @@
 #include "ct_storage_sqlite.h"
 #include "ct_storage_multifile.h"
 #include "ct_p7za_iface.h"
+#include "ct_sqlite_crypt_vfs.h"
 #include "ct_main_win.h"
 #include "ct_logging.h"
 #include <glib/gstdio.h>
@@ -112,6 +113,7 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
                                                         Glib::ustring password)
 {
     fs::path extracted_file_path{file_path};
+    bool cryptKeysHeld{false};
 
     try {
         if (CtDocType::MultiFile == doc_type) {
@@ -121,7 +123,15 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
             if (not fs::is_regular_file(file_path)) throw std::runtime_error("no file");
 
             // unpack file if need
-            if (fs::get_doc_encrypt_from_file_ext(file_path) == CtDocEncrypt::True) {
+            if (CtDocType::SQLite == doc_type and CtSqliteCryptVfs::is_crypt_file(file_path.string())) {
+                // encrypted page by page, the database is worked on in place
+                if (not _unlock_crypt_file(pCtMainWin, file_path, password)) {
+                    // user canceled operation
+                    return nullptr;
+                }
+                cryptKeysHeld = true;
+            }
+            else if (fs::get_doc_encrypt_from_file_ext(file_path) == CtDocEncrypt::True) {
                 extracted_file_path = _extract_file(pCtMainWin, file_path, password);
                 if (extracted_file_path.empty()) {
                     // user canceled operation
@@ -137,8 +147,13 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
         std::unique_ptr<CtStorageEntity> pStorage = CtStorageControl::_get_entity_by_type(pCtMainWin, doc_type);
         if (not pStorage) throw std::runtime_error("no storage");
 
-        // load from file / folder
-        if (not pStorage->populate_treestore(extracted_file_path, error)) throw std::runtime_error(error);
+        // load from file / folder, with the tree model detached from the view
+        {
+            CtTreeStore& ctTreeStore = pCtMainWin->get_tree_store();
+            ctTreeStore.bulk_population_begin();
+            auto on_scope_exit = scope_guard([&ctTreeStore](void*) { ctTreeStore.bulk_population_end(); });
+            if (not pStorage->populate_treestore(extracted_file_path, error)) throw std::runtime_error(error);
+        }
 
         // it's ready
         CtStorageControl* doc = new CtStorageControl{pCtMainWin};
@@ -146,6 +161,7 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
         doc->_mod_time = fs::getmtime(file_path);
         doc->_password = password;
         doc->_extracted_file_path = extracted_file_path;
+        doc->_cryptKeysHeld = cryptKeysHeld;
         doc->_storage.swap(pStorage);
         return doc;
     }
@@ -153,6 +169,9 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
         if (extracted_file_path != file_path and fs::is_regular_file(extracted_file_path)) {
             g_remove(extracted_file_path.c_str());
         }
+        if (cryptKeysHeld) {
+            CtSqliteCryptVfs::release_file(file_path.string());
+        }
         spdlog::error(e.what());
         error = e.what();
         return nullptr;
@@ -232,6 +251,7 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
     #endif
 
     fs::path extracted_file_path = file_path;
+    bool cryptKeysHeld{false};
 
     auto f_cleanup = [&](){
         if (CtDocType::MultiFile == doc_type) {
@@ -282,10 +302,18 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
     }
 
     try {
-        if (fs::get_doc_encrypt_from_file_ext(file_path) == CtDocEncrypt::True) {
+        const bool page_encrypt = CtDocType::SQLite == doc_type and pCtMainWin->get_ct_config()->ctxPageEncryption;
+        if (fs::get_doc_encrypt_from_file_ext(file_path) == CtDocEncrypt::True and not page_encrypt) {
             extracted_file_path = pCtMainWin->get_ct_tmp()->getHiddenFilePath(file_path);
         }
         f_cleanup();
+        if (fs::get_doc_encrypt_from_file_ext(file_path) == CtDocEncrypt::True and page_encrypt) {
+            // the storage writes straight into the encrypted database, no archive to package
+            if (not CtSqliteCryptVfs::create_file(file_path.string(), password.raw())) {
+                throw std::runtime_error(str::format(_("You Have No Write Access to %s"), file_path.parent_path().string()));
+            }
+            cryptKeysHeld = true;
+        }
 
         std::unique_ptr<CtStorageEntity> storage = CtStorageControl::_get_entity_by_type(pCtMainWin, doc_type);
         if (not storage) throw std::runtime_error("no storage");
@@ -317,10 +345,14 @@ static bool _move_dir_with_fallback(const fs::path& dir_from, const fs::path& di
         doc->_mod_time = fs::getmtime(file_path);
         doc->_password = password;
         doc->_extracted_file_path = extracted_file_path;
+        doc->_cryptKeysHeld = cryptKeysHeld;
         doc->_storage.swap(storage);
         return doc;
     }
     catch (std::exception& e) {
+        if (cryptKeysHeld) {
+            CtSqliteCryptVfs::release_file(file_path.string()); // reads the salt, before the file is removed
+        }
         f_cleanup();
 
         spdlog::error(e.what());
@@ -392,6 +424,10 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring& error)
         }
     });
 
+    // sqlite in write ahead log mode: the backup of the document as before this save is
+    // taken online from a read snapshot by the backup thread, without closing the connection
+    std::shared_ptr<CtSqliteSnapshot> pMainBackupSnapshot;
+
     try {
         if (_file_path.empty()) {
             throw std::runtime_error("storage not initialized");
@@ -402,6 +438,14 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring& error)
 
         if (need_main_backup) {
             if (CtDocType::SQLite == doc_type and not need_encrypt) {
+                pMainBackupSnapshot = CtSqliteSnapshot::create(_file_path);
+            }
+            if (pMainBackupSnapshot) {
+#if defined(DEBUG_BACKUP_ENCRYPT)
+                spdlog::debug("{} snapshot for {}", _file_path.string(), main_backup.string());
+#endif // DEBUG_BACKUP_ENCRYPT
+            }
+            else if (CtDocType::SQLite == doc_type and not need_encrypt) {
                 _storage->close_connect(); // temporary, because of sqlite keepig the file
                 if (not fs::copy_file(_file_path, main_backup)) {
                     throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _file_path.parent_path().string()));
@@ -434,22 +478,31 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring& error)
         if (need_vacuum) {
             _storage->vacuum();
         }
-        if (need_main_backup or need_encrypt) {
+        if (need_main_backup or need_encrypt or CtDocType::SQLite == doc_type) {
             auto pBackupEncryptData = std::make_shared<CtBackupEncryptData>();
             pBackupEncryptData->backupType = need_main_backup ? CtBackupType::SingleFile : CtBackupType::None;
             pBackupEncryptData->needEncrypt = need_encrypt;
             pBackupEncryptData->file_path = _file_path.string();
             pBackupEncryptData->main_backup = main_backup.string();
+            pBackupEncryptData->pMainBackupSnapshot = pMainBackupSnapshot;
+            if (CtDocType::SQLite == doc_type) {
+                pBackupEncryptData->wal_checkpoint_db = _extracted_file_path.string();
+            }
             if (need_encrypt) {
                 pBackupEncryptData->extracted_copy = _extracted_file_path.string() + (str_timestamp + _extracted_file_path.extension());
-                _storage->close_connect(); // temporary, because of sqlite keepig the file
-                if (not fs::copy_file(_extracted_file_path, pBackupEncryptData->extracted_copy)) {
-                    throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _extracted_file_path.parent_path().string()));
+                if (CtDocType::SQLite == doc_type) {
+                    pBackupEncryptData->pExtractedCopySnapshot = CtSqliteSnapshot::create(_extracted_file_path);
                 }
+                if (not pBackupEncryptData->pExtractedCopySnapshot) {
+                    _storage->close_connect(); // temporary, because of sqlite keepig the file
+                    if (not fs::copy_file(_extracted_file_path, pBackupEncryptData->extracted_copy)) {
+                        throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _extracted_file_path.parent_path().string()));
+                    }
 #if defined(DEBUG_BACKUP_ENCRYPT)
-                spdlog::debug("{} ++ {}", _extracted_file_path.string(), pBackupEncryptData->extracted_copy);
+                    spdlog::debug("{} ++ {}", _extracted_file_path.string(), pBackupEncryptData->extracted_copy);
 #endif // DEBUG_BACKUP_ENCRYPT
-                _storage->reopen_connect();
+                    _storage->reopen_connect();
+                }
                 pBackupEncryptData->password = _password;
             }
             pBackupEncryptData->p_mod_time = &_mod_time;
@@ -465,6 +518,13 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring& error)
     catch (std::exception& e) {
         // recover from backup
         try {
+            if (pMainBackupSnapshot) {
+                // the snapshot still holds the content before this save
+                if (not pMainBackupSnapshot->backup_to(main_backup)) {
+                    (void)fs::remove(main_backup);
+                }
+                pMainBackupSnapshot.reset(); // the main connection must be the last to close, removing the write ahead log
+            }
             _storage->close_connect();
             if (need_main_backup and fs::is_regular_file(main_backup)) fs::move_file(main_backup, _file_path);
             _storage->reopen_connect();
@@ -479,13 +539,23 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring& error)
 
 Glib::RefPtr<Gtk::TextBuffer> CtStorageControl::get_delayed_text_buffer(const gint64 node_id,
                                                                         const std::string& syntax,
-                                                                        std::list<CtAnchoredWidget*>& widgets) const
+                                                                        std::list<CtAnchoredWidget*>& widgets,
+                                                                        const CtPreparedRichText* pPrepared/*= nullptr*/) const
 {
     if (not _storage) {
         spdlog::error("!! {} storage is not initialized", __FUNCTION__);
         return Glib::RefPtr<Gtk::TextBuffer>{};
     }
-    return _storage->get_delayed_text_buffer(node_id, syntax, widgets);
+    return _storage->get_delayed_text_buffer(node_id, syntax, widgets, pPrepared);
+}
+
+bool CtStorageControl::get_delayed_text_raw(const gint64 node_id, std::string& rawXml, bool* pHasWidgets/*= nullptr*/) const
+{
+    if (not _storage) {
+        spdlog::error("!! {} storage is not initialized", __FUNCTION__);
+        return false;
+    }
+    return _storage->get_delayed_text_raw(node_id, rawXml, pHasWidgets);
 }
 
 fs::path CtStorageControl::get_embedded_filepath(const CtTreeIter& ct_tree_iter, const std::string& filename) const
@@ -497,37 +567,59 @@ fs::path CtStorageControl::get_embedded_filepath(const CtTreeIter& ct_tree_iter,
     return _storage->get_embedded_filepath(ct_tree_iter, filename);
 }
 
-/*static*/fs::path CtStorageControl::_extract_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password)
+bool CtStorageControl::restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter)
+{
+    if (not _storage) {
+        spdlog::error("!! {} storage is not initialized", __FUNCTION__);
+        return false;
+    }
+    return _storage->restore_delayed_text_buffer(ct_tree_iter);
+}
+
+void CtStorageControl::memory_usage_populate(CtMemoryUsage& memoryUsage) const
+{
+    if (_storage) {
+        _storage->memory_usage_populate(memoryUsage);
+    }
+}
+
+/*static*/bool CtStorageControl::_ask_password(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password)
 {
-    fs::path temp_dir = pCtMainWin->get_ct_tmp()->getHiddenDirPath(file_path);
-    fs::path temp_file_path = pCtMainWin->get_ct_tmp()->getHiddenFilePath(file_path);
     Glib::ustring title = str::format(_("Enter Password for %s"), file_path.filename().string());
-    while (true) {
-        if (password.empty()) {
-            CtDialogTextEntry dialogTextEntry(title, true/*forPassword*/, pCtMainWin);
+    CtDialogTextEntry dialogTextEntry(title, true/*forPassword*/, pCtMainWin);
 #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
-            auto on_scope_exit = scope_guard([pCtMainWin](void*) {
-                pCtMainWin->set_systray_can_hide(true);
-            });
-            pCtMainWin->set_systray_can_hide(false);
+    auto on_scope_exit = scope_guard([pCtMainWin](void*) {
+        pCtMainWin->set_systray_can_hide(true);
+    });
+    pCtMainWin->set_systray_can_hide(false);
 #endif /* GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED) */
 #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
-            if (Gtk::RESPONSE_OK != dialogTextEntry.run()) {
+    if (Gtk::RESPONSE_OK != dialogTextEntry.run()) {
 #else
-            int response = -1;
-            auto loop = Glib::MainLoop::create(false);
-            dialogTextEntry.signal_response().connect([&](int resp){
-                response = resp;
-                loop->quit();
-            });
-            dialogTextEntry.present();
-            loop->run();
-            if (1 != response) {
+    int response = -1;
+    auto loop = Glib::MainLoop::create(false);
+    dialogTextEntry.signal_response().connect([&](int resp){
+        response = resp;
+        loop->quit();
+    });
+    dialogTextEntry.present();
+    loop->run();
+    if (1 != response) {
 #endif
-                // no password, user cancels operation, return empty path
-                return fs::path{};
-            }
-            password = dialogTextEntry.get_entry_text();
+        return false;
+    }
+    password = dialogTextEntry.get_entry_text();
+    return true;
+}
+
+/*static*/fs::path CtStorageControl::_extract_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password)
+{
+    fs::path temp_dir = pCtMainWin->get_ct_tmp()->getHiddenDirPath(file_path);
+    fs::path temp_file_path = pCtMainWin->get_ct_tmp()->getHiddenFilePath(file_path);
+    while (true) {
+        if (password.empty() and not _ask_password(pCtMainWin, file_path, password)) {
+            // no password, user cancels operation, return empty path
+            return fs::path{};
         }
         const int retVal = CtP7zaIface::p7za_extract(file_path.c_str(), temp_dir.c_str(), password.c_str(), false);
         if (0 == retVal) {
@@ -553,6 +645,19 @@ fs::path CtStorageControl::get_embedded_filepath(const CtTreeIter& ct_tree_iter,
     }
 }
 
+/*static*/bool CtStorageControl::_unlock_crypt_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password)
+{
+    while (true) {
+        if (password.empty() and not _ask_password(pCtMainWin, file_path, password)) {
+            return false;
+        }
+        if (CtSqliteCryptVfs::unlock_file(file_path.string(), password.raw())) {
+            return true;
+        }
+        password.clear();
+    }
+}
+
 /*static*/bool CtStorageControl::_package_file(const fs::path& file_from, const fs::path& file_to, const Glib::ustring& password)
 {
     fs::path tmp_prev_archive;
@@ -598,6 +703,9 @@ CtStorageControl::~CtStorageControl()
         backupEncryptDEQueue.push_back(nullptr);
         _pThreadBackupEncrypt->join();
     }
+    if (_cryptKeysHeld) {
+        CtSqliteCryptVfs::release_file(_file_path.string());
+    }
 }
 
 void CtStorageControl::_backupEncryptThread()
@@ -609,8 +717,50 @@ void CtStorageControl::_backupEncryptThread()
             break;
         }
 
+        // passive checkpoint of the document once done with this item, whatever the outcome
+        auto on_scope_exit = scope_guard([pBackupEncryptData](void*) {
+            if (pBackupEncryptData->wal_checkpoint_db.empty()) {
+                return;
+            }
+            pBackupEncryptData->pMainBackupSnapshot.reset();
+            pBackupEncryptData->pExtractedCopySnapshot.reset();
+            (void)CtSqliteSnapshot::wal_checkpoint_passive(pBackupEncryptData->wal_checkpoint_db);
+            if (pBackupEncryptData->p_mod_time and not pBackupEncryptData->needEncrypt) {
+                // the checkpoint has just written to the document file
+                *pBackupEncryptData->p_mod_time = fs::getmtime(pBackupEncryptData->file_path);
+            }
+        });
+
+        // online backup from the snapshot taken before the save
+        if (pBackupEncryptData->pMainBackupSnapshot) {
+            const bool retValBackup = pBackupEncryptData->pMainBackupSnapshot->backup_to(pBackupEncryptData->main_backup);
+            pBackupEncryptData->pMainBackupSnapshot.reset();
+            if (not retValBackup) {
+                (void)fs::remove(pBackupEncryptData->main_backup);
+                _pCtMainWin->errorsDEQueue.push_back(str::format(_("You Have No Write Access to %s"), fs::path{pBackupEncryptData->main_backup}.parent_path().string()));
+                _pCtMainWin->dispatcherErrorMsg.emit();
+                continue;
+            }
+#if defined(DEBUG_BACKUP_ENCRYPT)
+            spdlog::debug("{} ++ {}", pBackupEncryptData->file_path, pBackupEncryptData->main_backup);
+#endif // DEBUG_BACKUP_ENCRYPT
+        }
+
         // encrypt the file
         if (pBackupEncryptData->needEncrypt) {
+            if (pBackupEncryptData->pExtractedCopySnapshot) {
+                const bool retValBackup = pBackupEncryptData->pExtractedCopySnapshot->backup_to(pBackupEncryptData->extracted_copy);
+                pBackupEncryptData->pExtractedCopySnapshot.reset();
+                if (not retValBackup) {
+                    (void)fs::remove(pBackupEncryptData->extracted_copy);
+                    _pCtMainWin->errorsDEQueue.push_back(_("Failed to encrypt the file"));
+                    _pCtMainWin->dispatcherErrorMsg.emit();
+                    continue;
+                }
+#if defined(DEBUG_BACKUP_ENCRYPT)
+                spdlog::debug("{} ++ {}", pBackupEncryptData->wal_checkpoint_db, pBackupEncryptData->extracted_copy);
+#endif // DEBUG_BACKUP_ENCRYPT
+            }
             Glib::ustring error;
             if (not CtStorageControl::document_integrity_check_pass(_pCtMainWin, pBackupEncryptData->extracted_copy, error)) {
                 spdlog::error("{} {}", __FUNCTION__, error.raw());
@@ -853,7 +1003,18 @@ void CtStorageControl::add_nodes_from_storage(const fs::path& file_path,
 
     Glib::ustring password;
     fs::path extracted_file_path = file_path;
-    if (not is_folder and CtDocEncrypt::True == fs::get_doc_encrypt_from_file_ext(file_path)) {
+    bool cryptKeysHeld{false};
+    auto on_scope_exit = scope_guard([&](void*) {
+        if (cryptKeysHeld) CtSqliteCryptVfs::release_file(file_path.string());
+    });
+    if (not is_folder and CtSqliteCryptVfs::is_crypt_file(file_path.string())) {
+        if (not _unlock_crypt_file(_pCtMainWin, file_path, password)) {
+            // user canceled operation
+            return;
+        }
+        cryptKeysHeld = true;
+    }
+    else if (not is_folder and CtDocEncrypt::True == fs::get_doc_encrypt_from_file_ext(file_path)) {
         extracted_file_path = _extract_file(_pCtMainWin, file_path, password);
         if (extracted_file_path.empty()) {
             // user canceled operation
@@ -874,9 +1035,14 @@ void CtStorageControl::add_nodes_from_storage(const fs::path& file_path,
 
     if (not pStorage) throw std::runtime_error("no storage");
 
-    pStorage->import_nodes(extracted_file_path, parent_iter);
+    CtTreeStore& ctTreeStore = _pCtMainWin->get_tree_store();
+    {
+        ctTreeStore.bulk_population_begin();
+        auto on_scope_exit = scope_guard([&ctTreeStore](void*) { ctTreeStore.bulk_population_end(); });
+        pStorage->import_nodes(extracted_file_path, parent_iter);
+    }
 
-    _pCtMainWin->get_tree_store().nodes_sequences_fix(parent_iter, false);
+    ctTreeStore.nodes_sequences_fix(parent_iter, false);
     _pCtMainWin->update_window_save_needed();
 }
 
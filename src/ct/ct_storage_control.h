@@ -66,8 +66,12 @@ public:
     bool try_reopen(Glib::ustring& error);
     Glib::RefPtr<Gtk::TextBuffer> get_delayed_text_buffer(const gint64 node_id,
                                                           const std::string& syntax,
-                                                          std::list<CtAnchoredWidget*>& widgets) const;
+                                                          std::list<CtAnchoredWidget*>& widgets,
+                                                          const CtPreparedRichText* pPrepared = nullptr) const;
+    bool get_delayed_text_raw(const gint64 node_id, std::string& rawXml, bool* pHasWidgets = nullptr) const;
     fs::path get_embedded_filepath(const CtTreeIter& ct_tree_iter, const std::string& filename) const;
+    bool restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter);
+    void memory_usage_populate(CtMemoryUsage& memoryUsage) const;
     const fs::path& get_file_path() { return _file_path; }
     time_t get_mod_time() { return _mod_time; }
     fs::path get_file_name() { return _file_path.empty() ? "" : _file_path.filename(); }
@@ -92,7 +96,9 @@ public:
 
 private:
     static std::unique_ptr<CtStorageEntity> _get_entity_by_type(CtMainWin* pCtMainWin, CtDocType file_type);
+    static bool     _ask_password(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password);
     static fs::path _extract_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password);
+    static bool     _unlock_crypt_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password);
     static bool     _package_file(const fs::path& file_from, const fs::path& file_to, const Glib::ustring& password);
 
     CtStorageControl(CtMainWin* pCtMainWin);
@@ -103,6 +109,7 @@ private:
     time_t                           _mod_time{0};
     Glib::ustring                    _password;
     fs::path                         _extracted_file_path;
+    bool                             _cryptKeysHeld{false}; // the page encrypted file is released on close
     std::unique_ptr<CtStorageEntity> _storage;
     CtStorageSyncPending             _syncPending;
 
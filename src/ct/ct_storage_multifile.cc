@@ -491,24 +491,59 @@ bool CtStorageMultiFile::_nodes_to_multifile(const CtTreeIter* ct_tree_iter,
     return sha256sum;
 }
 
+/*static*/std::string CtStorageMultiFile::save_blob(const CtEmbFileBlob& blob,
+                                                    const std::string& dir_path,
+                                                    const std::string& file_ext)
+{
+    const std::string sha256sum = blob.get_sha256sum();
+    const std::string sha256sum_ext = sha256sum + file_ext;
+    const std::string filepath = Glib::build_filename(dir_path, sha256sum_ext);
+    if (not Glib::file_test(filepath, Glib::FILE_TEST_IS_REGULAR)) {
+        const std::string filepath_before = Glib::build_filename(dir_path, BEFORE_SAVE, sha256sum_ext);
+        if (Glib::file_test(filepath_before, Glib::FILE_TEST_IS_REGULAR)) {
+            fs::move_file(filepath_before, filepath);
+        }
+        else {
+            blob.write_to_file(filepath);
+        }
+    }
+    return sha256sum;
+}
+
 /*static*/bool CtStorageMultiFile::read_blob(const std::string& dir_path,
                                              const std::string& sha256sum,
                                              std::string& rawBlob)
+{
+    const fs::path blob_filepath = get_blob_filepath(dir_path, sha256sum);
+    if (blob_filepath.empty()) {
+        return false;
+    }
+    try {
+        rawBlob = Glib::file_get_contents(blob_filepath.string());
+        return true;
+    }
+    catch (Glib::Error& error) {
+        spdlog::error("{} {}", __FUNCTION__, std::string(error.what()));
+    }
+    return false;
+}
+
+/*static*/fs::path CtStorageMultiFile::get_blob_filepath(const std::string& dir_path,
+                                                        const std::string& sha256sum)
 {
     try {
         Glib::Dir gdir{dir_path};
         std::list<std::string> dir_entries{gdir.begin(), gdir.end()};
         for (const std::string& filename : dir_entries) {
             if (str::startswith(filename, sha256sum)) {
-                rawBlob = Glib::file_get_contents(Glib::build_filename(dir_path, filename));
-                return true;
+                return fs::path{dir_path} / filename;
             }
         }
     }
     catch (Glib::Error& error) {
         spdlog::error("{} {}", __FUNCTION__, std::string(error.what()));
     }
-    return false;
+    return fs::path{};
 }
 
 /*static*/std::list<fs::path> CtStorageMultiFile::get_child_nodes_dirs(const fs::path& dir_path)
@@ -710,7 +745,8 @@ void CtStorageMultiFile::import_nodes(const fs::path& dir_path, const Gtk::TreeM
 
 Glib::RefPtr<Gtk::TextBuffer> CtStorageMultiFile::get_delayed_text_buffer(const gint64 node_id,
                                                                           const std::string& syntax,
-                                                                          std::list<CtAnchoredWidget*>& widgets) const
+                                                                          std::list<CtAnchoredWidget*>& widgets,
+                                                                          const CtPreparedRichText*/*pPrepared*/) const
 {
     if (_delayed_text_buffers.count(node_id) == 0) {
         spdlog::error("!! {} node_id {}", __FUNCTION__, node_id);
@@ -725,3 +761,33 @@ Glib::RefPtr<Gtk::TextBuffer> CtStorageMultiFile::get_delayed_text_buffer(const
     }
     return ret_buffer;
 }
+
+bool CtStorageMultiFile::restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter)
+{
+    // the node is saved so its node.xml on disk has the same content
+    const fs::path node_xml_path = _get_node_dirpath(ct_tree_iter) / NODE_XML;
+    try {
+        std::unique_ptr<xmlpp::DomParser> parser = CtStorageXml::get_parser(node_xml_path);
+        xmlpp::Node* xml_node = parser->get_document()->get_root_node()->get_first_child("node");
+        if (not xml_node) {
+            spdlog::error("!! {} missing node in {}", __FUNCTION__, node_xml_path.string());
+            return false;
+        }
+        auto node_buffer = std::make_shared<xmlpp::Document>();
+        node_buffer->create_root_node("root")->import_node(xml_node);
+        _delayed_text_buffers[ct_tree_iter.get_node_id_data_holder()] = node_buffer;
+        return true;
+    }
+    catch (std::exception& ex) {
+        spdlog::error("!! {} parse {} : {}", __FUNCTION__, node_xml_path.string(), ex.what());
+    }
+    return false;
+}
+
+void CtStorageMultiFile::memory_usage_populate(CtMemoryUsage& memoryUsage) const
+{
+    for (const auto& [nodeId, node_buffer] : _delayed_text_buffers) {
+        memoryUsage.add(nodeId, CtMemoryUsage::Category::DelayedXml,
+                        CtStorageXmlHelper::estimate_node_xml_bytes(node_buffer->get_root_node()));
+    }
+}
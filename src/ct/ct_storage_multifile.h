@@ -33,6 +33,7 @@
 
 class CtMainWin;
 class CtAnchoredWidget;
+class CtEmbFileBlob;
 class CtTreeIter;
 class CtStorageCache;
 
@@ -47,9 +48,16 @@ public:
     static std::string save_blob(const std::string& rawBlob,
                                  const std::string& dir_path,
                                  const std::string& file_ext);
+    // checksum and copy in chunks, without the whole content in memory
+    static std::string save_blob(const CtEmbFileBlob& blob,
+                                 const std::string& dir_path,
+                                 const std::string& file_ext);
     static bool read_blob(const std::string& dir_path,
                           const std::string& sha256sum,
                           std::string& rawBlob);
+    // empty if not found
+    static fs::path get_blob_filepath(const std::string& dir_path,
+                                      const std::string& sha256sum);
 
     static std::list<fs::path> get_child_nodes_dirs(const fs::path& dir_path);
 
@@ -73,10 +81,16 @@ public:
 
     Glib::RefPtr<Gtk::TextBuffer> get_delayed_text_buffer(const gint64 node_id,
                                                           const std::string& syntax,
-                                                          std::list<CtAnchoredWidget*>& widgets) const override;
+                                                          std::list<CtAnchoredWidget*>& widgets,
+                                                          const CtPreparedRichText* pPrepared) const override;
+    // the nodes are parsed at load
+    bool get_delayed_text_raw(const gint64/*node_id*/, std::string&/*rawXml*/, bool*/*pHasWidgets*/ = nullptr) const override { return false; }
 
     fs::path get_embedded_filepath(const CtTreeIter& ct_tree_iter, const std::string& filename) const override;
 
+    bool restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter) override;
+    void memory_usage_populate(CtMemoryUsage& memoryUsage) const override;
+
 private:
     CtMainWin* const _pCtMainWin;
     CtConfig*  const _pCtConfig;
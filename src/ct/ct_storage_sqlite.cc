@@ -24,6 +24,7 @@
 #include "ct_storage_sqlite.h"
 #include "ct_storage_xml.h"
 #include "ct_storage_control.h"
+#include "ct_sqlite_crypt_vfs.h"
 #include "ct_main_win.h"
 #include "ct_logging.h"
 #include <unistd.h>
@@ -117,6 +118,26 @@ const char CtStorageSqlite::TABLE_BOOKMARK_CREATE[]{"CREATE TABLE bookmark ("
 const char CtStorageSqlite::TABLE_BOOKMARK_INSERT[]{"INSERT INTO bookmark VALUES(?,?)"};
 const char CtStorageSqlite::TABLE_BOOKMARK_DELETE[]{"DELETE FROM bookmark"};
 
+// rich text node links extracted at save, valid while ts_lastsave matches the one of the node
+const char CtStorageSqlite::TABLE_NODE_LINKS_CREATE[]{"CREATE TABLE IF NOT EXISTS node_links ("
+"node_id INTEGER UNIQUE,"
+"ts_lastsave INTEGER,"
+"links TEXT"            /* newline separated node link properties */
+")"
+};
+const char CtStorageSqlite::TABLE_NODE_LINKS_INSERT[]{"INSERT OR REPLACE INTO node_links VALUES(?,?,?)"};
+const char CtStorageSqlite::TABLE_NODE_LINKS_DELETE[]{"DELETE FROM node_links WHERE node_id=?"};
+
+// node content counters computed at save, valid while ts_lastsave matches the one of the node
+const char CtStorageSqlite::TABLE_NODE_STATS_CREATE[]{"CREATE TABLE IF NOT EXISTS node_stats ("
+"node_id INTEGER UNIQUE,"
+"ts_lastsave INTEGER,"
+"stats TEXT"            /* CtNodeStats::to_string() */
+")"
+};
+const char CtStorageSqlite::TABLE_NODE_STATS_INSERT[]{"INSERT OR REPLACE INTO node_stats VALUES(?,?,?)"};
+const char CtStorageSqlite::TABLE_NODE_STATS_DELETE[]{"DELETE FROM node_stats WHERE node_id=?"};
+
 /*static*/const std::string CtStorageSqlite::ERR_SQLITE_PREPV2{"!! sqlite3_prepare_v2: "};
 /*static*/const std::string CtStorageSqlite::ERR_SQLITE_STEP{"!! sqlite3_step: "};
 
@@ -175,6 +196,10 @@ bool CtStorageSqlite::_check_database_integrity()
 
 CtStorageSqlite::~CtStorageSqlite()
 {
+    if (_pThreadStaleNodes) {
+        _staleNodesCancel = true;
+        _pThreadStaleNodes->join();
+    }
     _close_db();
 }
 
@@ -242,6 +267,7 @@ bool CtStorageSqlite::populate_treestore(const fs::path& file_path, Glib::ustrin
     _close_db();
     try {
         // open db
+        _walMode = not _isDryRun;
         _open_db(file_path);
         _file_path = file_path;
 
@@ -276,6 +302,10 @@ bool CtStorageSqlite::populate_treestore(const fs::path& file_path, Glib::ustrin
         for (const std::pair<gint64,gint64>& top_id_pair : _get_children_node_ids_from_db(0)) {
             f_nodes_from_db(top_id_pair, ++sequence, Gtk::TreeModel::iterator{});
         }
+        if (not _isDryRun) {
+            _links_and_stats_from_db();
+            _stale_nodes_start();
+        }
 
         // keep db open for lazy node buffer loading
         return true;
@@ -298,10 +328,16 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
     try {
         // it's the first time (or an export), a new file will be created
         if (_pDb == nullptr) {
+            _walMode = true;
             _open_db(file_path);
             _file_path = file_path;
 
+            // must precede the creation of the tables, allows vacuum() to be incremental
+            _exec_no_callback("PRAGMA auto_vacuum=INCREMENTAL");
             _create_all_tables_in_db();
+            _sideTablesChecked = true;
+            _nodeLinksToWrite.clear();
+            _nodeStatsToWrite.clear();
             if ( CtExporting::NONESAVEAS == export_type or
                  CtExporting::ALL_TREE == export_type )
             {
@@ -367,6 +403,12 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
             if (syncPending.fix_db_tables) {
                 _fix_db_tables();
             }
+            // documents written by older versions have no node links / node stats tables
+            if (not _sideTablesChecked) {
+                _exec_no_callback(TABLE_NODE_LINKS_CREATE);
+                _exec_no_callback(TABLE_NODE_STATS_CREATE);
+                _sideTablesChecked = true;
+            }
             // update bookmarks
             if (syncPending.bookmarks_to_write) {
                 _write_bookmarks_to_db(_pCtMainWin->get_tree_store().bookmarks_get());
@@ -390,6 +432,15 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
             for (const gint64 node_id : syncPending.nodes_to_rm_set) {
                 _remove_db_node_with_children(node_id);
             }
+            // node links found out of date at load and not rewritten with their node
+            for (const auto& [node_id, tsLastSaveLinks] : _nodeLinksToWrite) {
+                _write_node_links_to_db(node_id, tsLastSaveLinks.first, tsLastSaveLinks.second);
+            }
+            _nodeLinksToWrite.clear();
+            for (const auto& [node_id, tsLastSaveStats] : _nodeStatsToWrite) {
+                _write_node_stats_to_db(node_id, tsLastSaveStats.first, tsLastSaveStats.second);
+            }
+            _nodeStatsToWrite.clear();
         }
         return true;
     }
@@ -401,7 +452,22 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
 
 void CtStorageSqlite::vacuum()
 {
-    spdlog::debug("VACUUM");
+    gint64 auto_vacuum{0};
+    {
+        Sqlite3StmtAuto stmt{_pDb, "PRAGMA auto_vacuum"};
+        if (not stmt.is_bad() and sqlite3_step(stmt) == SQLITE_ROW) {
+            auto_vacuum = sqlite3_column_int64(stmt, 0);
+        }
+    }
+    if (2 == auto_vacuum) {
+        // only release the free pages, no full rewrite of the database
+        spdlog::debug("PRAGMA incremental_vacuum");
+        _exec_no_callback("PRAGMA incremental_vacuum");
+        return;
+    }
+    // document created with an older version: one last full VACUUM is needed to switch to incremental
+    spdlog::debug("VACUUM (auto_vacuum {} -> INCREMENTAL)", auto_vacuum);
+    _exec_no_callback("PRAGMA auto_vacuum=INCREMENTAL");
     _exec_no_callback("VACUUM");
     _exec_no_callback("REINDEX");
 }
@@ -409,17 +475,147 @@ void CtStorageSqlite::vacuum()
 void CtStorageSqlite::_open_db(const fs::path& path)
 {
     if (_pDb) return;
-    if (sqlite3_open(path.c_str(), &_pDb) != SQLITE_OK) {
+    if (sqlite3_open_v2(path.c_str(), &_pDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, CtSqliteCryptVfs::get_vfs_name()) != SQLITE_OK) {
         std::string error = sqlite3_errmsg(_pDb);
         sqlite3_close(_pDb); // even after error, _pDb is initialized
         _pDb = nullptr;
         throw std::runtime_error(std::string("sqlite3_open: ") + error);
     }
+    if (CtSqliteCryptVfs::is_crypt_file(path.string())) {
+        // the temporary databases (e.g. of VACUUM) would be written in plain to disk
+        _exec_no_callback("PRAGMA temp_store=MEMORY");
+    }
+    if (_walMode) {
+        _set_wal_mode();
+    }
+}
+
+void CtStorageSqlite::_set_wal_mode()
+{
+    // only the document being edited switches to write ahead log, not files opened for
+    // integrity check or import; the checkpoints are run by the backup thread after each save
+    try {
+        {
+            // given back at close, the file on disk keeps its journal mode; one left in write
+            // ahead log by a crash gets the default
+            Sqlite3StmtAuto stmt{_pDb, "PRAGMA journal_mode"};
+            if (stmt.is_bad() or sqlite3_step(stmt) != SQLITE_ROW) {
+                throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
+            }
+            const std::string journal_mode = safe_sqlite3_column_text(stmt, 0);
+            _journalModeToRestore = journal_mode == "wal" ? "delete" : journal_mode;
+        }
+        Sqlite3StmtAuto stmt{_pDb, "PRAGMA journal_mode=WAL"};
+        if (stmt.is_bad() or sqlite3_step(stmt) != SQLITE_ROW) {
+            throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
+        }
+        const std::string journal_mode = safe_sqlite3_column_text(stmt, 0);
+        if (journal_mode != "wal") {
+            spdlog::warn("{} journal_mode={} {}", __FUNCTION__, journal_mode, _file_path.string());
+            _journalModeToRestore.clear();
+            return;
+        }
+        _exec_no_callback("PRAGMA wal_autocheckpoint=0");
+    }
+    catch (std::exception& e) {
+        spdlog::warn("{} {}", __FUNCTION__, e.what());
+    }
+}
+
+/*static*/std::shared_ptr<CtSqliteSnapshot> CtSqliteSnapshot::create(const fs::path& db_path)
+{
+    std::shared_ptr<CtSqliteSnapshot> pSnapshot{new CtSqliteSnapshot{}};
+    if (sqlite3_open_v2(db_path.c_str(), &pSnapshot->_pDb, SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX, CtSqliteCryptVfs::get_vfs_name()) != SQLITE_OK) {
+        spdlog::error("!! {} sqlite3_open_v2 {}: {}", __FUNCTION__, db_path.string(), sqlite3_errmsg(pSnapshot->_pDb));
+        return nullptr;
+    }
+    {
+        Sqlite3StmtAuto stmt{pSnapshot->_pDb, "PRAGMA journal_mode"};
+        if (stmt.is_bad() or
+            sqlite3_step(stmt) != SQLITE_ROW or
+            std::string{CtStorageSqlite::safe_sqlite3_column_text(stmt, 0)} != "wal")
+        {
+            // with a rollback journal our shared lock would block the writer
+            return nullptr;
+        }
+    }
+    // the first read after BEGIN starts the read transaction that pins the content
+    if (SQLITE_OK != sqlite3_exec(pSnapshot->_pDb, "BEGIN; SELECT count(*) FROM sqlite_master", nullptr, nullptr, nullptr)) {
+        spdlog::error("!! {} read transaction {}: {}", __FUNCTION__, db_path.string(), sqlite3_errmsg(pSnapshot->_pDb));
+        return nullptr;
+    }
+    return pSnapshot;
+}
+
+/*static*/bool CtSqliteSnapshot::wal_checkpoint_passive(const fs::path& db_path)
+{
+    sqlite3* pDb{nullptr};
+    if (sqlite3_open_v2(db_path.c_str(), &pDb, SQLITE_OPEN_READWRITE, CtSqliteCryptVfs::get_vfs_name()) != SQLITE_OK) {
+        spdlog::debug("!! {} sqlite3_open_v2 {}: {}", __FUNCTION__, db_path.string(), sqlite3_errmsg(pDb));
+        sqlite3_close(pDb);
+        return false;
+    }
+    // a fresh connection is aware of the write ahead log only after the first read
+    (void)sqlite3_exec(pDb, "SELECT count(*) FROM sqlite_master", nullptr, nullptr, nullptr);
+    int nLog{0};
+    int nCkpt{0};
+    const int rc = sqlite3_wal_checkpoint_v2(pDb, nullptr, SQLITE_CHECKPOINT_PASSIVE, &nLog, &nCkpt);
+    if (SQLITE_OK != rc) {
+        spdlog::debug("!! {} {}: {}", __FUNCTION__, db_path.string(), sqlite3_errmsg(pDb));
+    }
+    sqlite3_close(pDb);
+    return SQLITE_OK == rc and nLog == nCkpt;
+}
+
+CtSqliteSnapshot::~CtSqliteSnapshot()
+{
+    // closing the connection also ends the read transaction
+    sqlite3_close(_pDb);
+}
+
+bool CtSqliteSnapshot::backup_to(const fs::path& dest_path)
+{
+    // the copy of an encrypted database is encrypted with the same keys
+    const std::string src_path{sqlite3_db_filename(_pDb, "main")};
+    if (CtSqliteCryptVfs::is_crypt_file(src_path) and not CtSqliteCryptVfs::clone_header(src_path, dest_path.string())) {
+        spdlog::error("!! {} clone_header {}", __FUNCTION__, dest_path.string());
+        return false;
+    }
+    sqlite3* pDestDb{nullptr};
+    if (sqlite3_open_v2(dest_path.c_str(), &pDestDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, CtSqliteCryptVfs::get_vfs_name()) != SQLITE_OK) {
+        spdlog::error("!! {} sqlite3_open {}: {}", __FUNCTION__, dest_path.string(), sqlite3_errmsg(pDestDb));
+        sqlite3_close(pDestDb);
+        return false;
+    }
+    bool retVal{false};
+    sqlite3_backup* pBackup = sqlite3_backup_init(pDestDb, "main", _pDb, "main");
+    if (pBackup) {
+        // all pages in one step: the source is not modified from this connection
+        (void)sqlite3_backup_step(pBackup, -1);
+        retVal = SQLITE_OK == sqlite3_backup_finish(pBackup);
+    }
+    if (retVal) {
+        // the copy is a standalone file, do not carry over the write ahead log mode
+        (void)sqlite3_exec(pDestDb, "PRAGMA journal_mode=DELETE", nullptr, nullptr, nullptr);
+    }
+    else {
+        spdlog::error("!! {} {}: {}", __FUNCTION__, dest_path.string(), sqlite3_errmsg(pDestDb));
+    }
+    sqlite3_close(pDestDb);
+    return retVal;
 }
 
 void CtStorageSqlite::_close_db()
 {
     if (not _pDb) return;
+    if (not _journalModeToRestore.empty()) {
+        // checkpoints and removes the write ahead log, unless another connection is still open
+        const std::string sql = "PRAGMA journal_mode=" + _journalModeToRestore;
+        if (SQLITE_OK != sqlite3_exec(_pDb, sql.c_str(), nullptr, nullptr, nullptr)) {
+            spdlog::warn("{} {}: {}", __FUNCTION__, sql, sqlite3_errmsg(_pDb));
+        }
+        _journalModeToRestore.clear();
+    }
     sqlite3_close(_pDb);
     _pDb = nullptr;
     //_file_path = ""; we need file_path for reconnection
@@ -480,7 +676,7 @@ Gtk::TreeModel::iterator CtStorageSqlite::_node_from_db(const gint64 node_id,
 
     // buffer for imported node should be loaded now because file will be closed
     if (new_id != -1 and master_id <= 0/*no need for shared non master*/) {
-        nodeData.pTextBuffer = get_delayed_text_buffer(node_id, nodeData.syntax, nodeData.anchoredWidgets);
+        nodeData.pTextBuffer = get_delayed_text_buffer(node_id, nodeData.syntax, nodeData.anchoredWidgets, nullptr/*pPrepared*/);
     }
 
     return _pCtMainWin->get_tree_store().append_node(&nodeData, &parent_iter);
@@ -488,9 +684,13 @@ Gtk::TreeModel::iterator CtStorageSqlite::_node_from_db(const gint64 node_id,
 
 Glib::RefPtr<Gtk::TextBuffer> CtStorageSqlite::get_delayed_text_buffer(const gint64 node_id,
                                                                        const std::string& syntax,
-                                                                       std::list<CtAnchoredWidget*>& widgets) const
+                                                                       std::list<CtAnchoredWidget*>& widgets,
+                                                                       const CtPreparedRichText* pPrepared) const
 {
-    Sqlite3StmtAuto stmt{_pDb, "SELECT txt, has_codebox, has_table, has_image FROM node WHERE node_id=?"};
+    // the rich text already prepared off the main thread is not read again
+    const bool textPrepared = pPrepared and CtConst::RICH_TEXT_ID == syntax;
+    Sqlite3StmtAuto stmt{_pDb, textPrepared ? "SELECT has_codebox, has_table, has_image FROM node WHERE node_id=?"
+                                            : "SELECT has_codebox, has_table, has_image, txt FROM node WHERE node_id=?"};
     if (stmt.is_bad()) {
         spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
         return Glib::RefPtr<Gtk::TextBuffer>{};
@@ -503,19 +703,20 @@ Glib::RefPtr<Gtk::TextBuffer> CtStorageSqlite::get_delayed_text_buffer(const gin
     }
 
     Glib::RefPtr<Gtk::TextBuffer> rRetTextBuffer;
-    const char* textContent = safe_sqlite3_column_text(stmt, 0);
+    const char* textContent = textPrepared ? "" : safe_sqlite3_column_text(stmt, 3);
     if (CtConst::RICH_TEXT_ID != syntax) {
         rRetTextBuffer = _pCtMainWin->get_new_text_buffer(textContent);
     }
     else {
-        rRetTextBuffer = CtStorageXmlHelper{_pCtMainWin}.create_buffer_no_widgets(syntax, textContent);
+        rRetTextBuffer = textPrepared ? CtStorageXmlHelper{_pCtMainWin}.create_buffer_from_prepared(*pPrepared)
+                                      : CtStorageXmlHelper{_pCtMainWin}.create_buffer_no_widgets(syntax, textContent);
         if (not rRetTextBuffer) {
             spdlog::error("!! xml read: {}", textContent);
             return rRetTextBuffer;
         }
-        if (sqlite3_column_int64(stmt, 1)) _codebox_from_db(node_id, widgets);
-        if (sqlite3_column_int64(stmt, 2)) _table_from_db(node_id, widgets);
-        if (sqlite3_column_int64(stmt, 3)) _image_from_db(node_id, widgets);
+        if (sqlite3_column_int64(stmt, 0)) _codebox_from_db(node_id, widgets);
+        if (sqlite3_column_int64(stmt, 1)) _table_from_db(node_id, widgets);
+        if (sqlite3_column_int64(stmt, 2)) _image_from_db(node_id, widgets);
 
         widgets.sort([](const CtAnchoredWidget* w1, const CtAnchoredWidget* w2) { return w1->getOffset() < w2->getOffset(); });
         #if !GTK_SOURCE_CHECK_VERSION(5, 0, 0)
@@ -531,9 +732,30 @@ Glib::RefPtr<Gtk::TextBuffer> CtStorageSqlite::get_delayed_text_buffer(const gin
     return rRetTextBuffer;
 }
 
+bool CtStorageSqlite::get_delayed_text_raw(const gint64 node_id, std::string& rawXml, bool* pHasWidgets/*= nullptr*/) const
+{
+    Sqlite3StmtAuto stmt{_pDb, "SELECT txt, has_codebox, has_table, has_image FROM node WHERE node_id=?"};
+    if (stmt.is_bad()) {
+        spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, node_id);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
+    }
+    rawXml = safe_sqlite3_column_text(stmt, 0);
+    if (pHasWidgets) {
+        *pHasWidgets = sqlite3_column_int64(stmt, 1) or sqlite3_column_int64(stmt, 2) or sqlite3_column_int64(stmt, 3);
+    }
+    return true;
+}
+
 void CtStorageSqlite::_image_from_db(const gint64& nodeId, std::list<CtAnchoredWidget*>& anchoredWidgets) const
 {
-    Sqlite3StmtAuto stmt{_pDb, "SELECT * FROM image WHERE node_id=? ORDER BY offset ASC"};
+    // the same columns as SELECT * plus rowid and the size of the blob, so that large embedded
+    // files can be streamed out of the row instead of going through sqlite3_column_blob
+    Sqlite3StmtAuto stmt{_pDb, "SELECT node_id, offset, justification, anchor, png, filename, link, time, rowid, length(png)"
+                               " FROM image WHERE node_id=? ORDER BY offset ASC"};
     if (stmt.is_bad()) {
         spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
         return;
@@ -558,9 +780,22 @@ void CtStorageSqlite::_image_from_db(const gint64& nodeId, std::list<CtAnchoredW
         }
         else {
             fs::path fileName = safe_sqlite3_column_text(stmt, 5);
+            const bool isEmbFile = not fileName.empty() and fileName != CtImageLatex::LatexSpecialFilename;
+            const sqlite3_int64 blobSize = sqlite3_column_int64(stmt, 9);
+            if (isEmbFile and static_cast<size_t>(blobSize) >= CtEmbFileBlob::SPOOL_MIN_SIZE) {
+                const time_t timeSeconds = sqlite3_column_int64(stmt, 7);
+                anchoredWidgets.push_back(new CtImageEmbFile{_pCtMainWin,
+                                                             fileName,
+                                                             blob_read(_pDb, "image", "png", sqlite3_column_int64(stmt, 8)),
+                                                             timeSeconds,
+                                                             charOffset,
+                                                             justification,
+                                                             CtImageEmbFile::get_next_unique_id(),
+                                                             ""});
+                continue;
+            }
             const void* pBlob = sqlite3_column_blob(stmt, 4);
-            const int blobSize = sqlite3_column_bytes(stmt, 4);
-            const std::string rawBlob(reinterpret_cast<const char*>(pBlob), static_cast<size_t>(blobSize));
+            const std::string rawBlob(reinterpret_cast<const char*>(pBlob), static_cast<size_t>(sqlite3_column_bytes(stmt, 4)));
             if (not fileName.empty()) {
                 if (fileName == CtImageLatex::LatexSpecialFilename) {
                     anchoredWidgets.push_back(new CtImageLatex{_pCtMainWin,
@@ -573,7 +808,7 @@ void CtStorageSqlite::_image_from_db(const gint64& nodeId, std::list<CtAnchoredW
                     const time_t timeSeconds = sqlite3_column_int64(stmt, 7);
                     anchoredWidgets.push_back(new CtImageEmbFile{_pCtMainWin,
                                                                  fileName,
-                                                                 rawBlob,
+                                                                 CtEmbFileBlob::from_memory(rawBlob),
                                                                  timeSeconds,
                                                                  charOffset,
                                                                  justification,
@@ -670,6 +905,284 @@ void CtStorageSqlite::_create_all_tables_in_db()
     _exec_no_callback(TABLE_IMAGE_CREATE);
     _exec_no_callback(TABLE_CHILDREN_CREATE);
     _exec_no_callback(TABLE_BOOKMARK_CREATE);
+    _exec_no_callback(TABLE_NODE_LINKS_CREATE);
+    _exec_no_callback(TABLE_NODE_STATS_CREATE);
+}
+
+void CtStorageSqlite::_links_and_stats_from_db()
+{
+    std::unordered_map<gint64, CtLinkIndex::NodeData> nodesData;
+    // anchors and image links are always up to date in the image table
+    auto uStmt = std::make_unique<Sqlite3StmtAuto>(_pDb, "SELECT node_id, anchor, link FROM image WHERE anchor != '' OR link != ''");
+    if (uStmt->is_bad()) {
+        // an older version of the SQLite db didn't have link
+        uStmt.reset(new Sqlite3StmtAuto{_pDb, "SELECT node_id, anchor, '' FROM image WHERE anchor != ''"});
+        if (uStmt->is_bad()) {
+            throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+        }
+    }
+    while (sqlite3_step(*uStmt) == SQLITE_ROW) {
+        CtLinkIndex::NodeData& nodeData = nodesData[sqlite3_column_int64(*uStmt, 0)];
+        const std::string anchorName = safe_sqlite3_column_text(*uStmt, 1);
+        if (not anchorName.empty()) {
+            nodeData.anchors.insert(anchorName);
+        }
+        else {
+            CtLinkIndex::add_link_from_property(safe_sqlite3_column_text(*uStmt, 2), nodeData);
+        }
+    }
+
+    // the node links and stats saved by a version not maintaining the side tables are extracted from the node text
+    uStmt.reset(new Sqlite3StmtAuto{_pDb, "SELECT node.node_id, node.is_richtxt, node.ts_lastsave,"
+                                          " node.ts_lastsave = node_links.ts_lastsave, node_links.links,"
+                                          " node.ts_lastsave = node_stats.ts_lastsave, node_stats.stats"
+                                          " FROM node LEFT JOIN node_links ON node.node_id = node_links.node_id"
+                                          " LEFT JOIN node_stats ON node.node_id = node_stats.node_id"});
+    if (uStmt->is_bad()) {
+        // no side tables (or an older version of the SQLite db without ts_lastsave)
+        uStmt.reset(new Sqlite3StmtAuto{_pDb, "SELECT node_id, is_richtxt, 0, 0, NULL, 0, NULL FROM node"});
+        if (uStmt->is_bad()) {
+            throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+        }
+    }
+    CtTreeStore& ct_tree_store = _pCtMainWin->get_tree_store();
+    _staleNodes.clear();
+    while (sqlite3_step(*uStmt) == SQLITE_ROW) {
+        const gint64 node_id = sqlite3_column_int64(*uStmt, 0);
+        const bool isRichText = sqlite3_column_int64(*uStmt, 1) & 0x01;
+        CtLinkIndex::NodeData& nodeData = nodesData[node_id];
+        bool staleLinks{false};
+        if (isRichText) {
+            if (sqlite3_column_int64(*uStmt, 3)) {
+                for (const std::string& link : str::split(std::string{safe_sqlite3_column_text(*uStmt, 4)}, "\n")) {
+                    CtLinkIndex::add_link_from_property(link, nodeData);
+                }
+            }
+            else {
+                staleLinks = true;
+            }
+        }
+        CtNodeStats nodeStats;
+        const bool staleStats = not sqlite3_column_int64(*uStmt, 5) or not CtNodeStats::from_string(safe_sqlite3_column_text(*uStmt, 6), nodeStats);
+        if (not staleStats) {
+            ct_tree_store.node_stats_set(node_id, nodeStats);
+        }
+        if (staleLinks or staleStats) {
+            // the anchors are known already, the rest follows once extracted from the text
+            StaleNode& staleNode = _staleNodes.emplace_back();
+            staleNode.nodeId = node_id;
+            staleNode.tsLastSave = sqlite3_column_int64(*uStmt, 2);
+            staleNode.isRichText = isRichText;
+            staleNode.staleLinks = staleLinks;
+            staleNode.staleStats = staleStats;
+            staleNode.linkIndexNodeData = nodeData;
+        }
+    }
+    for (auto& [node_id, nodeData] : nodesData) {
+        ct_tree_store.link_index_set_node(node_id, std::move(nodeData));
+    }
+}
+
+void CtStorageSqlite::_stale_nodes_start()
+{
+    if (_staleNodes.empty()) {
+        return;
+    }
+    // the text is read and parsed off the main thread, from a read transaction of its own
+    std::shared_ptr<CtSqliteSnapshot> pSnapshot = CtSqliteSnapshot::create(_file_path);
+    if (not pSnapshot) {
+        // not in write ahead log mode, a reader would block the writer
+        _stale_nodes_extract(_pDb);
+        _stale_nodes_merge();
+        return;
+    }
+    if (not _pDispatcherStaleNodesDone) {
+        _pDispatcherStaleNodesDone = std::make_unique<Glib::Dispatcher>();
+        _pDispatcherStaleNodesDone->connect(sigc::mem_fun(*this, &CtStorageSqlite::_on_dispatcher_stale_nodes_done));
+    }
+    _staleNodesCancel = false;
+    _pThreadStaleNodes = std::make_unique<std::thread>([this, pSnapshot](){
+        _stale_nodes_extract(pSnapshot->get_db());
+        _pDispatcherStaleNodesDone->emit();
+    });
+}
+
+void CtStorageSqlite::_stale_nodes_extract(sqlite3* pDb)
+{
+    try {
+        Sqlite3StmtAuto stmtTxt{pDb, "SELECT txt FROM node WHERE node_id=?"};
+        if (stmtTxt.is_bad()) {
+            throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(pDb));
+        }
+        // one read and one parse of the text for both the links and the stats
+        std::unordered_map<gint64, CtNodeStats> staleNodesStats;
+        for (StaleNode& staleNode : _staleNodes) {
+            if (_staleNodesCancel) {
+                return;
+            }
+            sqlite3_bind_int64(stmtTxt, 1, staleNode.nodeId);
+            if (sqlite3_step(stmtTxt) == SQLITE_ROW) {
+                const char* txt = safe_sqlite3_column_text(stmtTxt, 0);
+                if (staleNode.isRichText) {
+                    xmlpp::DomParser parser;
+                    if (CtXmlHelper::safe_parse_memory(parser, txt)) {
+                        const xmlpp::Element* pRootElement = parser.get_document()->get_root_node();
+                        if (staleNode.staleLinks) {
+                            CtLinkIndex::NodeData nodeDataTxt;
+                            CtStorageXmlHelper::link_index_node_from_xml(pRootElement, nodeDataTxt);
+                            for (const CtLinkIndex::Target& target : nodeDataTxt.links) {
+                                staleNode.links.push_back(CtLinkIndex::to_link_property(target));
+                                CtLinkIndex::add_link_from_property(staleNode.links.back(), staleNode.linkIndexNodeData);
+                            }
+                        }
+                        if (staleNode.staleStats) {
+                            CtStorageXmlHelper::node_stats_from_xml(pRootElement, staleNode.nodeStats, ""/*multifile_dir*/);
+                        }
+                        staleNode.ok = true;
+                    }
+                }
+                else {
+                    const Glib::ustring text{txt};
+                    staleNode.nodeStats.chars = text.size();
+                    staleNode.nodeStats.words = static_cast<size_t>(CtTextIterUtil::get_words_count(text));
+                    staleNode.ok = true;
+                }
+                if (staleNode.ok and staleNode.staleStats) {
+                    staleNodesStats[staleNode.nodeId] = staleNode.nodeStats;
+                }
+            }
+            sqlite3_reset(stmtTxt);
+        }
+        if (not staleNodesStats.empty()) {
+            // the widgets are in their own tables, counted in one pass
+            _node_stats_widgets_from_db(pDb, staleNodesStats);
+            for (StaleNode& staleNode : _staleNodes) {
+                const auto it = staleNodesStats.find(staleNode.nodeId);
+                if (staleNodesStats.end() != it) {
+                    staleNode.nodeStats = it->second;
+                }
+            }
+        }
+    }
+    catch (std::exception& e) {
+        spdlog::error("!! {} {}", __FUNCTION__, e.what());
+        for (StaleNode& staleNode : _staleNodes) {
+            staleNode.ok = false;
+        }
+    }
+}
+
+void CtStorageSqlite::_on_dispatcher_stale_nodes_done()
+{
+    if (_pThreadStaleNodes) {
+        _pThreadStaleNodes->join();
+        _pThreadStaleNodes.reset();
+    }
+    _stale_nodes_merge();
+}
+
+void CtStorageSqlite::_stale_nodes_merge()
+{
+    CtTreeStore& ct_tree_store = _pCtMainWin->get_tree_store();
+    size_t numMerged{0};
+    for (StaleNode& staleNode : _staleNodes) {
+        if (not staleNode.ok) {
+            continue;
+        }
+        CtTreeIter ctTreeIter = ct_tree_store.get_node_from_node_id(staleNode.nodeId);
+        if (not ctTreeIter) {
+            // removed meanwhile
+            continue;
+        }
+        if (ctTreeIter.get_node_buffer_already_loaded()) {
+            // the buffer, possibly edited meanwhile, is the reference
+            if (staleNode.staleLinks) {
+                ct_tree_store.link_index_set_dirty(staleNode.nodeId);
+            }
+            continue;
+        }
+        if (staleNode.staleLinks) {
+            ct_tree_store.link_index_set_node(staleNode.nodeId, std::move(staleNode.linkIndexNodeData));
+            _nodeLinksToWrite[staleNode.nodeId] = std::make_pair(staleNode.tsLastSave, str::join(staleNode.links, "\n"));
+        }
+        if (staleNode.staleStats) {
+            ct_tree_store.node_stats_set(staleNode.nodeId, staleNode.nodeStats);
+            _nodeStatsToWrite[staleNode.nodeId] = std::make_pair(staleNode.tsLastSave, staleNode.nodeStats.to_string());
+        }
+        ++numMerged;
+    }
+    spdlog::debug("{} node links and stats extracted from {}/{} nodes", __FUNCTION__, numMerged, _staleNodes.size());
+    _staleNodes.clear();
+}
+
+void CtStorageSqlite::_write_node_links_to_db(const gint64 node_id, const gint64 ts_lastsave, const std::string& links)
+{
+    Sqlite3StmtAuto stmt{_pDb, TABLE_NODE_LINKS_INSERT};
+    if (stmt.is_bad()) {
+        throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+    }
+    sqlite3_bind_int64(stmt, 1, node_id);
+    sqlite3_bind_int64(stmt, 2, ts_lastsave);
+    sqlite3_bind_text(stmt, 3, links.c_str(), links.size(), SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
+    }
+}
+
+/*static*/void CtStorageSqlite::_node_stats_widgets_from_db(sqlite3* pDb, std::unordered_map<gint64, CtNodeStats>& nodesStats)
+{
+    // a single node is looked up, many nodes in one pass on the widgets tables
+    const bool singleNode = 1u == nodesStats.size();
+    auto f_stats_step = [&](const char* sqlCmd, const std::function<void(sqlite3_stmt*, CtNodeStats&)>& f_add) {
+        Sqlite3StmtAuto stmt{pDb, singleNode ? fmt::format("{} WHERE node_id=?", sqlCmd).c_str() : sqlCmd};
+        if (stmt.is_bad()) {
+            throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(pDb));
+        }
+        if (singleNode) {
+            sqlite3_bind_int64(stmt, 1, nodesStats.begin()->first);
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const auto it = nodesStats.find(sqlite3_column_int64(stmt, 0));
+            if (nodesStats.end() != it) {
+                f_add(stmt, it->second);
+            }
+        }
+    };
+    // length() doesn't read the blob content
+    f_stats_step("SELECT node_id, anchor, filename, length(png) FROM image", [](sqlite3_stmt* stmt, CtNodeStats& nodeStats){
+        const std::string fileName = safe_sqlite3_column_text(stmt, 2);
+        if (safe_sqlite3_column_text(stmt, 1)[0] != '\0') {
+            nodeStats.add_widget(CtAnchWidgType::ImageAnchor);
+        }
+        else if (fileName == CtImageLatex::LatexSpecialFilename) {
+            nodeStats.add_widget(CtAnchWidgType::ImageLatex);
+        }
+        else {
+            nodeStats.add_widget(fileName.empty() ? CtAnchWidgType::ImagePng : CtAnchWidgType::ImageEmbFile,
+                                 static_cast<size_t>(sqlite3_column_int64(stmt, 3)));
+        }
+    });
+    // is_light is an attribute of the table root element
+    f_stats_step("SELECT node_id, instr(substr(txt, 1, 1024), 'is_light=\"1\"') FROM grid", [](sqlite3_stmt* stmt, CtNodeStats& nodeStats){
+        nodeStats.add_widget(sqlite3_column_int64(stmt, 1) > 0 ? CtAnchWidgType::TableLight : CtAnchWidgType::TableHeavy);
+    });
+    f_stats_step("SELECT node_id FROM codebox", [](sqlite3_stmt*, CtNodeStats& nodeStats){
+        nodeStats.add_widget(CtAnchWidgType::CodeBox);
+    });
+}
+
+void CtStorageSqlite::_write_node_stats_to_db(const gint64 node_id, const gint64 ts_lastsave, const std::string& stats)
+{
+    Sqlite3StmtAuto stmt{_pDb, TABLE_NODE_STATS_INSERT};
+    if (stmt.is_bad()) {
+        throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+    }
+    sqlite3_bind_int64(stmt, 1, node_id);
+    sqlite3_bind_int64(stmt, 2, ts_lastsave);
+    sqlite3_bind_text(stmt, 3, stats.c_str(), stats.size(), SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
+    }
 }
 
 void CtStorageSqlite::_write_bookmarks_to_db(const std::list<gint64>& bookmarks)
@@ -815,20 +1328,30 @@ void CtStorageSqlite::_write_node_to_db(const CtTreeIter* ct_tree_iter,
     else if (node_state.buff) {
         // get buffer content
         std::string node_txt;
+        std::vector<std::string> node_links;
+        CtNodeStats nodeStats;
         if (is_richtxt & 0x01) {
             xmlpp::Document xml_doc;
             xml_doc.create_root_node("node");
             CtStorageXmlHelper{_pCtMainWin}.save_buffer_no_widgets_to_xml(xml_doc.get_root_node(),
                 ct_tree_iter->get_node_text_buffer(), start_offset, end_offset, 'n');
             node_txt = xml_doc.write_to_string();
+            CtLinkIndex::NodeData nodeData;
+            CtStorageXmlHelper::link_index_node_from_xml(xml_doc.get_root_node(), nodeData);
+            for (const CtLinkIndex::Target& target : nodeData.links) {
+                node_links.push_back(CtLinkIndex::to_link_property(target));
+            }
+            CtStorageXmlHelper::node_stats_from_xml(xml_doc.get_root_node(), nodeStats, ""/*multifile_dir*/);
         }
         else {
+            // the text of the huge plain text nodes (logs, dumps) is only copied once, straight to the bound string
             const auto text_buffer = ct_tree_iter->get_node_text_buffer();
             if (end_offset < 0) {
-                node_txt = text_buffer->get_text();
+                CtTextIterUtil::get_text_by_chunks(text_buffer->begin(), text_buffer->end(), node_txt, nodeStats.chars, nodeStats.words);
             }
             else {
-                node_txt = text_buffer->get_iter_at_offset(start_offset).get_text(text_buffer->get_iter_at_offset(end_offset));
+                CtTextIterUtil::get_text_by_chunks(text_buffer->get_iter_at_offset(start_offset), text_buffer->get_iter_at_offset(end_offset),
+                                                   node_txt, nodeStats.chars, nodeStats.words);
             }
         }
 
@@ -880,6 +1403,19 @@ void CtStorageSqlite::_write_node_to_db(const CtTreeIter* ct_tree_iter,
                 throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
             }
         }
+        _write_node_links_to_db(node_id, ct_tree_iter->get_node_modification_time(), str::join(node_links, "\n"));
+        _nodeLinksToWrite.erase(node_id);
+        if (has_codebox or has_table or has_image) {
+            // the widgets just written, with the size of their blobs
+            std::unordered_map<gint64, CtNodeStats> nodesStats{{node_id, nodeStats}};
+            _node_stats_widgets_from_db(_pDb, nodesStats);
+            nodeStats = nodesStats.at(node_id);
+        }
+        _write_node_stats_to_db(node_id, ct_tree_iter->get_node_modification_time(), nodeStats.to_string());
+        _nodeStatsToWrite.erase(node_id);
+        if (CtExporting::NONESAVEAS == export_type) {
+            _pCtMainWin->get_tree_store().node_stats_set(node_id, nodeStats);
+        }
     }
 }
 
@@ -908,6 +1444,10 @@ void CtStorageSqlite::_remove_db_node_with_children(const gint64 node_id)
     _exec_bind_int64(TABLE_IMAGE_DELETE, node_id);
     _exec_bind_int64(TABLE_NODE_DELETE, node_id);
     _exec_bind_int64(TABLE_CHILDREN_DELETE, node_id);
+    _exec_bind_int64(TABLE_NODE_LINKS_DELETE, node_id);
+    _nodeLinksToWrite.erase(node_id);
+    _exec_bind_int64(TABLE_NODE_STATS_DELETE, node_id);
+    _nodeStatsToWrite.erase(node_id);
 
     for (const std::pair<gint64,gint64>& child_id_pair : _get_children_node_ids_from_db(node_id)) {
         _remove_db_node_with_children(child_id_pair.first);
@@ -1027,3 +1567,50 @@ const char* CtStorageSqlite::safe_sqlite3_column_text(sqlite3_stmt* stmt, int iC
     const char* pStr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, iCol));
     return pStr ? pStr : "";
 }
+
+/*static*/bool CtStorageSqlite::blob_write_from(sqlite3* pDb, const char* table, const char* column, const sqlite3_int64 rowid, const CtEmbFileBlob& blob)
+{
+    sqlite3_blob* pSqliteBlob{nullptr};
+    if (SQLITE_OK != sqlite3_blob_open(pDb, "main", table, column, rowid, 1/*read-write*/, &pSqliteBlob)) {
+        spdlog::error("{} sqlite3_blob_open: {}", __FUNCTION__, sqlite3_errmsg(pDb));
+        sqlite3_blob_close(pSqliteBlob);
+        return false;
+    }
+    int blobOffset{0};
+    const bool retVal = blob.read_chunks([&](const char* pData, const size_t dataSize){
+        if (SQLITE_OK != sqlite3_blob_write(pSqliteBlob, pData, static_cast<int>(dataSize), blobOffset)) {
+            spdlog::error("{} sqlite3_blob_write: {}", __FUNCTION__, sqlite3_errmsg(pDb));
+            return false;
+        }
+        blobOffset += static_cast<int>(dataSize);
+        return true;
+    });
+    sqlite3_blob_close(pSqliteBlob);
+    return retVal;
+}
+
+/*static*/CtEmbFileBlobPtr CtStorageSqlite::blob_read(sqlite3* pDb, const char* table, const char* column, const sqlite3_int64 rowid)
+{
+    sqlite3_blob* pSqliteBlob{nullptr};
+    if (SQLITE_OK != sqlite3_blob_open(pDb, "main", table, column, rowid, 0/*read-only*/, &pSqliteBlob)) {
+        spdlog::error("{} sqlite3_blob_open: {}", __FUNCTION__, sqlite3_errmsg(pDb));
+        sqlite3_blob_close(pSqliteBlob);
+        return nullptr;
+    }
+    const int blobSize = sqlite3_blob_bytes(pSqliteBlob);
+    CtEmbFileBlob::Writer writer{static_cast<size_t>(blobSize)};
+    std::vector<char> chunk(CtEmbFileBlob::CHUNK_SIZE);
+    bool readOk{true};
+    for (int blobOffset = 0; readOk and blobOffset < blobSize; blobOffset += static_cast<int>(chunk.size())) {
+        const int readSize = std::min(static_cast<int>(chunk.size()), blobSize - blobOffset);
+        if (SQLITE_OK != sqlite3_blob_read(pSqliteBlob, chunk.data(), readSize, blobOffset)) {
+            spdlog::error("{} sqlite3_blob_read: {}", __FUNCTION__, sqlite3_errmsg(pDb));
+            readOk = false;
+        }
+        else {
+            readOk = writer.append(chunk.data(), static_cast<size_t>(readSize));
+        }
+    }
+    sqlite3_blob_close(pSqliteBlob);
+    return readOk ? writer.finish() : nullptr;
+}
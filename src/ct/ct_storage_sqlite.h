@@ -26,16 +26,23 @@
 #include "ct_types.h"
 #include "ct_widgets.h"
 #include "ct_filesystem.h"
+#include "ct_misc_utils.h"
 #include <sqlite3.h>
 #include <glibmm/refptr.h>
 #include <gtkmm/textbuffer.h>
 #include <gtkmm/treeiter.h>
+#include <glibmm/dispatcher.h>
+#include <unordered_map>
 #include <unordered_set>
+#include <atomic>
+#include <thread>
 
 class CtMainWin;
 class CtAnchoredWidget;
 class CtTreeIter;
 class CtStorageCache;
+class CtEmbFileBlob;
+class CtSqliteSnapshot;
 
 class CtStorageSqlite : public CtStorageEntity
 {
@@ -63,12 +70,19 @@ public:
 
     Glib::RefPtr<Gtk::TextBuffer> get_delayed_text_buffer(const gint64 node_id,
                                                           const std::string& syntax,
-                                                          std::list<CtAnchoredWidget*>& widgets) const override;
+                                                          std::list<CtAnchoredWidget*>& widgets,
+                                                          const CtPreparedRichText* pPrepared) const override;
+    bool get_delayed_text_raw(const gint64 node_id, std::string& rawXml, bool* pHasWidgets = nullptr) const override;
 
     fs::path get_embedded_filepath(const CtTreeIter&/*ct_tree_iter*/, const std::string&/*filename*/) const override { return ""; }
 
+    // the buffers are always read from the database, nothing is kept aside
+    bool restore_delayed_text_buffer(const CtTreeIter&/*ct_tree_iter*/) override { return true; }
+    void memory_usage_populate(CtMemoryUsage&/*memoryUsage*/) const override {}
+
 private:
     void _open_db(const fs::path& path);
+    void _set_wal_mode();
     void _close_db();
     bool _check_database_integrity();
 
@@ -97,6 +111,17 @@ private:
     void                _table_from_db(const gint64& nodeId, std::list<CtAnchoredWidget*>& anchoredWidgets) const;
 
     void                _create_all_tables_in_db();
+    // from the side tables and the image anchors, the stale nodes are left to _stale_nodes_start()
+    void                _links_and_stats_from_db();
+    // the nodes with a stale node links or node stats row are extracted from their text by a worker, on a snapshot of the database
+    void                _stale_nodes_start();
+    void                _stale_nodes_extract(sqlite3* pDb);
+    void                _on_dispatcher_stale_nodes_done();
+    void                _stale_nodes_merge();
+    void                _write_node_links_to_db(const gint64 node_id, const gint64 ts_lastsave, const std::string& links);
+    // adds the anchored widgets counters to the nodes in nodesStats
+    static void         _node_stats_widgets_from_db(sqlite3* pDb, std::unordered_map<gint64, CtNodeStats>& nodesStats);
+    void                _write_node_stats_to_db(const gint64 node_id, const gint64 ts_lastsave, const std::string& stats);
     void                _write_bookmarks_to_db(const std::list<gint64>& bookmarks);
     void                _write_node_to_db(const CtTreeIter* ct_tree_iter,
                                           const gint64 sequence,
@@ -133,12 +158,78 @@ public:
     static const char TABLE_BOOKMARK_CREATE[];
     static const char TABLE_BOOKMARK_INSERT[];
     static const char TABLE_BOOKMARK_DELETE[];
+    static const char TABLE_NODE_LINKS_CREATE[];
+    static const char TABLE_NODE_LINKS_INSERT[];
+    static const char TABLE_NODE_LINKS_DELETE[];
+    static const char TABLE_NODE_STATS_CREATE[];
+    static const char TABLE_NODE_STATS_INSERT[];
+    static const char TABLE_NODE_STATS_DELETE[];
     static const std::string ERR_SQLITE_PREPV2;
     static const std::string ERR_SQLITE_STEP;
     static const char* safe_sqlite3_column_text(sqlite3_stmt* stmt, int iCol);
+    // incremental blob I/O, for writing the row blob must already be sized (zeroblob) to the content
+    static bool blob_write_from(sqlite3* pDb, const char* table, const char* column, const sqlite3_int64 rowid, const CtEmbFileBlob& blob);
+    static std::shared_ptr<const CtEmbFileBlob> blob_read(sqlite3* pDb, const char* table, const char* column, const sqlite3_int64 rowid);
 
 private:
     CtMainWin*    _pCtMainWin;
     sqlite3*      _pDb{nullptr};
     fs::path      _file_path;
+    bool          _walMode{false};
+    std::string   _journalModeToRestore; // the journal mode of the file before the switch to write ahead log
+    bool          _sideTablesChecked{false};
+    // node links and stats extracted at load from nodes saved by versions not maintaining the side tables
+    std::unordered_map<gint64, std::pair<gint64, std::string>> _nodeLinksToWrite; // node id -> ts_lastsave, links
+    std::unordered_map<gint64, std::pair<gint64, std::string>> _nodeStatsToWrite; // node id -> ts_lastsave, stats
+
+    struct StaleNode
+    {
+        gint64                   nodeId{0};
+        gint64                   tsLastSave{0};
+        bool                     isRichText{false};
+        bool                     staleLinks{false};
+        bool                     staleStats{false};
+        CtLinkIndex::NodeData    linkIndexNodeData; // the anchors from the image table, the links added by the worker
+        std::vector<std::string> links;
+        CtNodeStats              nodeStats;
+        bool                     ok{false};
+    };
+    std::vector<StaleNode>            _staleNodes; // only touched by the worker until it is done
+    std::atomic<bool>                 _staleNodesCancel{false};
+    std::unique_ptr<Glib::Dispatcher> _pDispatcherStaleNodesDone;
+    std::unique_ptr<std::thread>      _pThreadStaleNodes;
+};
+
+/**
+ * @brief Read only connection holding a read transaction on a document in write ahead log mode
+ * The content of the database at the time of creation is preserved while the main connection
+ * keeps writing, so that it can be backed up online from a worker thread
+ */
+class CtSqliteSnapshot
+{
+public:
+    /**
+     * @brief Open a snapshot of the database
+     * @return nullptr if the database is not in write ahead log mode (a reader would block the writer)
+     */
+    static std::shared_ptr<CtSqliteSnapshot> create(const fs::path& db_path);
+    /**
+     * @brief Passive checkpoint of the write ahead log into the database file, does not block readers or writers
+     */
+    static bool wal_checkpoint_passive(const fs::path& db_path);
+
+    ~CtSqliteSnapshot();
+
+    /**
+     * @brief Copy the snapshot into a new standalone database file with the online backup API
+     */
+    bool backup_to(const fs::path& dest_path);
+
+    // to be used by a single thread
+    sqlite3* get_db() const { return _pDb; }
+
+private:
+    CtSqliteSnapshot() = default;
+
+    sqlite3* _pDb{nullptr};
 };
@@ -233,7 +233,8 @@ void CtStorageXml::import_nodes(const fs::path& filepath, const Gtk::TreeModel::
 
 Glib::RefPtr<Gtk::TextBuffer> CtStorageXml::get_delayed_text_buffer(const gint64 node_id,
                                                                     const std::string& syntax,
-                                                                    std::list<CtAnchoredWidget*>& widgets) const
+                                                                    std::list<CtAnchoredWidget*>& widgets,
+                                                                    const CtPreparedRichText*/*pPrepared*/) const
 {
     if (_delayed_text_buffers.count(node_id) == 0) {
         spdlog::error("!! {} node_id {}", __FUNCTION__, node_id);
@@ -248,6 +249,27 @@ Glib::RefPtr<Gtk::TextBuffer> CtStorageXml::get_delayed_text_buffer(const gint64
     return ret_buffer;
 }
 
+bool CtStorageXml::restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter)
+{
+    // the single file is not read again, the node is serialized the same way as at save
+    auto node_buffer = std::make_shared<xmlpp::Document>();
+    CtStorageXmlHelper{_pCtMainWin}.node_to_xml(&ct_tree_iter,
+                                                node_buffer->create_root_node("root"),
+                                                ""/*multifile_dir*/,
+                                                nullptr/*storage_cache*/,
+                                                CtExporting::NONESAVE);
+    _delayed_text_buffers[ct_tree_iter.get_node_id_data_holder()] = node_buffer;
+    return true;
+}
+
+void CtStorageXml::memory_usage_populate(CtMemoryUsage& memoryUsage) const
+{
+    for (const auto& [nodeId, node_buffer] : _delayed_text_buffers) {
+        memoryUsage.add(nodeId, CtMemoryUsage::Category::DelayedXml,
+                        CtStorageXmlHelper::estimate_node_xml_bytes(node_buffer->get_root_node()));
+    }
+}
+
 void CtStorageXml::_nodes_to_xml(CtTreeIter* ct_tree_iter,
                                  xmlpp::Element* p_node_parent,
                                  CtStorageCache* storage_cache,
@@ -393,6 +415,13 @@ xmlpp::Element* CtStorageXmlHelper::node_to_xml(const CtTreeIter* ct_tree_iter,
         for (CtAnchoredWidget* pAnchoredWidget : ct_tree_iter->get_anchored_widgets(start_offset, end_offset)) {
             pAnchoredWidget->to_xml(p_node_node, start_offset > 0 ? -start_offset : 0, storage_cache, multifile_dir);
         }
+
+        CtNodeStats nodeStats;
+        node_stats_from_xml(p_node_node, nodeStats, multifile_dir);
+        p_node_node->set_attribute("stats", nodeStats.to_string());
+        if (CtExporting::NONESAVEAS == export_type) {
+            _pCtMainWin->get_tree_store().node_stats_set(my_node_id, nodeStats);
+        }
     }
     return p_node_node;
 }
@@ -442,10 +471,12 @@ Gtk::TreeModel::iterator CtStorageXmlHelper::node_from_xml(const xmlpp::Element*
         return Gtk::TreeModel::iterator{};
     }
 
+    bool hasDuplicatedId{false};
     if (-1 == new_id) {
         // use the id found in the xml
         if (delayed_text_buffers.count(node_data.nodeId) != 0) {
             spdlog::debug("node has duplicated id {}, will be fixed", node_data.nodeId);
+            hasDuplicatedId = true;
             if (pHasDuplicatedId) *pHasDuplicatedId = true;
             // create buffer now because we cannot put a duplicate id in _delayed_text_buffers
             // the id will be fixed on top level code
@@ -464,7 +495,147 @@ Gtk::TreeModel::iterator CtStorageXmlHelper::node_from_xml(const xmlpp::Element*
         // create buffer now because imported document will be closed
         node_data.pTextBuffer = create_buffer_and_widgets_from_xml(xml_element, node_data.syntax, node_data.anchoredWidgets, nullptr, -1, multifile_dir);
     }
-    return _pCtMainWin->get_tree_store().append_node(&node_data, &parent_iter);
+    Gtk::TreeModel::iterator new_iter = _pCtMainWin->get_tree_store().append_node(&node_data, &parent_iter);
+    // the entries of a duplicated id stay the ones of the first node, the other gets them from its buffer once its id is fixed
+    if (node_data.sharedNodesMasterId <= 0 and not hasDuplicatedId) {
+        CtLinkIndex::NodeData linkIndexNodeData;
+        link_index_node_from_xml(xml_element, linkIndexNodeData);
+        _pCtMainWin->get_tree_store().link_index_set_node(node_data.nodeId, std::move(linkIndexNodeData));
+        // the counters saved by a version not writing them are computed from the xml
+        CtNodeStats nodeStats;
+        if (not CtNodeStats::from_string(xml_element->get_attribute_value("stats"), nodeStats)) {
+            node_stats_from_xml(xml_element, nodeStats, multifile_dir);
+        }
+        _pCtMainWin->get_tree_store().node_stats_set(node_data.nodeId, nodeStats);
+    }
+    return new_iter;
+}
+
+/*static*/void CtStorageXmlHelper::link_index_node_from_xml(const xmlpp::Element* parent_xml_element, CtLinkIndex::NodeData& nodeData)
+{
+    for (const xmlpp::Node* xml_slot : parent_xml_element->get_children()) {
+        auto slot_element = dynamic_cast<const xmlpp::Element*>(xml_slot);
+        if (not slot_element) {
+            continue;
+        }
+        const Glib::ustring slot_element_name = slot_element->get_name();
+        if (slot_element_name == "rich_text" or slot_element_name == "encoded_png") {
+            const Glib::ustring link = slot_element->get_attribute_value(CtConst::TAG_LINK);
+            if (not link.empty()) {
+                CtLinkIndex::add_link_from_property(link.raw(), nodeData);
+            }
+            if (slot_element_name == "encoded_png") {
+                const Glib::ustring anchorName = slot_element->get_attribute_value("anchor");
+                if (not anchorName.empty()) {
+                    nodeData.anchors.insert(anchorName.raw());
+                }
+            }
+        }
+    }
+}
+
+/*static*/bool CtStorageXmlHelper::link_index_node_from_xml(const char* xml_content, CtLinkIndex::NodeData& nodeData)
+{
+    xmlpp::DomParser parser;
+    if (not CtXmlHelper::safe_parse_memory(parser, xml_content)) {
+        return false;
+    }
+    link_index_node_from_xml(parser.get_document()->get_root_node(), nodeData);
+    return true;
+}
+
+/*static*/void CtStorageXmlHelper::node_stats_from_xml(const xmlpp::Element* parent_xml_element,
+                                                      CtNodeStats& nodeStats,
+                                                      const std::string& multifile_dir)
+{
+    auto f_blob_bytes = [&multifile_dir](const xmlpp::Element* slot_element, const std::string& file_name)->size_t{
+        if (multifile_dir.empty()) {
+            // base64 in the element text
+            const xmlpp::TextNode* pTextNode = slot_element->get_child_text();
+            if (not pTextNode) {
+                return 0u;
+            }
+            const std::string encodedBlob = pTextNode->get_content();
+            size_t numEncoded{0u};
+            size_t numPadding{0u};
+            for (const char c : encodedBlob) {
+                if ('=' == c) ++numPadding;
+                else if (not g_ascii_isspace(c)) ++numEncoded;
+            }
+            const size_t numBytes = (numEncoded + numPadding)/4*3;
+            return numBytes > numPadding ? numBytes - numPadding : 0u;
+        }
+        const std::string sha256sum = slot_element->get_attribute_value("sha256sum");
+        const fs::path blobFilepath = sha256sum.empty() ? fs::path{multifile_dir} / file_name
+                                                        : CtStorageMultiFile::get_blob_filepath(multifile_dir, sha256sum);
+        return not blobFilepath.empty() and fs::is_regular_file(blobFilepath) ? fs::file_size(blobFilepath) : 0u;
+    };
+    Glib::ustring text;
+    for (const xmlpp::Node* xml_slot : parent_xml_element->get_children()) {
+        auto slot_element = dynamic_cast<const xmlpp::Element*>(xml_slot);
+        if (not slot_element) {
+            continue;
+        }
+        const Glib::ustring slot_element_name = slot_element->get_name();
+        if (slot_element_name == "rich_text") {
+            if (const xmlpp::TextNode* pTextNode = slot_element->get_child_text()) {
+                text += pTextNode->get_content();
+            }
+        }
+        else if (slot_element_name == "encoded_png") {
+            const std::string file_name = slot_element->get_attribute_value("filename");
+            if (not slot_element->get_attribute_value("anchor").empty()) {
+                nodeStats.add_widget(CtAnchWidgType::ImageAnchor);
+            }
+            else if (file_name == CtImageLatex::LatexSpecialFilename) {
+                nodeStats.add_widget(CtAnchWidgType::ImageLatex);
+            }
+            else {
+                nodeStats.add_widget(file_name.empty() ? CtAnchWidgType::ImagePng : CtAnchWidgType::ImageEmbFile,
+                                     f_blob_bytes(slot_element, file_name));
+            }
+        }
+        else if (slot_element_name == "table") {
+            nodeStats.add_widget(CtStrUtil::is_str_true(slot_element->get_attribute_value("is_light")) ?
+                                 CtAnchWidgType::TableLight : CtAnchWidgType::TableHeavy);
+        }
+        else if (slot_element_name == "codebox") {
+            nodeStats.add_widget(CtAnchWidgType::CodeBox);
+        }
+    }
+    nodeStats.chars = text.size();
+    nodeStats.words = static_cast<size_t>(CtTextIterUtil::get_words_count(text));
+}
+
+/*static*/bool CtStorageXmlHelper::node_stats_from_xml(const char* xml_content, CtNodeStats& nodeStats)
+{
+    xmlpp::DomParser parser;
+    if (not CtXmlHelper::safe_parse_memory(parser, xml_content)) {
+        return false;
+    }
+    node_stats_from_xml(parser.get_document()->get_root_node(), nodeStats, ""/*multifile_dir*/);
+    return true;
+}
+
+/*static*/size_t CtStorageXmlHelper::estimate_node_xml_bytes(const xmlpp::Node* xml_node)
+{
+    // xmlNode struct plus name, then content and attributes
+    constexpr size_t xmlNodeOverhead{120u};
+    size_t bytes = xmlNodeOverhead + xml_node->get_name().bytes();
+    if (auto pContentNode = dynamic_cast<const xmlpp::ContentNode*>(xml_node)) {
+        bytes += pContentNode->get_content().bytes();
+    }
+    else if (auto pElement = dynamic_cast<const xmlpp::Element*>(xml_node)) {
+        for (const xmlpp::Attribute* pAttribute : pElement->get_attributes()) {
+            bytes += xmlNodeOverhead + pAttribute->get_name().bytes() + pAttribute->get_value().bytes();
+        }
+    }
+    for (const xmlpp::Node* pChild : xml_node->get_children()) {
+        if (pChild->get_name() != "node") {
+            bytes += estimate_node_xml_bytes(pChild);
+        }
+    }
+    return bytes;
 }
 
 Glib::RefPtr<Gtk::TextBuffer> CtStorageXmlHelper::create_buffer_and_widgets_from_xml(const xmlpp::Element* parent_xml_element,
@@ -622,23 +793,83 @@ void CtStorageXmlHelper::save_buffer_no_widgets_to_xml(xmlpp::Element* p_node_pa
     CtTextIterUtil::generic_process_slot(_pCtMainWin->get_ct_config(), start_offset, end_offset, rBuffer, rich_txt_serialize);
 }
 
+/*static*/bool CtStorageXmlHelper::prepare_rich_text(const std::string& xml_content, CtPreparedRichText& preparedRichText)
+{
+    xmlpp::DomParser parser;
+    if (not CtXmlHelper::safe_parse_memory(parser, xml_content)) {
+        return false;
+    }
+    for (xmlpp::Node* xml_slot : parser.get_document()->get_root_node()->get_children("rich_text")) {
+        auto slot_element = static_cast<xmlpp::Element*>(xml_slot);
+        xmlpp::TextNode* text_node = slot_element->get_child_text();
+        if (not text_node) continue;
+        CtPreparedRichText::Slot slot;
+        slot.text = text_node->get_content();
+        if (slot.text.empty()) continue;
+        for (const xmlpp::Attribute* pAttribute : slot_element->get_attributes()) {
+            if (CtStrUtil::contains(CtConst::TAG_PROPERTIES, pAttribute->get_name().c_str())) {
+                slot.attributes.push_back(std::make_pair(pAttribute->get_name().raw(), pAttribute->get_value().raw()));
+            }
+        }
+        preparedRichText.slots.push_back(std::move(slot));
+    }
+    return true;
+}
+
+Glib::RefPtr<Gtk::TextBuffer> CtStorageXmlHelper::create_buffer_from_prepared(const CtPreparedRichText& preparedRichText)
+{
+    Glib::RefPtr<Gtk::TextBuffer> pBuffer = _pCtMainWin->get_new_text_buffer();
+    #if !GTK_SOURCE_CHECK_VERSION(5, 0, 0)
+    auto pGtkSourceBuffer = GTK_SOURCE_BUFFER(pBuffer->gobj());
+    #endif
+    CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(pGtkSourceBuffer);
+    for (const CtPreparedRichText::Slot& slot : preparedRichText.slots) {
+        _add_rich_text(pBuffer, slot.text, slot.attributes, nullptr);
+    }
+    CT_SOURCE_BUFFER_END_NOT_UNDOABLE(pGtkSourceBuffer);
+    pBuffer->set_modified(false);
+    return pBuffer;
+}
+
 void CtStorageXmlHelper::_add_rich_text_from_xml(Glib::RefPtr<Gtk::TextBuffer> buffer, xmlpp::Element* xml_element, Gtk::TextIter* text_insert_pos)
 {
     xmlpp::TextNode* text_node = xml_element->get_child_text();
     if (not text_node) return;
     const Glib::ustring text_content = text_node->get_content();
     if (text_content.empty()) return;
-    std::vector<Glib::ustring> tags;
+    std::vector<std::pair<std::string, std::string>> attributes;
     for (const xmlpp::Attribute* pAttribute : xml_element->get_attributes()) {
         if (CtStrUtil::contains(CtConst::TAG_PROPERTIES, pAttribute->get_name().c_str())) {
-            tags.push_back(_pCtMainWin->get_text_tag_name_exist_or_create(pAttribute->get_name(), pAttribute->get_value()));
+            attributes.push_back(std::make_pair(pAttribute->get_name().raw(), pAttribute->get_value().raw()));
+        }
+    }
+    _add_rich_text(buffer, text_content, attributes, text_insert_pos);
+}
+
+void CtStorageXmlHelper::_add_rich_text(Glib::RefPtr<Gtk::TextBuffer> buffer,
+                                        const Glib::ustring& text_content,
+                                        const std::vector<std::pair<std::string, std::string>>& attributes,
+                                        Gtk::TextIter* text_insert_pos)
+{
+    std::vector<Glib::ustring> tags;
+    std::string link_property;
+    for (const auto& [propertyName, propertyValue] : attributes) {
+        tags.push_back(_pCtMainWin->get_text_tag_name_exist_or_create(propertyName, propertyValue));
+        if (CtConst::TAG_LINK == propertyName) {
+            link_property = propertyValue;
         }
     }
     Gtk::TextIter iter = text_insert_pos ? *text_insert_pos : buffer->end();
+    const int start_offset = iter.get_offset();
     if (tags.size() > 0)
         buffer->insert_with_tags_by_name(iter, text_content, tags);
     else
         buffer->insert(iter, text_content);
+    if (not link_property.empty()) {
+        CtLinkTable::get(buffer)->set(buffer->get_iter_at_offset(start_offset),
+                                      buffer->get_iter_at_offset(start_offset + static_cast<int>(text_content.size())),
+                                      link_property);
+    }
 }
 
 CtAnchoredWidget* CtStorageXmlHelper::_create_image_from_xml(xmlpp::Element* xml_element,
@@ -662,12 +893,17 @@ CtAnchoredWidget* CtStorageXmlHelper::_create_image_from_xml(xmlpp::Element* xml
     if (file_name == CtImageLatex::LatexSpecialFilename) {
         return new CtImageLatex{_pCtMainWin, encodedBlob, charOffset, justification, CtImageEmbFile::get_next_unique_id()};
     }
+    const bool isEmbFile = not file_name.empty();
     std::string rawBlob;
+    CtEmbFileBlobPtr pEmbFileBlob;
     if (multifile_dir.empty()) {
         // type is single file
         if (encodedBlob.empty()) {
             spdlog::warn("!! {} unexp image with empty encodedBlob (filename {})", __FUNCTION__, file_name.string());
         }
+        else if (isEmbFile) {
+            pEmbFileBlob = CtEmbFileBlob::from_base64(encodedBlob);
+        }
         else {
             rawBlob = Glib::Base64::decode(encodedBlob);
         }
@@ -682,12 +918,19 @@ CtAnchoredWidget* CtStorageXmlHelper::_create_image_from_xml(xmlpp::Element* xml
             }
             // if file name is non empty, it is ok since this is a multifile type and it means file name is constant on disk
         }
+        else if (isEmbFile) {
+            const fs::path blobFilepath = CtStorageMultiFile::get_blob_filepath(multifile_dir, sha256sum);
+            if (blobFilepath.empty() or not (pEmbFileBlob = CtEmbFileBlob::from_file(blobFilepath))) {
+                spdlog::warn("!! {} unexp not found {} in {}", __FUNCTION__, sha256sum, multifile_dir);
+                return nullptr;
+            }
+        }
         else if (not CtStorageMultiFile::read_blob(multifile_dir, sha256sum, rawBlob)) {
             spdlog::warn("!! {} unexp not found {} in {}", __FUNCTION__, sha256sum, multifile_dir);
             return nullptr;
         }
     }
-    if (not file_name.empty()) {
+    if (isEmbFile) {
         std::string timeStr = xml_element->get_attribute_value("time");
         if (timeStr.empty()) {
             timeStr = "0";
@@ -695,7 +938,7 @@ CtAnchoredWidget* CtStorageXmlHelper::_create_image_from_xml(xmlpp::Element* xml
         const time_t timeInt = std::stoll(timeStr);
         return new CtImageEmbFile{_pCtMainWin,
                                   file_name,
-                                  rawBlob,
+                                  pEmbFileBlob,
                                   timeInt,
                                   charOffset,
                                   justification,
@@ -747,13 +990,12 @@ CtAnchoredWidget* CtStorageXmlHelper::_create_table_from_xml(xmlpp::Element* xml
     return new CtTableHeavy{_pCtMainWin, tableMatrix, colWidthDefault, charOffset, justification, tableColWidths};
 }
 
-void CtXmlHelper::table_to_xml(xmlpp::Element* p_parent,
-                               const std::vector<std::vector<Glib::ustring>>& rows,
-                               const int char_offset,
-                               const Glib::ustring justification,
-                               const int defaultWidth,
-                               const Glib::ustring colWidths,
-                               const bool is_light)
+xmlpp::Element* CtXmlHelper::table_node_to_xml(xmlpp::Element* p_parent,
+                                               const int char_offset,
+                                               const Glib::ustring justification,
+                                               const int defaultWidth,
+                                               const Glib::ustring colWidths,
+                                               const bool is_light)
 {
     xmlpp::Element* p_table_node = p_parent->add_child("table");
     p_table_node->set_attribute("char_offset", std::to_string(char_offset));
@@ -764,6 +1006,18 @@ void CtXmlHelper::table_to_xml(xmlpp::Element* p_parent,
     if (is_light) {
         p_table_node->set_attribute("is_light", "1");
     }
+    return p_table_node;
+}
+
+void CtXmlHelper::table_to_xml(xmlpp::Element* p_parent,
+                               const std::vector<std::vector<Glib::ustring>>& rows,
+                               const int char_offset,
+                               const Glib::ustring justification,
+                               const int defaultWidth,
+                               const Glib::ustring colWidths,
+                               const bool is_light)
+{
+    xmlpp::Element* p_table_node = table_node_to_xml(p_parent, char_offset, justification, defaultWidth, colWidths, is_light);
 
     auto row_to_xml = [&](const std::vector<Glib::ustring>& tableRow) {
         xmlpp::Element* row_element = p_table_node->add_child("row");
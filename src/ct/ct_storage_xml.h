@@ -26,6 +26,7 @@
 #include "ct_types.h"
 #include "ct_widgets.h"
 #include "ct_filesystem.h"
+#include "ct_misc_utils.h"
 #include <glibmm/refptr.h>
 #include <gtkmm/treeiter.h>
 #include <gtkmm/textbuffer.h>
@@ -71,10 +72,16 @@ public:
 
     Glib::RefPtr<Gtk::TextBuffer> get_delayed_text_buffer(const gint64 node_id,
                                                           const std::string& syntax,
-                                                          std::list<CtAnchoredWidget*>& widgets) const override;
+                                                          std::list<CtAnchoredWidget*>& widgets,
+                                                          const CtPreparedRichText* pPrepared) const override;
+    // the nodes are parsed at load
+    bool get_delayed_text_raw(const gint64/*node_id*/, std::string&/*rawXml*/, bool*/*pHasWidgets*/ = nullptr) const override { return false; }
 
     fs::path get_embedded_filepath(const CtTreeIter&/*ct_tree_iter*/, const std::string&/*filename*/) const override { return ""; }
 
+    bool restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter) override;
+    void memory_usage_populate(CtMemoryUsage& memoryUsage) const override;
+
 private:
     void _nodes_to_xml(CtTreeIter* ct_tree_iter,
                        xmlpp::Element* p_node_parent,
@@ -130,6 +137,18 @@ public:
                                            const std::string& multifile_dir);
 
     Glib::RefPtr<Gtk::TextBuffer> create_buffer_no_widgets(const Glib::ustring& syntax, const char* xml_content);
+    // parsing of the rich text xml, safe off the main thread, then the buffer is created from it on the main thread
+    static bool prepare_rich_text(const std::string& xml_content, CtPreparedRichText& preparedRichText);
+    Glib::RefPtr<Gtk::TextBuffer> create_buffer_from_prepared(const CtPreparedRichText& preparedRichText);
+
+    // node links and anchors straight from the rich text xml, without creating the buffer
+    static void link_index_node_from_xml(const xmlpp::Element* parent_xml_element, CtLinkIndex::NodeData& nodeData);
+    static bool link_index_node_from_xml(const char* xml_content, CtLinkIndex::NodeData& nodeData);
+    // node content counters straight from the node xml (no multifile_dir for the single file blobs)
+    static void node_stats_from_xml(const xmlpp::Element* parent_xml_element, CtNodeStats& nodeStats, const std::string& multifile_dir);
+    static bool node_stats_from_xml(const char* xml_content, CtNodeStats& nodeStats);
+    // approximate bytes of the libxml2 tree of the node, its subnodes excluded
+    static size_t estimate_node_xml_bytes(const xmlpp::Node* xml_node);
 
     bool populate_table_matrix(CtTableMatrix& tableMatrix,
                                const char* xml_content,
@@ -147,6 +166,10 @@ public:
 
 private:
     void              _add_rich_text_from_xml(Glib::RefPtr<Gtk::TextBuffer> buffer, xmlpp::Element* xml_element, Gtk::TextIter* text_insert_pos);
+    void              _add_rich_text(Glib::RefPtr<Gtk::TextBuffer> buffer,
+                                     const Glib::ustring& text_content,
+                                     const std::vector<std::pair<std::string, std::string>>& attributes,
+                                     Gtk::TextIter* text_insert_pos);
     CtAnchoredWidget* _create_image_from_xml(xmlpp::Element* xml_element, int charOffset, const Glib::ustring& justification, const std::string& multifile_dir);
     CtAnchoredWidget* _create_codebox_from_xml(xmlpp::Element* xml_element, int charOffset, const Glib::ustring& justification);
     CtAnchoredWidget* _create_table_from_xml(xmlpp::Element* xml_element, int charOffset, const Glib::ustring& justification);
@@ -157,6 +180,14 @@ private:
 
 namespace CtXmlHelper {
 
+// the table element with its attributes, without the rows
+xmlpp::Element* table_node_to_xml(xmlpp::Element* parent,
+                                  const int char_offset,
+                                  const Glib::ustring justification,
+                                  const int defaultWidth,
+                                  const Glib::ustring colWidths,
+                                  const bool is_light);
+
 void table_to_xml(xmlpp::Element* parent,
                   const std::vector<std::vector<Glib::ustring>>& rows,
                   const int char_offset,
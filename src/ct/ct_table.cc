@@ -28,6 +28,7 @@
 #include "ct_storage_xml.h"
 #include "ct_logging.h"
 #include "ct_misc_utils.h"
+#include <glib/gstdio.h>
 
 CtTableCommon::CtTableCommon(CtMainWin* pCtMainWin,
                              const int colWidthDefault,
@@ -222,60 +223,110 @@ bool CtTableCommon::on_cell_key_press_event(GdkEventKey* event)
 }
 #endif
 
-/*static*/void CtTableCommon::populate_table_matrix_from_csv(const std::string& filepath,
+/*static*/bool CtTableCommon::populate_table_matrix_from_csv(const std::string& filepath,
                                                              CtMainWin* main_win,
                                                              const bool is_light,
-                                                             CtTableMatrix& tbl_matrix)
-{
-    CtCSV::CtStringTable str_tbl = CtCSV::table_from_csv(filepath);
-    if (str_tbl.size() and str_tbl.front().size()) {
-        const size_t numColumns = str_tbl.front().size();
-        size_t currRow{0};
-        void* pCell{nullptr};
-        for (const auto& row : str_tbl) {
-            ++currRow;
-            CtTableRow tbl_row;
-            size_t currCol{0};
-            for (const auto& cell : row) {
-                ++currCol;
-                if (currCol > numColumns) {
-                    spdlog::warn("{} row {} col {} > {}", __FUNCTION__, currRow, currCol, numColumns);
-                    break;
-                }
-                if (is_light) {
-                    pCell = new Glib::ustring{cell};
-                }
-                else {
-                    pCell = new CtTextCell{main_win, cell, CtConst::TABLE_CELL_TEXT_ID};
-                }
-                tbl_row.emplace_back(pCell);
+                                                             CtTableMatrix& tbl_matrix,
+                                                             const CtCSV::CtCsvProgressFunc& onProgress/*= nullptr*/)
+{
+    size_t numColumns{0};
+    size_t currRow{0};
+    auto f_onRow = [&](std::vector<std::string>& row)->bool{
+        ++currRow;
+        if (0u == numColumns) {
+            numColumns = row.size();
+        }
+        if (row.size() > numColumns) {
+            spdlog::warn("{} row {} cols {} > {}", __FUNCTION__, currRow, row.size(), numColumns);
+        }
+        row.resize(numColumns);
+        CtTableRow tbl_row;
+        tbl_row.reserve(numColumns);
+        for (const auto& cell : row) {
+            if (is_light) {
+                tbl_row.emplace_back(new Glib::ustring{cell});
             }
-            while (currCol < numColumns) {
-                ++currCol;
-                if (is_light) {
-                    pCell = new Glib::ustring{};
-                }
-                else {
-                    pCell = new CtTextCell{main_win, "", CtConst::TABLE_CELL_TEXT_ID};
-                }
-                tbl_row.emplace_back(pCell);
+            else {
+                tbl_row.emplace_back(new CtTextCell{main_win, cell, CtConst::TABLE_CELL_TEXT_ID});
+            }
+        }
+        tbl_matrix.emplace_back(std::move(tbl_row));
+        return true;
+    };
+    return CtCSV::table_from_csv_stream(filepath, f_onRow, onProgress);
+}
+
+/*static*/bool CtTableCommon::populate_table_store_from_csv(const std::string& filepath,
+                                                            CtTableStore& tableStore,
+                                                            const CtCSV::CtCsvProgressFunc& onProgress/*= nullptr*/)
+{
+    size_t currRow{0};
+    auto f_onRow = [&](std::vector<std::string>& row)->bool{
+        ++currRow;
+        if (1u == currRow) {
+            tableStore = CtTableStore{row.size()};
+        }
+        else if (row.size() > tableStore.get_num_columns()) {
+            spdlog::warn("{} row {} cols {} > {}", __FUNCTION__, currRow, row.size(), tableStore.get_num_columns());
+        }
+        tableStore.row_append(row);
+        return true;
+    };
+    return CtCSV::table_from_csv_stream(filepath, f_onRow, onProgress);
+}
+
+std::string CtTableCommon::to_csv() const
+{
+    std::string csvOut;
+    const size_t numRows = get_num_rows();
+    for (size_t rowIdx = 0u; rowIdx < numRows; ++rowIdx) {
+        _append_csv_row(rowIdx, csvOut);
+    }
+    return csvOut;
+}
+
+bool CtTableCommon::to_csv_file(const std::string& filepath, const CtCSV::CtCsvProgressFunc& onProgress/*= nullptr*/) const
+{
+    FILE* pFile = g_fopen(filepath.c_str(), "wb");
+    if (not pFile) {
+        throw std::runtime_error(fmt::format("could not open {}", filepath));
+    }
+    bool writeOk{true};
+    bool stopped{false};
+    std::string csvChunk;
+    csvChunk.reserve(CtCSV::CSV_CHUNK_SIZE*2);
+    const size_t numRows = get_num_rows();
+    for (size_t rowIdx = 0u; rowIdx < numRows and writeOk; ++rowIdx) {
+        _append_csv_row(rowIdx, csvChunk);
+        if (csvChunk.size() >= CtCSV::CSV_CHUNK_SIZE or rowIdx == numRows-1) {
+            writeOk = csvChunk.size() == fwrite(csvChunk.data(), 1, csvChunk.size(), pFile);
+            csvChunk.clear();
+            if (onProgress and not onProgress(double(rowIdx+1)/numRows)) {
+                stopped = true;
+                break;
             }
-            tbl_matrix.emplace_back(tbl_row);
         }
     }
+    writeOk = 0 == fclose(pFile) and writeOk;
+    if (stopped or not writeOk) {
+        (void)g_remove(filepath.c_str());
+    }
+    if (not writeOk) {
+        throw std::runtime_error(fmt::format("could not write {}", filepath));
+    }
+    return not stopped;
 }
 
 void CtTableCommon::to_xml(xmlpp::Element* p_node_parent, const int offset_adjustment, CtStorageCache*, const std::string&/*multifile_dir*/)
 {
-    std::vector<std::vector<Glib::ustring>> rows;
-    write_strings_matrix(rows);
-    CtXmlHelper::table_to_xml(p_node_parent,
-                              rows,
-                              _charOffset+offset_adjustment,
-                              _justification,
-                              _colWidthDefault,
-                              str::join_numbers(_colWidths, ","),
-                              CtAnchWidgType::TableLight == get_type());
+    // the rows are written straight from the table rather than through a copy of the strings matrix
+    xmlpp::Element* p_table_node = CtXmlHelper::table_node_to_xml(p_node_parent,
+                                                                  _charOffset+offset_adjustment,
+                                                                  _justification,
+                                                                  _colWidthDefault,
+                                                                  str::join_numbers(_colWidths, ","),
+                                                                  CtAnchWidgType::TableLight == get_type());
+    _populate_xml_rows_cells(p_table_node);
 }
 
 bool CtTableCommon::to_sqlite(sqlite3* pDb, const gint64 node_id, const int offset_adjustment, CtStorageCache*)
@@ -444,20 +495,13 @@ void CtTableHeavy::_populate_xml_rows_cells(xmlpp::Element* p_table_node) const
     row_to_xml(_tableMatrix.front());
 }
 
-std::string CtTableHeavy::to_csv() const
+void CtTableHeavy::_append_csv_row(const size_t rowIdx, std::string& csvOut) const
 {
-    CtCSV::CtStringTable tbl;
-    tbl.reserve(get_num_rows());
-    const size_t numColumns = get_num_columns();
-    for (const CtTableRow& ct_row : _tableMatrix) {
-        std::vector<std::string> row;
-        row.reserve(numColumns);
-        for (void* ct_cell : ct_row) {
-            row.emplace_back(static_cast<CtTextCell*>(ct_cell)->get_text_content());
-        }
-        tbl.emplace_back(row);
+    const CtTableRow& ct_row = _tableMatrix.at(rowIdx);
+    const size_t numColumns = ct_row.size();
+    for (size_t colIdx = 0u; colIdx < numColumns; ++colIdx) {
+        CtCSV::cell_to_csv(static_cast<CtTextCell*>(ct_row.at(colIdx))->get_text_content().raw(), colIdx == numColumns-1, csvOut);
     }
-    return CtCSV::table_to_csv(tbl);
 }
 
 std::shared_ptr<CtAnchoredWidgetState> CtTableHeavy::get_state()
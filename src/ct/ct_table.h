@@ -25,8 +25,11 @@
 
 #include "ct_codebox.h"
 #include "ct_widgets.h"
+#include "ct_misc_utils.h"
 #include <optional>
+#include <string_view>
 
+class CtTableStore;
 class CtAnchoredWidgetState_TableCommon;
 class CtTableCommon : public CtAnchoredWidget
 {
@@ -61,13 +64,20 @@ public:
     bool to_sqlite(sqlite3* pDb, const gint64 node_id, const int offset_adjustment, CtStorageCache* cache) override;
 
     // Build a table from csv; The input csv should be compatable with the excel csv format
-    static void populate_table_matrix_from_csv(const std::string& filepath,
+    static bool populate_table_matrix_from_csv(const std::string& filepath,
                                                CtMainWin* main_win,
                                                const bool is_light,
-                                               CtTableMatrix& tbl_matrix);
+                                               CtTableMatrix& tbl_matrix,
+                                               const CtCSV::CtCsvProgressFunc& onProgress = nullptr);
+    // Build a light table store from csv, one record at a time
+    static bool populate_table_store_from_csv(const std::string& filepath,
+                                              CtTableStore& tableStore,
+                                              const CtCSV::CtCsvProgressFunc& onProgress = nullptr);
 
     // Serialise to csv format; The output CSV excel csv with double quotes around cells and newlines for each record
-    virtual std::string to_csv() const = 0;
+    std::string to_csv() const;
+    // Serialise to csv file one chunk at a time; Returns false if stopped by onProgress
+    bool to_csv_file(const std::string& filepath, const CtCSV::CtCsvProgressFunc& onProgress = nullptr) const;
 
     virtual Glib::ustring get_line_content(const size_t rowIdx, const size_t colIdx, const int match_end_offset) const = 0;
 
@@ -111,6 +121,7 @@ public:
 
 protected:
     virtual void _populate_xml_rows_cells(xmlpp::Element* p_table_node) const = 0;
+    virtual void _append_csv_row(const size_t rowIdx, std::string& csvOut) const = 0;
     virtual bool _row_sort(const bool sortAsc) = 0;
     virtual bool _on_cell_key_press_alt_or_ctrl_enter() { return false; /* propagate signal */ }
 
@@ -120,17 +131,71 @@ protected:
     size_t           _currentColumn{0u};
 };
 
-struct CtTableLightColumns : public Gtk::TreeModelColumnRecord
+// Columnar text storage of the light table: every column keeps the text of all its cells
+// in a single arena, each cell being an offset/size pair, so that even tables with
+// hundreds of thousands of cells cost a few allocations instead of one per cell
+class CtTableStore
 {
-    CtTableLightColumns(const size_t numColumns) {
-        columnsText.resize(numColumns);
-        for (size_t i = 0u; i < numColumns; ++i) {
-            add(columnsText.at(i));
+public:
+    CtTableStore(const size_t numColumns = 0u) : _columns(numColumns) {}
+
+    size_t get_num_rows() const { return _numRows; }
+    size_t get_num_columns() const { return _columns.size(); }
+
+    // the view is valid until the next change to the store
+    std::string_view get(const size_t rowIdx, const size_t colIdx) const {
+        const Column& column = _columns.at(colIdx);
+        const Cell& cell = column.cells.at(rowIdx);
+        return std::string_view{column.arena.data() + cell.offset, cell.size};
+    }
+    void set(const size_t rowIdx, const size_t colIdx, const std::string_view text);
+    // memory held by the columns, garbage included
+    size_t get_bytes() const {
+        size_t bytes{0u};
+        for (const Column& column : _columns) {
+            bytes += column.arena.capacity() + column.cells.capacity()*sizeof(Cell);
         }
-        add(columnWeight);
+        return bytes;
     }
-    std::vector<Gtk::TreeModelColumn<Glib::ustring>> columnsText;
-    Gtk::TreeModelColumn<int>                        columnWeight;
+
+    void reserve_rows(const size_t numRows);
+    // exceeding cells are dropped, missing cells are left empty
+    void row_append(const std::vector<std::string>& cells);
+    void row_insert(const size_t rowIdx);
+    void row_delete(const size_t rowIdx);
+    void rows_swap(const size_t rowIdxA, const size_t rowIdxB);
+    // returns the indexes of the rows that changed position
+    std::vector<size_t> rows_sort(const bool sortAsc, const size_t startRow);
+
+    void column_insert(const size_t colIdx);
+    void column_delete(const size_t colIdx);
+    void columns_swap(const size_t colIdxA, const size_t colIdxB);
+
+    static constexpr size_t COMPACT_MIN_GARBAGE{64*1024};
+
+private:
+    struct Cell
+    {
+        uint32_t offset{0};
+        uint32_t size{0};
+    };
+    struct Column
+    {
+        std::string       arena;
+        std::vector<Cell> cells;
+        size_t            garbage{0}; // bytes in arena no longer referenced by cells
+    };
+    static void _compact_if_needed(Column& column);
+
+    std::vector<Column> _columns;
+    size_t              _numRows{0};
+};
+
+// the list store only holds a placeholder row per table row, the cells text lives in the CtTableStore
+struct CtTableLightColumns : public Gtk::TreeModelColumnRecord
+{
+    CtTableLightColumns() { add(columnPlaceholder); }
+    Gtk::TreeModelColumn<bool> columnPlaceholder;
 };
 
 class CtTableLight : public CtTableCommon
@@ -144,22 +209,29 @@ public:
                  const CtTableColWidths& colWidths,
                  const size_t currRow = 0,
                  const size_t currCol = 0);
+    CtTableLight(CtMainWin* pCtMainWin,
+                 CtTableStore&& tableStore,
+                 const int colWidthDefault,
+                 const int charOffset,
+                 const std::string& justification,
+                 const CtTableColWidths& colWidths,
+                 const size_t currRow = 0,
+                 const size_t currCol = 0);
 
-    const CtTableLightColumns& get_columns() const { return *_pColumns; }
+    const CtTableStore& get_store() const { return _tableStore; }
 
     Glib::ustring get_cell_text(const size_t rowIdx, const size_t colIdx) const;
     void set_cell_text(const size_t rowIdx, const size_t colIdx, const Glib::ustring& cell_text);
 
     void apply_syntax_highlighting(const bool /*forceReApply*/) override {}
-    std::string to_csv() const override;
     Glib::ustring get_line_content(const size_t rowIdx, const size_t colIdx, const int match_end_offset) const override;
     void set_modified_false() override {}
     CtAnchWidgType get_type() const override { return CtAnchWidgType::TableLight; }
     std::shared_ptr<CtAnchoredWidgetState> get_state() override;
 
     void write_strings_matrix(std::vector<std::vector<Glib::ustring>>& rows) const override;
-    size_t get_num_rows() const override { return _pListStore->children().size(); }
-    size_t get_num_columns() const override { return _pColumns->columnsText.size(); }
+    size_t get_num_rows() const override { return _tableStore.get_num_rows(); }
+    size_t get_num_columns() const override { return _tableStore.get_num_columns(); }
 
     void column_add(const size_t afterColIdx, const std::vector<Glib::ustring>* pNewColumn = nullptr) override;
     void column_delete(const size_t colIdx) override;
@@ -181,11 +253,16 @@ public:
     int get_curr_cell_curr_offset() const override;
     int get_curr_cell_max_offset() const override;
 
+    // above this number of rows the columns only grow, sparing the measure of all the rows at every change
+    static constexpr size_t AUTOSIZE_MAX_ROWS{1000};
+
 protected:
-    void _reset(CtTableMatrix& tableMatrix);
-    static void _free_matrix(CtTableMatrix& tableMatrix);
+    void _reset_model();
+    void _reset_view();
+    void _row_changed(const size_t rowIdx);
 
     void _populate_xml_rows_cells(xmlpp::Element* p_table_node) const override;
+    void _append_csv_row(const size_t rowIdx, std::string& csvOut) const override;
     bool _row_sort(const bool sortAsc) override;
     bool _on_cell_key_press_alt_or_ctrl_enter() override;
 
@@ -196,7 +273,8 @@ protected:
     void _on_cell_renderer_text_edited(const Glib::ustring& path, const Glib::ustring& new_text, const size_t column);
     void _on_cell_renderer_editing_started(Gtk::CellEditable* editable, const Glib::ustring& path, const size_t column);
 
-    std::unique_ptr<CtTableLightColumns> _pColumns;
+    CtTableStore _tableStore;
+    CtTableLightColumns _listColumns;
     Gtk::TreeView* _pManagedTreeView{nullptr};
     Glib::RefPtr<Gtk::ListStore> _pListStore;
     Gtk::Entry* _pEditingCellEntry{nullptr};
@@ -216,7 +294,6 @@ public:
     ~CtTableHeavy() override;
 
     void apply_syntax_highlighting(const bool forceReApply) override;
-    std::string to_csv() const override;
     Glib::ustring get_line_content(const size_t rowIdx, const size_t colIdx, const int match_end_offset) const override;
     void set_modified_false() override;
     CtAnchWidgType get_type() const override { return CtAnchWidgType::TableHeavy; }
@@ -256,6 +333,7 @@ protected:
 
     bool _row_sort(const bool sortAsc) override;
     void _populate_xml_rows_cells(xmlpp::Element* p_table_node) const override;
+    void _append_csv_row(const size_t rowIdx, std::string& csvOut) const override;
 
     void _on_grid_set_focus_child(Gtk::Widget* pWidget);
 
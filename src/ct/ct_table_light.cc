@@ -28,15 +28,150 @@
 #include "ct_storage_xml.h"
 #include "ct_logging.h"
 #include "ct_misc_utils.h"
+#include <cstring>
+#include <numeric>
 
-/*static*/void CtTableLight::_free_matrix(CtTableMatrix& tableMatrix)
+void CtTableStore::set(const size_t rowIdx, const size_t colIdx, const std::string_view text)
 {
-    for (CtTableRow& tableRow : tableMatrix) {
-        for (void* pText : tableRow) {
-            delete static_cast<Glib::ustring*>(pText);
-            pText = nullptr;
+    Column& column = _columns.at(colIdx);
+    Cell& cell = column.cells.at(rowIdx);
+    if (text.data() >= column.arena.data() and text.data() < column.arena.data() + column.arena.size()) {
+        // the text is a view on the arena that we are about to modify
+        set(rowIdx, colIdx, std::string{text});
+        return;
+    }
+    if (text.size() <= cell.size) {
+        if (not text.empty()) {
+            memcpy(&column.arena[cell.offset], text.data(), text.size());
+        }
+        column.garbage += cell.size - text.size();
+        cell.size = static_cast<uint32_t>(text.size());
+    }
+    else {
+        if (column.arena.size() + text.size() > UINT32_MAX) {
+            spdlog::error("!! {} column {} exceeds the max size", __FUNCTION__, colIdx);
+            return;
+        }
+        column.garbage += cell.size;
+        cell.offset = static_cast<uint32_t>(column.arena.size());
+        cell.size = static_cast<uint32_t>(text.size());
+        column.arena.append(text.data(), text.size());
+    }
+    _compact_if_needed(column);
+}
+
+/*static*/void CtTableStore::_compact_if_needed(Column& column)
+{
+    if (column.garbage < COMPACT_MIN_GARBAGE or column.garbage*2u < column.arena.size()) {
+        return;
+    }
+    std::string arena;
+    arena.reserve(column.arena.size() - column.garbage);
+    for (Cell& cell : column.cells) {
+        const uint32_t offset = static_cast<uint32_t>(arena.size());
+        arena.append(column.arena, cell.offset, cell.size);
+        cell.offset = offset;
+    }
+    column.arena.swap(arena);
+    column.garbage = 0u;
+}
+
+void CtTableStore::reserve_rows(const size_t numRows)
+{
+    for (Column& column : _columns) {
+        column.cells.reserve(numRows);
+    }
+}
+
+void CtTableStore::row_append(const std::vector<std::string>& cells)
+{
+    row_insert(_numRows);
+    const size_t numColumns = std::min(cells.size(), _columns.size());
+    for (size_t c = 0u; c < numColumns; ++c) {
+        set(_numRows-1u, c, cells[c]);
+    }
+}
+
+void CtTableStore::row_insert(const size_t rowIdx)
+{
+    for (Column& column : _columns) {
+        column.cells.insert(column.cells.begin()+rowIdx, Cell{});
+    }
+    ++_numRows;
+}
+
+void CtTableStore::row_delete(const size_t rowIdx)
+{
+    for (Column& column : _columns) {
+        column.garbage += column.cells.at(rowIdx).size;
+        column.cells.erase(column.cells.begin()+rowIdx);
+        _compact_if_needed(column);
+    }
+    --_numRows;
+}
+
+void CtTableStore::rows_swap(const size_t rowIdxA, const size_t rowIdxB)
+{
+    for (Column& column : _columns) {
+        std::swap(column.cells.at(rowIdxA), column.cells.at(rowIdxB));
+    }
+}
+
+std::vector<size_t> CtTableStore::rows_sort(const bool sortAsc, const size_t startRow)
+{
+    std::vector<size_t> changedRows;
+    if (_numRows <= startRow + 1u or _columns.empty()) {
+        return changedRows;
+    }
+    // the first column decides most of the comparisons, convert it only once
+    std::vector<Glib::ustring> firstColumnKeys;
+    firstColumnKeys.reserve(_numRows);
+    for (size_t r = 0u; r < _numRows; ++r) {
+        firstColumnKeys.emplace_back(std::string{get(r, 0u)});
+    }
+    auto f_less = [&](const size_t l, const size_t r)->bool{
+        int cmpResult = CtStrUtil::natural_compare(firstColumnKeys[l], firstColumnKeys[r]);
+        for (size_t c = 1u; 0 == cmpResult and c < _columns.size(); ++c) {
+            cmpResult = CtStrUtil::natural_compare(Glib::ustring{std::string{get(l, c)}},
+                                                   Glib::ustring{std::string{get(r, c)}});
+        }
+        return sortAsc ? cmpResult < 0 : cmpResult > 0;
+    };
+    std::vector<size_t> order(_numRows);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin()+startRow, order.end(), f_less);
+    for (size_t r = startRow; r < _numRows; ++r) {
+        if (order[r] != r) {
+            changedRows.push_back(r);
+        }
+    }
+    if (not changedRows.empty()) {
+        for (Column& column : _columns) {
+            std::vector<Cell> cells(_numRows);
+            for (size_t r = 0u; r < _numRows; ++r) {
+                cells[r] = column.cells[order[r]];
+            }
+            column.cells.swap(cells);
         }
     }
+    return changedRows;
+}
+
+void CtTableStore::column_insert(const size_t colIdx)
+{
+    Column column;
+    column.cells.resize(_numRows);
+    _columns.insert(_columns.begin()+colIdx, std::move(column));
+}
+
+void CtTableStore::column_delete(const size_t colIdx)
+{
+    _columns.erase(_columns.begin()+colIdx);
+}
+
+void CtTableStore::columns_swap(const size_t colIdxA, const size_t colIdxB)
+{
+    std::swap(_columns.at(colIdxA), _columns.at(colIdxB));
 }
 
 CtTableLight::CtTableLight(CtMainWin* pCtMainWin,
@@ -49,39 +184,60 @@ CtTableLight::CtTableLight(CtMainWin* pCtMainWin,
                            const size_t currCol)
  : CtTableCommon{pCtMainWin, colWidthDefault, charOffset, justification, colWidths, currRow, currCol}
 {
-    _reset(tableMatrix);
+    // enforce same number of columns per row
+    size_t numColumns{0u};
+    for (const CtTableRow& tableRow : tableMatrix) {
+        numColumns = std::max(numColumns, tableRow.size());
+    }
+    _tableStore = CtTableStore{numColumns};
+    _tableStore.reserve_rows(tableMatrix.size());
+    for (CtTableRow& tableRow : tableMatrix) {
+        const size_t rowIdx = _tableStore.get_num_rows();
+        _tableStore.row_insert(rowIdx);
+        for (size_t c = 0u; c < tableRow.size(); ++c) {
+            auto pText = static_cast<Glib::ustring*>(tableRow[c]);
+            _tableStore.set(rowIdx, c, pText->raw());
+            delete pText;
+        }
+        tableRow.clear();
+    }
+    _reset_model();
+    _reset_view();
+}
+
+CtTableLight::CtTableLight(CtMainWin* pCtMainWin,
+                           CtTableStore&& tableStore,
+                           const int colWidthDefault,
+                           const int charOffset,
+                           const std::string& justification,
+                           const CtTableColWidths& colWidths,
+                           const size_t currRow,
+                           const size_t currCol)
+ : CtTableCommon{pCtMainWin, colWidthDefault, charOffset, justification, colWidths, currRow, currCol}
+ , _tableStore{std::move(tableStore)}
+{
+    _reset_model();
+    _reset_view();
 }
 
-void CtTableLight::_reset(CtTableMatrix& tableMatrix)
+void CtTableLight::_reset_model()
 {
-    const size_t numRows{tableMatrix.size()};
-    size_t numColumns{0u};
-    // enforce same number of columns per row
-    for (size_t r = 0u; r < numRows; ++r) {
-        if (tableMatrix[r].size() > numColumns) { numColumns = tableMatrix[r].size(); }
-    }
+    _pListStore = Gtk::ListStore::create(_listColumns);
+    const size_t numRows = get_num_rows();
     for (size_t r = 0u; r < numRows; ++r) {
-        while (tableMatrix[r].size() < numColumns) { tableMatrix[r].push_back(new Glib::ustring{}); }
+        (void)_pListStore->append();
     }
+}
 
+void CtTableLight::_reset_view()
+{
+    const size_t numColumns = get_num_columns();
     // column widths can be empty or wrong, trying to fix it
     // so we don't need to check it again and again
     while (_colWidths.size() < numColumns) {
         _colWidths.push_back(0); // 0 means we use default width
     }
 
-    _pColumns.reset(new CtTableLightColumns{numColumns});
-    _pListStore = Gtk::ListStore::create(*_pColumns);
-
-    for (size_t r = 0u; r < numRows; ++r) {
-        Gtk::TreeModel::Row row = *(_pListStore->append());
-        row[_pColumns->columnWeight] = CtTreeIter::get_pango_weight_from_is_bold(0u == r);
-        for (size_t c = 0u; c < numColumns; ++c) {
-            row[_pColumns->columnsText.at(c)] = *static_cast<Glib::ustring*>(tableMatrix.at(r).at(c));
-        }
-    }
-    CtTableLight::_free_matrix(tableMatrix);
-
     if (_pManagedTreeView) {
 #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
         _frame.remove();
@@ -98,23 +254,30 @@ void CtTableLight::_reset(CtTableMatrix& tableMatrix)
 #endif
     for (size_t c = 0u; c < numColumns; ++c) {
         const int width = get_col_width(c);
-        _pManagedTreeView->append_column_editable(""/*header*/, _pColumns->columnsText.at(c));
-        Gtk::TreeViewColumn* pTVColumn = _pManagedTreeView->get_column(c);
-        if (pTVColumn) {
-            auto pCellRendererText = static_cast<Gtk::CellRendererText*>(pTVColumn->get_first_cell());
-            pTVColumn->add_attribute(pCellRendererText->property_weight(), _pColumns->columnWeight);
-            pCellRendererText->property_wrap_width() = width;
-            pCellRendererText->property_wrap_mode() =
+        auto pCellRendererText = Gtk::manage(new Gtk::CellRendererText{});
+        auto pTVColumn = Gtk::manage(new Gtk::TreeViewColumn{});
+        pTVColumn->pack_start(*pCellRendererText, true);
+        // the text is only fetched from the store for the rows being measured or drawn
+        pTVColumn->set_cell_data_func(*pCellRendererText, [this, c](Gtk::CellRenderer* cell, const auto& iter) {
+            const size_t rowIdx = _pListStore->get_path(iter)[0];
+            auto pCell = static_cast<Gtk::CellRendererText*>(cell);
+            pCell->property_text() = Glib::ustring{std::string{_tableStore.get(rowIdx, c)}};
+            pCell->property_weight() = CtTreeIter::get_pango_weight_from_is_bold(0u == rowIdx);
+        });
+        _pManagedTreeView->append_column(*pTVColumn);
+        pCellRendererText->property_editable() = true;
+        pCellRendererText->property_wrap_width() = width;
+        pCellRendererText->property_wrap_mode() =
 #if GTKMM_MAJOR_VERSION >= 4
-                Pango::WrapMode::WORD_CHAR;
+            Pango::WrapMode::WORD_CHAR;
 #else
-                Pango::WrapMode::WRAP_WORD_CHAR;
-            pTVColumn->property_sizing() = Gtk::TREE_VIEW_COLUMN_AUTOSIZE;
+            Pango::WrapMode::WRAP_WORD_CHAR;
+        pTVColumn->property_sizing() = get_num_rows() > AUTOSIZE_MAX_ROWS ?
+            Gtk::TREE_VIEW_COLUMN_GROW_ONLY : Gtk::TREE_VIEW_COLUMN_AUTOSIZE;
 #endif
-            pTVColumn->property_min_width() = width/2;
-            pCellRendererText->signal_edited().connect(sigc::bind(sigc::mem_fun(*this, &CtTableLight::_on_cell_renderer_text_edited), c), false);
-            pCellRendererText->signal_editing_started().connect(sigc::bind(sigc::mem_fun(*this, &CtTableLight::_on_cell_renderer_editing_started), c), false);
-        }
+        pTVColumn->property_min_width() = width/2;
+        pCellRendererText->signal_edited().connect(sigc::bind(sigc::mem_fun(*this, &CtTableLight::_on_cell_renderer_text_edited), c), false);
+        pCellRendererText->signal_editing_started().connect(sigc::bind(sigc::mem_fun(*this, &CtTableLight::_on_cell_renderer_editing_started), c), false);
     }
 #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
     _pManagedTreeView->signal_button_press_event().connect(sigc::mem_fun(*this, &CtTableCommon::on_table_button_press_event), false);
@@ -132,14 +295,22 @@ void CtTableLight::_reset(CtTableMatrix& tableMatrix)
 #endif
 }
 
-void CtTableLight::_on_cell_renderer_text_edited(const Glib::ustring& path, const Glib::ustring& new_text, const size_t column)
+void CtTableLight::_row_changed(const size_t rowIdx)
 {
-    Gtk::TreeModel::iterator treeIter{_pListStore->get_iter(path)};
+    Gtk::TreePath treePath{std::to_string(rowIdx)};
+    Gtk::TreeModel::iterator treeIter = _pListStore->get_iter(treePath);
     if (treeIter) {
-        Gtk::TreeRow treeRow{*treeIter};
-        const Glib::ustring old_text = treeRow.get_value(_pColumns->columnsText.at(column));
-        if (old_text != new_text) {
-            treeRow[_pColumns->columnsText.at(column)] = new_text;
+        _pListStore->row_changed(treePath, treeIter);
+    }
+}
+
+void CtTableLight::_on_cell_renderer_text_edited(const Glib::ustring& path, const Glib::ustring& new_text, const size_t column)
+{
+    const size_t rowIdx = std::stoi(path.raw());
+    if (rowIdx < get_num_rows() and column < get_num_columns()) {
+        if (_tableStore.get(rowIdx, column) != new_text.raw()) {
+            _tableStore.set(rowIdx, column, new_text.raw());
+            _row_changed(rowIdx);
             _pCtMainWin->update_window_save_needed(CtSaveNeededUpdType::nbuf, true/*new_machine_state*/);
         }
     }
@@ -177,45 +348,42 @@ bool CtTableLight::_on_entry_focus_out_event(GdkEventFocus*/*gdk_event*/, Gtk::E
 
 void CtTableLight::write_strings_matrix(std::vector<std::vector<Glib::ustring>>& rows) const
 {
-    rows.reserve(get_num_rows());
-    auto f_action = [&](const Gtk::TreeModel::iterator& treeIter)->bool{
-        Gtk::TreeRow treeRow = *treeIter;
+    const size_t numRows = get_num_rows();
+    const size_t numCols = get_num_columns();
+    rows.reserve(numRows);
+    for (size_t r = 0u; r < numRows; ++r) {
         rows.push_back(std::vector<Glib::ustring>{});
-        const size_t numCols = get_num_columns();
         rows.back().reserve(numCols);
-        const CtTableLightColumns& cols = get_columns();
         for (size_t c = 0u; c < numCols; ++c) {
-            rows.back().push_back(treeRow[cols.columnsText.at(c)]);
+            rows.back().emplace_back(std::string{_tableStore.get(r, c)});
         }
-        return false; /* to continue */
-    };
-    _pListStore->foreach_iter(f_action);
+    }
 }
 
 void CtTableLight::_populate_xml_rows_cells(xmlpp::Element* p_table_node) const
 {
-    // put header at the end
-    Gtk::TreeModel::iterator headerIter;
-    bool is_header{true};
-    auto f_action = [&](const Gtk::TreeModel::iterator& treeIter)->bool{
-        if (is_header) {
-            is_header = false;
-            headerIter = treeIter;
-        }
-        else {
-            Gtk::TreeRow treeRow = *treeIter;
-            xmlpp::Element* p_row_node = p_table_node->add_child("row");
-            const size_t numCols = get_num_columns();
-            const CtTableLightColumns& cols = get_columns();
-            for (size_t c = 0u; c < numCols; ++c) {
-                xmlpp::Element* p_cell_node = p_row_node->add_child("cell");
-                p_cell_node->add_child_text(treeRow[cols.columnsText.at(c)]);
-            }
+    const size_t numRows = get_num_rows();
+    const size_t numCols = get_num_columns();
+    auto f_row_to_xml = [&](const size_t r) {
+        xmlpp::Element* p_row_node = p_table_node->add_child("row");
+        for (size_t c = 0u; c < numCols; ++c) {
+            xmlpp::Element* p_cell_node = p_row_node->add_child("cell");
+            p_cell_node->add_child_text(std::string{_tableStore.get(r, c)});
         }
-        return false; /* to continue */
     };
-    _pListStore->foreach_iter(f_action);
-    if (not is_header) f_action(headerIter);
+    // put header at the end
+    for (size_t r = 1u; r < numRows; ++r) {
+        f_row_to_xml(r);
+    }
+    if (numRows > 0u) f_row_to_xml(0u);
+}
+
+void CtTableLight::_append_csv_row(const size_t rowIdx, std::string& csvOut) const
+{
+    const size_t numCols = get_num_columns();
+    for (size_t c = 0u; c < numCols; ++c) {
+        CtCSV::cell_to_csv(_tableStore.get(rowIdx, c), c == numCols-1, csvOut);
+    }
 }
 
 std::shared_ptr<CtAnchoredWidgetState> CtTableLight::get_state()
@@ -233,22 +401,21 @@ void CtTableLight::row_add(const size_t afterRowIdx, const std::vector<Glib::ust
     #else
     Gtk::TreeModel::iterator afterIter = _pListStore->get_iter(Gtk::TreePath{std::to_string(afterRowIdx)});
     #endif
-    Gtk::TreeModel::iterator newIter;
-    if (afterIter) {
-        newIter = _pListStore->insert_after(afterIter);
-    }
-    else {
-        newIter = _pListStore->append();
-    }
-    Gtk::TreeModel::Row newRow = *newIter;
-    newRow[_pColumns->columnWeight] = CtTreeIter::get_pango_weight_from_is_bold(false);
+    const size_t newRowIdx = afterIter ? afterRowIdx + 1u : get_num_rows();
+    _tableStore.row_insert(newRowIdx);
     if (pNewRow) {
         const size_t numColsTo = get_num_columns();
         const size_t numColsFrom = pNewRow->size();
         for (size_t c = 0u; c < numColsTo and c < numColsFrom; ++c) {
-            newRow[_pColumns->columnsText.at(c)] = pNewRow->at(c);
+            _tableStore.set(newRowIdx, c, pNewRow->at(c).raw());
         }
     }
+    if (afterIter) {
+        (void)_pListStore->insert_after(afterIter);
+    }
+    else {
+        (void)_pListStore->append();
+    }
     grab_focus();
 }
 
@@ -263,68 +430,34 @@ void CtTableLight::row_delete(const size_t rowIdx)
     for (size_t r = 0; r < rowIdx && const_iter; ++r) ++const_iter;
     Gtk::TreeModel::iterator treeIter = const_iter ? _pListStore->get_iter(_pListStore->get_path(const_iter)) : Gtk::TreeModel::iterator{};
     #else
-    Gtk::TreePath treePath{std::to_string(rowIdx)};
-    Gtk::TreeModel::iterator treeIter = _pListStore->get_iter(treePath);
+    Gtk::TreeModel::iterator treeIter = _pListStore->get_iter(Gtk::TreePath{std::to_string(rowIdx)});
     #endif
     if (not treeIter) {
         return;
     }
-    //const CtTableLightColumns& cols = get_columns();
-    //spdlog::debug("rm row {} [{},{},{},{}]", treePath.to_string().raw(),
-    //    treeIter->get_value(cols.columnsText.at(0)),
-    //    treeIter->get_value(cols.columnsText.at(1)),
-    //    treeIter->get_value(cols.columnsText.at(2)),
-    //    treeIter->get_value(cols.columnsText.at(3)));
     exit_cell_edit();
     (void)_pListStore->erase(treeIter);
+    _tableStore.row_delete(rowIdx);
     if (_currentRow == get_num_rows()) {
         --_currentRow;
     }
     if (0u == rowIdx) {
         // we deleted the header
-        #if GTKMM_MAJOR_VERSION >= 4
-        auto children2 = _pListStore->children();
-        auto const_iter2 = children2.begin();
-        // header is first row
-        Gtk::TreeModel::iterator treeIterHeader = const_iter2 ? _pListStore->get_iter(_pListStore->get_path(const_iter2)) : Gtk::TreeModel::iterator{};
-        #else
-        Gtk::TreeModel::iterator treeIterHeader = _pListStore->get_iter(treePath);
-        #endif
-        if (treeIterHeader) {
-            (*treeIterHeader)[_pColumns->columnWeight] = CtTreeIter::get_pango_weight_from_is_bold(true);
-        }
+        _row_changed(0u);
     }
     grab_focus();
 }
 
 void CtTableLight::row_move_up(const size_t rowIdx, const bool from_move_down)
 {
-    if (0u == rowIdx) {
+    if (0u == rowIdx or rowIdx >= get_num_rows()) {
         return;
     }
     const size_t rowIdxUp = rowIdx - 1u;
-    #if GTKMM_MAJOR_VERSION >= 4
-    auto children = _pListStore->children();
-    auto const_iter = children.begin();
-    for (size_t r = 0; r < rowIdx && const_iter; ++r) ++const_iter;
-    Gtk::TreeModel::iterator treeIter = const_iter ? _pListStore->get_iter(_pListStore->get_path(const_iter)) : Gtk::TreeModel::iterator{};
-    auto const_iter_up = children.begin();
-    for (size_t r = 0; r < rowIdxUp && const_iter_up; ++r) ++const_iter_up;
-    Gtk::TreeModel::iterator treeIterUp = const_iter_up ? _pListStore->get_iter(_pListStore->get_path(const_iter_up)) : Gtk::TreeModel::iterator{};
-    #else
-    Gtk::TreeModel::iterator treeIter = _pListStore->get_iter(Gtk::TreePath{std::to_string(rowIdx)});
-    Gtk::TreeModel::iterator treeIterUp = _pListStore->get_iter(Gtk::TreePath{std::to_string(rowIdxUp)});
-    #endif
-    if (not treeIter or not treeIterUp) {
-        return;
-    }
-    if (0u == rowIdxUp) {
-        // we are swapping header
-        (*treeIter)[_pColumns->columnWeight] = CtTreeIter::get_pango_weight_from_is_bold(true);
-        (*treeIterUp)[_pColumns->columnWeight] = CtTreeIter::get_pango_weight_from_is_bold(false);
-    }
     exit_cell_edit();
-    _pListStore->iter_swap(treeIter, treeIterUp);
+    _tableStore.rows_swap(rowIdx, rowIdxUp);
+    _row_changed(rowIdxUp);
+    _row_changed(rowIdx);
     _currentRow = rowIdxUp;
     if (not from_move_down) {
         grab_focus();
@@ -344,53 +477,27 @@ bool CtTableLight::_on_cell_key_press_alt_or_ctrl_enter()
 
 bool CtTableLight::_row_sort(const bool sortAsc)
 {
-    auto f_need_swap = [sortAsc, this](Gtk::TreeModel::iterator& l, Gtk::TreeModel::iterator& r)->bool{
-        const size_t minCols = get_num_columns();
-        for (size_t c = 0; c < minCols; ++c) {
-            const int cmpResult = CtStrUtil::natural_compare((*l)[_pColumns->columnsText.at(c)],
-                                                             (*r)[_pColumns->columnsText.at(c)]);
-            if (0 != cmpResult) {
-                return sortAsc ? cmpResult > 0 : cmpResult < 0;
-            }
-        }
-        return false; // no swap needed as equal
-    };
     exit_cell_edit();
-    const bool retVal = CtMiscUtil::node_siblings_sort(_pListStore,
-                                                       _pListStore->children(),
-                                                       f_need_swap,
-                                                       1u/*start_offset*/);
-    return retVal;
+    const std::vector<size_t> changedRows = _tableStore.rows_sort(sortAsc, 1u/*startRow*/);
+    for (const size_t rowIdx : changedRows) {
+        _row_changed(rowIdx);
+    }
+    return not changedRows.empty();
 }
 
 void CtTableLight::column_add(const size_t afterColIdx, const std::vector<Glib::ustring>* pNewColumn/*= nullptr*/)
 {
-    const size_t currNumCol = get_num_columns();
-    CtTableMatrix tableMatrix;
-    tableMatrix.reserve(get_num_rows());
-    const CtTableLightColumns& cols = get_columns();
-    size_t rowIdx{0u};
-    auto f_action = [&](const Gtk::TreeModel::iterator& treeIter)->bool{
-        Gtk::TreeRow treeRow = *treeIter;
-        tableMatrix.push_back(CtTableRow{});
-        tableMatrix.back().reserve(currNumCol+1u);
-        for (size_t c = 0u; c < currNumCol; ++c) {
-            tableMatrix.back().push_back(new Glib::ustring{treeRow.get_value(cols.columnsText.at(c))});
-            if (afterColIdx == c) {
-                auto pStr = new Glib::ustring{};
-                if (pNewColumn and pNewColumn->size() > rowIdx) {
-                    *pStr = pNewColumn->at(rowIdx);
-                }
-                ++rowIdx;
-                tableMatrix.back().push_back(pStr);
-            }
-        }
-        return false; /* to continue */
-    };
+    const size_t newColIdx = std::min(afterColIdx + 1u, get_num_columns());
     exit_cell_edit();
-    _pListStore->foreach_iter(f_action);
-    _colWidths.insert(_colWidths.begin()+afterColIdx+1, 0);
-    _reset(tableMatrix);
+    _tableStore.column_insert(newColIdx);
+    if (pNewColumn) {
+        const size_t numRows = std::min(get_num_rows(), pNewColumn->size());
+        for (size_t r = 0u; r < numRows; ++r) {
+            _tableStore.set(r, newColIdx, pNewColumn->at(r).raw());
+        }
+    }
+    _colWidths.insert(_colWidths.begin()+newColIdx, 0);
+    _reset_view();
 }
 
 void CtTableLight::column_delete(const size_t colIdx)
@@ -399,24 +506,10 @@ void CtTableLight::column_delete(const size_t colIdx)
     if (1u == currNumCol or colIdx >= currNumCol) {
         return;
     }
-    CtTableMatrix tableMatrix;
-    tableMatrix.reserve(get_num_rows());
-    const CtTableLightColumns& cols = get_columns();
-    auto f_action = [&](const Gtk::TreeModel::iterator& treeIter)->bool{
-        Gtk::TreeRow treeRow = *treeIter;
-        tableMatrix.push_back(CtTableRow{});
-        tableMatrix.back().reserve(currNumCol-1u);
-        for (size_t c = 0u; c < currNumCol; ++c) {
-            if (colIdx != c) {
-                tableMatrix.back().push_back(new Glib::ustring{treeRow.get_value(cols.columnsText.at(c))});
-            }
-        }
-        return false; /* to continue */
-    };
     exit_cell_edit();
-    _pListStore->foreach_iter(f_action);
+    _tableStore.column_delete(colIdx);
     _colWidths.erase(_colWidths.begin()+colIdx);
-    _reset(tableMatrix);
+    _reset_view();
     if (_currentColumn == get_num_columns()) {
         --_currentColumn;
     }
@@ -425,25 +518,14 @@ void CtTableLight::column_delete(const size_t colIdx)
 
 void CtTableLight::column_move_left(const size_t colIdx, const bool from_move_right)
 {
-    if (0 == colIdx) {
+    if (0 == colIdx or colIdx >= get_num_columns()) {
         return;
     }
     const size_t colIdxLeft{colIdx - 1u};
-    const CtTableLightColumns& cols = get_columns();
-    auto f_action = [&](const Gtk::TreeModel::iterator& treeIter)->bool{
-        Gtk::TreeRow treeRow = *treeIter;
-        const Glib::ustring tmpCell = treeRow[cols.columnsText.at(colIdx)];
-        treeRow[cols.columnsText.at(colIdx)] = treeRow.get_value(cols.columnsText.at(colIdxLeft));
-        treeRow[cols.columnsText.at(colIdxLeft)] = tmpCell;
-        return false; /* to continue */
-    };
     exit_cell_edit();
-    _pListStore->foreach_iter(f_action);
+    _tableStore.columns_swap(colIdx, colIdxLeft);
     std::swap(_colWidths[colIdx], _colWidths[colIdxLeft]);
-    if (0 != _colWidths[colIdx]) set_col_width(_colWidths[colIdx], colIdx);
-    else set_col_width_default(_colWidthDefault);
-    if (0 != _colWidths[colIdxLeft]) set_col_width(_colWidths[colIdxLeft], colIdxLeft);
-    else set_col_width_default(_colWidthDefault);
+    _reset_view();
     _currentColumn = colIdxLeft;
     if (not from_move_right) {
         grab_focus();
@@ -492,26 +574,6 @@ void CtTableLight::set_col_width(const int colWidth, std::optional<size_t> optCo
     }
 }
 
-std::string CtTableLight::to_csv() const
-{
-    CtCSV::CtStringTable tbl;
-    tbl.reserve(get_num_rows());
-    const size_t numColumns = get_num_columns();
-    const CtTableLightColumns& cols = get_columns();
-    auto f_action = [&](const Gtk::TreeModel::iterator& treeIter)->bool{
-        Gtk::TreeRow treeRow = *treeIter;
-        std::vector<std::string> row;
-        row.reserve(numColumns);
-        for (size_t c = 0u; c < numColumns; ++c) {
-            row.emplace_back(treeRow.get_value(cols.columnsText.at(c)));
-        }
-        tbl.emplace_back(row);
-        return false; /* to continue */
-    };
-    _pListStore->foreach_iter(f_action);
-    return CtCSV::table_to_csv(tbl);
-}
-
 void CtTableLight::grab_focus() const
 {
     const size_t currRow = current_row();
@@ -591,36 +653,29 @@ int CtTableLight::get_curr_cell_max_offset() const
 
 Glib::ustring CtTableLight::get_cell_text(const size_t rowIdx, const size_t colIdx) const
 {
-    Gtk::TreePath treePath{std::to_string(rowIdx)};
-    Gtk::TreeModel::iterator treeIter = _pListStore->get_iter(treePath);
-    if (not treeIter) {
+    if (rowIdx >= get_num_rows()) {
         spdlog::warn("!! {} row {}", __FUNCTION__, rowIdx);
         return "!?";
     }
-    Gtk::TreeRow treeRow = *treeIter;
-    const CtTableLightColumns& cols = get_columns();
-    if (cols.columnsText.size() <= colIdx) {
+    if (colIdx >= get_num_columns()) {
         spdlog::warn("!! {} col {}", __FUNCTION__, colIdx);
         return "!?";
     }
-    return treeRow[cols.columnsText.at(colIdx)];
+    return std::string{_tableStore.get(rowIdx, colIdx)};
 }
 
 void CtTableLight::set_cell_text(const size_t rowIdx, const size_t colIdx, const Glib::ustring& cell_text)
 {
-    Gtk::TreePath treePath{std::to_string(rowIdx)};
-    Gtk::TreeModel::iterator treeIter = _pListStore->get_iter(treePath);
-    if (not treeIter) {
+    if (rowIdx >= get_num_rows()) {
         spdlog::warn("!! {} row {}", __FUNCTION__, rowIdx);
         return;
     }
-    Gtk::TreeRow treeRow = *treeIter;
-    const CtTableLightColumns& cols = get_columns();
-    if (cols.columnsText.size() <= colIdx) {
+    if (colIdx >= get_num_columns()) {
         spdlog::warn("!! {} col {}", __FUNCTION__, colIdx);
         return;
     }
-    treeRow[cols.columnsText.at(colIdx)] = cell_text;
+    _tableStore.set(rowIdx, colIdx, cell_text.raw());
+    _row_changed(rowIdx);
 }
 
 Glib::ustring CtTableLight::get_line_content(const size_t rowIdx, const size_t colIdx, const int match_end_offset) const
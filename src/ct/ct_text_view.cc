@@ -27,6 +27,10 @@
 #include "ct_actions.h"
 #include "ct_list.h"
 #include "ct_clipboard.h"
+#include "ct_misc_utils.h"
+
+const constexpr int REGION_HIGHL_SLICE_LINES{200};
+const constexpr int REGION_HIGHL_AROUND_LINES{500};
 
 #ifdef HAVE_GSPELL
 std::unordered_map<std::string, GspellChecker*> CtTextView::_static_spell_checkers;
@@ -133,10 +137,18 @@ CtTextView::CtTextView(CtMainWin* pCtMainWin)
     _columnEdit.register_new_cursor_row_col_callback([this](const int r, const int c){
         _pCtStatusBar->new_cursor_pos(r, c);
     });
+    // the vertical adjustment comes with the scrolled window the view is added to
+    _pTextView->property_vadjustment().signal_changed().connect(sigc::mem_fun(*this, &CtTextView::_region_highlight_vadjustment_connect));
+    _region_highlight_vadjustment_connect();
 }
 
 CtTextView::~CtTextView()
 {
+    _regionHighlIdleConn.disconnect();
+    _regionHighlBufferConn.disconnect();
+    for (sigc::connection& sigc_conn : _regionHighlVAdjustmentConn) {
+        sigc_conn.disconnect();
+    }
 #ifdef HAVE_LIBSPELLING
     g_clear_object(&_spellingAdapter);
     g_clear_object(&_spellingChecker);
@@ -377,15 +389,12 @@ void CtTextView::for_event_after_double_click_button12(GdkEvent* event)
          (iter_rect.get_width() < 0/*RTL*/ and (iter_rect.get_x() + iter_rect.get_width()) <= x and x <= iter_rect.get_x()) )
     {
         if (_pCtConfig->doubleClickLink) {
-            auto tags = text_iter.get_tags();
             // check whether we are hovering a link
-            for (auto& tag : tags) {
-                Glib::ustring tag_name = tag->property_name();
-                if (str::startswith(tag_name, CtConst::TAG_LINK)) {
-                    _pCtMainWin->get_ct_actions()->link_clicked(tag_name.substr(5), event->button.button == 2);
-                    text_buffer->place_cursor(text_iter);
-                    return;
-                }
+            const std::string link_property = CtTextIterUtil::get_link_at(text_iter);
+            if (not link_property.empty()) {
+                _pCtMainWin->get_ct_actions()->link_clicked(link_property, event->button.button == 2);
+                text_buffer->place_cursor(text_iter);
+                return;
             }
         }
     }
@@ -440,6 +449,60 @@ void CtTextView::set_buffer(const Glib::RefPtr<Gtk::TextBuffer>& buffer)
     // Setup the markdown filter for a new buffer
     if (_markdown_filter_active()) _md_handler->buffer(get_buffer());
 #endif // MD_AUTO_REPLACEMENT
+
+    _regionHighlBufferConn.disconnect();
+    if (buffer) {
+        _regionHighlBufferConn = buffer->signal_changed().connect(sigc::mem_fun(*this, &CtTextView::queue_region_highlight));
+    }
+    queue_region_highlight();
+}
+
+void CtTextView::queue_region_highlight()
+{
+    if (_regionHighlIdleConn.connected()) {
+        return;
+    }
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = get_buffer();
+    if (pTextBuffer and CtRegionHighlighter::get(pTextBuffer)) {
+        // before the redraw, the slices are small
+        _regionHighlIdleConn = Glib::signal_idle().connect(sigc::mem_fun(*this, &CtTextView::_region_highlight_idle), Glib::PRIORITY_HIGH_IDLE);
+    }
+}
+
+void CtTextView::_region_highlight_vadjustment_connect()
+{
+    for (sigc::connection& sigc_conn : _regionHighlVAdjustmentConn) {
+        sigc_conn.disconnect();
+    }
+    _regionHighlVAdjustmentConn.clear();
+    if (Glib::RefPtr<Gtk::Adjustment> pVAdjustment = _pTextView->get_vadjustment()) {
+        _regionHighlVAdjustmentConn.push_back(pVAdjustment->signal_value_changed().connect(sigc::mem_fun(*this, &CtTextView::queue_region_highlight)));
+        _regionHighlVAdjustmentConn.push_back(pVAdjustment->signal_changed().connect(sigc::mem_fun(*this, &CtTextView::queue_region_highlight)));
+    }
+}
+
+bool CtTextView::_region_highlight_idle()
+{
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = get_buffer();
+    CtRegionHighlighter* pCtRegionHighlighter = pTextBuffer ? CtRegionHighlighter::get(pTextBuffer) : nullptr;
+    if (not pCtRegionHighlighter) {
+        return false; /* false to disconnect */
+    }
+    Gdk::Rectangle visible_rect;
+    _pTextView->get_visible_rect(visible_rect);
+    Gtk::TextIter iter_top, iter_bottom;
+    int line_top{0};
+    _pTextView->get_line_at_y(iter_top, visible_rect.get_y(), line_top);
+    _pTextView->get_line_at_y(iter_bottom, visible_rect.get_y() + visible_rect.get_height(), line_top);
+    const int line_first = iter_top.get_line();
+    const int line_last = iter_bottom.get_line();
+    // the visible lines first, then the ones around them for the next scrolls
+    if (pCtRegionHighlighter->highlight_lines(line_first, line_last, REGION_HIGHL_SLICE_LINES)) {
+        return true; /* true to continue */
+    }
+    return pCtRegionHighlighter->highlight_lines(line_first - REGION_HIGHL_AROUND_LINES,
+                                                 line_last + REGION_HIGHL_AROUND_LINES,
+                                                 REGION_HIGHL_SLICE_LINES);
 }
 
 #ifdef HAVE_LIBSPELLING
@@ -511,16 +574,13 @@ void CtTextView::for_event_after_button_press(GdkEvent* event)
         if ( (iter_rect.get_width() >= 0/*LTR*/ and iter_rect.get_x() <= x and x <= (iter_rect.get_x() + iter_rect.get_width())) or
              (iter_rect.get_width() < 0/*RTL*/ and (iter_rect.get_x() + iter_rect.get_width()) <= x and x <= iter_rect.get_x()) )
         {
-            auto tags = text_iter.get_tags();
             // check whether we are hovering a link
-            for (auto& tag : tags) {
-                Glib::ustring tag_name = tag->property_name();
-                if (str::startswith(tag_name, CtConst::TAG_LINK)) {
-                    if (not _pCtConfig->doubleClickLink) {
-                        _pCtMainWin->get_ct_actions()->link_clicked(tag_name.substr(5), event->button.button == 2);
-                    }
-                    return;
+            const std::string link_property = CtTextIterUtil::get_link_at(text_iter);
+            if (not link_property.empty()) {
+                if (not _pCtConfig->doubleClickLink) {
+                    _pCtMainWin->get_ct_actions()->link_clicked(link_property, event->button.button == 2);
                 }
+                return;
             }
             if (CtList{_pCtConfig, text_buffer}.is_list_todo_beginning(text_iter)) {
                 if (_pCtMainWin->get_ct_actions()->_is_curr_node_not_read_only_or_error()) {
@@ -810,16 +870,11 @@ void CtTextView::cursor_and_tooltips_handler(int x, int y)
             _pTextView->set_tooltip_text("");
             return;
         }
-        auto tags = text_iter.get_tags();
-        bool find_link = false;
-        for (auto tag : tags) {
-            Glib::ustring tag_name = tag->property_name();
-            if (str::startswith(tag_name, CtConst::TAG_LINK)) {
-                find_link = true;
-                hovering_link_iter_offset = text_iter.get_offset();
-                tooltip = _pCtMainWin->sourceview_hovering_link_get_tooltip(tag_name.substr(5));
-                break;
-            }
+        const std::string link_property = CtTextIterUtil::get_link_at(text_iter);
+        const bool find_link = not link_property.empty();
+        if (find_link) {
+            hovering_link_iter_offset = text_iter.get_offset();
+            tooltip = _pCtMainWin->sourceview_hovering_link_get_tooltip(link_property);
         }
         if (not find_link) {
             Gtk::TextIter iter_anchor = text_iter;
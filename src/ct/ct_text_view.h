@@ -74,6 +74,8 @@ public:
     void synch_spell_check_change_from_gspell_right_click_menu();
 
     void set_buffer(const Glib::RefPtr<Gtk::TextBuffer>& buffer);
+    // the lines around the visible region of a buffer with a CtRegionHighlighter are highlighted in idle slices
+    void queue_region_highlight();
     CtColEditState column_edit_get_state() const {
         return _columnEdit.get_state();
     }
@@ -114,6 +116,8 @@ private:
     /// Replace the char between iter_start and iter_end with another one
     void          _special_char_replace(Glib::ustring special_char, Gtk::TextIter iter_start, Gtk::TextIter iter_end);
     void          _set_highlight_current_line_enabled(const bool enabled);
+    void          _region_highlight_vadjustment_connect();
+    bool          _region_highlight_idle();
 #ifdef HAVE_LIBSPELLING
     void          _libspelling_rebuild_adapter(GtkTextBuffer* pGtkTextBuffer);
 #endif
@@ -175,4 +179,7 @@ private:
     CtColumnEdit _columnEdit;
     guint32      _todoRotateTime{0};
     std::string  _syntaxHighlighting;
+    sigc::connection              _regionHighlIdleConn;
+    sigc::connection              _regionHighlBufferConn;
+    std::vector<sigc::connection> _regionHighlVAdjustmentConn;
 };
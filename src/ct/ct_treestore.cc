@@ -26,9 +26,19 @@
 #include "ct_treestore.h"
 #include "ct_misc_utils.h"
 #include "ct_storage_control.h"
+#include "ct_storage_xml.h"
 #include "ct_actions.h"
 #include "ct_logging.h"
 
+// GtkSourceView 5 removed begin/end_not_undoable_action
+#if GTK_SOURCE_CHECK_VERSION(5, 0, 0)
+#define CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(buf) /* no-op */
+#define CT_SOURCE_BUFFER_END_NOT_UNDOABLE(buf)   /* no-op */
+#else
+#define CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(buf) gtk_source_buffer_begin_not_undoable_action(buf)
+#define CT_SOURCE_BUFFER_END_NOT_UNDOABLE(buf)   gtk_source_buffer_end_not_undoable_action(buf)
+#endif
+
 #if GTKMM_MAJOR_VERSION >= 4
 namespace {
 void gtk4_refresh_anchored_widgets(Gtk::TextView& textView,
@@ -101,19 +111,34 @@ CtTreeIter CtTreeIter::first_child() const
     return CtTreeIter{};
 }
 
+CtNodeRowCache* CtTreeIter::_get_row_cache() const
+{
+    return _pCtMainWin->get_tree_store().get_row_cache(*this);
+}
+
+CtNodeRowCache* CtTreeIter::_get_data_holder_row_cache() const
+{
+    return _pCtMainWin->get_tree_store().get_row_cache_data_holder(*this);
+}
+
+CtTreeIter CtTreeIter::_get_shared_master() const
+{
+    const CtNodeRowCache* pRowCache = _get_row_cache();
+    if (pRowCache->sharedNodesMasterId <= 0) {
+        return CtTreeIter{};
+    }
+    const CtNodeRowCache* pDataHolder = _get_data_holder_row_cache();
+    if (pDataHolder == pRowCache) {
+        // master not found, the node was reset to non shared
+        return CtTreeIter{};
+    }
+    return CtTreeIter{pDataHolder->treeIter, _pColumns, _pCtMainWin};
+}
+
 bool CtTreeIter::get_node_read_only() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_read_only();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colNodeIsReadOnly);
+        return _get_data_holder_row_cache()->isReadOnly;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return false;
@@ -122,17 +147,9 @@ bool CtTreeIter::get_node_read_only() const
 void CtTreeIter::set_node_read_only(const bool val)
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                masterIter.set_node_read_only(val);
-                return;
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        (*this)->set_value(_pColumns->colNodeIsReadOnly, val);
+        CtNodeRowCache* pDataHolder = _get_data_holder_row_cache();
+        pDataHolder->treeIter->set_value(_pColumns->colNodeIsReadOnly, val);
+        pDataHolder->isReadOnly = val;
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -142,7 +159,7 @@ void CtTreeIter::set_node_read_only(const bool val)
 gint64 CtTreeIter::get_node_id() const
 {
     if (*this) {
-        return (*this)->get_value(_pColumns->colNodeUniqueId);
+        return _get_row_cache()->nodeId;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return -1;
@@ -151,7 +168,33 @@ gint64 CtTreeIter::get_node_id() const
 void CtTreeIter::set_node_id(const gint64 new_id)
 {
     if (*this) {
+        const gint64 prevNodeId = get_node_id();
+        CtTreeStore& ctTreeStore = _pCtMainWin->get_tree_store();
         (*this)->set_value(_pColumns->colNodeUniqueId, new_id);
+        ctTreeStore.row_cache_reload(*this);
+        if (get_node_shared_master_id() <= 0) {
+            if (get_node_buffer_already_loaded()) {
+                ctTreeStore.link_index_set_dirty(new_id);
+                ctTreeStore.node_stats_drop(new_id);
+            }
+            else {
+                // the entries go with the node rather than being extracted again from a buffer to load
+                ctTreeStore.link_index_copy(prevNodeId, new_id);
+                ctTreeStore.node_stats_copy(prevNodeId, new_id);
+            }
+        }
+        ctTreeStore.tag_index_remove(prevNodeId);
+        CtTreeIter prevIter = ctTreeStore.get_node_from_node_id(prevNodeId);
+        if (prevIter) {
+            // the tags of the other node with the previous id are back in the index
+            ctTreeStore.tag_index_update(prevIter);
+        }
+        else {
+            // removed from the index since no node has it anymore
+            ctTreeStore.link_index_set_dirty(prevNodeId);
+            ctTreeStore.node_stats_drop(prevNodeId);
+        }
+        ctTreeStore.tag_index_update(*this);
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -161,7 +204,7 @@ void CtTreeIter::set_node_id(const gint64 new_id)
 gint64 CtTreeIter::get_node_shared_master_id() const
 {
     if (*this) {
-        return (*this)->get_value(_pColumns->colSharedNodesMasterId);
+        return _get_row_cache()->sharedNodesMasterId;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return -1;
@@ -171,6 +214,8 @@ void CtTreeIter::set_node_shared_master_id(const gint64 new_master_id)
 {
     if (*this) {
         (*this)->set_value(_pColumns->colSharedNodesMasterId, new_master_id);
+        _pCtMainWin->get_tree_store().row_cache_reload(*this);
+        _pCtMainWin->get_tree_store().tag_index_update(*this);
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -180,11 +225,7 @@ void CtTreeIter::set_node_shared_master_id(const gint64 new_master_id)
 gint64 CtTreeIter::get_node_id_data_holder() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            return masterId;
-        }
-        return (*this)->get_value(_pColumns->colNodeUniqueId);
+        return _get_data_holder_row_cache()->nodeId;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return -1;
@@ -208,7 +249,7 @@ std::vector<gint64> CtTreeIter::get_children_node_ids() const
 gint64 CtTreeIter::get_node_sequence() const
 {
     if (*this) {
-        return (*this)->get_value(_pColumns->colNodeSequence);
+        return _get_row_cache()->sequence;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return -1;
@@ -217,16 +258,7 @@ gint64 CtTreeIter::get_node_sequence() const
 bool CtTreeIter::get_node_is_bold() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_is_bold();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return get_is_bold_from_pango_weight((*this)->get_value(_pColumns->colWeight));
+        return _get_data_holder_row_cache()->isBold;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return false;
@@ -235,16 +267,7 @@ bool CtTreeIter::get_node_is_bold() const
 bool CtTreeIter::get_node_is_excluded_from_search() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_is_excluded_from_search();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        const bool exclude = (*this)->get_value(_pColumns->colNodeIsExcludedFromSearch);
+        const bool exclude = _get_data_holder_row_cache()->excludeMeFromSearch;
         if (exclude and not _hitExclusionFromSearch) {
             _hitExclusionFromSearch = true;
         }
@@ -258,6 +281,7 @@ void CtTreeIter::set_node_is_excluded_from_search(const bool val)
 {
     if (*this) {
         (*this)->set_value(_pColumns->colNodeIsExcludedFromSearch, val);
+        _get_row_cache()->excludeMeFromSearch = val;
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -267,16 +291,7 @@ void CtTreeIter::set_node_is_excluded_from_search(const bool val)
 bool CtTreeIter::get_node_children_are_excluded_from_search() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_children_are_excluded_from_search();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        const bool exclude = (*this)->get_value(_pColumns->colNodeChildrenAreExcludedFromSearch);
+        const bool exclude = _get_data_holder_row_cache()->excludeChildrenFromSearch;
         if (exclude and not _hitExclusionFromSearch) {
             _hitExclusionFromSearch = true;
         }
@@ -290,6 +305,7 @@ void CtTreeIter::set_node_children_are_excluded_from_search(const bool val)
 {
     if (*this) {
         (*this)->set_value(_pColumns->colNodeChildrenAreExcludedFromSearch, val);
+        _get_row_cache()->excludeChildrenFromSearch = val;
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -308,16 +324,7 @@ Glib::RefPtr<Gdk::Pixbuf> CtTreeIter::get_node_icon() const
 guint16 CtTreeIter::get_node_custom_icon_id() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_custom_icon_id();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colCustomIconId);
+        return _get_data_holder_row_cache()->customIconId;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return 0u;
@@ -326,16 +333,7 @@ guint16 CtTreeIter::get_node_custom_icon_id() const
 Glib::ustring CtTreeIter::get_node_name() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_name();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colNodeName);
+        return _get_data_holder_row_cache()->name;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return "";
@@ -344,17 +342,10 @@ Glib::ustring CtTreeIter::get_node_name() const
 void CtTreeIter::set_node_name(const Glib::ustring& node_name)
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                masterIter.set_node_name(node_name);
-                return;
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        (*this)->set_value(_pColumns->colNodeName, node_name);
+        CtNodeRowCache* pDataHolder = _get_data_holder_row_cache();
+        pDataHolder->treeIter->set_value(_pColumns->colNodeName, node_name);
+        pDataHolder->name = node_name;
+        _pCtMainWin->get_tree_store().nodes_match_index_on_rename(pDataHolder->nodeId);
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -364,16 +355,7 @@ void CtTreeIter::set_node_name(const Glib::ustring& node_name)
 Glib::ustring CtTreeIter::get_node_tags() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_tags();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colNodeTags);
+        return _get_data_holder_row_cache()->tags;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return "";
@@ -382,16 +364,7 @@ Glib::ustring CtTreeIter::get_node_tags() const
 std::string CtTreeIter::get_node_foreground() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_foreground();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colForeground);
+        return _get_data_holder_row_cache()->foreground;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return "";
@@ -400,16 +373,7 @@ std::string CtTreeIter::get_node_foreground() const
 std::string CtTreeIter::get_node_syntax_highlighting() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_syntax_highlighting();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colSyntaxHighlighting);
+        return _get_data_holder_row_cache()->syntax;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return "";
@@ -434,16 +398,7 @@ bool CtTreeIter::get_node_is_text() const
 gint64 CtTreeIter::get_node_creating_time() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_creating_time();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colTsCreation);
+        return _get_data_holder_row_cache()->tsCreation;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return 0;
@@ -452,16 +407,7 @@ gint64 CtTreeIter::get_node_creating_time() const
 gint64 CtTreeIter::get_node_modification_time() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_modification_time();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        return (*this)->get_value(_pColumns->colTsLastSave);
+        return _get_data_holder_row_cache()->tsLastSave;
     }
     spdlog::error("!! {}", __FUNCTION__);
     return 0;
@@ -470,17 +416,9 @@ gint64 CtTreeIter::get_node_modification_time() const
 void CtTreeIter::set_node_modification_time(const gint64 modification_time)
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                masterIter.set_node_modification_time(modification_time);
-                return;
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
-        }
-        (*this)->set_value(_pColumns->colTsLastSave, modification_time);
+        CtNodeRowCache* pDataHolder = _get_data_holder_row_cache();
+        pDataHolder->treeIter->set_value(_pColumns->colTsLastSave, modification_time);
+        pDataHolder->tsLastSave = modification_time;
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -491,6 +429,7 @@ void CtTreeIter::set_node_sequence(gint64 num)
 {
     if (*this) {
         (*this)->set_value(_pColumns->colNodeSequence, num);
+        _get_row_cache()->sequence = num;
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -500,19 +439,15 @@ void CtTreeIter::set_node_sequence(gint64 num)
 void CtTreeIter::set_node_text_buffer(Glib::RefPtr<Gtk::TextBuffer> new_buffer, const std::string& new_syntax_highlighting)
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                masterIter.set_node_text_buffer(new_buffer, new_syntax_highlighting);
-                return;
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            masterIter.set_node_text_buffer(new_buffer, new_syntax_highlighting);
+            return;
         }
         remove_all_embedded_widgets();
         (*this)->set_value(_pColumns->rColTextBuffer, new_buffer);
         (*this)->set_value(_pColumns->colSyntaxHighlighting, new_syntax_highlighting);
+        _get_row_cache()->syntax = new_syntax_highlighting;
         pending_edit_db_node_buff();
         pending_edit_db_node_prop();
     }
@@ -524,14 +459,9 @@ void CtTreeIter::set_node_text_buffer(Glib::RefPtr<Gtk::TextBuffer> new_buffer,
 Glib::RefPtr<Gtk::TextBuffer> CtTreeIter::get_node_text_buffer() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_text_buffer();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            return masterIter.get_node_text_buffer();
         }
         Glib::RefPtr<Gtk::TextBuffer> rRetTextBuffer;
         const Gtk::TreeModel::iterator& self = *this;
@@ -544,9 +474,17 @@ Glib::RefPtr<Gtk::TextBuffer> CtTreeIter::get_node_text_buffer() const
                 const gint64 nodeId = get_node_id();
                 const std::string nodeSyntaxHighl = get_node_syntax_highlighting();
                 CtStorageControl* pCtStorageControl = _pCtMainWin->get_ct_storage();
-                rRetTextBuffer = pCtStorageControl->get_delayed_text_buffer(nodeId,
-                                                                            nodeSyntaxHighl,
-                                                                            anchoredWidgetList);
+                // a node imported and not yet saved is not in the storage
+                rRetTextBuffer = _pCtMainWin->get_tree_store().imported_content_to_buffer(nodeId, anchoredWidgetList);
+                if (not rRetTextBuffer) {
+                    // the rich text may have been parsed already while idle
+                    CtPreparedRichText preparedRichText;
+                    const bool prepared = _pCtMainWin->get_tree_store().nodes_prefetch_take_prepared(nodeId, preparedRichText);
+                    rRetTextBuffer = pCtStorageControl->get_delayed_text_buffer(nodeId,
+                                                                                nodeSyntaxHighl,
+                                                                                anchoredWidgetList,
+                                                                                prepared ? &preparedRichText : nullptr);
+                }
                 if (not rRetTextBuffer) {
                     Glib::ustring error;
                     if (not pCtStorageControl->try_reopen(error)) {
@@ -570,14 +508,9 @@ Glib::RefPtr<Gtk::TextBuffer> CtTreeIter::get_node_text_buffer() const
 bool CtTreeIter::get_node_buffer_already_loaded() const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_node_buffer_already_loaded();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            return masterIter.get_node_buffer_already_loaded();
         }
         return static_cast<bool>((*this)->get_value(_pColumns->rColTextBuffer));
     }
@@ -598,15 +531,10 @@ bool CtTreeIter::get_node_buffer_already_loaded() const
 void CtTreeIter::remove_all_embedded_widgets()
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                masterIter.remove_all_embedded_widgets();
-                return;
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            masterIter.remove_all_embedded_widgets();
+            return;
         }
         (void)get_node_text_buffer(); // ensure buffer/widgets loaded
         for (CtAnchoredWidget* pWidget : (*this)->get_value(_pColumns->colAnchoredWidgets)) {
@@ -622,14 +550,9 @@ void CtTreeIter::remove_all_embedded_widgets()
 std::list<CtAnchoredWidget*> CtTreeIter::get_anchored_widgets_fast(const char doSort) const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_anchored_widgets_fast();
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            return masterIter.get_anchored_widgets_fast();
         }
         (void)get_node_text_buffer(); // ensure buffer/widgets loaded
         // remove invalid widgets (deleted from buffer)
@@ -679,20 +602,14 @@ std::list<CtAnchoredWidget*> CtTreeIter::get_anchored_widgets(const int start_of
                                                               const bool also_links/*= false*/) const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_anchored_widgets(start_offset, end_offset);
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            return masterIter.get_anchored_widgets(start_offset, end_offset);
         }
         Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = get_node_text_buffer(); // ensure buffer/widgets loaded
         std::list<CtAnchoredWidget*> retAnchoredWidgetsList;
-        if ((*this)->get_value(_pColumns->colAnchoredWidgets).size() > 0 or also_links) {
+        if ((*this)->get_value(_pColumns->colAnchoredWidgets).size() > 0) {
             Gtk::TextIter curr_iter = start_offset >= 0 ? pTextBuffer->get_iter_at_offset(start_offset) : pTextBuffer->begin();
-            Glib::ustring lastLinkTagName;
             do {
                 if (end_offset >= 0 and curr_iter.get_offset() > end_offset) {
                     break;
@@ -706,26 +623,34 @@ std::list<CtAnchoredWidget*> CtTreeIter::get_anchored_widgets(const int start_of
                         retAnchoredWidgetsList.push_back(pCtAnchoredWidget);
                     }
                 }
-                else if (also_links) {
-                    // CAREFUL, also_links OPTION NEEDS MANUAL CLEANUP!
-                    std::optional<Glib::ustring> tag_name = CtTextIterUtil::iter_get_tag_startingwith(curr_iter, CtConst::TAG_LINK_PREFIX);
-                    if (tag_name.has_value() and tag_name.value() != lastLinkTagName) {
-                        lastLinkTagName = tag_name.value();
-                        CtLinkEntry link_entry = CtMiscUtil::get_link_entry_from_property(lastLinkTagName.substr(5));
-                        if (CtLinkType::None != link_entry.type) {
-                            Glib::RefPtr<Gtk::TextTag> pTextTag = _pCtMainWin->get_text_tag_table()->lookup(lastLinkTagName);
-                            (void)curr_iter.forward_to_tag_toggle(pTextTag);
-                            (void)curr_iter.backward_char();
-                            auto pCtAnchoredWidget = new CtAnchWidgLink{_pCtMainWin, curr_iter.get_offset(), link_entry,
-                                                                        CtTextIterUtil::get_text_iter_alignment(curr_iter, _pCtMainWin)};
-                            retAnchoredWidgetsList.push_back(pCtAnchoredWidget);
-                            //spdlog::debug("{} +{}", __FUNCTION__, link_entry.get_target_searchable().c_str());
-                        }
-                    }
-                }
             }
             while (curr_iter.forward_char());
         }
+        if (also_links) {
+            // CAREFUL, also_links OPTION NEEDS MANUAL CLEANUP!
+            // the links are listed at the offset of their last char, in order with the widgets
+            std::list<CtAnchoredWidget*> linksList;
+            CtLinkTable::get(pTextBuffer)->for_each([&](const Gtk::TextIter& iter_start,
+                                                        const Gtk::TextIter& iter_end,
+                                                        const std::string& link_property){
+                if ((start_offset >= 0 and iter_end.get_offset() <= start_offset) or
+                    (end_offset >= 0 and iter_start.get_offset() > end_offset) or
+                    CtTextIterUtil::get_link_at(iter_start).empty())
+                {
+                    return;
+                }
+                CtLinkEntry link_entry = CtMiscUtil::get_link_entry_from_property(link_property);
+                if (CtLinkType::None != link_entry.type) {
+                    Gtk::TextIter iter_last{iter_end};
+                    (void)iter_last.backward_char();
+                    linksList.push_back(new CtAnchWidgLink{_pCtMainWin, iter_last.get_offset(), link_entry,
+                                                           CtTextIterUtil::get_text_iter_alignment(iter_last, _pCtMainWin)});
+                }
+            });
+            retAnchoredWidgetsList.merge(linksList, [](CtAnchoredWidget* pLeft, CtAnchoredWidget* pRight){
+                return pLeft->getOffset() < pRight->getOffset();
+            });
+        }
         return retAnchoredWidgetsList;
     }
     spdlog::error("!! {}", __FUNCTION__);
@@ -735,14 +660,9 @@ std::list<CtAnchoredWidget*> CtTreeIter::get_anchored_widgets(const int start_of
 CtAnchoredWidget* CtTreeIter::get_anchored_widget(Glib::RefPtr<Gtk::TextChildAnchor> pChildAnchor) const
 {
     if (*this) {
-        const gint64 masterId = (*this)->get_value(_pColumns->colSharedNodesMasterId);
-        if (masterId > 0) {
-            CtTreeIter masterIter = _pCtMainWin->get_tree_store().get_node_from_node_id(masterId);
-            if (masterIter) {
-                return masterIter.get_anchored_widget(pChildAnchor);
-            }
-            spdlog::error("!! {} master {}", __FUNCTION__, masterId);
-            (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
+        CtTreeIter masterIter = _get_shared_master();
+        if (masterIter) {
+            return masterIter.get_anchored_widget(pChildAnchor);
         }
         for (CtAnchoredWidget* pCtAnchoredWidget : (*this)->get_value(_pColumns->colAnchoredWidgets)) {
             if (pChildAnchor == pCtAnchoredWidget->getTextChildAnchor()) {
@@ -783,20 +703,477 @@ const char* CtTreeIter::get_cherrytree_filepath() const
 
 CtTreeStore::CtTreeStore(CtMainWin* pCtMainWin)
  : _pCtMainWin{pCtMainWin}
+ , _nodesPrefetch{pCtMainWin}
 {
     _rTreeStore = Gtk::TreeStore::create(_columns);
+    _rTreeStore->signal_row_deleted().connect(sigc::mem_fun(*this, &CtTreeStore::_on_row_deleted));
+    _rTreeStore->signal_row_inserted().connect(sigc::mem_fun(*this, &CtTreeStore::_on_row_inserted));
 }
 
 CtTreeStore::~CtTreeStore()
 {
+    _realizeConnection.disconnect();
     _iter_delete_anchored_widgets(_rTreeStore->children());
     for (sigc::connection& sigc_conn : _curr_node_sigc_conn) {
         sigc_conn.disconnect();
     }
 }
 
+void CtTreeStore::_on_row_deleted(const Gtk::TreeModel::Path& path)
+{
+    // the row is already gone, we cannot tell which entries referred to it
+    _rowsCache.clear();
+    _nodeIdIters.clear();
+    _nodeIdItersValid = false;
+    _nodesMatchIndex.clear();
+    _nodesMatchIndexValid = false;
+    if (not _subtreeNodesCounts.empty()) {
+        Gtk::TreeModel::Path parentPath{path};
+        if (parentPath.size() > 1 and parentPath.up()) {
+            _subtree_nodes_counts_drop_ancestors(_rTreeStore->get_iter(parentPath));
+        }
+    }
+}
+
+void CtTreeStore::_on_row_inserted(const Gtk::TreeModel::Path& /*path*/, const Gtk::TreeModel::iterator& treeIter)
+{
+    // a moved node is removed and inserted again so this covers moves as well
+    if (not _subtreeNodesCounts.empty()) {
+        _subtree_nodes_counts_drop_ancestors(treeIter);
+    }
+}
+
+void CtTreeStore::_subtree_nodes_counts_drop_ancestors(Gtk::TreeModel::iterator treeIter)
+{
+    // a new row may reuse the key of a deleted one, so the row itself goes as well
+    while (treeIter) {
+        _subtreeNodesCounts.erase(treeIter.gobj()->user_data);
+        treeIter = treeIter->parent();
+    }
+}
+
+size_t CtTreeStore::get_subtree_nodes_count(const Gtk::TreeModel::iterator& treeIter)
+{
+    const gpointer rowKey = treeIter.gobj()->user_data;
+    auto it = _subtreeNodesCounts.find(rowKey);
+    if (_subtreeNodesCounts.end() != it) {
+        return it->second;
+    }
+    size_t count{0};
+    for (Gtk::TreeModel::iterator childIter : treeIter->children()) {
+        count += 1 + get_subtree_nodes_count(childIter);
+    }
+    _subtreeNodesCounts[rowKey] = count;
+    return count;
+}
+
+const CtMatchIndex& CtTreeStore::get_nodes_match_index()
+{
+    if (not _nodesMatchIndexValid) {
+        _nodesMatchIndex.clear();
+        gint64 order{0};
+        for (Gtk::TreeModel::iterator treeIter : _rTreeStore->children()) {
+            _nodes_match_index_add(treeIter, nullptr, &order);
+        }
+        _nodesMatchIndexValid = true;
+    }
+    return _nodesMatchIndex;
+}
+
+void CtTreeStore::nodes_match_index_update(const Gtk::TreeModel::iterator& treeIter)
+{
+    if (not _nodesMatchIndexValid) {
+        return;
+    }
+    Gtk::TreeModel::iterator parentIter = treeIter->parent();
+    if (not parentIter) {
+        _nodes_match_index_add(treeIter, nullptr, nullptr);
+        return;
+    }
+    const CtMatchIndex::Entry* pParentEntry = _nodesMatchIndex.get(parentIter->get_value(_columns.colNodeUniqueId));
+    if (not pParentEntry) {
+        // parent not indexed yet, rebuild on next use
+        _nodesMatchIndexValid = false;
+        return;
+    }
+    const std::string parentPath = pParentEntry->path;
+    _nodes_match_index_add(treeIter, &parentPath, nullptr);
+}
+
+void CtTreeStore::nodes_match_index_on_rename(const gint64 nodeIdDataHolder)
+{
+    if (not _nodesMatchIndexValid) {
+        return;
+    }
+    // the shared nodes display the name of their master
+    std::vector<gint64> nodeIds = _nodesMatchIndex.get_ids_in_group(nodeIdDataHolder);
+    nodeIds.push_back(nodeIdDataHolder);
+    for (const gint64 nodeId : nodeIds) {
+        CtTreeIter ctTreeIter = get_node_from_node_id(nodeId);
+        if (ctTreeIter) {
+            nodes_match_index_update(ctTreeIter);
+        }
+    }
+}
+
+void CtTreeStore::_nodes_match_index_add(const Gtk::TreeModel::iterator& treeIter, const std::string* pFoldedParentPath, gint64* pOrder)
+{
+    CtTreeIter ctTreeIter = to_ct_tree_iter(treeIter);
+    const Glib::ustring name = ctTreeIter.get_node_name();
+    std::string foldedPath = CtMatchIndex::fold(str::trim(name));
+    if (pFoldedParentPath) {
+        foldedPath = *pFoldedParentPath + " / " + foldedPath;
+    }
+    _nodesMatchIndex.set(ctTreeIter.get_node_id(),
+                         CtMatchIndex::fold(name),
+                         foldedPath,
+                         ctTreeIter.get_node_shared_master_id(),
+                         pOrder ? (*pOrder)++ : -1);
+    for (Gtk::TreeModel::iterator childIter : treeIter->children()) {
+        _nodes_match_index_add(childIter, &foldedPath, pOrder);
+    }
+}
+
+const CtLinkIndex& CtTreeStore::get_link_index()
+{
+    for (const gint64 nodeId : _linkIndexDirty) {
+        CtTreeIter ctTreeIter = get_node_from_node_id(nodeId);
+        if (not ctTreeIter) {
+            _linkIndex.remove_node(nodeId);
+            continue;
+        }
+        CtLinkIndex::NodeData nodeData;
+        _link_index_node_from_buffer(ctTreeIter, nodeData);
+        _linkIndex.set_node(nodeId, std::move(nodeData));
+    }
+    _linkIndexDirty.clear();
+    return _linkIndex;
+}
+
+void CtTreeStore::link_index_set_node(const gint64 nodeIdDataHolder, CtLinkIndex::NodeData nodeData)
+{
+    _linkIndex.set_node(nodeIdDataHolder, std::move(nodeData));
+    _linkIndexDirty.erase(nodeIdDataHolder);
+}
+
+void CtTreeStore::link_index_copy(const gint64 fromNodeIdDataHolder, const gint64 toNodeIdDataHolder)
+{
+    if (0 == _linkIndexDirty.count(fromNodeIdDataHolder)) {
+        if (const CtLinkIndex::NodeData* pNodeData = _linkIndex.get_node(fromNodeIdDataHolder)) {
+            link_index_set_node(toNodeIdDataHolder, *pNodeData);
+            return;
+        }
+    }
+    link_index_set_dirty(toNodeIdDataHolder);
+}
+
+bool CtTreeStore::link_index_is_target_missing(const gint64 nodeId, const std::string& anchor)
+{
+    CtTreeIter ctTreeIter = get_node_from_node_id(nodeId);
+    if (not ctTreeIter) {
+        return true;
+    }
+    if (anchor.empty()) {
+        return false;
+    }
+    // the anchors of a shared node are the ones of its master
+    return get_link_index().has_anchor(ctTreeIter.get_node_id_data_holder(), anchor) == false;
+}
+
+std::vector<gint64> CtTreeStore::link_index_get_referrers(const gint64 nodeId)
+{
+    std::vector<gint64> referrers = get_link_index().get_referrers(nodeId);
+    referrers.erase(std::remove_if(referrers.begin(), referrers.end(), [this](const gint64 referrerId){
+        return not get_node_from_node_id(referrerId);
+    }), referrers.end());
+    return referrers;
+}
+
+std::vector<CtLinkIndex::BrokenLink> CtTreeStore::link_index_get_broken_links()
+{
+    std::vector<CtLinkIndex::BrokenLink> brokenLinks = get_link_index().get_broken_links([this](const gint64 nodeId){
+        return static_cast<bool>(get_node_from_node_id(nodeId));
+    });
+    // a link to a shared node is resolved through the anchors of its master
+    brokenLinks.erase(std::remove_if(brokenLinks.begin(), brokenLinks.end(), [this](const CtLinkIndex::BrokenLink& brokenLink){
+        return not brokenLink.missingNode and not link_index_is_target_missing(brokenLink.target.nodeId, brokenLink.target.anchor);
+    }), brokenLinks.end());
+    return brokenLinks;
+}
+
+void CtTreeStore::_link_index_node_from_buffer(CtTreeIter& ctTreeIter, CtLinkIndex::NodeData& nodeData)
+{
+    if (not ctTreeIter.get_node_is_rich_text()) {
+        return;
+    }
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = ctTreeIter.get_node_text_buffer();
+    if (not pTextBuffer) {
+        return;
+    }
+    CtLinkTable::get(pTextBuffer)->for_each([&nodeData](const Gtk::TextIter& iter_start,
+                                                        const Gtk::TextIter&/*iter_end*/,
+                                                        const std::string& link_property){
+        if (not CtTextIterUtil::get_link_at(iter_start).empty()) {
+            CtLinkIndex::add_link_from_property(link_property, nodeData);
+        }
+    });
+    for (CtAnchoredWidget* pCtAnchoredWidget : ctTreeIter.get_anchored_widgets_fast()) {
+        if (auto pCtImageAnchor = dynamic_cast<CtImageAnchor*>(pCtAnchoredWidget)) {
+            nodeData.anchors.insert(pCtImageAnchor->get_anchor_name().raw());
+        }
+        else if (auto pCtImage = dynamic_cast<CtImage*>(pCtAnchoredWidget)) {
+            if (not pCtImage->get_link().empty()) {
+                CtLinkIndex::add_link_from_property(pCtImage->get_link().raw(), nodeData);
+            }
+        }
+    }
+}
+
+void CtTreeStore::node_stats_copy(const gint64 fromNodeIdDataHolder, const gint64 toNodeIdDataHolder)
+{
+    const auto it = _nodesStats.find(fromNodeIdDataHolder);
+    if (_nodesStats.end() == it) {
+        _nodesStats.erase(toNodeIdDataHolder);
+        return;
+    }
+    const CtNodeStats nodeStats = it->second;
+    _nodesStats[toNodeIdDataHolder] = nodeStats;
+}
+
+bool CtTreeStore::node_stats_get(CtTreeIter& ctTreeIter, CtNodeStats& nodeStats)
+{
+    const gint64 nodeIdDataHolder = ctTreeIter.get_node_id_data_holder();
+    const auto it = _nodesStats.find(nodeIdDataHolder);
+    if (_nodesStats.end() != it) {
+        nodeStats = it->second;
+        return true;
+    }
+    if (not _node_stats_from_buffer(ctTreeIter, nodeStats)) {
+        return false;
+    }
+    _nodesStats[nodeIdDataHolder] = nodeStats;
+    return true;
+}
+
+bool CtTreeStore::_node_stats_from_buffer(CtTreeIter& ctTreeIter, CtNodeStats& nodeStats)
+{
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = ctTreeIter.get_node_text_buffer();
+    if (not pTextBuffer) {
+        return false;
+    }
+    size_t numWidgets{0u};
+    for (CtAnchoredWidget* pCtAnchoredWidget : ctTreeIter.get_anchored_widgets_fast()) {
+        size_t widgetBlobBytes{0u};
+        if (auto pCtImageEmbFile = dynamic_cast<CtImageEmbFile*>(pCtAnchoredWidget)) {
+            if (pCtImageEmbFile->get_blob()) {
+                widgetBlobBytes = pCtImageEmbFile->get_blob()->size();
+            }
+        }
+        else if (auto pCtImagePng = dynamic_cast<CtImagePng*>(pCtAnchoredWidget)) {
+            widgetBlobBytes = pCtImagePng->get_raw_blob().size();
+        }
+        nodeStats.add_widget(pCtAnchoredWidget->get_type(), widgetBlobBytes);
+        ++numWidgets;
+    }
+    // every anchored widget takes one char in the buffer
+    const size_t bufferChars = static_cast<size_t>(pTextBuffer->get_char_count());
+    nodeStats.chars = bufferChars > numWidgets ? bufferChars - numWidgets : 0u;
+    nodeStats.words = static_cast<size_t>(CtTextIterUtil::get_words_count(pTextBuffer));
+    return true;
+}
+
+void CtTreeStore::memory_usage_populate(CtMemoryUsage& memoryUsage)
+{
+    using Category = CtMemoryUsage::Category;
+    // GtkTextBTree line, segments and tags toggles
+    constexpr size_t textLineOverhead{96u};
+    auto f_buffer_bytes = [](const Glib::RefPtr<Gtk::TextBuffer>& pTextBuffer)->size_t{
+        return static_cast<size_t>(pTextBuffer->get_char_count()) +
+               static_cast<size_t>(pTextBuffer->get_line_count())*textLineOverhead;
+    };
+    _rTreeStore->foreach_iter([&](const Gtk::TreeModel::iterator& treeIter)->bool{
+        if (treeIter->get_value(_columns.colSharedNodesMasterId) > 0) {
+            return false; /* continue, the shared non master has no buffer of its own */
+        }
+        Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = treeIter->get_value(_columns.rColTextBuffer);
+        if (not pTextBuffer) {
+            return false; /* continue, not loaded */
+        }
+        const gint64 nodeId = treeIter->get_value(_columns.colNodeUniqueId);
+        memoryUsage.add(nodeId, Category::TextBuffer, f_buffer_bytes(pTextBuffer));
+        for (CtAnchoredWidget* pCtAnchoredWidget : treeIter->get_value(_columns.colAnchoredWidgets)) {
+            if (auto pCtImageEmbFile = dynamic_cast<CtImageEmbFile*>(pCtAnchoredWidget)) {
+                const CtEmbFileBlobPtr& pBlob = pCtImageEmbFile->get_blob();
+                if (pBlob and not pBlob->is_spooled()) {
+                    memoryUsage.add_shared(nodeId, Category::EmbFiles, pBlob.get(), pBlob->size());
+                }
+            }
+            else if (auto pCtImage = dynamic_cast<CtImage*>(pCtAnchoredWidget)) {
+                // png and latex, the anchor pixbuf is the shared icon
+                Glib::RefPtr<Gdk::Pixbuf> pPixbuf = pCtImage->get_pixbuf();
+                if (pPixbuf and CtAnchWidgType::ImageAnchor != pCtImage->get_type()) {
+                    memoryUsage.add_shared(nodeId, Category::Images, pPixbuf->gobj(), gdk_pixbuf_get_byte_length(pPixbuf->gobj()));
+                }
+            }
+            else if (auto pCtCodebox = dynamic_cast<CtCodebox*>(pCtAnchoredWidget)) {
+                memoryUsage.add(nodeId, Category::TextBuffer, f_buffer_bytes(pCtCodebox->get_buffer()));
+            }
+            else if (auto pCtTableLight = dynamic_cast<CtTableLight*>(pCtAnchoredWidget)) {
+                memoryUsage.add(nodeId, Category::TextBuffer, pCtTableLight->get_store().get_bytes());
+            }
+            else if (auto pCtTableHeavy = dynamic_cast<CtTableHeavy*>(pCtAnchoredWidget)) {
+                for (size_t rowIdx = 0; rowIdx < pCtTableHeavy->get_num_rows(); ++rowIdx) {
+                    for (size_t colIdx = 0; colIdx < pCtTableHeavy->get_num_columns(); ++colIdx) {
+                        memoryUsage.add(nodeId, Category::TextBuffer, f_buffer_bytes(pCtTableHeavy->get_buffer(rowIdx, colIdx)));
+                    }
+                }
+            }
+        }
+        return false; /* continue */
+    });
+}
+
+bool CtTreeStore::unload_text_buffer(CtTreeIter& ctTreeIter)
+{
+    CtTreeIter dataHolderIter = get_node_from_node_id(ctTreeIter.get_node_id_data_holder());
+    if (not dataHolderIter or not dataHolderIter.get_node_buffer_already_loaded()) {
+        return false;
+    }
+    CtTreeIter currTreeIter = _pCtMainWin->curr_tree_iter();
+    if (currTreeIter and currTreeIter.get_node_id_data_holder() == dataHolderIter.get_node_id()) {
+        return false; // in the text view
+    }
+    if (dataHolderIter.get_node_text_buffer()->get_modified() or
+        _pCtMainWin->get_ct_storage()->get_storage_sync_pending()->nodes_to_write_dict.count(dataHolderIter.get_node_id()))
+    {
+        return false; // the storage does not have the current content
+    }
+    if (_pCtMainWin->get_ct_actions()->get_were_embfiles_opened(dataHolderIter.get_node_id())) {
+        return false; // the embedded files opened externally are synced back to these widgets
+    }
+    if (not _pCtMainWin->get_ct_storage()->restore_delayed_text_buffer(dataHolderIter)) {
+        return false;
+    }
+    for (CtAnchoredWidget* pCtAnchoredWidget : dataHolderIter->get_value(_columns.colAnchoredWidgets)) {
+        delete pCtAnchoredWidget;
+    }
+    dataHolderIter->set_value(_columns.colAnchoredWidgets, std::list<CtAnchoredWidget*>{});
+    dataHolderIter->set_value(_columns.rColTextBuffer, Glib::RefPtr<Gtk::TextBuffer>{});
+    return true;
+}
+
+Glib::RefPtr<Gtk::TextBuffer> CtTreeStore::imported_content_to_buffer(const gint64 nodeId, std::list<CtAnchoredWidget*>& anchoredWidgets)
+{
+    const auto it = _importedContent.find(nodeId);
+    if (_importedContent.end() == it) {
+        return Glib::RefPtr<Gtk::TextBuffer>{};
+    }
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = _pCtMainWin->get_new_text_buffer();
+    xmlpp::DomParser parser;
+    if (CtXmlHelper::safe_parse_memory(parser, it->second)) {
+        #if GTKMM_MAJOR_VERSION < 4
+        auto pGtkSourceBuffer = GTK_SOURCE_BUFFER(pTextBuffer->gobj());
+        #endif
+        CT_SOURCE_BUFFER_BEGIN_NOT_UNDOABLE(pGtkSourceBuffer);
+        CtStorageXmlHelper ctStorageXmlHelper{_pCtMainWin};
+        xmlpp::Element* root_node = parser.get_document()->get_root_node();
+        const xmlpp::Node::NodeList xml_slots = "root" == root_node->get_name() ? root_node->get_children("slot")
+                                                                                : xmlpp::Node::NodeList{root_node};
+        for (xmlpp::Node* xml_slot : xml_slots) {
+            for (xmlpp::Node* child : xml_slot->get_children()) {
+                Gtk::TextIter insert_iter = pTextBuffer->get_insert()->get_iter();
+                ctStorageXmlHelper.get_text_buffer_one_slot_from_xml(pTextBuffer, child, anchoredWidgets, &insert_iter, -1, "");
+            }
+        }
+        CT_SOURCE_BUFFER_END_NOT_UNDOABLE(pGtkSourceBuffer);
+    }
+    else {
+        spdlog::error("!! {} node {}", __FUNCTION__, nodeId);
+    }
+    pTextBuffer->set_modified(false);
+    _importedContent.erase(it);
+    return pTextBuffer;
+}
+
+CtNodeRowCache* CtTreeStore::get_row_cache(const Gtk::TreeModel::iterator& treeIter)
+{
+    // Gtk::TreeStore iters persist for the life of the row and user_data identifies the row
+    const gpointer rowKey = treeIter.gobj()->user_data;
+    auto it = _rowsCache.find(rowKey);
+    if (_rowsCache.end() != it) {
+        return &it->second;
+    }
+    CtNodeRowCache& rowCache = _rowsCache[rowKey];
+    _row_cache_load(treeIter, rowCache);
+    return &rowCache;
+}
+
+CtNodeRowCache* CtTreeStore::get_row_cache_data_holder(const Gtk::TreeModel::iterator& treeIter)
+{
+    CtNodeRowCache* pRowCache = get_row_cache(treeIter);
+    if (pRowCache->sharedNodesMasterId <= 0) {
+        return pRowCache;
+    }
+    if (not pRowCache->pMaster) {
+        CtTreeIter masterIter = get_node_from_node_id(pRowCache->sharedNodesMasterId);
+        if (not masterIter) {
+            spdlog::error("!! {} master {}", __FUNCTION__, pRowCache->sharedNodesMasterId);
+            treeIter->set_value(_columns.colSharedNodesMasterId, static_cast<gint64>(0));
+            pRowCache->sharedNodesMasterId = 0;
+            return pRowCache;
+        }
+        pRowCache->pMaster = get_row_cache(masterIter);
+    }
+    return pRowCache->pMaster;
+}
+
+void CtTreeStore::row_cache_reload(const Gtk::TreeModel::iterator& treeIter)
+{
+    CtNodeRowCache* pRowCache = get_row_cache(treeIter);
+    const gint64 prevNodeId = pRowCache->nodeId;
+    _row_cache_load(treeIter, *pRowCache);
+    if (_nodeIdItersValid and prevNodeId != pRowCache->nodeId) {
+        if (_nodeIdIters.count(prevNodeId) and _nodeIdIters.at(prevNodeId) == treeIter) {
+            // walked again at the next lookup, another row can have the same id (duplicated ids fixed at load)
+            _nodeIdItersValid = false;
+        }
+        else {
+            _nodeIdIters[pRowCache->nodeId] = treeIter;
+        }
+    }
+}
+
+void CtTreeStore::_row_cache_load(const Gtk::TreeModel::iterator& treeIter, CtNodeRowCache& rowCache)
+{
+    const Gtk::TreeRow row = *treeIter;
+    rowCache.treeIter = treeIter;
+    rowCache.pMaster = nullptr; // resolved again on first use
+    rowCache.nodeId = row.get_value(_columns.colNodeUniqueId);
+    rowCache.sharedNodesMasterId = row.get_value(_columns.colSharedNodesMasterId);
+    rowCache.sequence = row.get_value(_columns.colNodeSequence);
+    rowCache.name = row.get_value(_columns.colNodeName);
+    rowCache.syntax = row.get_value(_columns.colSyntaxHighlighting);
+    rowCache.tags = row.get_value(_columns.colNodeTags);
+    rowCache.foreground = row.get_value(_columns.colForeground);
+    rowCache.tsCreation = row.get_value(_columns.colTsCreation);
+    rowCache.tsLastSave = row.get_value(_columns.colTsLastSave);
+    rowCache.customIconId = row.get_value(_columns.colCustomIconId);
+    rowCache.isReadOnly = row.get_value(_columns.colNodeIsReadOnly);
+    rowCache.isBold = CtTreeIter::get_is_bold_from_pango_weight(row.get_value(_columns.colWeight));
+    rowCache.excludeMeFromSearch = row.get_value(_columns.colNodeIsExcludedFromSearch);
+    rowCache.excludeChildrenFromSearch = row.get_value(_columns.colNodeChildrenAreExcludedFromSearch);
+}
+
 void CtTreeStore::pending_rm_db_nodes(const std::vector<gint64>& node_ids)
 {
+    for (const gint64 nodeId : node_ids) {
+        _linkIndex.remove_node(nodeId);
+        _linkIndexDirty.erase(nodeId);
+        _nodesStats.erase(nodeId);
+        _tagIndex.remove_node(nodeId);
+        // the id can be allocated again to a new node
+        _importedContent.erase(nodeId);
+    }
     _pCtMainWin->get_ct_storage()->pending_rm_db_nodes(node_ids);
 }
 
@@ -852,6 +1229,42 @@ void CtTreeStore::treeview_set_tree_path_n_text_cursor(CtTreeView* pTreeView,
     }
 }
 
+void CtTreeStore::bulk_population_begin()
+{
+    if (_bulkPopulationDepth++ > 0 or not _pTreeView) {
+        return;
+    }
+    _bulkRestoreExpColl.clear();
+    _bulkRestoreCursorNodeId = -1;
+    if (_rTreeStore->children().size() > 0) {
+        _bulkRestoreExpColl = treeview_get_tree_expanded_collapsed_string(*_pTreeView);
+        Gtk::TreeModel::iterator selIter = _pTreeView->get_selection()->get_selected();
+        if (selIter) {
+            _bulkRestoreCursorNodeId = selIter->get_value(_columns.colNodeUniqueId);
+        }
+    }
+    _pTreeView->unset_model();
+}
+
+void CtTreeStore::bulk_population_end()
+{
+    if (_bulkPopulationDepth <= 0 or --_bulkPopulationDepth > 0 or not _pTreeView) {
+        return;
+    }
+    _pTreeView->set_model(_rTreeStore);
+    if (not _bulkRestoreExpColl.empty()) {
+        treeview_set_tree_expanded_collapsed_string(_bulkRestoreExpColl, *_pTreeView, false/*nodes_bookm_exp*/);
+        _bulkRestoreExpColl.clear();
+    }
+    if (_bulkRestoreCursorNodeId > 0) {
+        CtTreeIter cursorIter = get_node_from_node_id(_bulkRestoreCursorNodeId);
+        if (cursorIter) {
+            _pTreeView->set_cursor(_rTreeStore->get_path(cursorIter));
+        }
+        _bulkRestoreCursorNodeId = -1;
+    }
+}
+
 std::string CtTreeStore::treeview_get_tree_expanded_collapsed_string(Gtk::TreeView& treeView)
 {
     std::vector<std::string> expanded_collapsed_vec;
@@ -893,6 +1306,7 @@ void CtTreeStore::treeview_set_tree_expanded_collapsed_string(const std::string&
 
 void CtTreeStore::tree_view_connect(Gtk::TreeView* pTreeView)
 {
+    _pTreeView = pTreeView;
     pTreeView->set_model(_rTreeStore);
 
     // if change column num, then change CtTreeView::TITLE_COL_NUM
@@ -929,6 +1343,8 @@ void CtTreeStore::text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* p
 {
     auto& textView = pCtTextView->mm();
     if (not static_cast<bool>(treeIter)) {
+        _realizeConnection.disconnect();
+        _realizePendingAnchors.clear();
         pCtTextView->set_buffer(Glib::RefPtr<Gtk::TextBuffer>{});
         pCtTextView->set_spell_check(false);
         textView.set_sensitive(false);
@@ -956,31 +1372,23 @@ void CtTreeStore::text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* p
     textView.set_editable(not treeIter.get_node_read_only());
     pCtTextView->cursor_and_tooltips_reset();
 
+    // the widgets not yet added to the text view are added in idle batches, after the text is drawn
+    _realizeConnection.disconnect();
+    _realizePendingAnchors.clear();
+    _realizeSortedTop = -1;
+    _realizeNodeIdDataHolder = treeIter.get_node_id_data_holder();
+    _pRealizeTextView = pCtTextView;
     std::list<CtAnchoredWidget*> anchored_widgets_to_hide;
-#if GTKMM_MAJOR_VERSION >= 4
-    std::list<CtAnchoredWidget*> anchored_widgets_to_relayout;
-#endif
     for (CtAnchoredWidget* pCtAnchoredWidget : treeIter.get_anchored_widgets_fast()) {
         Glib::RefPtr<Gtk::TextChildAnchor> pChildAnchor = pCtAnchoredWidget->getTextChildAnchor();
         if (pChildAnchor) {
             const auto anchorWidgets = pChildAnchor->get_widgets();
             const bool hasThisWidget = std::find(anchorWidgets.begin(), anchorWidgets.end(), pCtAnchoredWidget) != anchorWidgets.end();
             if (not hasThisWidget) {
-                // Gtk::TextIter textIter = pTextBuffer->get_iter_at_child_anchor(pChildAnchor);
-                textView.add_child_at_anchor(*pCtAnchoredWidget, pChildAnchor);
-                pCtAnchoredWidget->apply_width_height(textView.get_allocation().get_width());
-                pCtAnchoredWidget->apply_syntax_highlighting(false/*forceReApply*/);
-    #if GTKMM_MAJOR_VERSION >= 4
-                // GTK4: widgets don't auto-show after add_child_at_anchor
-                pCtAnchoredWidget->show();
-                anchored_widgets_to_relayout.push_back(pCtAnchoredWidget);
-    #endif
-            }
-            else {
-                // this happens if we click on a node that is already selected, not an issue
-                // we simply must not add the same widget to the anchor again
+                _realizePendingAnchors.push_back(pChildAnchor);
             }
-            if (pCtAnchoredWidget->get_hidden()) {
+            else if (pCtAnchoredWidget->get_hidden()) {
+                // this happens if we click on a node that is already selected, or visited before
                 anchored_widgets_to_hide.push_back(pCtAnchoredWidget);
             }
         }
@@ -992,10 +1400,6 @@ void CtTreeStore::text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* p
 #if GTKMM_MAJOR_VERSION < 4 && !defined(GTKMM_DISABLE_DEPRECATED)
     textView.show_all();
 #else
-    Glib::signal_idle().connect([pCtTextView, anchored_widgets_to_relayout]() {
-        gtk4_refresh_anchored_widgets(pCtTextView->mm(), anchored_widgets_to_relayout, "post-load-idle", true/*doWrapToggle*/);
-        return false;
-    });
     // GTK4: queue_draw to ensure proper rendering of text and anchored widgets
     textView.queue_draw();
 #endif
@@ -1005,6 +1409,9 @@ void CtTreeStore::text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* p
     for (CtAnchoredWidget* pCtAnchoredWidget : anchored_widgets_to_hide) {
         pCtAnchoredWidget->hide();
     }
+    if (not _realizePendingAnchors.empty() and not _realizePaused) {
+        _realizeConnection = Glib::signal_idle().connect(sigc::mem_fun(*this, &CtTreeStore::_realize_pending_widgets_step));
+    }
 
     // connect signals
     _curr_node_sigc_conn.push_back(
@@ -1021,8 +1428,17 @@ void CtTreeStore::text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* p
     _curr_node_sigc_conn.push_back(
         pTextBuffer->signal_mark_set().connect(sigc::mem_fun(*this, &CtTreeStore::_on_textbuffer_mark_set), false)
     );
+    _curr_node_sigc_conn.push_back(pTextBuffer->signal_changed().connect(
+        [this, nodeIdDataHolder=treeIter.get_node_id_data_holder()](){ node_stats_drop(nodeIdDataHolder); }));
     if (treeIter.get_node_is_rich_text()) {
         const auto nodeIdDataHolder = treeIter.get_node_id_data_holder();
+        // links and anchors come and go with text, tags and anchored widgets
+        auto f_linkIndexSetDirty = [this, nodeIdDataHolder](){ link_index_set_dirty(nodeIdDataHolder); };
+        _curr_node_sigc_conn.push_back(pTextBuffer->signal_changed().connect(f_linkIndexSetDirty));
+        _curr_node_sigc_conn.push_back(pTextBuffer->signal_apply_tag().connect(
+            [f_linkIndexSetDirty](const Glib::RefPtr<Gtk::TextTag>&, const Gtk::TextIter&, const Gtk::TextIter&){ f_linkIndexSetDirty(); }));
+        _curr_node_sigc_conn.push_back(pTextBuffer->signal_remove_tag().connect(
+            [f_linkIndexSetDirty](const Glib::RefPtr<Gtk::TextTag>&, const Gtk::TextIter&, const Gtk::TextIter&){ f_linkIndexSetDirty(); }));
         _curr_node_sigc_conn.push_back(
             _pCtMainWin->getScrolledwindowText().get_vadjustment()->signal_value_changed().connect([this, nodeIdDataHolder](){
                 _pCtMainWin->get_state_machine().update_curr_state_v_adj_val(nodeIdDataHolder);
@@ -1037,6 +1453,139 @@ void CtTreeStore::text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* p
     }
 }
 
+void CtTreeStore::text_view_realize_pending_widgets(const int up_to_offset/*= -1*/)
+{
+    CtTreeIter treeIter = get_node_from_node_id(_realizeNodeIdDataHolder);
+    if (not treeIter or not _pRealizeTextView) {
+        _realizePendingAnchors.clear();
+        return;
+    }
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = _pRealizeTextView->get_buffer();
+#if GTKMM_MAJOR_VERSION >= 4
+    std::list<CtAnchoredWidget*> anchored_widgets_to_relayout;
+#endif
+    std::vector<Glib::RefPtr<Gtk::TextChildAnchor>> stillPendingAnchors;
+    for (Glib::RefPtr<Gtk::TextChildAnchor>& pChildAnchor : _realizePendingAnchors) {
+        if (pChildAnchor->get_deleted()) {
+            continue;
+        }
+        if (up_to_offset >= 0 and pTextBuffer->get_iter_at_child_anchor(pChildAnchor).get_offset() > up_to_offset) {
+            stillPendingAnchors.push_back(pChildAnchor);
+            continue;
+        }
+        if (CtAnchoredWidget* pCtAnchoredWidget = treeIter.get_anchored_widget(pChildAnchor)) {
+            _realize_anchored_widget(pCtAnchoredWidget, pChildAnchor, _pRealizeTextView->mm());
+#if GTKMM_MAJOR_VERSION >= 4
+            anchored_widgets_to_relayout.push_back(pCtAnchoredWidget);
+#endif
+        }
+    }
+    _realizePendingAnchors.swap(stillPendingAnchors);
+    if (_realizePendingAnchors.empty()) {
+        _realizeConnection.disconnect();
+    }
+#if GTKMM_MAJOR_VERSION >= 4
+    if (not anchored_widgets_to_relayout.empty()) {
+        CtTextView* pCtTextView = _pRealizeTextView;
+        Glib::signal_idle().connect([pCtTextView, anchored_widgets_to_relayout]() {
+            gtk4_refresh_anchored_widgets(pCtTextView->mm(), anchored_widgets_to_relayout, "realize-pending-idle", true/*doWrapToggle*/);
+            return false;
+        });
+    }
+#endif
+}
+
+void CtTreeStore::text_view_realize_pause(const bool pause)
+{
+    _realizePaused = pause;
+    _nodesPrefetch.set_paused(pause);
+    if (pause) {
+        _realizeConnection.disconnect();
+    }
+    else if (not _realizePendingAnchors.empty() and not _realizeConnection.connected()) {
+        _realizeConnection = Glib::signal_idle().connect(sigc::mem_fun(*this, &CtTreeStore::_realize_pending_widgets_step));
+    }
+}
+
+bool CtTreeStore::_realize_pending_widgets_step()
+{
+    CtTreeIter treeIter = _pCtMainWin->curr_tree_iter();
+    if (not treeIter or treeIter.get_node_id_data_holder() != _realizeNodeIdDataHolder or not _pRealizeTextView) {
+        _realizePendingAnchors.clear();
+        return false; /* false to disconnect */
+    }
+    Gtk::TextView& textView = _pRealizeTextView->mm();
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = textView.get_buffer();
+    Gdk::Rectangle visibleRect;
+    textView.get_visible_rect(visibleRect);
+    Gtk::TextIter iterTop, iterBottom;
+    textView.get_iter_at_location(iterTop, visibleRect.get_x(), visibleRect.get_y());
+    const int offsetTop = iterTop.get_offset();
+    if (offsetTop != _realizeSortedTop) {
+        // distance in chars from the text in view, the anchors in view first and then the closest;
+        // sorted again only once scrolled, not at every batch of a node with many widgets
+        textView.get_iter_at_location(iterBottom, visibleRect.get_x() + visibleRect.get_width(), visibleRect.get_y() + visibleRect.get_height());
+        const int offsetBottom = iterBottom.get_offset();
+        std::vector<std::pair<int, Glib::RefPtr<Gtk::TextChildAnchor>>> distAnchors;
+        for (Glib::RefPtr<Gtk::TextChildAnchor>& pChildAnchor : _realizePendingAnchors) {
+            if (not pChildAnchor->get_deleted()) {
+                const int offset = pTextBuffer->get_iter_at_child_anchor(pChildAnchor).get_offset();
+                const int distance = offset < offsetTop ? offsetTop - offset : (offset > offsetBottom ? offset - offsetBottom : 0);
+                distAnchors.push_back(std::make_pair(distance, pChildAnchor));
+            }
+        }
+        std::stable_sort(distAnchors.begin(), distAnchors.end(),
+            [](const auto& left, const auto& right){ return left.first < right.first; });
+        _realizePendingAnchors.clear();
+        for (auto& distAnchor : distAnchors) {
+            _realizePendingAnchors.push_back(distAnchor.second);
+        }
+        _realizeSortedTop = offsetTop;
+    }
+    const auto batchEnd = _realizePendingAnchors.begin() + std::min(REALIZE_WIDGETS_BATCH, _realizePendingAnchors.size());
+    const std::vector<Glib::RefPtr<Gtk::TextChildAnchor>> batchAnchors(_realizePendingAnchors.begin(), batchEnd);
+    _realizePendingAnchors.erase(_realizePendingAnchors.begin(), batchEnd);
+#if GTKMM_MAJOR_VERSION >= 4
+    std::list<CtAnchoredWidget*> anchored_widgets_to_relayout;
+#endif
+    for (const Glib::RefPtr<Gtk::TextChildAnchor>& pChildAnchor : batchAnchors) {
+        if (pChildAnchor->get_deleted()) {
+            continue;
+        }
+        if (CtAnchoredWidget* pCtAnchoredWidget = treeIter.get_anchored_widget(pChildAnchor)) {
+            _realize_anchored_widget(pCtAnchoredWidget, pChildAnchor, textView);
+#if GTKMM_MAJOR_VERSION >= 4
+            anchored_widgets_to_relayout.push_back(pCtAnchoredWidget);
+#endif
+        }
+    }
+#if GTKMM_MAJOR_VERSION >= 4
+    gtk4_refresh_anchored_widgets(textView, anchored_widgets_to_relayout, "realize-step", _realizePendingAnchors.empty()/*doWrapToggle*/);
+#endif
+    return not _realizePendingAnchors.empty();
+}
+
+void CtTreeStore::_realize_anchored_widget(CtAnchoredWidget* pCtAnchoredWidget,
+                                           Glib::RefPtr<Gtk::TextChildAnchor> pChildAnchor,
+                                           Gtk::TextView& textView)
+{
+    const auto anchorWidgets = pChildAnchor->get_widgets();
+    if (std::find(anchorWidgets.begin(), anchorWidgets.end(), pCtAnchoredWidget) == anchorWidgets.end()) {
+        textView.add_child_at_anchor(*pCtAnchoredWidget, pChildAnchor);
+        pCtAnchoredWidget->apply_width_height(textView.get_allocation().get_width());
+        pCtAnchoredWidget->apply_syntax_highlighting(false/*forceReApply*/);
+#if GTKMM_MAJOR_VERSION >= 4
+        // GTK4: widgets don't auto-show after add_child_at_anchor
+        pCtAnchoredWidget->show();
+#else
+        pCtAnchoredWidget->show_all();
+#endif
+    }
+    if (pCtAnchoredWidget->get_hidden()) {
+        pCtAnchoredWidget->hide();
+    }
+}
+
 int CtTreeStore::get_tree_icon_size() const
 {
     const Glib::ustring& currentFont = _pCtMainWin->get_ct_config()->treeFont;
@@ -1053,17 +1602,36 @@ int CtTreeStore::get_tree_icon_size() const
 
 Glib::RefPtr<Gdk::Pixbuf> CtTreeStore::_get_node_icon(int nodeDepth, const std::string &syntax, guint32 customIconId)
 {
-    const char* stock_id = get_node_icon(nodeDepth, syntax, customIconId);
+    return _get_icon_pixbuf(get_node_icon(nodeDepth, syntax, customIconId));
+}
+
+Glib::RefPtr<Gdk::Pixbuf> CtTreeStore::_get_icon_pixbuf(const std::string& stock_id)
+{
+    // the same few pixbufs are shared by all the rows instead of loading one per row
     const int icon_size = get_tree_icon_size();
+    if (icon_size != _iconsPixbufsSize) {
+        _iconsPixbufs.clear();
+        _iconsPixbufsSize = icon_size;
+    }
+    auto it = _iconsPixbufs.find(stock_id);
+    if (it != _iconsPixbufs.end()) {
+        return it->second;
+    }
+    Glib::RefPtr<Gdk::Pixbuf> rPixbuf;
     #if GTKMM_MAJOR_VERSION < 4
-    return _pCtMainWin->get_icon_theme()->load_icon(stock_id, icon_size);
+    try {
+        rPixbuf = _pCtMainWin->get_icon_theme()->load_icon(stock_id, icon_size);
+    } catch (Glib::Error& error) {
+        spdlog::error("{} {}: {}", __FUNCTION__, stock_id, error.what());
+    }
     #else
     try {
-        return Gdk::Pixbuf::create_from_resource(std::string{"/icons/"} + stock_id + ".svg",
-                                                icon_size, icon_size, false);
+        rPixbuf = Gdk::Pixbuf::create_from_resource(std::string{"/icons/"} + stock_id + ".svg",
+                                                   icon_size, icon_size, false);
     } catch (...) {}
-    return Glib::RefPtr<Gdk::Pixbuf>{};
     #endif
+    _iconsPixbufs[stock_id] = rPixbuf;
+    return rPixbuf;
 }
 
 const char* CtTreeStore::get_node_icon(int nodeDepth, const std::string &syntax, guint32 customIconId)
@@ -1155,8 +1723,16 @@ void CtTreeStore::update_node_data(const Gtk::TreeModel::iterator& treeIter, con
     row[_columns.colAnchoredWidgets] = nodeData.anchoredWidgets;
 
     update_node_aux_icon(treeIter);
-    add_used_tags(nodeData.tags);
     _nodes_names_dict[nodeData.nodeId] = nodeData.name;
+    if (nodeData.pTextBuffer and nodeData.sharedNodesMasterId <= 0) {
+        link_index_set_dirty(nodeData.nodeId);
+    }
+    row_cache_reload(treeIter);
+    tag_index_update(treeIter);
+    if (_nodeIdItersValid) {
+        _nodeIdIters[nodeData.nodeId] = treeIter;
+    }
+    nodes_match_index_update(treeIter);
 }
 
 void CtTreeStore::update_node_icon(const Gtk::TreeModel::iterator& treeIter)
@@ -1229,17 +1805,7 @@ void CtTreeStore::update_node_aux_icon(const Gtk::TreeModel::iterator& treeIter)
         treeIter->set_value(_columns.rColPixbufAux, Glib::RefPtr<Gdk::Pixbuf>{});
     }
     else {
-        const int icon_size = get_tree_icon_size();
-        #if GTKMM_MAJOR_VERSION < 4
-        treeIter->set_value(_columns.rColPixbufAux, _pCtMainWin->get_icon_theme()->load_icon(stock_id, icon_size));
-        #else
-        try {
-            treeIter->set_value(_columns.rColPixbufAux, Gdk::Pixbuf::create_from_resource(
-                std::string{"/icons/"} + stock_id + ".svg", icon_size, icon_size, false));
-        } catch (...) {
-            treeIter->set_value(_columns.rColPixbufAux, Glib::RefPtr<Gdk::Pixbuf>{});
-        }
-        #endif
+        treeIter->set_value(_columns.rColPixbufAux, _get_icon_pixbuf(stock_id));
     }
 }
 
@@ -1404,14 +1970,15 @@ gint64 CtTreeStore::node_id_get(gint64 original_id/*=-1*/,
     return new_node_id;
 }
 
-void CtTreeStore::add_used_tags(const Glib::ustring& tags)
+void CtTreeStore::tag_index_update(const Gtk::TreeModel::iterator& treeIter)
 {
-    std::vector<Glib::ustring> tagVec = str::split(tags, " ");
-    for (auto& tag : tagVec) {
-        tag = str::trim(tag);
-        if (not tag.empty()) {
-            _usedTags.insert(tag);
-        }
+    // only the data holders, the shared nodes display the tags of their master
+    const CtNodeRowCache* pRowCache = get_row_cache(treeIter);
+    if (pRowCache->sharedNodesMasterId > 0) {
+        _tagIndex.remove_node(pRowCache->nodeId);
+    }
+    else {
+        _tagIndex.set_node(pRowCache->nodeId, pRowCache->tags.raw());
     }
 }
 
@@ -1429,13 +1996,20 @@ std::string CtTreeStore::get_node_name_from_node_id(const gint64 node_id)
 
 CtTreeIter CtTreeStore::get_node_from_node_id(const gint64 node_id)
 {
-    Gtk::TreeModel::iterator find_iter;
-    _rTreeStore->foreach_iter([&node_id, &find_iter, this](const Gtk::TreeModel::iterator& iter) {
-        if (iter->get_value(_columns.colNodeUniqueId) != node_id) return false; /* continue */
-        find_iter = iter;
-        return true;
-    });
-    return to_ct_tree_iter(find_iter);
+    if (not _nodeIdItersValid) {
+        // one walk of the whole tree, then kept up to date until a row is deleted
+        _nodeIdIters.clear();
+        _rTreeStore->foreach_iter([this](const Gtk::TreeModel::iterator& iter) {
+            _nodeIdIters[iter->get_value(_columns.colNodeUniqueId)] = iter;
+            return false; /* continue */
+        });
+        _nodeIdItersValid = true;
+    }
+    const auto it = _nodeIdIters.find(node_id);
+    if (_nodeIdIters.end() == it) {
+        return to_ct_tree_iter(Gtk::TreeModel::iterator{});
+    }
+    return to_ct_tree_iter(it->second);
 }
 
 CtTreeIter CtTreeStore::get_node_from_node_name(const Glib::ustring& node_name)
@@ -1588,12 +2162,6 @@ bool CtTreeStore::populate_summary_info(CtSummaryInfo& summaryInfo)
             else {
                 ++summaryInfo.nodes_code_num;
             }
-            // ensure the node content is populated
-            Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = ctTreeIter.get_node_text_buffer();
-            if (not pTextBuffer) {
-                error = str::format(_("Failed to retrieve the content of the node '%s'"), ctTreeIter.get_node_name().raw());
-                return true; /* true for stop */
-            }
             const gint64 shared_master_id = ctTreeIter.get_node_shared_master_id();
             if (shared_master_id > 0) {
                 // shared non master
@@ -1606,19 +2174,13 @@ bool CtTreeStore::populate_summary_info(CtSummaryInfo& summaryInfo)
                 sharedNodesMap[shared_master_id].insert(ctTreeIter.get_node_id());
             }
             else {
-                // non shared or shared master (data holder)
-                for (CtAnchoredWidget* pAnchoredWidget : ctTreeIter.get_anchored_widgets_fast()) {
-                    switch (pAnchoredWidget->get_type()) {
-                        case CtAnchWidgType::CodeBox: ++summaryInfo.codeboxes_num; break;
-                        case CtAnchWidgType::ImageAnchor: ++summaryInfo.anchors_num; break;
-                        case CtAnchWidgType::ImageLatex: ++summaryInfo.latexes_num; break;
-                        case CtAnchWidgType::ImageEmbFile: ++summaryInfo.embfile_num; break;
-                        case CtAnchWidgType::ImagePng: ++summaryInfo.images_num; break;
-                        case CtAnchWidgType::TableHeavy: ++summaryInfo.heavytables_num; break;
-                        case CtAnchWidgType::TableLight: ++summaryInfo.lighttables_num; break;
-                        default: break;
-                    }
+                // non shared or shared master (data holder), the buffer is populated only if the counters are missing
+                CtNodeStats nodeStats;
+                if (not node_stats_get(ctTreeIter, nodeStats)) {
+                    error = str::format(_("Failed to retrieve the content of the node '%s'"), ctTreeIter.get_node_name().raw());
+                    return true; /* true for stop */
                 }
+                nodeStats.add_to(summaryInfo);
             }
             return false; /* false for continue */
         }
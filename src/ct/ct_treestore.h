@@ -24,9 +24,12 @@
 #pragma once
 
 #include "ct_types.h"
+#include "ct_misc_utils.h"
+#include "ct_nodes_prefetch.h"
 #include <gtkmm.h>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 class CtMainWin;
 class CtAnchoredWidget;
@@ -82,6 +85,29 @@ struct CtTreeModelColumns : public Gtk::TreeModelColumnRecord
     Gtk::TreeModelColumn<std::list<CtAnchoredWidget*>> colAnchoredWidgets;
 };
 
+// copy of the node row properties held by CtTreeStore, to read them without
+// going through Gtk::TreeRow::get_value; a shared non master node refers to
+// the entry of its master for all the data holder properties
+struct CtNodeRowCache
+{
+    Gtk::TreeModel::iterator treeIter;
+    CtNodeRowCache* pMaster{nullptr};
+    gint64          nodeId{0};
+    gint64          sharedNodesMasterId{0};
+    gint64          sequence{-1};
+    gint64          tsCreation{0};
+    gint64          tsLastSave{0};
+    Glib::ustring   name;
+    std::string     syntax;
+    Glib::ustring   tags;
+    std::string     foreground;
+    guint16         customIconId{0};
+    bool            isReadOnly{false};
+    bool            isBold{false};
+    bool            excludeMeFromSearch{false};
+    bool            excludeChildrenFromSearch{false};
+};
+
 class CtMainWin;
 
 class CtTreeIter : public Gtk::TreeModel::iterator
@@ -148,6 +174,10 @@ public:
     static void clear_hit_exclusion_from_search() { _hitExclusionFromSearch = false; }
 
 private:
+    CtNodeRowCache* _get_row_cache() const;
+    CtNodeRowCache* _get_data_holder_row_cache() const;
+    CtTreeIter      _get_shared_master() const;
+
     const CtTreeModelColumns* _pColumns{nullptr};
     CtMainWin*                _pCtMainWin{nullptr};
 
@@ -163,7 +193,20 @@ public:
     virtual ~CtTreeStore();
 
     void          tree_view_connect(Gtk::TreeView* pTreeView);
+    // between begin and end the model is detached from the tree view so that appending
+    // many rows does not go through the view, the expanded state and cursor are restored at end
+    void          bulk_population_begin();
+    void          bulk_population_end();
     void          text_view_apply_textbuffer(CtTreeIter& treeIter, CtTextView* pTextView);
+    // the anchored widgets of the node in the text view are added in idle batches, the ones in view first;
+    // these add at once the pending ones up to the offset (-1 for all) and pause the batches, with the prefetch
+    void          text_view_realize_pending_widgets(const int up_to_offset = -1);
+    void          text_view_realize_pause(const bool pause);
+    // parse while idle the rich text of the nodes likely to be selected next
+    void          nodes_prefetch_around(CtTreeIter& treeIter) { _nodesPrefetch.on_node_selected(treeIter); }
+    bool          nodes_prefetch_take_prepared(const gint64 nodeIdDataHolder, CtPreparedRichText& preparedRichText) {
+        return _nodesPrefetch.take_prepared(nodeIdDataHolder, preparedRichText);
+    }
 
     void          get_node_data(const Gtk::TreeModel::iterator& treeIter, CtNodeData& nodeData, const bool loadTextBuffer);
     bool          populate_summary_info(CtSummaryInfo& summaryInfo);
@@ -189,8 +232,10 @@ public:
 
     gint64                         node_id_get(gint64 original_id=-1,
                                                std::unordered_map<gint64,gint64> remapping_ids=std::unordered_map<gint64,gint64>{});
-    void                           add_used_tags(const Glib::ustring& tags);
-    const std::set<Glib::ustring>& get_used_tags() { return _usedTags; }
+    // tags of all the nodes, kept updated with the node properties
+    const CtTagIndex&              get_tag_index() const { return _tagIndex; }
+    void                           tag_index_update(const Gtk::TreeModel::iterator& treeIter);
+    void                           tag_index_remove(const gint64 nodeId) { _tagIndex.remove_node(nodeId); }
     bool                           is_node_bookmarked(const gint64 node_id);
     std::string                    get_node_name_from_node_id(const gint64 node_id);
     CtTreeIter                     get_node_from_node_id(const gint64 node_id);
@@ -218,10 +263,71 @@ public:
     const char* get_node_icon(int nodeDepth, const std::string &syntax, guint32 customIconId);
     int get_tree_icon_size() const;
 
+    // names and hierarchical paths of all the nodes, built on first use and then kept updated
+    const CtMatchIndex& get_nodes_match_index();
+    void                nodes_match_index_update(const Gtk::TreeModel::iterator& treeIter);
+    void                nodes_match_index_on_rename(const gint64 nodeIdDataHolder);
+
+    // node links and anchors, loaded with the document and refreshed from the buffers of the edited nodes
+    const CtLinkIndex&  get_link_index();
+    void                link_index_set_node(const gint64 nodeIdDataHolder, CtLinkIndex::NodeData nodeData);
+    void                link_index_set_dirty(const gint64 nodeIdDataHolder) { _linkIndexDirty.insert(nodeIdDataHolder); }
+    // the entry of a node whose id changes, extracted again from the buffer only if not known
+    void                link_index_copy(const gint64 fromNodeIdDataHolder, const gint64 toNodeIdDataHolder);
+    // nodeId or its anchor (if not empty) missing, without loading the target buffer
+    bool                link_index_is_target_missing(const gint64 nodeId, const std::string& anchor);
+    std::vector<gint64> link_index_get_referrers(const gint64 nodeId);
+    std::vector<CtLinkIndex::BrokenLink> link_index_get_broken_links();
+
+    // content counters of the nodes, loaded with the document and dropped when a buffer is edited
+    void                node_stats_set(const gint64 nodeIdDataHolder, const CtNodeStats& nodeStats) { _nodesStats[nodeIdDataHolder] = nodeStats; }
+    void                node_stats_drop(const gint64 nodeIdDataHolder) { _nodesStats.erase(nodeIdDataHolder); }
+    // the counters of a node whose id changes, computed again from the buffer only if not known
+    void                node_stats_copy(const gint64 fromNodeIdDataHolder, const gint64 toNodeIdDataHolder);
+    // the counters missing are computed from the node buffer
+    bool                node_stats_get(CtTreeIter& ctTreeIter, CtNodeStats& nodeStats);
+
+    // content of the imported or duplicated nodes kept as xml (root/slot as the rich text clipboard, or node
+    // as the rich text in the database), the buffer is only built when the node is first needed
+    void                imported_content_set(const gint64 nodeId, std::string&& xmlContent) { _importedContent[nodeId] = std::move(xmlContent); }
+    const std::string*  imported_content_get(const gint64 nodeId) const {
+        const auto it = _importedContent.find(nodeId);
+        return _importedContent.end() != it ? &it->second : nullptr;
+    }
+    // the buffer of a node still holding its imported content (then dropped), null if none
+    Glib::RefPtr<Gtk::TextBuffer> imported_content_to_buffer(const gint64 nodeId, std::list<CtAnchoredWidget*>& anchoredWidgets);
+
+    // approximate memory of the loaded buffers and widgets, nothing is loaded to count
+    void                memory_usage_populate(CtMemoryUsage& memoryUsage);
+    // drop the loaded buffer and widgets of a saved, not selected node, to be loaded again on demand
+    bool                unload_text_buffer(CtTreeIter& ctTreeIter);
+
+    // number of all the descendants, cached per row and dropped for the ancestors of inserted/deleted rows
+    size_t          get_subtree_nodes_count(const Gtk::TreeModel::iterator& treeIter);
+    CtTextStats&    get_curr_node_text_stats() { return _currNodeTextStats; }
+
+    CtNodeRowCache* get_row_cache(const Gtk::TreeModel::iterator& treeIter);
+    CtNodeRowCache* get_row_cache_data_holder(const Gtk::TreeModel::iterator& treeIter);
+    void            row_cache_reload(const Gtk::TreeModel::iterator& treeIter);
+
 protected:
     Glib::RefPtr<Gdk::Pixbuf> _get_node_icon(int nodeDepth, const std::string &syntax, guint32 customIconId);
+    Glib::RefPtr<Gdk::Pixbuf> _get_icon_pixbuf(const std::string& stock_id);
     void                      _iter_delete_anchored_widgets(const Gtk::TreeModel::Children& children);
 
+    void _on_row_deleted(const Gtk::TreeModel::Path& path);
+    void _on_row_inserted(const Gtk::TreeModel::Path& path, const Gtk::TreeModel::iterator& treeIter);
+    void _subtree_nodes_counts_drop_ancestors(Gtk::TreeModel::iterator treeIter);
+    void _nodes_match_index_add(const Gtk::TreeModel::iterator& treeIter, const std::string* pFoldedParentPath, gint64* pOrder);
+    void _row_cache_load(const Gtk::TreeModel::iterator& treeIter, CtNodeRowCache& rowCache);
+    void _link_index_node_from_buffer(CtTreeIter& ctTreeIter, CtLinkIndex::NodeData& nodeData);
+    bool _node_stats_from_buffer(CtTreeIter& ctTreeIter, CtNodeStats& nodeStats);
+
+    bool _realize_pending_widgets_step();
+    void _realize_anchored_widget(CtAnchoredWidget* pCtAnchoredWidget,
+                                  Glib::RefPtr<Gtk::TextChildAnchor> pChildAnchor,
+                                  Gtk::TextView& textView);
+
     void _on_textbuffer_modified_changed(Glib::RefPtr<Gtk::TextBuffer> pTextBuffer);
     void _on_textbuffer_insert(const Gtk::TextBuffer::iterator& pos, const Glib::ustring& text, int bytes);
     void _on_textbuffer_erase(const Gtk::TextBuffer::iterator& range_start, const Gtk::TextBuffer::iterator& range_end);
@@ -231,10 +337,35 @@ private:
     CtTreeModelColumns              _columns;
     Glib::RefPtr<Gtk::TreeStore>    _rTreeStore;
     std::list<gint64>               _bookmarks;
-    std::set<Glib::ustring>         _usedTags;
+    CtTagIndex                      _tagIndex;
     std::map<gint64, Glib::ustring> _nodes_names_dict; // for link tooltips
+    std::unordered_map<gpointer, CtNodeRowCache> _rowsCache; // keyed by row, cleared when a row is deleted
+    std::unordered_map<gint64, Gtk::TreeModel::iterator> _nodeIdIters;
+    bool                            _nodeIdItersValid{false};
+    CtMatchIndex                    _nodesMatchIndex;
+    bool                            _nodesMatchIndexValid{false};
+    std::unordered_map<gpointer, size_t> _subtreeNodesCounts; // keyed by row
+    CtTextStats                     _currNodeTextStats;
+    CtLinkIndex                     _linkIndex; // keyed by data holder node id
+    std::unordered_set<gint64>      _linkIndexDirty;
+    std::unordered_map<gint64, CtNodeStats> _nodesStats; // keyed by data holder node id
+    std::unordered_map<gint64, std::string> _importedContent; // root/slot xml, until the buffer is built
     std::list<sigc::connection>     _curr_node_sigc_conn;
+    static constexpr size_t         REALIZE_WIDGETS_BATCH{8u};
+    std::vector<Glib::RefPtr<Gtk::TextChildAnchor>> _realizePendingAnchors; // of the node in the text view
+    int                             _realizeSortedTop{-1}; // offset at the top of the view when the pending were sorted
+    gint64                          _realizeNodeIdDataHolder{-1};
+    CtTextView*                     _pRealizeTextView{nullptr};
+    sigc::connection                _realizeConnection;
+    bool                            _realizePaused{false};
     CtMainWin*                      _pCtMainWin;
+    Gtk::TreeView*                  _pTreeView{nullptr};
+    int                             _bulkPopulationDepth{0};
+    std::string                     _bulkRestoreExpColl;
+    gint64                          _bulkRestoreCursorNodeId{-1};
+    std::unordered_map<std::string, Glib::RefPtr<Gdk::Pixbuf>> _iconsPixbufs; // stock id -> pixbuf at _iconsPixbufsSize
+    int                             _iconsPixbufsSize{-1};
     mutable int                     _cached_icon_size{-1};
     mutable Glib::ustring           _cached_tree_font;
+    CtNodesPrefetch                 _nodesPrefetch;
 };
@@ -34,6 +34,7 @@
 #include <type_traits>
 #include <array>
 #include <vector>
+#include <memory>
 #include <glibmm/ustring.h>
 #include <gtkmm/liststore.h>
 #include <gtkmm/textbuffer.h>
@@ -49,6 +50,8 @@ enum class CtDocType { None, XML, SQLite, MultiFile };
 
 enum class CtDocEncrypt { None, True, False };
 
+enum class CtFileOpenResult { Failed, Opened, OpenedElsewhere };
+
 enum class CtAnchWidgType { None, CodeBox, TableHeavy, TableLight, ImagePng, ImageAnchor, ImageLatex, ImageEmbFile, Link };
 
 enum class CtAnchorExpCollState { None, Expanded, Collapsed };
@@ -303,7 +306,19 @@ struct CtStorageSyncPending
     std::unordered_set<gint64>                     nodes_to_rm_set;
 };
 
+// the rich text of a node parsed from its xml, with no gtk object so that it can be prepared off the main thread
+struct CtPreparedRichText
+{
+    struct Slot
+    {
+        Glib::ustring                                    text;
+        std::vector<std::pair<std::string, std::string>> attributes; // tag property, value
+    };
+    std::vector<Slot> slots;
+};
+
 enum class CtBackupType { None, SingleFile, MultiFile };
+class CtSqliteSnapshot;
 struct CtBackupEncryptData
 {
     CtBackupType backupType;
@@ -312,6 +327,9 @@ struct CtBackupEncryptData
     std::string file_path;
     std::string password;
     std::string extracted_copy;
+    std::string wal_checkpoint_db; // sqlite db to passively checkpoint after the backup / encrypt
+    std::shared_ptr<CtSqliteSnapshot> pMainBackupSnapshot;   // source of main_backup if not already on disk
+    std::shared_ptr<CtSqliteSnapshot> pExtractedCopySnapshot;// source of extracted_copy if not already on disk
     time_t* p_mod_time;
 };
 
@@ -351,6 +369,9 @@ struct CtSummaryInfo
     size_t lighttables_num{0u};
     size_t codeboxes_num{0u};
     size_t anchors_num{0u};
+    size_t chars_num{0u};
+    size_t words_num{0u};
+    size_t blob_bytes{0u};
 };
 
 template<class F> auto scope_guard(F&& f) {
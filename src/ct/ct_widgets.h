@@ -50,6 +50,7 @@ protected:
 class CtMainWin;
 class CtAnchoredWidgetState;
 class CtStorageCache;
+class CtMemoryUsage;
 
 #if GTKMM_MAJOR_VERSION >= 4
 class CtAnchoredWidget : public Gtk::Frame
@@ -202,11 +203,20 @@ public:
     virtual void vacuum() = 0;
     virtual void import_nodes(const fs::path& path, const Gtk::TreeModel::iterator& parent_iter) = 0;
 
+    // pPrepared if not null is the rich text already parsed from get_delayed_text_raw
     virtual Glib::RefPtr<Gtk::TextBuffer> get_delayed_text_buffer(const gint64 node_id,
                                                                   const std::string& syntax,
-                                                                  std::list<CtAnchoredWidget*>& widgets) const = 0;
+                                                                  std::list<CtAnchoredWidget*>& widgets,
+                                                                  const CtPreparedRichText* pPrepared) const = 0;
+    // the rich text xml (or plain text) of a not yet loaded node, for the parsing to be done off the main thread
+    // or to be copied as is; false if the storage keeps the nodes already parsed
+    virtual bool get_delayed_text_raw(const gint64 node_id, std::string& rawXml, bool* pHasWidgets = nullptr) const = 0;
     virtual fs::path get_embedded_filepath(const CtTreeIter& ct_tree_iter, const std::string& filename) const = 0;
 
+    // put back what get_delayed_text_buffer needs to build again the (saved) node buffer
+    virtual bool restore_delayed_text_buffer(const CtTreeIter& ct_tree_iter) = 0;
+    virtual void memory_usage_populate(CtMemoryUsage& memoryUsage) const = 0;
+
     void set_is_dry_run() { _isDryRun = true; }
 
 protected:
@@ -40,11 +40,14 @@ public:
     }
     CtTmp* getCtTmp() { return _uCtTmp.get(); }
     void register_args(const std::vector<std::string>* pVecArgs) { _pVecArgs = pVecArgs; }
+    void set_doc_open_in_other_window(const bool docOpenInOtherWindow) { _docOpenInOtherWindow = docOpenInOtherWindow; }
 
 private:
     void on_activate() final;
+    void on_open(const Gio::Application::type_vec_files& files, const Glib::ustring& hint) final;
 
     const std::vector<std::string>* _pVecArgs{nullptr};
+    bool _docOpenInOtherWindow{false};
 };
 
 void TestCtApp::on_activate()
@@ -68,9 +71,72 @@ void TestCtApp::on_activate()
     on_open(files, "");
 }
 
+void TestCtApp::on_open(const Gio::Application::type_vec_files& files, const Glib::ustring& hint)
+{
+    CtMainWin* pWinWithDoc{nullptr};
+    if (_docOpenInOtherWindow) {
+        // the document is already open in a window when the export is requested
+        pWinWithDoc = _create_window(true/*no_gui*/);
+        ASSERT_EQ(CtFileOpenResult::Opened, pWinWithDoc->file_open(files.front()->get_path(), ""/*node*/, ""/*anchor*/));
+    }
+    CtApp::on_open(files, hint);
+    if (pWinWithDoc) {
+        pWinWithDoc->force_exit() = true;
+        remove_window(*pWinWithDoc);
+    }
+}
+
 enum class ExportType { None, Txt, Pdf, Html };
 
-class ExportsMultipleParametersTests : public ::testing::TestWithParam<std::tuple<std::string, std::string>>
+// the page objects can be in compressed object streams, so the flate streams are inflated and searched too
+static int pdf_count_pages(const std::string& rawPdf, int& pagesTreeCount)
+{
+    std::string searchable{rawPdf};
+    for (size_t pos = rawPdf.find("stream\n"); std::string::npos != pos; pos = rawPdf.find("stream\n", pos + 1)) {
+        if (pos >= 3u and 0 == rawPdf.compare(pos - 3u, 3u, "end")) {
+            continue;
+        }
+        const size_t streamBegin = pos + 7u;
+        const size_t streamEnd = rawPdf.find("endstream", streamBegin);
+        if (std::string::npos == streamEnd) {
+            break;
+        }
+        GConverter* pConverter = G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB));
+        const char* pIn = rawPdf.data() + streamBegin;
+        gsize inLeft = streamEnd - streamBegin;
+        char outBuf[4096];
+        while (true) {
+            gsize bytesRead{0};
+            gsize bytesWritten{0};
+            const GConverterResult res = g_converter_convert(pConverter, pIn, inLeft, outBuf, sizeof(outBuf),
+                                                             G_CONVERTER_INPUT_AT_END, &bytesRead, &bytesWritten, nullptr);
+            if (G_CONVERTER_ERROR == res) {
+                break; // not a flate stream
+            }
+            searchable.append(outBuf, bytesWritten);
+            pIn += bytesRead;
+            inLeft -= bytesRead;
+            if (G_CONVERTER_FINISHED == res) {
+                break;
+            }
+        }
+        g_object_unref(pConverter);
+    }
+    int pagesNum{0};
+    for (size_t pos = searchable.find("/Type /Page"); std::string::npos != pos; pos = searchable.find("/Type /Page", pos + 1)) {
+        if ('s' != searchable[pos + 11u]) {
+            ++pagesNum;
+        }
+    }
+    pagesTreeCount = 0;
+    const size_t countPos = searchable.find("/Count ", searchable.find("/Type /Pages"));
+    if (std::string::npos != countPos) {
+        pagesTreeCount = std::stoi(searchable.substr(countPos + 7u, 16u));
+    }
+    return pagesNum;
+}
+
+class ExportsMultipleParametersTests : public ::testing::TestWithParam<std::tuple<std::string, std::string, bool>>
 {
 };
 
@@ -96,6 +162,7 @@ TEST_P(ExportsMultipleParametersTests, ChecksExports)
     }
     ASSERT_FALSE(ExportType::None == exportType);
     const std::vector<std::string> vec_args{"cherrytree", inDocPath, exportSwitch, tmpDirpath.string(), "--export_single_file"};
+    testCtApp.set_doc_open_in_other_window(std::get<2>(GetParam()));
     testCtApp.register_args(&vec_args);
     gchar** pp_args = CtStrUtil::vector_to_array(vec_args);
     testCtApp.run(vec_args.size(), pp_args);
@@ -114,6 +181,15 @@ TEST_P(ExportsMultipleParametersTests, ChecksExports)
     }
     else if (ExportType::Pdf == exportType) {
         ASSERT_NE(0, fs::file_size(tmpFilepath));
+        // written directly to a cairo pdf surface, with no print operation
+        const std::string resultPdf = Glib::file_get_contents(tmpFilepath.string());
+        ASSERT_EQ(0u, resultPdf.find("%PDF-"));
+        ASSERT_NE(std::string::npos, resultPdf.rfind("%%EOF"));
+        // every streamed page is in the page tree, the test document does not fit in one page
+        int pagesTreeCount{0};
+        const int pagesNum = pdf_count_pages(resultPdf, pagesTreeCount);
+        ASSERT_LT(1, pagesNum);
+        ASSERT_EQ(pagesNum, pagesTreeCount);
     }
     else if (ExportType::Html == exportType) {
         std::string expectHtml_path{Glib::build_filename(UT::unitTestsDataDir, "test.export.html")};
@@ -136,11 +212,13 @@ INSTANTIATE_TEST_CASE_P(
         ExportsTests,
         ExportsMultipleParametersTests,
         ::testing::Values(
-            std::make_tuple(UT::testCtbDocPath, "--export_to_txt_dir"),
-            std::make_tuple(UT::testCtdDocPath, "--export_to_txt_dir"),
-            std::make_tuple(UT::testCtbDocPath, "--export_to_pdf_dir"),
-            std::make_tuple(UT::testCtdDocPath, "--export_to_pdf_dir"),
-            std::make_tuple(UT::testCtbDocPath, "--export_to_html_dir"),
-            std::make_tuple(UT::testCtdDocPath, "--export_to_html_dir"),
-            std::make_tuple(UT::testMultiFileSourCherry, "--export_to_txt_dir"))
+            std::make_tuple(UT::testCtbDocPath, "--export_to_txt_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtdDocPath, "--export_to_txt_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtbDocPath, "--export_to_pdf_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtdDocPath, "--export_to_pdf_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtbDocPath, "--export_to_html_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtdDocPath, "--export_to_html_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testMultiFileSourCherry, "--export_to_txt_dir", false/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtbDocPath, "--export_to_txt_dir", true/*doc_open_in_other_window*/),
+            std::make_tuple(UT::testCtdDocPath, "--export_to_txt_dir", true/*doc_open_in_other_window*/))
 );
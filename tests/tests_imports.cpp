@@ -22,6 +22,7 @@
  */
 
 #include "ct_imports.h"
+#include "ct_parser.h"
 #include "ct_config.h"
 #include "ct_filesystem.h"
 #include "tests_common.h"
@@ -74,3 +75,76 @@ TEST(ImportsGroup, TomboyEmptyTagDoesNotCrash)
       ASSERT_STREQ("Harmless Meeting Note", importedNode->node_name.c_str());
     }
 }
+
+TEST(ImportsGroup, TextParserTokensAreViewsOfTheText)
+{
+    CtTextParser textParser{{{"**", true, true, nullptr}, {"[", true, false, nullptr, "]"}}};
+    const std::string text{"plain **bold** [link]"};
+    const std::vector<std::string_view> tokens = textParser.tokenize(text);
+    const std::vector<std::string_view> expectedTokens{"plain", " ", "**", "bold", "**", " ", "[", "link", "]"};
+    ASSERT_EQ(expectedTokens, tokens);
+    for (const std::string_view token : tokens) {
+        // no copy, every token points into the text
+        ASSERT_TRUE(token.data() >= text.data() and token.data() + token.size() <= text.data() + text.size());
+    }
+    const auto tokenStream = textParser.parse_tokens(tokens);
+    ASSERT_EQ(5u, tokenStream.size());
+    ASSERT_EQ(nullptr, tokenStream.at(0).first);
+    ASSERT_EQ("plain", tokenStream.at(0).second);
+    ASSERT_EQ("**", tokenStream.at(2).first->open_tag);
+    ASSERT_EQ("bold", tokenStream.at(2).second);
+    ASSERT_EQ("[", tokenStream.at(4).first->open_tag);
+    ASSERT_EQ("link", tokenStream.at(4).second);
+}
+
+TEST(ImportsGroup, TraverseDirInListingOrderAndCancel)
+{
+    Glib::init();
+
+    g_autofree gchar* pTmpDir = g_dir_make_tmp("ct_traverse_dir_XXXXXX", nullptr);
+    ASSERT_TRUE(pTmpDir);
+    const fs::path importDir{pTmpDir};
+    auto on_scope_exit = scope_guard([&importDir](void*) { (void)fs::remove_all(importDir); });
+    const fs::path subDir = importDir / "sub";
+    ASSERT_EQ(0, g_mkdir_with_parents(subDir.c_str(), 0755));
+    for (int i = 0; i < 40; ++i) {
+        Glib::file_set_contents((importDir / ("note" + std::to_string(i) + ".md")).string(), "# note " + std::to_string(i) + "\n**bold** text\n");
+    }
+    Glib::file_set_contents((subDir / "inner.md").string(), "inner\n");
+    Glib::file_set_contents((importDir / "not_markdown.txt").string(), "skipped\n");
+
+    // the nodes are in the order of the listing, whatever worker imported them
+    std::vector<std::string> expectedNames;
+    for (const fs::path& entry : fs::get_dir_entries(importDir)) {
+        if (fs::is_directory(entry)) {
+            expectedNames.push_back("sub");
+        }
+        else if (entry.extension() == ".md") {
+            expectedNames.push_back(entry.stem().string());
+        }
+    }
+    CtMDImport importer{CtConfig::GetCtConfig()};
+    double lastFraction{0.0};
+    std::unique_ptr<CtImportedNode> dirNode = CtImports::traverse_dir(importDir, &importer, [&lastFraction](const double fraction){
+        lastFraction = fraction;
+        return true;
+    });
+    ASSERT_TRUE(dirNode);
+    ASSERT_DOUBLE_EQ(1.0, lastFraction);
+    std::vector<std::string> importedNames;
+    for (const auto& pChild : dirNode->children) {
+        importedNames.push_back(pChild->node_name.raw());
+        if ("sub" == pChild->node_name) {
+            ASSERT_FALSE(pChild->has_content());
+            ASSERT_EQ(1u, pChild->children.size());
+            ASSERT_STREQ("inner", pChild->children.front()->node_name.c_str());
+        }
+        else {
+            ASSERT_TRUE(pChild->has_content());
+        }
+    }
+    ASSERT_EQ(expectedNames, importedNames);
+
+    // cancelled at the first progress
+    ASSERT_FALSE(CtImports::traverse_dir(importDir, &importer, [](const double){ return false; }));
+}
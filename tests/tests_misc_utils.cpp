@@ -22,6 +22,7 @@
  */
 
 #include "ct_misc_utils.h"
+#include "ct_table.h"
 #include "ct_const.h"
 #include "ct_filesystem.h"
 #include "tests_common.h"
@@ -456,6 +457,13 @@ TEST(MiscUtilsGroup, str__diacritical_to_ascii)
     ASSERT_STREQ("li", str::diacritical_to_ascii("lì").c_str());
     ASSERT_STREQ("puo", str::diacritical_to_ascii("può").c_str());
     ASSERT_STREQ("piu", str::diacritical_to_ascii("più").c_str());
+    ASSERT_STREQ("", str::diacritical_to_ascii("").c_str());
+    ASSERT_STREQ("ascii only text longer than a word", str::diacritical_to_ascii("ascii only text longer than a word").c_str());
+    // the characters offsets must be kept
+    const Glib::ustring mixed{"Ḅello ẹ ŉ ok \u263A città, perché non può"};
+    const Glib::ustring mixedAscii = str::diacritical_to_ascii(mixed);
+    ASSERT_STREQ("Bello e n ok \u263A citta, perche non puo", mixedAscii.c_str());
+    ASSERT_EQ(mixed.size(), mixedAscii.size());
 }
 
 TEST(MiscUtilsGroup, vec_remove)
@@ -665,3 +673,410 @@ TEST(MiscUtilsGroup, highlight_words)
     ASSERT_STREQ("uno <u>due</u> <u>tre</u>", CtStrUtil::highlight_words(Glib::ustring{"uno due tre"}, {Glib::ustring{"due"}, Glib::ustring{"tre"}}, "u").c_str());
     ASSERT_STREQ("uno <b>due</b> <b>tre</b>", CtStrUtil::highlight_words(Glib::ustring{"uno due tre"}, {Glib::ustring{"tre"}, Glib::ustring{"due"}}).c_str());
 }
+
+TEST(MiscUtilsGroup, match_index)
+{
+    ASSERT_STREQ("elan vital citta", CtMatchIndex::fold("Èlan VITAL Città").c_str());
+
+    CtMatchIndex matchIndex;
+    matchIndex.set(1, CtMatchIndex::fold("Tre"), CtMatchIndex::fold("Uno / Tre"));
+    matchIndex.set(2, CtMatchIndex::fold("Quattro"), CtMatchIndex::fold("Due / Quattro"));
+    matchIndex.set(3, CtMatchIndex::fold("Attrezzi"), CtMatchIndex::fold("Uno / Attrezzi"));
+    matchIndex.set(4, CtMatchIndex::fold("Città"), CtMatchIndex::fold("Città"));
+    ASSERT_EQ(4u, matchIndex.size());
+
+    ASSERT_EQ(std::vector<gint64>({1, 2, 3}), matchIndex.query("tr", 10));
+    ASSERT_EQ(std::vector<gint64>({4}), matchIndex.query("CITTÀ", 10));
+    ASSERT_EQ(std::vector<gint64>({2}), matchIndex.query("qto", 10));
+    ASSERT_EQ(std::vector<gint64>({1, 3}), matchIndex.query("uno", 10));
+    ASSERT_EQ(std::vector<gint64>({1, 2}), matchIndex.query("  ", 2));
+
+    matchIndex.remove(1);
+    ASSERT_EQ(3u, matchIndex.size());
+    ASSERT_EQ(nullptr, matchIndex.get(1));
+    ASSERT_EQ(std::vector<gint64>({2, 3}), matchIndex.query("tr", 10));
+}
+
+TEST(MiscUtilsGroup, text_stats)
+{
+    Glib::init();
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = Gtk::TextBuffer::create();
+    pTextBuffer->set_text("one two\nthree\n\nfour five six");
+    CtTextStats textStats;
+    ASSERT_EQ(6, textStats.get_words_count(pTextBuffer));
+    ASSERT_EQ(4, textStats.get_lines_count());
+
+    pTextBuffer->insert(pTextBuffer->get_iter_at_line(1), "seven\neight nine\n");
+    ASSERT_EQ(9, textStats.get_words_count(pTextBuffer));
+    ASSERT_EQ(CtTextIterUtil::get_words_count(pTextBuffer), textStats.get_words_count(pTextBuffer));
+
+    // join "one two" with "seven"
+    Gtk::TextIter iter_start = pTextBuffer->get_iter_at_line(0);
+    iter_start.forward_to_line_end();
+    Gtk::TextIter iter_end = iter_start;
+    iter_end.forward_char();
+    pTextBuffer->erase(iter_start, iter_end);
+    ASSERT_EQ(8, textStats.get_words_count(pTextBuffer));
+
+    // across several lines
+    pTextBuffer->erase(pTextBuffer->get_iter_at_offset(4), pTextBuffer->get_iter_at_line(3));
+    ASSERT_EQ(CtTextIterUtil::get_words_count(pTextBuffer), textStats.get_words_count(pTextBuffer));
+    ASSERT_EQ(pTextBuffer->get_char_count(), textStats.get_chars_count());
+
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer2 = Gtk::TextBuffer::create();
+    pTextBuffer2->set_text("a b");
+    ASSERT_EQ(2, textStats.get_words_count(pTextBuffer2));
+    ASSERT_EQ(0, textStats.get_words_count(Glib::RefPtr<Gtk::TextBuffer>{}));
+}
+
+TEST(MiscUtilsGroup, get_text_by_chunks)
+{
+    Glib::init();
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = Gtk::TextBuffer::create();
+    // more lines than in a chunk
+    Glib::ustring text;
+    for (int i = 0; i < 5000; ++i) {
+        text += "àè word\n";
+    }
+    pTextBuffer->set_text(text);
+    std::string text_raw{"x"};
+    size_t chars{0u}, words{0u};
+    CtTextIterUtil::get_text_by_chunks(pTextBuffer->begin(), pTextBuffer->end(), text_raw, chars, words);
+    ASSERT_EQ("x" + text.raw(), text_raw);
+    ASSERT_EQ(text.size(), chars);
+    ASSERT_EQ(10000u, words);
+    ASSERT_EQ(10000, CtTextIterUtil::get_words_count(pTextBuffer));
+
+    text_raw.clear();
+    chars = words = 0u;
+    CtTextIterUtil::get_text_by_chunks(pTextBuffer->get_iter_at_offset(3), pTextBuffer->get_iter_at_offset(7), text_raw, chars, words);
+    ASSERT_EQ("word", text_raw);
+    ASSERT_EQ(4u, chars);
+    ASSERT_EQ(1u, words);
+}
+
+TEST(MiscUtilsGroup, csv_stream)
+{
+    const std::string csv_path = Glib::build_filename(Glib::get_tmp_dir(), "ct_test_stream.csv");
+    const CtCSV::CtStringTable table{{"a", "b \"quoted\"", "c,d"}, {"multi\nline", "", "x"}};
+    const std::string csv_text = CtCSV::table_to_csv(table);
+    ASSERT_STREQ("\"a\",\"b \\\"quoted\\\"\",\"c,d\"\n\"multi\nline\",\"\",\"x\"\n", csv_text.c_str());
+
+    // more records than fit in a chunk, the last one not terminated by newline
+    std::string big_csv_text;
+    const size_t big_rows_num = 3u*CtCSV::CSV_CHUNK_SIZE/csv_text.size();
+    for (size_t i = 0u; i < big_rows_num; ++i) {
+        big_csv_text += csv_text;
+    }
+    big_csv_text += "\"last\",\"row\"";
+    Glib::file_set_contents(csv_path, big_csv_text);
+
+    size_t rows_num{0u};
+    double last_fraction{0};
+    ASSERT_TRUE(CtCSV::table_from_csv_stream(csv_path, [&](std::vector<std::string>& row){
+        if (rows_num < 2u*big_rows_num) {
+            EXPECT_EQ(table.at(rows_num % 2u), row);
+        }
+        ++rows_num;
+        return true;
+    }, [&](const double fraction){
+        EXPECT_GT(fraction, last_fraction);
+        last_fraction = fraction;
+        return true;
+    }));
+    ASSERT_EQ(2u*big_rows_num + 1u, rows_num);
+    ASSERT_EQ(std::vector<std::string>({"last", "row"}), CtCSV::table_from_csv(csv_path).back());
+
+    // stopped from the progress callback
+    ASSERT_FALSE(CtCSV::table_from_csv_stream(csv_path, [](std::vector<std::string>&){ return true; },
+                                              [](const double){ return false; }));
+    (void)g_remove(csv_path.c_str());
+}
+
+TEST(MiscUtilsGroup, table_store)
+{
+    CtTableStore tableStore{2u};
+    tableStore.row_append({"header1", "header2"});
+    tableStore.row_append({"item10", "x"});
+    tableStore.row_append({"item9", "y", "dropped"});
+    tableStore.row_append({"item10"});
+    ASSERT_EQ(4u, tableStore.get_num_rows());
+    ASSERT_EQ(2u, tableStore.get_num_columns());
+    ASSERT_EQ("y", tableStore.get(2u, 1u));
+    ASSERT_EQ("", tableStore.get(3u, 1u));
+
+    // shorter text in place, longer appended, copy of a cell of the same column
+    tableStore.set(1u, 1u, "");
+    tableStore.set(3u, 1u, "a longer text");
+    tableStore.set(1u, 1u, tableStore.get(3u, 1u));
+    ASSERT_EQ("a longer text", tableStore.get(1u, 1u));
+    ASSERT_EQ("a longer text", tableStore.get(3u, 1u));
+
+    std::vector<size_t> changedRows = tableStore.rows_sort(true/*sortAsc*/, 1u/*startRow*/);
+    ASSERT_EQ(std::vector<size_t>({1u, 2u}), changedRows);
+    ASSERT_EQ("header1", tableStore.get(0u, 0u));
+    ASSERT_EQ("item9", tableStore.get(1u, 0u));
+    ASSERT_EQ("item10", tableStore.get(2u, 0u));
+    ASSERT_EQ("item10", tableStore.get(3u, 0u));
+    ASSERT_TRUE(tableStore.rows_sort(true/*sortAsc*/, 1u/*startRow*/).empty());
+
+    tableStore.rows_swap(0u, 1u);
+    ASSERT_EQ("item9", tableStore.get(0u, 0u));
+    tableStore.row_delete(0u);
+    ASSERT_EQ(3u, tableStore.get_num_rows());
+    ASSERT_EQ("header2", tableStore.get(0u, 1u));
+    tableStore.row_insert(1u);
+    ASSERT_EQ("", tableStore.get(1u, 0u));
+
+    tableStore.column_insert(1u);
+    ASSERT_EQ(3u, tableStore.get_num_columns());
+    ASSERT_EQ("", tableStore.get(0u, 1u));
+    tableStore.columns_swap(1u, 2u);
+    ASSERT_EQ("header2", tableStore.get(0u, 1u));
+    tableStore.column_delete(0u);
+    ASSERT_EQ("header2", tableStore.get(0u, 0u));
+
+    // many rewrites of the same cell are compacted
+    const std::string big_text(CtTableStore::COMPACT_MIN_GARBAGE, 'z');
+    for (int i = 0; i < 10; ++i) {
+        tableStore.set(0u, 0u, big_text + std::string(i, 'y'));
+    }
+    ASSERT_EQ(big_text + std::string(9, 'y'), tableStore.get(0u, 0u));
+    ASSERT_EQ("a longer text", tableStore.get(3u, 0u));
+}
+
+TEST(MiscUtilsGroup, link_index)
+{
+    CtLinkIndex::NodeData nodeData1;
+    ASSERT_TRUE(CtLinkIndex::add_link_from_property("node 2", nodeData1));
+    ASSERT_TRUE(CtLinkIndex::add_link_from_property("node 2 my anchor", nodeData1));
+    ASSERT_TRUE(CtLinkIndex::add_link_from_property("node 2", nodeData1));
+    ASSERT_TRUE(CtLinkIndex::add_link_from_property("node 4", nodeData1));
+    ASSERT_FALSE(CtLinkIndex::add_link_from_property("webs http://www.giuspen.net/cherrytree/", nodeData1));
+    ASSERT_FALSE(CtLinkIndex::add_link_from_property("node bad", nodeData1));
+    ASSERT_EQ(3u, nodeData1.links.size());
+    ASSERT_EQ("node 2 my anchor", CtLinkIndex::to_link_property(nodeData1.links.at(1)));
+
+    CtLinkIndex::NodeData nodeData2;
+    nodeData2.anchors.insert("my anchor");
+    ASSERT_TRUE(CtLinkIndex::add_link_from_property("node 1 gone anchor", nodeData2));
+    CtLinkIndex::NodeData nodeData3;
+    ASSERT_TRUE(CtLinkIndex::add_link_from_property("node 2 my anchor", nodeData3));
+
+    CtLinkIndex linkIndex;
+    linkIndex.set_node(1, nodeData1);
+    linkIndex.set_node(2, nodeData2);
+    linkIndex.set_node(3, nodeData3);
+    ASSERT_EQ(3u, linkIndex.size());
+    ASSERT_EQ(std::vector<gint64>({1, 3}), linkIndex.get_referrers(2));
+    const std::string anchor{"my anchor"};
+    ASSERT_EQ(std::vector<gint64>({1, 3}), linkIndex.get_referrers(2, &anchor));
+    ASSERT_EQ(std::vector<gint64>({2}), linkIndex.get_referrers(1));
+    ASSERT_TRUE(linkIndex.get_referrers(3).empty());
+    ASSERT_TRUE(linkIndex.has_anchor(2, anchor).value());
+    ASSERT_FALSE(linkIndex.has_anchor(1, anchor).value());
+    ASSERT_FALSE(linkIndex.has_anchor(5, anchor).has_value());
+
+    // node 4 does not exist, node 1 has no "gone anchor"
+    const auto nodeExists = [](const gint64 nodeId){ return nodeId <= 3; };
+    std::vector<CtLinkIndex::BrokenLink> brokenLinks = linkIndex.get_broken_links(nodeExists);
+    ASSERT_EQ(2u, brokenLinks.size());
+    ASSERT_EQ(1, brokenLinks.at(0).referrerId);
+    ASSERT_EQ(4, brokenLinks.at(0).target.nodeId);
+    ASSERT_TRUE(brokenLinks.at(0).missingNode);
+    ASSERT_EQ(2, brokenLinks.at(1).referrerId);
+    ASSERT_EQ("gone anchor", brokenLinks.at(1).target.anchor);
+    ASSERT_FALSE(brokenLinks.at(1).missingNode);
+
+    // the node data replaced on edit
+    linkIndex.set_node(1, CtLinkIndex::NodeData{});
+    ASSERT_EQ(std::vector<gint64>({3}), linkIndex.get_referrers(2));
+    ASSERT_EQ(1u, linkIndex.get_broken_links(nodeExists).size());
+    linkIndex.remove_node(3);
+    ASSERT_TRUE(linkIndex.get_referrers(2).empty());
+    ASSERT_EQ(nullptr, linkIndex.get_node(3));
+}
+
+TEST(MiscUtilsGroup, tag_index)
+{
+    ASSERT_EQ(std::vector<std::string>({"work", "todo"}), CtTagIndex::split_tags(" work  todo work "));
+
+    CtTagIndex tagIndex;
+    tagIndex.set_node(1, "work todo");
+    tagIndex.set_node(2, "work");
+    tagIndex.set_node(3, "todo urgent");
+    tagIndex.set_node(4, "");
+    ASSERT_EQ(3u, tagIndex.size());
+    const std::vector<std::pair<std::string, size_t>> tags = tagIndex.get_tags();
+    ASSERT_EQ(3u, tags.size());
+    ASSERT_EQ("todo", tags.at(0).first);
+    ASSERT_EQ(2u, tags.at(0).second);
+
+    ASSERT_EQ(std::vector<std::string>({"todo"}), tagIndex.complete("to"));
+    ASSERT_EQ(std::vector<std::string>({"todo", "urgent", "work"}), tagIndex.complete(""));
+    ASSERT_EQ(std::vector<std::string>({"todo"}), tagIndex.complete("", 1u));
+    ASSERT_TRUE(tagIndex.complete("x").empty());
+
+    ASSERT_EQ(std::vector<gint64>({1}), tagIndex.query({"work", "todo"}, true/*requireAll*/));
+    ASSERT_EQ(std::vector<gint64>({1, 2, 3}), tagIndex.query({"work", "todo"}, false/*requireAll*/));
+    ASSERT_TRUE(tagIndex.query({"work", "missing"}, true/*requireAll*/).empty());
+    ASSERT_EQ(std::vector<gint64>({1, 3}), tagIndex.query("work todo | urgent"));
+    ASSERT_EQ(std::vector<gint64>({1, 2}), tagIndex.query("work"));
+
+    // the node properties changed
+    tagIndex.set_node(1, "urgent");
+    ASSERT_EQ(std::vector<gint64>({1, 3}), tagIndex.query("urgent"));
+    ASSERT_EQ(std::vector<gint64>({2}), tagIndex.query("work"));
+    tagIndex.remove_node(2);
+    ASSERT_EQ(std::vector<std::string>({"todo", "urgent"}), tagIndex.complete(""));
+}
+
+TEST(MiscUtilsGroup, link_table)
+{
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = Gtk::TextBuffer::create();
+    pTextBuffer->get_tag_table()->add(Gtk::TextTag::create(CtLinkTable::get_style_tag_name("webs x")));
+    pTextBuffer->set_text("0123456789");
+    CtLinkTable* pCtLinkTable = CtLinkTable::get(pTextBuffer);
+    ASSERT_EQ(pCtLinkTable, CtLinkTable::get(pTextBuffer));
+    ASSERT_EQ("link_webs", CtLinkTable::get_style_tag_name("webs https://a.b"));
+
+    auto f_apply = [&](const int start_offset, const int end_offset, const std::string& link_property){
+        pTextBuffer->apply_tag_by_name("link_webs", pTextBuffer->get_iter_at_offset(start_offset), pTextBuffer->get_iter_at_offset(end_offset));
+        pCtLinkTable->set(pTextBuffer->get_iter_at_offset(start_offset), pTextBuffer->get_iter_at_offset(end_offset), link_property);
+    };
+    // two adjacent links sharing the style tag
+    f_apply(2, 4, "webs https://a.a");
+    f_apply(4, 6, "webs https://b.b");
+    ASSERT_EQ(2u, pCtLinkTable->size());
+    ASSERT_EQ("", CtTextIterUtil::get_link_at(pTextBuffer->get_iter_at_offset(1)));
+    ASSERT_EQ("webs https://a.a", CtTextIterUtil::get_link_at(pTextBuffer->get_iter_at_offset(3)));
+    ASSERT_EQ("webs https://b.b", CtTextIterUtil::get_link_at(pTextBuffer->get_iter_at_offset(4)));
+    ASSERT_EQ("", CtTextIterUtil::get_link_at(pTextBuffer->get_iter_at_offset(6)));
+
+    // the text inserted at the bounds is out of the links, inside is in
+    pTextBuffer->insert(pTextBuffer->get_iter_at_offset(2), "X");
+    ASSERT_EQ("", pCtLinkTable->get_link(pTextBuffer->get_iter_at_offset(2)));
+    pTextBuffer->insert(pTextBuffer->get_iter_at_offset(4), "Y");
+    Gtk::TextIter iter_start, iter_end;
+    ASSERT_TRUE(pCtLinkTable->get_bounds(pTextBuffer->get_iter_at_offset(4), iter_start, iter_end));
+    ASSERT_EQ(3, iter_start.get_offset());
+    ASSERT_EQ(6, iter_end.get_offset());
+
+    // the deletion of a link text empties its range
+    pTextBuffer->erase(pTextBuffer->get_iter_at_offset(3), pTextBuffer->get_iter_at_offset(6));
+    std::vector<std::pair<int, std::string>> links;
+    pCtLinkTable->for_each([&links](const Gtk::TextIter& iter_start, const Gtk::TextIter&/*iter_end*/, const std::string& link_property){
+        links.push_back(std::make_pair(iter_start.get_offset(), link_property));
+    });
+    ASSERT_EQ(1u, links.size());
+    ASSERT_EQ(3, links.at(0).first);
+    ASSERT_EQ("webs https://b.b", links.at(0).second);
+
+    // removal in the middle splits the range
+    f_apply(0, 3, "webs https://c.c");
+    pCtLinkTable->remove(pTextBuffer->get_iter_at_offset(1), pTextBuffer->get_iter_at_offset(2));
+    ASSERT_EQ("webs https://c.c", pCtLinkTable->get_link(pTextBuffer->get_iter_at_offset(0)));
+    ASSERT_EQ("", pCtLinkTable->get_link(pTextBuffer->get_iter_at_offset(1)));
+    ASSERT_EQ("webs https://c.c", pCtLinkTable->get_link(pTextBuffer->get_iter_at_offset(2)));
+    ASSERT_EQ("webs https://b.b", pCtLinkTable->get_link(pTextBuffer->get_iter_at_offset(3)));
+}
+
+TEST(MiscUtilsGroup, node_stats)
+{
+    CtNodeStats nodeStats;
+    nodeStats.chars = 120u;
+    nodeStats.words = 21u;
+    nodeStats.add_widget(CtAnchWidgType::ImagePng, 1000u);
+    nodeStats.add_widget(CtAnchWidgType::ImageEmbFile, 24u);
+    nodeStats.add_widget(CtAnchWidgType::ImageAnchor);
+    nodeStats.add_widget(CtAnchWidgType::TableLight);
+    nodeStats.add_widget(CtAnchWidgType::CodeBox);
+    nodeStats.add_widget(CtAnchWidgType::CodeBox);
+    ASSERT_EQ(1024u, nodeStats.blobBytes);
+    ASSERT_EQ("1 120 21 1024 1 0 1 0 1 2 1", nodeStats.to_string());
+
+    CtNodeStats nodeStatsRead;
+    ASSERT_TRUE(CtNodeStats::from_string(nodeStats.to_string(), nodeStatsRead));
+    ASSERT_EQ(nodeStats.to_string(), nodeStatsRead.to_string());
+    // missing, older or future format
+    ASSERT_FALSE(CtNodeStats::from_string("", nodeStatsRead));
+    ASSERT_FALSE(CtNodeStats::from_string("1 120 21", nodeStatsRead));
+    ASSERT_FALSE(CtNodeStats::from_string("2 120 21 1024 1 0 1 0 1 2 1", nodeStatsRead));
+    ASSERT_FALSE(CtNodeStats::from_string("1 120 21 1024 1 0 1 0 1 2 -1", nodeStatsRead));
+
+    CtSummaryInfo summaryInfo;
+    nodeStats.add_to(summaryInfo);
+    nodeStats.add_to(summaryInfo);
+    ASSERT_EQ(240u, summaryInfo.chars_num);
+    ASSERT_EQ(2048u, summaryInfo.blob_bytes);
+    ASSERT_EQ(4u, summaryInfo.codeboxes_num);
+    ASSERT_EQ(2u, summaryInfo.lighttables_num);
+    ASSERT_EQ(0u, summaryInfo.heavytables_num);
+}
+
+TEST(MiscUtilsGroup, memory_usage)
+{
+    using Category = CtMemoryUsage::Category;
+    CtMemoryUsage memoryUsage;
+    const int sharedPixbuf{0};
+    memoryUsage.add(1, Category::TextBuffer, 100u);
+    memoryUsage.add(2, Category::TextBuffer, 50u);
+    memoryUsage.add(2, Category::UndoHistory, 300u);
+    memoryUsage.add_shared(1, Category::Images, &sharedPixbuf, 1000u);
+    // the same pixbuf held by an undo state of another node is not counted twice
+    memoryUsage.add_shared(2, Category::UndoHistory, &sharedPixbuf, 1000u);
+    ASSERT_EQ(150u, memoryUsage.get_total(Category::TextBuffer));
+    ASSERT_EQ(1000u, memoryUsage.get_total(Category::Images));
+    ASSERT_EQ(300u, memoryUsage.get_total(Category::UndoHistory));
+    ASSERT_EQ(0u, memoryUsage.get_total(Category::DelayedXml));
+    ASSERT_EQ(1450u, memoryUsage.get_total());
+
+    const std::vector<CtMemoryUsage::NodeUsage> byTotal = memoryUsage.get_sorted();
+    ASSERT_EQ(2u, byTotal.size());
+    ASSERT_EQ(1, byTotal.at(0).nodeId);
+    ASSERT_EQ(1100u, byTotal.at(0).get_total());
+    const std::vector<CtMemoryUsage::NodeUsage> byUndo = memoryUsage.get_sorted(Category::UndoHistory);
+    ASSERT_EQ(2, byUndo.at(0).nodeId);
+
+    const std::string report = memoryUsage.get_report([](const gint64 nodeId){ return std::to_string(nodeId); }, 1u);
+    ASSERT_EQ("memory usage total 1450 text_buffer 150 images 1000 embedded_files 0 delayed_xml 0 undo_history 300"
+              "\n  1 '1' 1100 text_buffer 100 images 1000", report);
+}
+
+TEST(MiscUtilsGroup, region_highlighter)
+{
+    Glib::init();
+    Glib::RefPtr<Gtk::TextBuffer> pTextBuffer = Glib::wrap(GTK_TEXT_BUFFER(gtk_source_buffer_new(nullptr)));
+    std::string text;
+    for (int i = 0; i < 300; ++i) {
+        text += "int a = 0; // comment\n";
+    }
+    pTextBuffer->set_text(text);
+    GtkSourceLanguage* pGtkSourceLanguage = gtk_source_language_manager_get_language(gtk_source_language_manager_get_default(), "cpp");
+    GtkSourceStyleScheme* pGtkSourceStyleScheme = gtk_source_style_scheme_manager_get_scheme(gtk_source_style_scheme_manager_get_default(), "classic");
+    ASSERT_EQ(nullptr, CtRegionHighlighter::get(pTextBuffer));
+    CtRegionHighlighter* pCtRegionHighlighter = CtRegionHighlighter::attach(pTextBuffer, pGtkSourceLanguage, pGtkSourceStyleScheme);
+    ASSERT_EQ(pCtRegionHighlighter, CtRegionHighlighter::get(pTextBuffer));
+
+    // a slice at a time
+    ASSERT_TRUE(pCtRegionHighlighter->highlight_lines(0, 9, 5));
+    ASSERT_TRUE(pCtRegionHighlighter->get_line_highlighted(4));
+    ASSERT_FALSE(pCtRegionHighlighter->get_line_highlighted(5));
+    ASSERT_FALSE(pCtRegionHighlighter->highlight_lines(0, 9, 0/*no limit*/));
+    ASSERT_EQ(10u, pCtRegionHighlighter->get_num_lines_highlighted());
+    ASSERT_FALSE(pTextBuffer->get_iter_at_line_offset(1, 12).get_tags().empty());
+    ASSERT_TRUE(pTextBuffer->get_iter_at_line_offset(20, 12).get_tags().empty());
+
+    // the edited lines and the ones below are to be highlighted again
+    pTextBuffer->insert(pTextBuffer->get_iter_at_line(2), "/* a\n");
+    ASSERT_TRUE(pCtRegionHighlighter->get_line_highlighted(1));
+    ASSERT_FALSE(pCtRegionHighlighter->get_line_highlighted(2));
+    ASSERT_FALSE(pCtRegionHighlighter->get_line_highlighted(10));
+    ASSERT_EQ(2u, pCtRegionHighlighter->get_num_lines_highlighted());
+    pTextBuffer->erase(pTextBuffer->get_iter_at_line(2), pTextBuffer->get_iter_at_line(3));
+    ASSERT_EQ(2u, pCtRegionHighlighter->get_num_lines_highlighted());
+
+    CtRegionHighlighter::detach(pTextBuffer);
+    ASSERT_EQ(nullptr, CtRegionHighlighter::get(pTextBuffer));
+    ASSERT_TRUE(pTextBuffer->get_iter_at_line_offset(1, 12).get_tags().empty());
+}
@@ -24,6 +24,8 @@
 #include "ct_app.h"
 #include "ct_misc_utils.h"
 #include "ct_storage_control.h"
+#include "ct_actions.h"
+#include "ct_image.h"
 #include "tests_common.h"
 
 class TestCtApp : public CtApp
@@ -82,7 +84,7 @@ void TestCtApp::_run_test(const fs::path doc_filepath_from, const fs::path doc_f
     // tree empty
     ASSERT_FALSE(pWin->get_tree_store().get_iter_first());
     // load file
-    ASSERT_TRUE(pWin->file_open(doc_filepath_from, ""/*node_to_focus*/, ""/*anchor_to_focus*/, docEncrypt_from != CtDocEncrypt::True ? "" : UT::testPassword));
+    ASSERT_EQ(CtFileOpenResult::Opened, pWin->file_open(doc_filepath_from, ""/*node_to_focus*/, ""/*anchor_to_focus*/, docEncrypt_from != CtDocEncrypt::True ? "" : UT::testPassword));
     // do not check/walk the tree before calling the save_as to test that
     // even without visiting each node we save it all
 
@@ -103,7 +105,7 @@ void TestCtApp::_run_test(const fs::path doc_filepath_from, const fs::path doc_f
     // tree empty
     ASSERT_FALSE(pWin2->get_tree_store().get_iter_first());
     // load file previously saved
-    ASSERT_TRUE(pWin2->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
+    ASSERT_EQ(CtFileOpenResult::Opened, pWin2->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
     // check tree
     _assert_tree_data(pWin2, false/*after_mods*/);
 
@@ -170,9 +172,52 @@ void TestCtApp::_run_test(const fs::path doc_filepath_from, const fs::path doc_f
     // tree empty
     ASSERT_FALSE(pWin3->get_tree_store().get_iter_first());
     // load file previously saved
-    ASSERT_TRUE(pWin3->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
+    ASSERT_EQ(CtFileOpenResult::Opened, pWin3->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
     // check tree
     _assert_tree_data(pWin3, true/*after_mods*/);
+    {
+        // duplicate node "b", the copy is built from its content when selected
+        CtTreeIter ctTreeIter = pWin3->get_tree_store().get_node_from_node_name("b");
+        pWin3->get_tree_view().set_cursor_safe(ctTreeIter);
+        pWin3->get_ct_actions()->node_subnodes_duplicate();
+        CtTreeIter dupTreeIter = pWin3->curr_tree_iter();
+        ASSERT_TRUE(dupTreeIter);
+        ASSERT_NE(ctTreeIter.get_node_id(), dupTreeIter.get_node_id());
+        ASSERT_STREQ("b", dupTreeIter.get_node_name().c_str());
+        _assert_node_text(dupTreeIter, ctTreeIter.get_node_text_buffer()->get_text());
+        ASSERT_TRUE(pWin3->get_ct_storage()->get_storage_sync_pending()->nodes_to_write_dict.count(dupTreeIter.get_node_id()) > 0u);
+
+        // a copied subnode deleted before ever being selected leaves no content behind for a node reusing its id
+        CtTreeIter leafTreeIter = pWin3->get_tree_store().to_ct_tree_iter(Gtk::TreeModel::iterator{});
+        std::function<void(Gtk::TreeModel::iterator)> f_find_leaf;
+        f_find_leaf = [&](Gtk::TreeModel::iterator parentIter) {
+            for (Gtk::TreeModel::iterator childIter = parentIter->children().begin(); childIter; ++childIter) {
+                CtTreeIter childTreeIter = pWin3->get_tree_store().to_ct_tree_iter(childIter);
+                if (childIter->children().empty() and
+                    pWin3->get_tree_store().imported_content_get(childTreeIter.get_node_id()) and
+                    (not leafTreeIter or childTreeIter.get_node_id() > leafTreeIter.get_node_id()))
+                {
+                    leafTreeIter = childTreeIter;
+                }
+                f_find_leaf(childIter);
+            }
+        };
+        f_find_leaf(dupTreeIter);
+        ASSERT_TRUE(leafTreeIter);
+        const gint64 leafNodeId = leafTreeIter.get_node_id();
+        pWin3->update_window_save_needed(CtSaveNeededUpdType::ndel, false/*new_machine_state*/, &leafTreeIter);
+        pWin3->get_tree_store().get_store()->erase(leafTreeIter);
+        ASSERT_EQ(nullptr, pWin3->get_tree_store().imported_content_get(leafNodeId));
+    }
+    {
+        // a window without gui (as for the export from command line) loads its own copy of a document already open
+        CtMainWin* pWin4 = _create_window(true/*start_hidden*/);
+        ASSERT_EQ(CtFileOpenResult::Opened, pWin4->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
+        ASSERT_TRUE(pWin4->get_tree_store().get_iter_first());
+        ASSERT_FALSE(pWin4->get_ct_storage()->get_file_path().empty());
+        pWin4->force_exit() = true;
+        remove_window(*pWin4);
+    }
 
     // close this window/tree
     pWin3->force_exit() = true;
@@ -647,7 +692,7 @@ void TestCtApp::_assert_tree_data(CtMainWin* pWin, const bool after_mods)
                     ASSERT_TRUE(pImageEmbFile);
                     ASSERT_STREQ("йцукенгшщз.txt", pImageEmbFile->get_file_name().c_str());
                     static const std::string embedded_file = Glib::Base64::decode("0LnRhtGD0LrQtdC90LPRiNGJ0LcK");
-                    const auto rawBlobSize = pImageEmbFile->get_raw_blob().size();
+                    const auto rawBlobSize = pImageEmbFile->get_blob()->size();
                     if (0 == rawBlobSize) {
                         const fs::path& embFilePath = pImageEmbFile->get_pathLastMultiFile();
                         ASSERT_TRUE(fs::is_regular_file(embFilePath));
@@ -656,8 +701,8 @@ void TestCtApp::_assert_tree_data(CtMainWin* pWin, const bool after_mods)
                         ASSERT_EQ(embedded_file, embFileContent);
                     }
                     else {
-                        ASSERT_EQ(embedded_file.size(), pImageEmbFile->get_raw_blob().size());
-                        ASSERT_EQ(embedded_file, pImageEmbFile->get_raw_blob());
+                        ASSERT_EQ(embedded_file.size(), pImageEmbFile->get_blob()->size());
+                        ASSERT_EQ(embedded_file, pImageEmbFile->get_blob()->read_all());
                         ASSERT_EQ(1565442560, pImageEmbFile->get_time());
                     }
                 } break;
@@ -723,3 +768,43 @@ INSTANTIATE_TEST_CASE_P(
                 std::make_tuple(UT::testCtzDocPath, UT::testCtxDocPath, false/*test_save*/),
                 std::make_tuple(UT::testCtzDocPath, UT::testMultiFilePath, false/*test_save*/))
 );
+
+TEST(EmbFileBlobGroup, spool_n_base64)
+{
+    std::string rawBlob(CtEmbFileBlob::SPOOL_MIN_SIZE + CtEmbFileBlob::CHUNK_SIZE / 2 + 1, '\0');
+    for (size_t i = 0; i < rawBlob.size(); ++i) {
+        rawBlob[i] = static_cast<char>((i * 7u) % 251u);
+    }
+    const std::string encodedBlob = Glib::Base64::encode(rawBlob);
+
+    CtEmbFileBlobPtr pBlob = CtEmbFileBlob::from_base64(encodedBlob);
+    ASSERT_TRUE(pBlob);
+    ASSERT_TRUE(pBlob->is_spooled());
+    ASSERT_TRUE(fs::is_regular_file(pBlob->get_spool_filepath()));
+    ASSERT_EQ(rawBlob.size(), pBlob->size());
+    ASSERT_EQ(rawBlob, pBlob->read_all());
+    ASSERT_EQ(encodedBlob, pBlob->to_base64());
+#if GTKMM_MAJOR_VERSION >= 4
+    ASSERT_EQ(Glib::Checksum::compute_checksum(Glib::Checksum::Type::SHA256, rawBlob), pBlob->get_sha256sum());
+#else
+    ASSERT_EQ(Glib::Checksum::compute_checksum(Glib::Checksum::ChecksumType::CHECKSUM_SHA256, rawBlob), pBlob->get_sha256sum());
+#endif
+
+    const fs::path spoolFilepath = pBlob->get_spool_filepath();
+    const fs::path outFilepath = spoolFilepath.string() + "_out";
+    ASSERT_TRUE(pBlob->write_to_file(outFilepath));
+    CtEmbFileBlobPtr pBlobFromFile = CtEmbFileBlob::from_file(outFilepath);
+    ASSERT_TRUE(pBlobFromFile);
+    ASSERT_TRUE(pBlobFromFile->is_spooled());
+    ASSERT_EQ(rawBlob, pBlobFromFile->read_all());
+    fs::remove(outFilepath);
+
+    pBlob.reset();
+    ASSERT_FALSE(fs::is_regular_file(spoolFilepath));
+
+    CtEmbFileBlobPtr pSmallBlob = CtEmbFileBlob::from_base64(Glib::Base64::encode("small"));
+    ASSERT_FALSE(pSmallBlob->is_spooled());
+    ASSERT_EQ(std::string{"small"}, pSmallBlob->read_all());
+    ASSERT_TRUE(CtEmbFileBlob::from_memory(std::string{})->empty());
+    ASSERT_EQ(std::string{}, CtEmbFileBlob::from_memory(std::string{})->to_base64());
+}
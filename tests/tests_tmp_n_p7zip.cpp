@@ -23,12 +23,14 @@
 
 #include "ct_app.h"
 #include "ct_p7za_iface.h"
+#include "ct_sqlite_crypt_vfs.h"
 #include "config.h"
 #include "ct_filesystem.h"
 #include "tests_common.h"
 
 #include <glib/gstdio.h>
 #include <libxml++/libxml++.h>
+#include <sqlite3.h>
 
 TEST(TmpP7zipGroup, CTTmp_misc)
 {
@@ -122,3 +124,109 @@ TEST(TmpP7zipGroup, P7zaExtravtWrongPasswd)
     ASSERT_TRUE(Glib::file_test(ctdTmpPath, Glib::FILE_TEST_EXISTS));
     g_remove(ctTmp.getHiddenFilePath(UT::ctzInputPath).string().c_str());
 }
+
+TEST(TmpP7zipGroup, SqliteCryptVfs)
+{
+    CtTmp ctTmp;
+    const std::string ctxTmpPath{(ctTmp.getHiddenDirPath(UT::ctxInputPath) / "vfs.ctx").string()};
+    ASSERT_TRUE(CtSqliteCryptVfs::create_file(ctxTmpPath, UT::testPassword));
+    ASSERT_TRUE(CtSqliteCryptVfs::is_crypt_file(ctxTmpPath));
+    ASSERT_FALSE(CtSqliteCryptVfs::is_crypt_file(UT::testCtbDocPath));
+    ASSERT_FALSE(CtSqliteCryptVfs::is_crypt_file(UT::ctxInputPath));
+
+    // write ahead log, frames not aligned to the encrypted blocks
+    sqlite3* pDb{nullptr};
+    ASSERT_EQ(SQLITE_OK, sqlite3_open_v2(ctxTmpPath.c_str(), &pDb, SQLITE_OPEN_READWRITE, CtSqliteCryptVfs::get_vfs_name()));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, "PRAGMA journal_mode=WAL", nullptr, nullptr, nullptr));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, "CREATE TABLE node (node_id INTEGER, txt TEXT)", nullptr, nullptr, nullptr));
+    for (int i = 0; i < 500; ++i) {
+        const std::string sql = "INSERT INTO node VALUES (" + std::to_string(i) + ", 'NodeContent" + std::string(i, 'x') + "')";
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, sql.c_str(), nullptr, nullptr, nullptr));
+    }
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, "DELETE FROM node WHERE node_id % 2 = 0", nullptr, nullptr, nullptr));
+    sqlite3_close(pDb);
+
+    // no plain content on disk
+    const std::string rawContent = Glib::file_get_contents(ctxTmpPath);
+    ASSERT_EQ(std::string::npos, rawContent.find("NodeContent"));
+    ASSERT_EQ(std::string::npos, rawContent.find("SQLite format 3"));
+
+    auto f_count_rows = [](sqlite3* pDb)->int{
+        sqlite3_stmt* pStmt{nullptr};
+        int count{-1};
+        if (SQLITE_OK == sqlite3_prepare_v2(pDb, "SELECT count(*) FROM node WHERE txt LIKE 'NodeContent%'", -1, &pStmt, nullptr) and
+            SQLITE_ROW == sqlite3_step(pStmt))
+        {
+            count = sqlite3_column_int(pStmt, 0);
+        }
+        sqlite3_finalize(pStmt);
+        return count;
+    };
+    ASSERT_FALSE(CtSqliteCryptVfs::unlock_file(ctxTmpPath, "wrongpassword"));
+    ASSERT_TRUE(CtSqliteCryptVfs::unlock_file(ctxTmpPath, UT::testPassword));
+    ASSERT_EQ(SQLITE_OK, sqlite3_open_v2(ctxTmpPath.c_str(), &pDb, SQLITE_OPEN_READONLY, CtSqliteCryptVfs::get_vfs_name()));
+    ASSERT_EQ(250, f_count_rows(pDb));
+    sqlite3_close(pDb);
+
+    // a crash leaves the tail of the write ahead log torn or truncated: the frames before it are recovered
+    // (every commit is padded to the 4 KiB sector with copies of its last frame, so it may survive whole)
+    ASSERT_EQ(SQLITE_OK, sqlite3_open_v2(ctxTmpPath.c_str(), &pDb, SQLITE_OPEN_READWRITE, CtSqliteCryptVfs::get_vfs_name()));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, "PRAGMA wal_autocheckpoint=0", nullptr, nullptr, nullptr));
+    for (int i = 500; i < 600; ++i) {
+        const std::string sql = "INSERT INTO node VALUES (" + std::to_string(i) + ", 'NodeContent" + std::string(i, 'x') + "')";
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, sql.c_str(), nullptr, nullptr, nullptr));
+    }
+    const std::string rawMain = Glib::file_get_contents(ctxTmpPath);
+    const std::string rawWal = Glib::file_get_contents(ctxTmpPath + "-wal");
+    sqlite3_close(pDb);
+    for (const bool truncated : {false, true}) {
+        const std::string crashPath{(ctTmp.getHiddenDirPath(UT::ctxInputPath) / "vfs_crash.ctx").string()};
+        Glib::file_set_contents(crashPath, rawMain);
+        std::string tornWal = rawWal;
+        if (truncated) tornWal.resize(tornWal.size() - 1000u);
+        else tornWal[tornWal.size() - 100u] ^= 0x01;
+        Glib::file_set_contents(crashPath + "-wal", tornWal);
+        ASSERT_EQ(SQLITE_OK, sqlite3_open_v2(crashPath.c_str(), &pDb, SQLITE_OPEN_READWRITE, CtSqliteCryptVfs::get_vfs_name()));
+        const int rowsNum = f_count_rows(pDb);
+        ASSERT_LE(349, rowsNum); // at most the last transaction is lost
+        ASSERT_GE(350, rowsNum);
+        sqlite3_close(pDb);
+        g_remove(crashPath.c_str());
+    }
+    // only the last block can be torn, one in the middle of the write ahead log was tampered with
+    {
+        const std::string crashPath{(ctTmp.getHiddenDirPath(UT::ctxInputPath) / "vfs_crash.ctx").string()};
+        Glib::file_set_contents(crashPath, rawMain);
+        const size_t physBlockSize{16u + 4u + 4096u + 16u}; // iv, plain length, ciphertext, tag
+        const size_t numBlocks = (rawWal.size() - 4096u)/physBlockSize;
+        ASSERT_LT(4u, numBlocks);
+        std::string tamperedWal = rawWal;
+        tamperedWal[4096u + (numBlocks/2u)*physBlockSize + 100u] ^= 0x01;
+        Glib::file_set_contents(crashPath + "-wal", tamperedWal);
+        const bool opened = SQLITE_OK == sqlite3_open_v2(crashPath.c_str(), &pDb, SQLITE_OPEN_READWRITE, CtSqliteCryptVfs::get_vfs_name());
+        ASSERT_TRUE(not opened or -1 == f_count_rows(pDb));
+#if defined(SQLITE_IOERR_DATA)
+        ASSERT_EQ(SQLITE_IOERR_DATA, sqlite3_extended_errcode(pDb)); // not read as a short log
+#endif
+        sqlite3_close(pDb);
+        g_remove(crashPath.c_str());
+    }
+
+    // the keys are forgotten once released by create_file() and unlock_file() and no file is open
+    CtSqliteCryptVfs::release_file(ctxTmpPath);
+    CtSqliteCryptVfs::release_file(ctxTmpPath);
+    ASSERT_NE(SQLITE_OK, sqlite3_open_v2(ctxTmpPath.c_str(), &pDb, SQLITE_OPEN_READONLY, CtSqliteCryptVfs::get_vfs_name()));
+    sqlite3_close(pDb);
+    ASSERT_TRUE(CtSqliteCryptVfs::unlock_file(ctxTmpPath, UT::testPassword));
+
+    // a tampered block does not authenticate (the first block, right after the 4 KiB header, holds the schema)
+    {
+        std::string tampered = rawContent;
+        tampered[4096 + 100] ^= 0x01;
+        Glib::file_set_contents(ctxTmpPath, tampered);
+    }
+    const bool opened = SQLITE_OK == sqlite3_open_v2(ctxTmpPath.c_str(), &pDb, SQLITE_OPEN_READONLY, CtSqliteCryptVfs::get_vfs_name());
+    ASSERT_TRUE(not opened or -1 == f_count_rows(pDb));
+    sqlite3_close(pDb);
+    g_remove(ctxTmpPath.c_str());
+}